@@ -198,6 +198,11 @@ typedef enum {
 	dx_csdec_protocol_error = 103,
 	dx_csdec_unsupported_version = 104,
 
+	/* gzip codec error codes */
+
+	dx_gzec_data_corrupted = 105,
+	dx_gzec_stream_error = 106,
+
 	/* miscellaneous error codes */
 
 	/* error code count */
@@ -482,6 +482,38 @@ DXFEED_API ERRORCODE dxf_create_subscription_timed_with_flags(dxf_connection_t c
                                                               dxf_long_t time, dx_event_subscr_flag subscr_flags,
                                                               OUT dxf_subscription_t* subscription);
 
+/**
+ * @ingroup c-api-basic-subscription-functions
+ *
+ * @brief Creates a subscription with the subscription flags that delivers its events asynchronously.
+ *
+ * @details The events are put into a bounded queue of the subscription and the listeners are called by a dedicated
+ *          thread of the subscription or by the tasks run by the user executor, so the slow listeners don't delay
+ *          the processing of the data received by the connection. The executor gets one task of the subscription
+ *          at a time, so the events are delivered in order. When the queue is full the events are dealt with according
+ *          to the overflow policy of the options, see {@link dxf_get_subscription_delivery_statistics} for the queue
+ *          depth and the dropped events. In the {@link dxf_dm_last_value} mode only the last event of every symbol
+ *          and type is kept until it's delivered, so the listeners get the latest values at their own pace and
+ *          the memory is bounded by the number of the symbols. The events queued before the symbols are removed are
+ *          still delivered, but no listener is called after {@link dxf_close_subscription} returns.
+ *
+ * @param[in] connection    A handle of a previously created connection which the subscription will be using
+ * @param[in] event_types   A bitmask of the subscription event types. See {@link dx_event_id_t} and
+ *                          {@link DX_EVENT_BIT_MASK} for information on how to create an event type bitmask
+ * @param[in] subscr_flags  A bitmask of the subscription event flags. See {@link dx_event_subscr_flag}
+ * @param[in] options       The delivery options: the delivery mode, the queue capacity, the overflow policy and
+ *                          the executor
+ * @param[out] subscription A handle of the created subscription
+ *
+ * @return {@link DXF_SUCCESS} on successful subscription creation or {@link DXF_FAILURE} on error;
+ *         {@link dxf_get_last_error} can be used to retrieve the error code and description in case of failure;
+ *         a handle to newly created subscription is returned via ```subscription``` out parameter
+ */
+DXFEED_API ERRORCODE dxf_create_subscription_with_delivery(dxf_connection_t connection, int event_types,
+                                                           dx_event_subscr_flag subscr_flags,
+                                                           const dxf_delivery_options_t* options,
+                                                           OUT dxf_subscription_t* subscription);
+
 /**
  * @ingroup c-api-basic-subscription-functions
  *
@@ -732,12 +764,107 @@ DXFEED_API ERRORCODE dxf_detach_event_listener_v2(dxf_subscription_t subscriptio
  */
 DXFEED_API ERRORCODE dxf_get_subscription_event_types (dxf_subscription_t subscription, OUT int* event_types);
 
+/**
+ * @ingroup c-api-event-listener-functions
+ *
+ * @brief Retrieves the counters of the asynchronous delivery of the subscription.
+ *
+ * @details The counters are zero for the subscriptions created without the delivery options, their listeners are
+ *          called by the thread processing the data received by the connection.
+ *
+ * @param[in] subscription A handle of the subscription created by {@link dxf_create_subscription_with_delivery}
+ * @param[out] statistics  The queue depth, the numbers of the delivered and the dropped events
+ *
+ * @return {@link DXF_SUCCESS} if the statistics has been successfully received or {@link DXF_FAILURE} on error;
+ *         {@link dxf_get_last_error} can be used to retrieve the error code and description in case of failure;
+ *         *statistics* itself is returned via out parameter
+ */
+DXFEED_API ERRORCODE dxf_get_subscription_delivery_statistics(dxf_subscription_t subscription,
+                                                              OUT dxf_delivery_statistics_t* statistics);
+
+/**
+ * @ingroup c-api-event-listener-functions
+ *
+ * @brief Creates a queue the events of the subscription are put into, so that the application takes them
+ *        with {@link dxf_poll_events} on its own thread instead of being called back.
+ *
+ * @details The queue gets the events of the subscription along with its listeners, which are called as usual.
+ *          The events are put into a bounded queue allocated at once, and the full queue is dealt with according to
+ *          the overflow policy of the options, the {@link dxf_dm_last_value} mode keeps only the last event of every
+ *          symbol and type. A subscription can have one event queue, it must be created before the symbols are
+ *          added to the subscription.
+ *
+ * @param[in] subscription A handle of the subscription whose events are to be queued
+ * @param[in] options      The delivery options: the delivery mode, the queue capacity and the overflow policy,
+ *                         the executor must be NULL
+ * @param[out] queue       A handle of the created event queue
+ *
+ * @return {@link DXF_SUCCESS} on successful queue creation or {@link DXF_FAILURE} on error;
+ *         {@link dxf_get_last_error} can be used to retrieve the error code and description in case of failure;
+ *         a handle to newly created queue is returned via ```queue``` out parameter
+ */
+DXFEED_API ERRORCODE dxf_create_event_queue(dxf_subscription_t subscription, const dxf_delivery_options_t* options,
+                                            OUT dxf_event_queue_t* queue);
+
+/**
+ * @ingroup c-api-event-listener-functions
+ *
+ * @brief Takes the queued events, waiting for them if the queue is empty.
+ *
+ * @details The events are taken in the order they have been received. Their symbols and data belong to the queue and
+ *          stay valid until the next call of the function for the queue or until the queue is closed. The function
+ *          must be called by one thread at a time. It returns no events when the subscription of the queue is closed.
+ *
+ * @param[in] queue        A handle of the event queue
+ * @param[out] events      The buffer for the taken events
+ * @param[in] max_events   The size of the buffer
+ * @param[in] timeout      How long to wait for the events in milliseconds: 0 means not to wait, a negative value
+ *                         means to wait until the events are queued or the subscription is closed
+ * @param[out] event_count The number of the events stored into the buffer
+ *
+ * @return {@link DXF_SUCCESS} on successful poll or {@link DXF_FAILURE} on error;
+ *         {@link dxf_get_last_error} can be used to retrieve the error code and description in case of failure
+ */
+DXFEED_API ERRORCODE dxf_poll_events(dxf_event_queue_t queue, OUT dxf_polled_event_t* events, int max_events,
+                                     int timeout, OUT int* event_count);
+
+/**
+ * @ingroup c-api-event-listener-functions
+ *
+ * @brief Retrieves the counters of the event queue.
+ *
+ * @param[in] queue       A handle of the event queue
+ * @param[out] statistics The queue depth, the numbers of the taken and the dropped events
+ *
+ * @return {@link DXF_SUCCESS} if the statistics has been successfully received or {@link DXF_FAILURE} on error;
+ *         {@link dxf_get_last_error} can be used to retrieve the error code and description in case of failure;
+ *         *statistics* itself is returned via out parameter
+ */
+DXFEED_API ERRORCODE dxf_get_event_queue_statistics(dxf_event_queue_t queue,
+                                                    OUT dxf_delivery_statistics_t* statistics);
+
+/**
+ * @ingroup c-api-event-listener-functions
+ *
+ * @brief Closes the event queue, no more events are put into it.
+ *
+ * @details The queue may be closed before or after its subscription, but not while it's polled by the other thread.
+ *          The events taken by the last poll become invalid.
+ *
+ * @param[in] queue A handle of the event queue
+ *
+ * @return {@link DXF_SUCCESS} on successful queue closing or {@link DXF_FAILURE} on error;
+ *         {@link dxf_get_last_error} can be used to retrieve the error code and description in case of failure
+ */
+DXFEED_API ERRORCODE dxf_close_event_queue(dxf_event_queue_t queue);
+
 /**
  * @ingroup c-api-event-listener-functions
  *
  * @brief Retrieves the last event data of the specified symbol and type for the connection.
  *
- * @details
+ * @details The returned data and their strings stay valid until the next call for the same symbol and type. Only the
+ *          events of the types set by {@link dxf_set_last_event_types} are kept, all types by default.
  *
  * @param[in] connection  A handle of the connection whose data is to be retrieved
  * @param[in] event_type  An event type bitmask defining a single event type
@@ -750,6 +877,23 @@ DXFEED_API ERRORCODE dxf_get_subscription_event_types (dxf_subscription_t subscr
  */
 DXFEED_API ERRORCODE dxf_get_last_event (dxf_connection_t connection, int event_type, dxf_const_string_t symbol,
                                          OUT dxf_event_data_t* event_data);
+
+/**
+ * @ingroup c-api-event-listener-functions
+ *
+ * @brief Sets the types of the events kept for {@link dxf_get_last_event}.
+ *
+ * @details The last event of every type is kept for every subscribed symbol by default. The events of the other types
+ *          aren't stored, which saves the memory and the time of processing them, and {@link dxf_get_last_event}
+ *          returns NULL for them.
+ *
+ * @param[in] connection  A handle of the connection
+ * @param[in] event_types A bitmask of the event types, 0 turns the last events off
+ *
+ * @return {@link DXF_SUCCESS} on success or {@link DXF_FAILURE} on error;
+ *         {@link dxf_get_last_error} can be used to retrieve the error code and description in case of failure
+ */
+DXFEED_API ERRORCODE dxf_set_last_event_types(dxf_connection_t connection, int event_types);
 /**
  * @ingroup c-api-common
  *
@@ -923,6 +1067,12 @@ DXFEED_API ERRORCODE dxf_delete_candle_symbol_attributes(dxf_candle_attributes_t
  *          If source is equal to "AGGREGATE_BID" or "AGGREGATE_ASK" subscription on MarketMaker event will
  *          be performed. For other events source parameter does not matter.
  *
+ *          If the snapshot with the same event id, symbol, source and time has been created with the connection
+ *          already, a new handle of that snapshot is returned, so the snapshot is received once and its records are
+ *          shared by the handles. Each handle has its own listeners, which get the records received already once
+ *          they are attached, and the snapshot is closed along with its last handle. The snapshot with the same event
+ *          id, symbol and source but another time can't be created.
+ *
  * @param[in] connection A handle of a previously created connection which the subscription will be using
  * @param[in] event_id   Single event id. Next events is supported: dxf_eid_order, dxf_eid_candle,
  *                       dx_eid_spread_order, dx_eid_time_and_sale, dx_eid_greeks, dx_eid_series.
@@ -943,6 +1093,34 @@ DXFEED_API ERRORCODE dxf_create_snapshot(dxf_connection_t connection, dx_event_i
                                          dxf_const_string_t symbol, const char* source, 
                                          dxf_long_t time, OUT dxf_snapshot_t* snapshot);
 
+/**
+ * @ingroup c-api-snapshots
+ *
+ * @brief Creates the snapshots of many symbols with the specified parameters.
+ *
+ * @details The snapshots are the same as the ones created by {@link dxf_create_snapshot} for each symbol, but they
+ *          are received with one subscription, whose events are passed to the snapshots of their symbols by a hash
+ *          table lookup, so the work per event doesn't grow with the number of the snapshots. The symbols whose
+ *          snapshots are open already get new handles of those snapshots. Each snapshot is closed with
+ *          {@link dxf_close_snapshot}, and the subscription is closed along with the last of them.
+ *
+ * @param[in] connection   A handle of a previously created connection which the subscription will be using
+ * @param[in] event_id     Single event id, see {@link dxf_create_snapshot}
+ * @param[in] symbols      The symbols of the snapshots
+ * @param[in] symbol_count The number of the symbols
+ * @param[in] source       Order source for Order or the keyword for MarketMaker, see {@link dxf_create_snapshot}
+ * @param[in] time         Time in the past (unix time in milliseconds)
+ * @param[out] snapshots   The array of *symbol_count* elements the handles of the snapshots of the symbols are
+ *                         returned to, in the order of the symbols
+ *
+ * @return {@link DXF_SUCCESS} if all the snapshots have been successfully created or {@link DXF_FAILURE} on error,
+ *         none of them is created then; {@link dxf_get_last_error} can be used to retrieve the error code and
+ *         description in case of failure
+ */
+DXFEED_API ERRORCODE dxf_create_snapshots(dxf_connection_t connection, dx_event_id_t event_id,
+                                          dxf_const_string_t* symbols, int symbol_count, const char* source,
+                                          dxf_long_t time, OUT dxf_snapshot_t* snapshots);
+
 /**
  * @ingroup c-api-snapshots
  *
@@ -996,7 +1174,8 @@ DXFEED_API ERRORCODE dxf_create_candle_snapshot(dxf_connection_t connection,
  *
  * @brief Closes a snapshot.
  *
- * @details All the data associated with it will be freed.
+ * @details The listeners attached with the handle are detached. All the data associated with the snapshot will be
+ *          freed when its last handle is closed.
  *
  * @param[in] snapshot A handle of the snapshot to close
  *
@@ -1075,6 +1254,44 @@ DXFEED_API ERRORCODE dxf_attach_snapshot_inc_listener(dxf_snapshot_t snapshot,
 DXFEED_API ERRORCODE dxf_detach_snapshot_inc_listener(dxf_snapshot_t snapshot, 
                                                   dxf_snapshot_inc_listener_t snapshot_listener);
 
+/**
+ * @ingroup c-api-snapshots
+ *
+ * @brief Sets how the listeners of the snapshot are notified of its changes.
+ *
+ * @details By default the listeners are called at the end of every transaction by the thread processing the data
+ *          received by the connection, and the full listeners get all the records each time. With a minimum interval
+ *          the changes are published by the worker thread of the connection at most once per interval, which is kept
+ *          to within a few tens of milliseconds, and the incremental listeners get the records added, updated or
+ *          removed since the previous notification at once. The full listeners can get all the records only with a
+ *          new snapshot and on request, see {@link dxf_request_full_snapshot}.
+ *          The policy is shared by all the handles of the snapshot.
+ *
+ * @param[in] snapshot A handle of the snapshot
+ * @param[in] policy   The minimum interval between the notifications and whether the full listeners get the records
+ *                     on demand only
+ *
+ * @return {@link DXF_SUCCESS} if the policy has been successfully set or {@link DXF_FAILURE} on error;
+ *         {@link dxf_get_last_error} can be used to retrieve the error code and description in case of failure;
+ */
+DXFEED_API ERRORCODE dxf_set_snapshot_publication_policy(dxf_snapshot_t snapshot,
+                                                         const dxf_snapshot_publication_policy_t* policy);
+
+/**
+ * @ingroup c-api-snapshots
+ *
+ * @brief Requests all the records of the snapshot to be passed to its listeners.
+ *
+ * @details The records are passed by the worker thread of the connection as a new snapshot as soon as the current
+ *          transaction is complete, regardless of the minimum interval of the publication policy.
+ *
+ * @param[in] snapshot A handle of the snapshot
+ *
+ * @return {@link DXF_SUCCESS} if the records have been successfully requested or {@link DXF_FAILURE} on error;
+ *         {@link dxf_get_last_error} can be used to retrieve the error code and description in case of failure;
+ */
+DXFEED_API ERRORCODE dxf_request_full_snapshot(dxf_snapshot_t snapshot);
+
 /**
  * @ingroup c-api-snapshots
  *
@@ -1373,6 +1590,71 @@ DXFEED_API ERRORCODE dxf_get_current_connected_address(dxf_connection_t connecti
  */
 DXFEED_API ERRORCODE dxf_get_current_connection_status(dxf_connection_t connection, OUT dxf_connection_status_t* status);
 
+/**
+ * @ingroup c-api-connection-functions
+ *
+ * @brief Retrieves the connection traffic counters before and after the compression
+ *
+ * @details The counters are accumulated for all the sockets opened by the connection. The gzip codec is enabled
+ *          by the "gzip+" address prefix, e.g. "gzip+demo.dxfeed.com:7300"; the compressed and the uncompressed
+ *          counters are equal for the connections that don't use it.
+ *
+ * @param[in] connection  A handle of a previously created connection
+ * @param[out] statistics Connection compression statistics
+ *
+ * @return {@link DXF_SUCCESS} if the statistics has been successfully received or {@link DXF_FAILURE} on error;
+ *         {@link dxf_get_last_error} can be used to retrieve the error code and description in case of failure;
+ *         *statistics* itself is returned via out parameter
+ */
+DXFEED_API ERRORCODE dxf_get_connection_compression_statistics(dxf_connection_t connection,
+	OUT dxf_compression_statistics_t* statistics);
+
+/**
+ * @ingroup c-api-connection-functions
+ *
+ * @brief Retrieves the counters of the records received by the connection and of the ones it hasn't transcoded
+ *
+ * @details The records are transcoded only into the events of the types some subscription of the connection wants.
+ *          The records none of the subscriptions wants any event of are skipped, and so are the events derived from
+ *          the transcoded records that nobody wants, e.g. the Order events of the Quote records while no subscription
+ *          wants the orders.
+ *
+ * @param[in] connection  A handle of a previously created connection
+ * @param[out] statistics Connection transcoding statistics
+ *
+ * @return {@link DXF_SUCCESS} if the statistics has been successfully received or {@link DXF_FAILURE} on error;
+ *         {@link dxf_get_last_error} can be used to retrieve the error code and description in case of failure;
+ *         *statistics* itself is returned via out parameter
+ */
+DXFEED_API ERRORCODE dxf_get_connection_transcoding_statistics(dxf_connection_t connection,
+	OUT dxf_transcoding_statistics_t* statistics);
+
+/**
+ * @ingroup c-api-connection-functions
+ *
+ * @brief Sets the fields of the records that the connection skips, because none of the listeners reads them
+ *
+ * @details The skipped fields aren't decoded, the string and the byte array ones aren't allocated, and the events
+ *          get the default values instead, as for the fields the server doesn't send. The skipped fields are also left out of the
+ *          record descriptions sent to the server, so the server may not send them at all. The field names are
+ *          the names of the record fields of the protocol, e.g. "Description" and "StatusReason" of the Profile
+ *          records or "Buyer" and "Seller" of the TimeAndSale ones; the time fields of the records can't be
+ *          skipped. The fields apply to all the subscriptions of the connection, and should be set before
+ *          the subscriptions are created: the records already described keep their fields until the connection
+ *          is restored.
+ *
+ * @param[in] connection     A handle of a previously created connection
+ * @param[in] record_info_id The records to skip the fields of
+ * @param[in] field_names    The names of the skipped fields, replacing the ones set before; may be NULL if
+ *                           field_count is 0, which makes the connection decode all the fields again
+ * @param[in] field_count    The number of the field names
+ *
+ * @return {@link DXF_SUCCESS} if the fields have been successfully set or {@link DXF_FAILURE} on error;
+ *         {@link dxf_get_last_error} can be used to retrieve the error code and description in case of failure
+ */
+DXFEED_API ERRORCODE dxf_set_skipped_record_fields(dxf_connection_t connection, dx_record_info_id_t record_info_id,
+	dxf_const_string_t* field_names, int field_count);
+
 /**
  * @ingroup c-api-common
  *
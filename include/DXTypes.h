@@ -70,6 +70,9 @@ typedef void* dxf_price_level_book_t;
 /// Regional book
 typedef void* dxf_regional_book_t;
 
+/// Event queue
+typedef void* dxf_event_queue_t;
+
 #ifdef _WIN32
 
 #	include <wchar.h>
@@ -173,4 +176,27 @@ typedef enum {
 	dxf_cs_authorized
 } dxf_connection_status_t;
 
+/// Connection traffic before and after the compression. The counters are equal for the uncompressed connections
+typedef struct {
+	/// The number of bytes read from the socket
+	dxf_ulong_t received_compressed_bytes;
+	/// The number of bytes the read data has been inflated to
+	dxf_ulong_t received_uncompressed_bytes;
+	/// The number of bytes sent by the client
+	dxf_ulong_t sent_uncompressed_bytes;
+	/// The number of bytes the sent data has been deflated to
+	dxf_ulong_t sent_compressed_bytes;
+} dxf_compression_statistics_t;
+
+/// The records received by the connection and the work skipped because no subscription wanted their events
+typedef struct {
+	/// The number of the records transcoded into events
+	dxf_ulong_t transcoded_records;
+	/// The number of the records skipped, because no subscription wanted any of the events they are transcoded into
+	dxf_ulong_t skipped_records;
+	/// The number of the events of the transcoded records that were skipped, e.g. the Order events derived from
+	/// the Quote records while no subscription wants the orders
+	dxf_ulong_t skipped_events;
+} dxf_transcoding_statistics_t;
+
 #endif /* DX_TYPES_H_INCLUDED */
\ No newline at end of file
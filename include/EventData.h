@@ -1112,6 +1112,8 @@ typedef dxf_ulong_t dxf_time_int_field_t;
 typedef struct dxf_event_params {
 	dxf_event_flags_t flags;
 	dxf_time_int_field_t time_int_field;
+	/// The key of the snapshot the event belongs to. It's set only for the events of the record types that have
+	/// snapshots open on the connection, otherwise it's 0
 	dxf_ulong_t snapshot_key;
 } dxf_event_params_t;
 
@@ -1131,7 +1133,7 @@ typedef struct dxf_event_params {
  * - event_type - Event type bit mask constructed from dx_event_id_t enum fields. See macro: \ref DXF_ET_TRADE, \ref DXF_ET_QUOTE ... \ref DXF_ET_CONFIGURATION
  * - symbol_name - Event symbol (AAPL, IBM, etc)
  * - data - Pointer to event data (should be casted to some specific event data structure, i.e. dxf_order_t, dxf_trade_t ...)
- * - data_count **[deprecated]** - The number of events. Always equals to 1. **[Will be removed in 8.0.0 version]**
+ * - data_count - The number of events. Equals to 1 unless the subscription has the #dx_esf_batch_events flag
  * - user_data - The user data passed to \ref dxf_attach_event_listener
  *
  *  An example of implementation:
@@ -1178,7 +1180,8 @@ typedef void (*dxf_event_listener_t)(int event_type, dxf_const_string_t symbol_n
  * - event_type - Event type bit mask constructed from dx_event_id_t enum fields. See macro: \ref DXF_ET_TRADE, \ref DXF_ET_QUOTE ... \ref DXF_ET_CONFIGURATION
  * - symbol_name - Event symbol (AAPL, IBM, etc)
  * - data - Pointer to event data (should be casted to some specific event data structure, i.e. dxf_order_t, dxf_trade_t ...)
- * - data_count **[deprecated]** - The number of events. Always equals to 1. **[Will be removed in 8.0.0 version]**
+ * - data_count - The number of events. Equals to 1 unless the subscription has the #dx_esf_batch_events flag,
+ *   the event_params are the parameters of the first event then
  * - event_params - Some event parameters: event flags, snapshot key and time stored in 4 high or low bytes
  * - user_data - The user data passed to \ref dxf_attach_event_listener_v2
  */
@@ -1284,6 +1287,9 @@ typedef enum dx_event_subscr_flag_t {
 	dx_esf_force_stream = 0x40u,
 	/// (0x80) Used for forcing subscription to history data
 	dx_esf_force_history = 0x80u,
+	/// (0x100) Used for passing the consecutive events of one record type and symbol received in one data message
+	/// to the listeners in one call. The listeners get `data_count` events and the parameters of the first one
+	dx_esf_batch_events = 0x100u,
 
 	dx_esf_force_enum_unsigned = UINT_MAX
 } dx_event_subscr_flag;
@@ -1303,6 +1309,94 @@ typedef struct dx_order_source_array {
 /// Pointer to an order source array
 typedef dx_order_source_array_t* dx_order_source_array_ptr_t;
 
+/**
+ * @ingroup event-data-structures-event-subscription-stuff
+ *
+ * @brief How the asynchronous delivery of a subscription keeps the events until they are delivered
+ */
+typedef enum dxf_delivery_mode {
+	/// Every event is put into the bounded queue, see #dxf_delivery_overflow_policy_t
+	dxf_dm_queue = 0,
+	/// Only the last event of every symbol and type is kept until it's delivered, the newer events replace it.
+	/// The events of the symbols are delivered in the order they have been updated in. The mode suits the events
+	/// that the newer ones override: Trade, Quote, Summary, Profile, Greeks, TheoPrice, Underlying, TradeETH and
+	/// Configuration, the subscriptions of the other types can't use it
+	dxf_dm_last_value
+} dxf_delivery_mode_t;
+
+/**
+ * @ingroup event-data-structures-event-subscription-stuff
+ *
+ * @brief What the asynchronous delivery of a subscription does when its queue is full
+ */
+typedef enum dxf_delivery_overflow_policy {
+	/// The thread receiving the data waits until the queue has room, so the server data is read more slowly.
+	/// The listeners and the other tasks of the executor may close the subscriptions and detach the listeners,
+	/// but they must not wait for the thread receiving the data otherwise, e.g. by closing the connection, as it may
+	/// be waiting for them to deliver the queued events
+	dxf_dop_block = 0,
+	/// The oldest queued event is dropped
+	dxf_dop_drop_oldest,
+	/// The new event replaces the queued event of the same symbol and type, or the oldest one is dropped if there's
+	/// no such event. It suits the events that the newer ones override, e.g. Quote, Trade or Summary
+	dxf_dop_conflate
+} dxf_delivery_overflow_policy_t;
+
+/// The task draining the delivery queue of a subscription, it must be called once with the task data
+typedef void (*dxf_delivery_task_t)(void* task_data);
+
+/// The user executor running the delivery tasks, e.g. on a thread pool. The executor must call every task
+/// it gets once, on any thread
+typedef void (*dxf_delivery_executor_t)(dxf_delivery_task_t task, void* task_data, void* executor_data);
+
+/// The asynchronous delivery options of a subscription
+typedef struct dxf_delivery_options {
+	/// How the events are kept until they are delivered
+	dxf_delivery_mode_t mode;
+	/// The number of the events the queue holds, it's rounded up to a power of two. Unused in the
+	/// #dxf_dm_last_value mode
+	int queue_capacity;
+	/// What is done when the queue is full. Unused in the #dxf_dm_last_value mode
+	dxf_delivery_overflow_policy_t overflow_policy;
+	/// The executor running the delivery tasks, or NULL for a dedicated delivery thread of the subscription
+	dxf_delivery_executor_t executor;
+	/// The user data passed to the executor
+	void* executor_data;
+} dxf_delivery_options_t;
+
+/// The counters of the asynchronous delivery of a subscription
+typedef struct dxf_delivery_statistics {
+	/// The number of the events in the queue, or the number of the undelivered last events in the
+	/// #dxf_dm_last_value mode
+	int queue_size;
+	/// The capacity of the queue, or the number of the symbol and type pairs seen in the #dxf_dm_last_value mode
+	int queue_capacity;
+	/// The largest number of the events the queue has held
+	int max_queue_size;
+	/// The number of the events passed to the listeners
+	dxf_ulong_t delivered_events;
+	/// The number of the events dropped by the #dxf_dop_drop_oldest and the #dxf_dop_conflate policies
+	dxf_ulong_t dropped_events;
+	/// The number of the events replaced by the newer ones by the #dxf_dop_conflate policy or in the
+	/// #dxf_dm_last_value mode
+	dxf_ulong_t conflated_events;
+	/// The number of the times the thread receiving the data has waited for the room by the #dxf_dop_block policy
+	dxf_ulong_t blocked_enqueues;
+} dxf_delivery_statistics_t;
+
+/// An event taken from an event queue by #dxf_poll_events, its symbol and data stay valid until the next poll
+/// of the queue
+typedef struct dxf_polled_event {
+	/// The event type, a one-bit mask of #dx_event_id_t
+	int event_type;
+	/// The symbol of the event
+	dxf_const_string_t symbol;
+	/// The event data of the type, e.g. #dxf_quote_t
+	dxf_const_event_data_t data;
+	/// The parameters of the event, see #dxf_event_listener_v2_t
+	dxf_event_params_t event_params;
+} dxf_polled_event_t;
+
 /// Subscription type
 typedef enum dx_subscription_type {
 	dx_st_begin = 0,
@@ -1415,6 +1509,17 @@ typedef void (*dxf_snapshot_listener_t)(const dxf_snapshot_data_ptr_t snapshot_d
 typedef void (*dxf_snapshot_inc_listener_t)(const dxf_snapshot_data_ptr_t snapshot_data, int new_snapshot,
 											void* user_data);
 
+/// How the listeners of a snapshot are notified of its changes
+typedef struct dxf_snapshot_publication_policy {
+	/// The least time between the notifications in milliseconds, the changes made by the transactions completed in
+	/// between are passed at once by the worker thread of the connection, so the incremental listeners get them
+	/// coalesced. 0 (the default) notifies the listeners at the end of every transaction
+	int min_interval;
+	/// If nonzero, the full listeners get all the records only with a new snapshot or after
+	/// #dxf_request_full_snapshot, the incremental listeners get the changes as usual
+	int full_snapshot_on_demand;
+} dxf_snapshot_publication_policy_t;
+
 /* -------------------------------------------------------------------------- */
 /*
  *  Price Level data structs
@@ -38,6 +38,9 @@ typedef struct dx_buffered_input_connection_context_t {
 	int in_buffer_length;
 	int in_buffer_limit;
 	int current_in_buffer_position;
+
+	/* the reads starting at or before this position end within the current message and skip the bounds checks */
+	int unchecked_read_limit;
 } dx_buffered_input_connection_context_t;
 
 #define CTX(context) \
@@ -46,17 +49,50 @@ typedef struct dx_buffered_input_connection_context_t {
 #define IS_BUF_CAPACITY_ENOUGH(context, bytes_to_read) \
 	(CTX(context)->current_in_buffer_position + bytes_to_read <= CTX(context)->in_buffer_length)
 
+/* the size of the longest value read at once, i.e. of a compact long */
+#define MAX_UNCHECKED_READ_SIZE 9
+#define NO_UNCHECKED_READS (-1)
+
+#define IS_UNCHECKED_READ_POSSIBLE(context) \
+	(CTX(context)->current_in_buffer_position <= CTX(context)->unchecked_read_limit)
+
+/* Validates the read, unless the value is known to be within the message validated by dx_set_in_buffer_limit */
+#define CHECKED_READ_BOUNDS(context, value, value_size) \
+	if (value == NULL || !IS_UNCHECKED_READ_POSSIBLE(context)) { \
+		CHECKED_CALL_3(dx_validate_buffer_and_value, context, value, value_size); \
+	}
+
 /* -------------------------------------------------------------------------- */
 
-DX_CONNECTION_SUBSYS_INIT_PROTO(dx_ccs_buffered_input) {
+void* dx_create_buffered_input (void) {
 	dx_buffered_input_connection_context_t* context = dx_calloc(1, sizeof(dx_buffered_input_connection_context_t));
 
+	if (context == NULL) {
+		return NULL;
+	}
+
+	context->unchecked_read_limit = NO_UNCHECKED_READS;
+
+	return context;
+}
+
+/* -------------------------------------------------------------------------- */
+
+void dx_free_buffered_input (void* context) {
+	dx_free(context);
+}
+
+/* -------------------------------------------------------------------------- */
+
+DX_CONNECTION_SUBSYS_INIT_PROTO(dx_ccs_buffered_input) {
+	void* context = dx_create_buffered_input();
+
 	if (context == NULL) {
 		return false;
 	}
 
 	if (!dx_set_subsystem_data(connection, dx_ccs_buffered_input, context)) {
-		dx_free(context);
+		dx_free_buffered_input(context);
 
 		return false;
 	}
@@ -74,7 +110,7 @@ DX_CONNECTION_SUBSYS_DEINIT_PROTO(dx_ccs_buffered_input) {
 		return res;
 	}
 
-	dx_free(context);
+	dx_free_buffered_input(context);
 
 	return true;
 }
@@ -116,6 +152,9 @@ int dx_get_in_buffer_length (void* context) {
 void dx_set_in_buffer (void* context, dxf_byte_t* new_buffer, int new_length) {
 	CTX(context)->in_buffer = new_buffer;
 	CTX(context)->in_buffer_length = new_length;
+
+	/* the limit of the message refers to the replaced buffer */
+	CTX(context)->unchecked_read_limit = NO_UNCHECKED_READS;
 }
 
 /* -------------------------------------------------------------------------- */
@@ -140,6 +179,8 @@ int dx_get_in_buffer_limit (void* context) {
 
 void dx_set_in_buffer_limit (void* context, int new_limit) {
 	CTX(context)->in_buffer_limit = new_limit;
+	CTX(context)->unchecked_read_limit = (CTX(context)->in_buffer == NULL) ? NO_UNCHECKED_READS :
+		MIN(new_limit, CTX(context)->in_buffer_length) - MAX_UNCHECKED_READ_SIZE;
 }
 
 /* -------------------------------------------------------------------------- */
@@ -332,6 +373,96 @@ int dx_read_byte_buffer_segment (void* context, dxf_byte_t* buffer, int buffer_l
 	return true;
 }
 
+/* -------------------------------------------------------------------------- */
+/*
+ *	Unchecked read operations. The caller guarantees that MAX_UNCHECKED_READ_SIZE bytes
+ *  are available at the current position, see IS_UNCHECKED_READ_POSSIBLE
+ */
+/* -------------------------------------------------------------------------- */
+
+static dxf_int_t dx_read_int_unchecked (dx_buffered_input_connection_context_t* context) {
+	const dxf_byte_t* in = context->in_buffer + context->current_in_buffer_position;
+
+	context->current_in_buffer_position += 4;
+
+	return ((dxf_int_t)(in[0] & 0xFF) << 24) | ((dxf_int_t)(in[1] & 0xFF) << 16) |
+		((dxf_int_t)(in[2] & 0xFF) << 8) | (dxf_int_t)(in[3] & 0xFF);
+}
+
+/* -------------------------------------------------------------------------- */
+
+static dxf_int_t dx_read_compact_int_unchecked (dx_buffered_input_connection_context_t* context) {
+	const dxf_byte_t* in = context->in_buffer + context->current_in_buffer_position;
+	dxf_int_t n = in[0] & 0xFF;
+
+	/* The ((n << k) >> k) expression performs two's complement */
+	if (n < 0x80) {
+		context->current_in_buffer_position += 1;
+
+		return (n << 25) >> 25;
+	}
+
+	if (n < 0xC0) {
+		context->current_in_buffer_position += 2;
+
+		return (((n << 8) | (in[1] & 0xFF)) << 18) >> 18;
+	}
+
+	if (n < 0xE0) {
+		context->current_in_buffer_position += 3;
+
+		return (((n << 16) | ((in[1] & 0xFF) << 8) | (in[2] & 0xFF)) << 11) >> 11;
+	}
+
+	if (n < 0xF0) {
+		context->current_in_buffer_position += 4;
+
+		return (((n << 24) | ((in[1] & 0xFF) << 16) | ((in[2] & 0xFF) << 8) | (in[3] & 0xFF)) << 4) >> 4;
+	}
+
+	/* The encoded number is possibly out of range, some bytes have to be skipped. */
+
+	++context->current_in_buffer_position;
+
+	while (((n <<= 1) & 0x10) != 0) {
+		++context->current_in_buffer_position;
+	}
+
+	return dx_read_int_unchecked(context);
+}
+
+/* -------------------------------------------------------------------------- */
+
+static dxf_long_t dx_read_compact_long_unchecked (dx_buffered_input_connection_context_t* context) {
+	const dxf_byte_t* in = context->in_buffer + context->current_in_buffer_position;
+	dxf_int_t n = in[0] & 0xFF;
+
+	if (n < 0xF0) {
+		/* the same encoding as of the compact int */
+
+		return dx_read_compact_int_unchecked(context);
+	}
+
+	if (n < 0xF8) {
+		context->current_in_buffer_position += 1;
+		n = (n << 29) >> 29;
+	} else if (n < 0xFC) {
+		context->current_in_buffer_position += 2;
+		n = (((n << 8) | (in[1] & 0xFF)) << 22) >> 22;
+	} else if (n < 0xFE) {
+		context->current_in_buffer_position += 3;
+		n = (((n << 16) | ((in[1] & 0xFF) << 8) | (in[2] & 0xFF)) << 15) >> 15;
+	} else if (n < 0xFF) {
+		context->current_in_buffer_position += 4;
+		n = ((dxf_int_t)in[1] << 16) | ((in[2] & 0xFF) << 8) | (in[3] & 0xFF);
+	} else {
+		context->current_in_buffer_position += 1;
+		n = dx_read_int_unchecked(context);
+	}
+
+	return ((dxf_long_t)n << 32) | (dx_read_int_unchecked(context) & 0xFFFFFFFFL);
+}
+
 /* -------------------------------------------------------------------------- */
 /*
  *	Read operations implementation
@@ -339,7 +470,7 @@ int dx_read_byte_buffer_segment (void* context, dxf_byte_t* buffer, int buffer_l
 /* -------------------------------------------------------------------------- */
 
 int dx_read_boolean (void* context, OUT dxf_bool_t* value) {
-	CHECKED_CALL_3(dx_validate_buffer_and_value, context, value, 1);
+	CHECKED_READ_BOUNDS(context, value, 1);
 
 	*value = CTX(context)->in_buffer[CTX(context)->current_in_buffer_position++];
 
@@ -349,7 +480,7 @@ int dx_read_boolean (void* context, OUT dxf_bool_t* value) {
 /* -------------------------------------------------------------------------- */
 
 int dx_read_byte (void* context, OUT dxf_byte_t* value) {
-	CHECKED_CALL_3(dx_validate_buffer_and_value, context, value, 1);
+	CHECKED_READ_BOUNDS(context, value, 1);
 
 	*value = CTX(context)->in_buffer[CTX(context)->current_in_buffer_position++];
 
@@ -359,7 +490,7 @@ int dx_read_byte (void* context, OUT dxf_byte_t* value) {
 /* -------------------------------------------------------------------------- */
 
 int dx_read_unsigned_byte (void* context, OUT dxf_uint_t* value) {
-	CHECKED_CALL_3(dx_validate_buffer_and_value, context, value, 1);
+	CHECKED_READ_BOUNDS(context, value, 1);
 
 	*value = ((dxf_uint_t)CTX(context)->in_buffer[CTX(context)->current_in_buffer_position++]) & 0xFF;
 
@@ -369,7 +500,7 @@ int dx_read_unsigned_byte (void* context, OUT dxf_uint_t* value) {
 /* -------------------------------------------------------------------------- */
 
 int dx_read_short (void* context, OUT dxf_short_t* value) {
-	CHECKED_CALL_3(dx_validate_buffer_and_value, context, value, 2);
+	CHECKED_READ_BOUNDS(context, value, 2);
 
 	*value = ((dxf_short_t)CTX(context)->in_buffer[CTX(context)->current_in_buffer_position++] << 8);
 	*value = *value | ((dxf_short_t)CTX(context)->in_buffer[CTX(context)->current_in_buffer_position++] & 0xFF);
@@ -380,7 +511,7 @@ int dx_read_short (void* context, OUT dxf_short_t* value) {
 /* -------------------------------------------------------------------------- */
 
 int dx_read_unsigned_short (void* context, OUT dxf_uint_t* value) {
-	CHECKED_CALL_3(dx_validate_buffer_and_value, context, value, 2);
+	CHECKED_READ_BOUNDS(context, value, 2);
 
 	*value = ((dxf_uint_t)(CTX(context)->in_buffer[CTX(context)->current_in_buffer_position++] & 0xFF) << 8);
 	*value = *value | ((dxf_uint_t)CTX(context)->in_buffer[CTX(context)->current_in_buffer_position++] & 0xFF);
@@ -391,7 +522,7 @@ int dx_read_unsigned_short (void* context, OUT dxf_uint_t* value) {
 /* -------------------------------------------------------------------------- */
 
 int dx_read_int (void* context, OUT dxf_int_t* value) {
-	CHECKED_CALL_3(dx_validate_buffer_and_value, context, value, 4);
+	CHECKED_READ_BOUNDS(context, value, 4);
 
 	*value = ((dxf_int_t)(CTX(context)->in_buffer[CTX(context)->current_in_buffer_position++] & 0xFF) << 24);
 	*value = *value | ((dxf_int_t)(CTX(context)->in_buffer[CTX(context)->current_in_buffer_position++] & 0xFF) << 16);
@@ -404,7 +535,7 @@ int dx_read_int (void* context, OUT dxf_int_t* value) {
 /* -------------------------------------------------------------------------- */
 
 int dx_read_long (void* context, OUT dxf_long_t* value) {
-	CHECKED_CALL_3(dx_validate_buffer_and_value, context, value, 8);
+	CHECKED_READ_BOUNDS(context, value, 8);
 
 	*value = ((dxf_long_t)CTX(context)->in_buffer[CTX(context)->current_in_buffer_position++] << 56);
 	*value = *value | ((dxf_long_t)CTX(context)->in_buffer[CTX(context)->current_in_buffer_position++] << 48);
@@ -518,6 +649,12 @@ int dx_read_compact_int (void* context, OUT dxf_int_t* value) {
 		return dx_set_error_code(dx_ec_invalid_func_param_internal);
 	}
 
+	if (IS_UNCHECKED_READ_POSSIBLE(context)) {
+		*value = dx_read_compact_int_unchecked(CTX(context));
+
+		return true;
+	}
+
 	dxf_uint_t temp_uint_byte;
 
 	/* The ((n << k) >> k) expression performs two's complement */
@@ -592,6 +729,12 @@ int dx_read_compact_long (void* context, OUT dxf_long_t* value) {
 		return dx_set_error_code(dx_ec_invalid_func_param_internal);
 	}
 
+	if (IS_UNCHECKED_READ_POSSIBLE(context)) {
+		*value = dx_read_compact_long_unchecked(CTX(context));
+
+		return true;
+	}
+
 	dxf_uint_t temp_uint_byte;
 	dxf_uint_t temp_uint_short;
 
@@ -606,9 +749,10 @@ int dx_read_compact_long (void* context, OUT dxf_long_t* value) {
 	}
 
 	if (n < 0xC0) {
-		dxf_uint_t tmp_byte;
+		dxf_int_t tmp_byte;
 
-		CHECKED_CALL_2(dx_read_unsigned_byte, context, &tmp_byte);
+		CHECKED_CALL_2(dx_read_unsigned_byte, context, &temp_uint_byte);
+		tmp_byte = (dxf_int_t)temp_uint_byte;
 
 		*value = (((n << 8) | tmp_byte) << 18) >> 18;
 
@@ -793,6 +937,57 @@ int dx_read_utf_string (void* context, OUT dxf_string_t* value) {
 	return dx_read_utf_sequence(context, (int)utflen, false, value);
 }
 
+/* -------------------------------------------------------------------------- */
+/*
+ *	Skip operations implementation
+ */
+/* -------------------------------------------------------------------------- */
+
+int dx_skip_byte_array (void* context) {
+	dxf_long_t length;
+
+	CHECKED_CALL_2(dx_read_compact_long, context, &length);
+
+	if (length < -1 || length > INT_MAX) {
+		return dx_set_error_code(dx_ec_invalid_func_param_internal);
+	}
+
+	if (length <= 0) {
+		return true;
+	}
+
+	/* the skipped data must end within the current message; IS_BUF_CAPACITY_ENOUGH might overflow for the lengths this large */
+	if (length > MIN(CTX(context)->in_buffer_limit, CTX(context)->in_buffer_length) - CTX(context)->current_in_buffer_position) {
+		return dx_set_error_code(dx_bioec_buffer_underflow);
+	}
+
+	CTX(context)->current_in_buffer_position += (int)length;
+
+	return true;
+}
+
+/* -------------------------------------------------------------------------- */
+
+int dx_skip_utf_char_array (void* context) {
+	dxf_long_t utflen;
+	dxf_int_t code_point;
+
+	CHECKED_CALL_2(dx_read_compact_long, context, &utflen);
+
+	if (utflen < -1 || utflen > INT_MAX) {
+		return dx_set_error_code(dx_ec_invalid_func_param_internal);
+	}
+
+	/* the characters have the variable length, but are validated all the same */
+	for (; utflen > 0; --utflen) {
+		CHECKED_CALL_2(dx_read_utf_char, context, &code_point);
+	}
+
+	return true;
+}
+
+/* -------------------------------------------------------------------------- */
+
 void dx_get_raw(void* context, OUT dxf_ubyte_t** raw, OUT dxf_int_t* len) {
 	int pos = CTX(context)->current_in_buffer_position;
 	dxf_int_t count = CTX(context)->in_buffer_limit - pos;
@@ -30,6 +30,10 @@
 
 void* dx_get_buffered_input_connection_context (dxf_connection_t connection);
 
+/* Creates the context that isn't bound to a connection, e.g. to decode the data obtained elsewhere */
+void* dx_create_buffered_input (void);
+void dx_free_buffered_input (void* context);
+
 /* -------------------------------------------------------------------------- */
 /*
  *	Buffer manipulators
@@ -42,6 +46,12 @@ void dx_set_in_buffer (void* context, dxf_byte_t* new_buffer, int new_length);
 int dx_get_in_buffer_position (void* context);
 void dx_set_in_buffer_position (void* context, int new_position);
 int dx_get_in_buffer_limit (void* context);
+
+/*
+ * Sets the end of the current message, which must be completely within the buffer.
+ * The message is validated once here: the reads that end well before the limit skip
+ * their own bounds checks, only the reads near the limit are checked.
+ */
 void dx_set_in_buffer_limit (void* context, int new_limit);
 
 /* -------------------------------------------------------------------------- */
@@ -130,6 +140,24 @@ int dx_read_utf_char_array (void* context, OUT dxf_string_t* value);
  */
 int dx_read_utf_string (void* context, OUT dxf_string_t* value);
 
+/* -------------------------------------------------------------------------- */
+/*
+ *	Skip operations
+ */
+/* -------------------------------------------------------------------------- */
+
+/*
+ * Skips an array of bytes in a compact encapsulation format without materializing it.
+ * This method defines length as a number of bytes, so it also skips the strings read by dx_read_utf_string.
+ */
+int dx_skip_byte_array (void* context);
+
+/*
+ * Skips Unicode string in a UTF-8 format with compact encapsulation without materializing it.
+ * This method defines length as a number of characters, as dx_read_utf_char_array does.
+ */
+int dx_skip_utf_char_array (void* context);
+
 void dx_get_raw(void* context, OUT dxf_ubyte_t** raw, OUT dxf_int_t* len);
 
 #endif /* BUFFERED_INPUT_H_INCLUDED */
\ No newline at end of file
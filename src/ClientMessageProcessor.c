@@ -29,6 +29,7 @@
 #include "DXPMessageData.h"
 #include "DXAlgorithms.h"
 #include "DXErrorHandling.h"
+#include "Configuration.h"
 #include "ConnectionContextData.h"
 #include "EventData.h"
 #include "ServerMessageProcessor.h"
@@ -191,23 +192,30 @@ static int dx_move_message_data (void* bocc, int old_offset, int new_offset, int
 
 /* -------------------------------------------------------------------------- */
 
-static int dx_finish_composing_message (void* bocc) {
-	int message_length = dx_get_out_buffer_position(bocc) - 1; /* 1 is for the one byte reserved for size */
+/* Finishes the message that starts at the given offset, the buffer may contain other messages before it */
+static int dx_finish_composing_message_at (void* bocc, int message_offset) {
+	int message_length = dx_get_out_buffer_position(bocc) - message_offset - 1; /* 1 is for the one byte reserved for size */
 	int length_size = dx_get_compact_size(message_length);
 
 	if (length_size > 1) {
 		/* Only one byte was initially reserved. Moving the message buffer */
 
-		CHECKED_CALL_4(dx_move_message_data, bocc, 1, length_size, message_length);
+		CHECKED_CALL_4(dx_move_message_data, bocc, message_offset + 1, message_offset + length_size, message_length);
 	}
 
-	dx_set_out_buffer_position(bocc, 0);
+	dx_set_out_buffer_position(bocc, message_offset);
 	CHECKED_CALL_2(dx_write_compact_int, bocc, message_length);
-	dx_set_out_buffer_position(bocc, length_size + message_length);
+	dx_set_out_buffer_position(bocc, message_offset + length_size + message_length);
 
 	return true;
 }
 
+/* -------------------------------------------------------------------------- */
+
+static int dx_finish_composing_message (void* bocc) {
+	return dx_finish_composing_message_at(bocc, 0);
+}
+
 /* -------------------------------------------------------------------------- */
 /*
  *	Symbol subscription helpers
@@ -227,75 +235,146 @@ static int dx_compose_body (void* bocc, dxf_int_t record_id, dxf_int_t cipher, d
 
 /* -------------------------------------------------------------------------- */
 
-static int dx_subscribe_symbol_to_record(dxf_connection_t connection, dx_message_type_t type,
-										dxf_const_string_t symbol, dxf_int_t cipher,
-										dxf_int_t record_id, dxf_long_t time, OUT dxf_byte_t** buffer, OUT int* buffer_size) {
-	static const dxf_int_t initial_buffer_size = 100;
+/*
+ *	The subscription batch composes the entries for many symbols into one reusable buffer. The consecutive entries
+ *  of the same message type share one message, and the buffer is sent with a single write when it reaches
+ *  the batch size. The buffered output is locked for the whole batch except for the time of sending.
+ */
+typedef struct {
+	dxf_connection_t connection;
+	void* bocc;
+	dxf_byte_t* buffer;
+	int buffer_capacity;
+	int batch_size;
 
-	void* bocc = NULL;
-	void* dscc = NULL;
-	dxf_byte_t* subscr_buffer = NULL;
-	int message_size = 0;
-	dxf_long_t subscription_time;
-	*buffer_size = 0;
-	*buffer = NULL;
+	/* the type and the offset of the message being composed, the offset is negative if there's none */
+	dx_message_type_t message_type;
+	int message_offset;
+} dx_subscription_batch_t;
 
-	bocc = dx_get_buffered_output_connection_context(connection);
-	dscc = dx_get_data_structures_connection_context(connection);
+#define DEFAULT_SUBSCRIPTION_BATCH_SIZE 65536
+#define MIN_SUBSCRIPTION_BATCH_SIZE		1024
 
-	if (bocc == NULL || dscc == NULL) {
+/* -------------------------------------------------------------------------- */
+
+static int dx_begin_subscription_batch(dx_subscription_batch_t* batch, dxf_connection_t connection) {
+	batch->connection = connection;
+	batch->bocc = dx_get_buffered_output_connection_context(connection);
+	batch->batch_size = MAX(dx_get_network_subscription_batch_size(DEFAULT_SUBSCRIPTION_BATCH_SIZE),
+		MIN_SUBSCRIPTION_BATCH_SIZE);
+	batch->message_offset = -1;
+
+	if (batch->bocc == NULL) {
 		return dx_set_error_code(dx_cec_connection_context_not_initialized);
 	}
 
-	if (!dx_is_subscription_message(type)) {
-		return dx_set_error_code(dx_pec_unexpected_message_type_internal);
+	/* the last entry may exceed the batch size a bit */
+	batch->buffer_capacity = batch->batch_size + MIN_SUBSCRIPTION_BATCH_SIZE;
+	batch->buffer = dx_malloc(batch->buffer_capacity);
+
+	if (batch->buffer == NULL) {
+		return false;
 	}
 
-	CHECKED_CALL(dx_lock_buffered_output, bocc);
+	if (!dx_lock_buffered_output(batch->bocc)) {
+		dx_free(batch->buffer);
 
-	subscr_buffer = (dxf_byte_t*)dx_malloc(initial_buffer_size);
+		return false;
+	}
 
-	if (subscr_buffer == NULL) {
-		dx_unlock_buffered_output(bocc);
+	dx_set_out_buffer(batch->bocc, batch->buffer, batch->buffer_capacity);
 
-		return false;
+	return true;
+}
+
+/* -------------------------------------------------------------------------- */
+
+static int dx_finish_subscription_message(dx_subscription_batch_t* batch) {
+	if (batch->message_offset < 0) {
+		return true;
 	}
 
-	dx_set_out_buffer(bocc, subscr_buffer, initial_buffer_size);
+	CHECKED_CALL_2(dx_finish_composing_message_at, batch->bocc, batch->message_offset);
 
-	if (!dx_compose_message_header(bocc, type) ||
-		!dx_compose_body(bocc, record_id, cipher, symbol) ||
-		((type == MESSAGE_HISTORY_ADD_SUBSCRIPTION) && !dx_create_subscription_time(dscc, record_id, time, OUT &subscription_time)) ||
-		((type == MESSAGE_HISTORY_ADD_SUBSCRIPTION) && !dx_write_compact_long(bocc, subscription_time)) ||
-		!dx_finish_composing_message(bocc)) {
+	batch->message_offset = -1;
 
-		dx_free(dx_get_out_buffer(bocc));
-		dx_unlock_buffered_output(bocc);
+	return true;
+}
 
-		return false;
+/* -------------------------------------------------------------------------- */
+
+/* Sends the composed messages. The buffered output is locked on return even if the sending fails */
+static int dx_flush_subscription_batch(dx_subscription_batch_t* batch) {
+	int data_size = 0;
+	int res = true;
+
+	CHECKED_CALL(dx_finish_subscription_message, batch);
+
+	data_size = dx_get_out_buffer_position(batch->bocc);
+
+	if (data_size == 0) {
+		return true;
 	}
 
-	subscr_buffer = dx_get_out_buffer(bocc);
-	message_size = dx_get_out_buffer_position(bocc);
+	/* the buffer might have been reallocated while composing */
+	batch->buffer = dx_get_out_buffer(batch->bocc);
+	batch->buffer_capacity = dx_get_out_buffer_length(batch->bocc);
 
-	if (!dx_unlock_buffered_output(bocc)) {
-		dx_free(subscr_buffer);
-		return false;
+	/* the other messages may be composed while the data is being sent */
+	CHECKED_CALL(dx_unlock_buffered_output, batch->bocc);
+
+	res = dx_send_data(batch->connection, batch->buffer, data_size);
+
+	CHECKED_CALL(dx_lock_buffered_output, batch->bocc);
+
+	dx_set_out_buffer(batch->bocc, batch->buffer, batch->buffer_capacity);
+
+	return res;
+}
+
+/* -------------------------------------------------------------------------- */
+
+static int dx_add_subscription_entry(dx_subscription_batch_t* batch, dx_message_type_t type, dxf_const_string_t symbol,
+									dxf_int_t cipher, dxf_int_t record_id, const dxf_long_t* subscription_time) {
+	if (batch->message_offset < 0 || batch->message_type != type) {
+		CHECKED_CALL(dx_finish_subscription_message, batch);
+
+		batch->message_type = type;
+		batch->message_offset = dx_get_out_buffer_position(batch->bocc);
+
+		CHECKED_CALL_2(dx_compose_message_header, batch->bocc, type);
 	}
-	if (subscr_buffer != NULL) {
-		if (message_size > 0) {
-			*buffer = subscr_buffer;
-			*buffer_size = message_size;
-		}
-		else {
-			dx_free(subscr_buffer);
-		}
+
+	CHECKED_CALL_4(dx_compose_body, batch->bocc, record_id, cipher, symbol);
+
+	if (subscription_time != NULL) {
+		CHECKED_CALL_2(dx_write_compact_long, batch->bocc, *subscription_time);
+	}
+
+	if (dx_get_out_buffer_position(batch->bocc) >= batch->batch_size) {
+		return dx_flush_subscription_batch(batch);
 	}
+
 	return true;
 }
 
 /* -------------------------------------------------------------------------- */
 
+/* Sends the rest of the composed messages if the batch is successful and frees the buffer */
+static int dx_end_subscription_batch(dx_subscription_batch_t* batch, int success) {
+	if (success) {
+		success = dx_flush_subscription_batch(batch);
+	}
+
+	/* the buffer might have been reallocated after the last flush */
+	dx_free(dx_get_out_buffer(batch->bocc));
+	dx_set_out_buffer(batch->bocc, NULL, 0);
+
+	return dx_unlock_buffered_output(batch->bocc) && success;
+}
+
+/* -------------------------------------------------------------------------- */
+
 int dx_subscribe_symbols_to_events_task (void* data, int command) {
 	dx_event_subscription_task_data_t* task_data = data;
 	int res = dx_tes_pop_me;
@@ -337,15 +416,26 @@ static int dx_write_record_field (void* bocc, const dx_field_info_t* field) {
 
 /* -------------------------------------------------------------------------- */
 
-static int dx_write_event_record(void* bocc, const dx_record_item_t* record, dx_record_id_t record_id) {
+/* The skipped fields are left out, so that the server may not send them at all */
+static int dx_write_event_record(void* bocc, const dx_record_item_t* record, dx_record_id_t record_id,
+								int skipped_fields) {
 	int field_index = 0;
+	int field_count = 0;
+
+	for (; field_index != record->field_count; ++field_index) {
+		if (!IS_FLAG_SET(skipped_fields, INDEX_BITMASK(field_index))) {
+			++field_count;
+		}
+	}
 
 	CHECKED_CALL_2(dx_write_compact_int, bocc, (dxf_int_t)record_id);
 	CHECKED_CALL_2(dx_write_utf_string, bocc, record->name);
-	CHECKED_CALL_2(dx_write_compact_int, bocc, (dxf_int_t)record->field_count);
+	CHECKED_CALL_2(dx_write_compact_int, bocc, (dxf_int_t)field_count);
 
-	for (; field_index != record->field_count; ++field_index) {
-		CHECKED_CALL_2(dx_write_record_field, bocc, record->fields + field_index);
+	for (field_index = 0; field_index != record->field_count; ++field_index) {
+		if (!IS_FLAG_SET(skipped_fields, INDEX_BITMASK(field_index))) {
+			CHECKED_CALL_2(dx_write_record_field, bocc, record->fields + field_index);
+		}
 	}
 
 	return true;
@@ -358,7 +448,9 @@ int dx_write_event_records (void* bocc, void* dscc) {
 	dx_record_id_t count = dx_get_records_list_count(dscc);
 
 	while (record_id < count) {
-		CHECKED_CALL_3(dx_write_event_record, bocc, dx_get_record_by_id(dscc, record_id), record_id);
+		const dx_record_item_t* record = dx_get_record_by_id(dscc, record_id);
+
+		CHECKED_CALL_4(dx_write_event_record, bocc, record, record_id, dx_get_skipped_record_fields(dscc, record->info_id));
 		record_id = dx_get_next_unsubscribed_record_id(dscc, true);
 	}
 
@@ -587,67 +679,74 @@ int dx_subscribe_symbols_to_events (dxf_connection_t connection, dx_order_source
 	}
 
 	/* executing in task mode (in background queue thread)*/
+	void* dscc = dx_get_data_structures_connection_context(connection);
+	dx_subscription_batch_t batch;
+	dxf_int_t* ciphers = NULL;
 	int success = true;
-	for (size_t i = 0; i < symbol_count && success; ++i) {
-		if (dx_string_null_or_empty(symbols[i])) {
+
+	if (dscc == NULL) {
+		return dx_set_error_code(dx_cec_connection_context_not_initialized);
+	}
+
+	if (symbol_count == 0) {
+		return true;
+	}
+
+	ciphers = dx_calloc(symbol_count, sizeof(dxf_int_t));
+
+	if (ciphers == NULL) {
+		return false;
+	}
+
+	for (size_t i = 0; i < symbol_count; ++i) {
+		if (!dx_string_null_or_empty(symbols[i])) {
+			ciphers[i] = dx_encode_symbol_name(symbols[i]);
+		}
+	}
+
+	if (!dx_begin_subscription_batch(&batch, connection)) {
+		dx_free(ciphers);
+
+		return false;
+	}
+
+	/* the entries are grouped by records, so that all the symbols of a record get into the same message */
+	for (dx_event_id_t eid = dx_eid_begin; eid < dx_eid_count && success; ++eid) {
+		if (!(event_types & DX_EVENT_BIT_MASK(eid))) {
 			continue;
 		}
 
-		dxf_byte_t* buffer = NULL;
-		int buffer_size = 0;
-		int buffer_capacity = 0;
-		for (dx_event_id_t eid = dx_eid_begin; eid < dx_eid_count && success; ++eid) {
-			if (event_types & DX_EVENT_BIT_MASK(eid)) {
-				dx_event_subscription_param_list_t subscr_params;
-				size_t param_count = dx_get_event_subscription_params(connection, order_source, eid, subscr_flags, &subscr_params);
-				for (size_t j = 0; j < param_count; ++j) {
-					const dx_event_subscription_param_t* cur_param = subscr_params.elements + j;
-					dx_message_type_t msg_type;
-					if (!dx_to_subscription_message_type(!unsubscribe, cur_param->subscription_type, &msg_type)) {
-						success = false;
-						break;
-					}
-					dxf_byte_t* param_buffer = NULL;
-					int param_buffer_size = 0;
-					if (!dx_subscribe_symbol_to_record(connection, msg_type, symbols[i],
-													dx_encode_symbol_name(symbols[i]),
-													cur_param->record_id, time, &param_buffer, &param_buffer_size)) {
-						success = false;
-						break;
-					}
-					if (param_buffer != NULL) {
-						if (buffer != NULL) {
-							if (buffer_capacity < buffer_size + param_buffer_size) {
-								dxf_byte_t* _temp = buffer;
-								buffer_capacity = (buffer_size + param_buffer_size) << 1;
-								buffer = (dxf_byte_t*)dx_malloc(buffer_capacity);
-								dx_memcpy(buffer, _temp, buffer_size);
-								dx_free(_temp);
-							}
-							dx_memcpy(buffer + buffer_size, param_buffer, param_buffer_size);
-							buffer_size += param_buffer_size;
-							dx_free(param_buffer);
-						}
-						else {
-							buffer = param_buffer;
-							buffer_size = param_buffer_size;
-							buffer_capacity = param_buffer_size;
-						}
-					}
-				}
-				dx_free(subscr_params.elements);
+		dx_event_subscription_param_list_t subscr_params;
+		size_t param_count = dx_get_event_subscription_params(connection, order_source, eid, subscr_flags, &subscr_params);
+
+		for (size_t j = 0; j < param_count && success; ++j) {
+			const dx_event_subscription_param_t* cur_param = subscr_params.elements + j;
+			dx_message_type_t msg_type;
+			dxf_long_t subscription_time;
+
+			if (!dx_to_subscription_message_type(!unsubscribe, cur_param->subscription_type, &msg_type) ||
+				(msg_type == MESSAGE_HISTORY_ADD_SUBSCRIPTION &&
+				 !dx_create_subscription_time(dscc, cur_param->record_id, time, OUT &subscription_time))) {
+				success = false;
+				break;
 			}
-		}
-		if (buffer != NULL) {
-			if (success) {
-				if (!dx_send_data(connection, buffer, buffer_size)) {
-					success = false;
+
+			for (size_t i = 0; i < symbol_count && success; ++i) {
+				if (dx_string_null_or_empty(symbols[i])) {
+					continue;
 				}
+
+				success = dx_add_subscription_entry(&batch, msg_type, symbols[i], ciphers[i], cur_param->record_id,
+					msg_type == MESSAGE_HISTORY_ADD_SUBSCRIPTION ? &subscription_time : NULL);
 			}
-			dx_free(buffer);
 		}
+
+		dx_free(subscr_params.elements);
 	}
-	return success;
+
+	dx_free(ciphers);
+
+	return dx_end_subscription_batch(&batch, success);
 }
 
 /* -------------------------------------------------------------------------- */
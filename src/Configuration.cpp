@@ -55,6 +55,22 @@ int dx_get_network_heartbeat_timeout(int default_heartbeat_timeout) {
 	return dx::Configuration::getInstance()->getNetworkHeartbeatTimeout(default_heartbeat_timeout);
 }
 
+int dx_get_network_receive_buffer_size(int default_receive_buffer_size) {
+	return dx::Configuration::getInstance()->getNetworkReceiveBufferSize(default_receive_buffer_size);
+}
+
+int dx_get_network_reactor_threads(int default_reactor_threads) {
+	return dx::Configuration::getInstance()->getNetworkReactorThreads(default_reactor_threads);
+}
+
+int dx_get_network_reactor_pin_threads(int default_reactor_pin_threads) {
+	return dx::Configuration::getInstance()->getNetworkReactorPinThreads(default_reactor_pin_threads != 0) ? 1 : 0;
+}
+
+int dx_get_network_subscription_batch_size(int default_subscription_batch_size) {
+	return dx::Configuration::getInstance()->getNetworkSubscriptionBatchSize(default_subscription_batch_size);
+}
+
 dx_log_level_t dx_get_minimum_logging_level(dx_log_level_t default_minimum_logging_level) {
 	return dx::Configuration::getInstance()->getMinimumLoggingLevel(default_minimum_logging_level);
 }
\ No newline at end of file
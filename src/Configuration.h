@@ -38,6 +38,14 @@ int dx_get_network_heartbeat_period(int default_heartbeat_period);
 
 int dx_get_network_heartbeat_timeout(int default_heartbeat_timeout);
 
+int dx_get_network_receive_buffer_size(int default_receive_buffer_size);
+
+int dx_get_network_reactor_threads(int default_reactor_threads);
+
+int dx_get_network_reactor_pin_threads(int default_reactor_pin_threads);
+
+int dx_get_network_subscription_batch_size(int default_subscription_batch_size);
+
 dx_log_level_t dx_get_minimum_logging_level(dx_log_level_t default_minimum_logging_level);
 
 #ifdef __cplusplus
@@ -193,7 +193,11 @@ struct Configuration : std::enable_shared_from_this<Configuration> {
 		std::cerr << "Loaded defaults:\n";
 		std::cerr << "dump = " << std::boolalpha << getDump() << std::endl;
 		std::cerr << "network.heartbeatPeriod = " << getNetworkHeartbeatPeriod() << std::endl;
-		std::cerr << "network.heartbeatTimeout = " << getNetworkHeartbeatTimeout() << std::endl << std::endl;
+		std::cerr << "network.heartbeatTimeout = " << getNetworkHeartbeatTimeout() << std::endl;
+		std::cerr << "network.receiveBufferSize = " << getNetworkReceiveBufferSize() << std::endl;
+		std::cerr << "network.reactorThreads = " << getNetworkReactorThreads() << std::endl;
+		std::cerr << "network.reactorPinThreads = " << getNetworkReactorPinThreads() << std::endl;
+		std::cerr << "network.subscriptionBatchSize = " << getNetworkSubscriptionBatchSize() << std::endl << std::endl;
 	}
 
 	bool loadFromFile(const std::string& fileName) {
@@ -274,6 +278,22 @@ struct Configuration : std::enable_shared_from_this<Configuration> {
 		return getProperty("network", "heartbeatTimeout", defaultValue);
 	}
 
+	int getNetworkReceiveBufferSize(int defaultValue = 256 * 1024) const {
+		return getProperty("network", "receiveBufferSize", defaultValue);
+	}
+
+	int getNetworkReactorThreads(int defaultValue = 0) const {
+		return getProperty("network", "reactorThreads", defaultValue);
+	}
+
+	bool getNetworkReactorPinThreads(bool defaultValue = false) const {
+		return getProperty("network", "reactorPinThreads", defaultValue);
+	}
+
+	int getNetworkSubscriptionBatchSize(int defaultValue = 64 * 1024) const {
+		return getProperty("network", "subscriptionBatchSize", defaultValue);
+	}
+
 	bool getDump(bool defaultValue = false) const { return getProperty("", "dump", defaultValue); }
 
 	dx_log_level_t getMinimumLoggingLevel(dx_log_level_t defaultValue = dx_ll_info) const {
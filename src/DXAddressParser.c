@@ -45,8 +45,8 @@
 #define DX_CODEC_TLS_STATUS false
 #endif
 
-/* To add TLS codec support for framework add 'DXFEED_CODEC_GZIP_ENABLED' string
- * to C/C++ compiller definition.
+/* To add gzip codec support for framework add 'DXFEED_CODEC_GZIP_ENABLED' string
+ * to C/C++ compiller definition. The CMake build defines it when zlib is found.
  */
 #ifdef DXFEED_CODEC_GZIP_ENABLED
 #define DX_CODEC_GZIP_STATUS true
@@ -290,7 +290,7 @@ int dx_millisecond_timestamp (void) {
 #else
 	struct timespec ts;
 	clock_gettime(CLOCK_MONOTONIC, &ts);
-	return (int)(ts.tv_sec * 1000 + ts.tv_sec / 1000000);
+	return (int)(ts.tv_sec * 1000 + ts.tv_nsec / 1000000);
 #endif
 }
 
@@ -516,30 +516,54 @@ void atomic_write_time(time_t volatile * dest, time_t src) {
     }
 }
 
+__int64 dx_atomic_add(__int64 volatile * value, __int64 delta) {
+	return InterlockedExchangeAdd64(value, delta) + delta;
+}
+
+void* dx_atomic_read_ptr(void* volatile* value) {
+	return InterlockedCompareExchangePointer(value, NULL, NULL);
+}
+
+void dx_atomic_write_ptr(void* volatile* dest, void* src) {
+	InterlockedExchangePointer(dest, src);
+}
+
 #else
 
 long long atomic_read(long long* value) {
-	return *value;
+	return __atomic_load_n(value, __ATOMIC_SEQ_CST);
 }
 
 void atomic_write(long long* dest, long long src) {
-	*dest = src;
+	__atomic_store_n(dest, src, __ATOMIC_SEQ_CST);
 }
 
 long atomic_read32(long* value) {
-	return *value;
+	return __atomic_load_n(value, __ATOMIC_SEQ_CST);
 }
 
 void atomic_write32(long* dest, long src) {
-	*dest = src;
+	__atomic_store_n(dest, src, __ATOMIC_SEQ_CST);
 }
 
 time_t atomic_read_time(time_t* value) {
-    return *value;
+    return __atomic_load_n(value, __ATOMIC_SEQ_CST);
 }
 
 void atomic_write_time(time_t* dest, time_t src) {
-    *dest = src;
+    __atomic_store_n(dest, src, __ATOMIC_SEQ_CST);
+}
+
+long long dx_atomic_add(long long* value, long long delta) {
+	return __atomic_add_fetch(value, delta, __ATOMIC_SEQ_CST);
+}
+
+void* dx_atomic_read_ptr(void* volatile* value) {
+	return __atomic_load_n(value, __ATOMIC_SEQ_CST);
+}
+
+void dx_atomic_write_ptr(void* volatile* dest, void* src) {
+	__atomic_store_n(dest, src, __ATOMIC_SEQ_CST);
 }
 
 #endif
@@ -561,6 +561,8 @@ __int32 atomic_read32(__int32 volatile * value);
 void atomic_write32(__int32 volatile * dest, __int32 src);
 time_t atomic_read_time(time_t volatile * value);
 void atomic_write_time(time_t volatile * dest, time_t src);
+/* Returns the new value */
+__int64 dx_atomic_add(__int64 volatile * value, __int64 delta);
 
 #else
 
@@ -570,7 +572,13 @@ long atomic_read32(long* value);
 void atomic_write32(long* dest, long src);
 time_t atomic_read_time(time_t* value);
 void atomic_write_time(time_t* dest, time_t src);
+/* Returns the new value */
+long long dx_atomic_add(long long* value, long long delta);
 
 #endif //_WIN32
 
+/* The pointer publication functions, also with the full memory barrier */
+void* dx_atomic_read_ptr(void* volatile* value);
+void dx_atomic_write_ptr(void* volatile* dest, void* src);
+
 #endif /* DX_ALGORITHMS_H_INCLUDED */
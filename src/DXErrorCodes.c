@@ -184,6 +184,11 @@ dxf_const_string_t dx_get_error_description (dx_error_code_t code) {
 	case dx_csdec_protocol_error: return L"Unexpected token is reached or data is damaged";
 	case dx_csdec_unsupported_version: return L"Current stream version of protocol is not supported";
 
+	/* gzip codec error codes */
+
+	case dx_gzec_data_corrupted: return L"Gzip codec: the compressed data is corrupted";
+	case dx_gzec_stream_error: return L"Gzip codec: internal compression stream error";
+
 	/* miscellaneous error codes */
 
 	default: return L"Invalid error code";
@@ -36,6 +36,7 @@
 #include "DXThreads.h"
 #include "Snapshot.h"
 #include "PriceLevelBook.h"
+#include "RecordTranscoder.h"
 #include "RegionalBook.h"
 #include "Configuration.h"
 
@@ -273,6 +274,7 @@ DXFEED_API ERRORCODE dxf_create_connection_impl (const char *address,
 	}
 
 	ccd.receiver = dx_socket_data_receiver;
+	ccd.buffer_provider = dx_get_socket_data_buffer;
 	ccd.notifier = notifier;
 	ccd.conn_status_notifier = conn_status_notifier;
 	ccd.stcn = stcn;
@@ -469,6 +471,25 @@ DXFEED_API ERRORCODE dxf_create_subscription_timed_with_flags (dxf_connection_t
 	                                    subscription);
 }
 
+DXFEED_API ERRORCODE dxf_create_subscription_with_delivery (dxf_connection_t connection, int event_types,
+                                                            dx_event_subscr_flag subscr_flags,
+                                                            const dxf_delivery_options_t* options,
+                                                            OUT dxf_subscription_t *subscription) {
+	if (dxf_create_subscription_impl(connection, event_types, subscr_flags, DEFAULT_SUBSCRIPTION_TIME, subscription) ==
+	    DXF_FAILURE) {
+		return DXF_FAILURE;
+	}
+
+	if (!dx_set_event_subscription_delivery(*subscription, options)) {
+		dx_close_event_subscription(*subscription);
+		*subscription = dx_invalid_subscription;
+
+		return DXF_FAILURE;
+	}
+
+	return DXF_SUCCESS;
+}
+
 DXFEED_API ERRORCODE dxf_close_subscription (dxf_subscription_t subscription) {
 	return dx_close_subscription(subscription, DX_RESET_ERROR);
 }
@@ -554,9 +575,9 @@ DXFEED_API ERRORCODE dxf_remove_symbol (dxf_subscription_t subscription, dxf_con
 
 /* -------------------------------------------------------------------------- */
 
-DXFEED_API ERRORCODE
-dxf_remove_symbols (dxf_subscription_t subscription, dxf_const_string_t *symbols, int symbol_count) {
-	dx_perform_common_actions(DX_RESET_ERROR);
+ERRORCODE dx_remove_symbols_impl (dxf_subscription_t subscription, dxf_const_string_t *symbols, int symbol_count,
+                                  int resetError) {
+	dx_perform_common_actions(resetError);
 
 	if (subscription == dx_invalid_subscription || symbols == NULL || symbol_count < 0) {
 		dx_set_error_code(dx_ec_invalid_func_param);
@@ -615,6 +636,13 @@ dxf_remove_symbols (dxf_subscription_t subscription, dxf_const_string_t *symbols
 
 /* -------------------------------------------------------------------------- */
 
+DXFEED_API ERRORCODE
+dxf_remove_symbols (dxf_subscription_t subscription, dxf_const_string_t *symbols, int symbol_count) {
+	return dx_remove_symbols_impl(subscription, symbols, symbol_count, DX_RESET_ERROR);
+}
+
+/* -------------------------------------------------------------------------- */
+
 DXFEED_API ERRORCODE dxf_get_symbols (dxf_subscription_t subscription,
                                       OUT dxf_const_string_t **symbols, OUT int *symbol_count) {
 	size_t symbols_size = 0;
@@ -797,6 +825,70 @@ DXFEED_API ERRORCODE dxf_get_subscription_event_types (dxf_subscription_t subscr
 
 /* -------------------------------------------------------------------------- */
 
+DXFEED_API ERRORCODE dxf_get_subscription_delivery_statistics (dxf_subscription_t subscription,
+                                                               OUT dxf_delivery_statistics_t *statistics) {
+	dx_perform_common_actions(DX_RESET_ERROR);
+
+	if (!dx_get_event_subscription_delivery_statistics(subscription, statistics)) {
+		return DXF_FAILURE;
+	}
+
+	return DXF_SUCCESS;
+}
+
+/* -------------------------------------------------------------------------- */
+
+DXFEED_API ERRORCODE dxf_create_event_queue (dxf_subscription_t subscription, const dxf_delivery_options_t* options,
+                                             OUT dxf_event_queue_t* queue) {
+	dx_perform_common_actions(DX_RESET_ERROR);
+
+	if (!dx_create_event_queue(subscription, options, queue)) {
+		return DXF_FAILURE;
+	}
+
+	return DXF_SUCCESS;
+}
+
+/* -------------------------------------------------------------------------- */
+
+DXFEED_API ERRORCODE dxf_poll_events (dxf_event_queue_t queue, OUT dxf_polled_event_t* events, int max_events,
+                                      int timeout, OUT int* event_count) {
+	dx_perform_common_actions(DX_RESET_ERROR);
+
+	if (!dx_poll_events(queue, events, max_events, timeout, event_count)) {
+		return DXF_FAILURE;
+	}
+
+	return DXF_SUCCESS;
+}
+
+/* -------------------------------------------------------------------------- */
+
+DXFEED_API ERRORCODE dxf_get_event_queue_statistics (dxf_event_queue_t queue,
+                                                     OUT dxf_delivery_statistics_t* statistics) {
+	dx_perform_common_actions(DX_RESET_ERROR);
+
+	if (!dx_get_event_queue_statistics(queue, statistics)) {
+		return DXF_FAILURE;
+	}
+
+	return DXF_SUCCESS;
+}
+
+/* -------------------------------------------------------------------------- */
+
+DXFEED_API ERRORCODE dxf_close_event_queue (dxf_event_queue_t queue) {
+	dx_perform_common_actions(DX_RESET_ERROR);
+
+	if (!dx_close_event_queue(queue)) {
+		return DXF_FAILURE;
+	}
+
+	return DXF_SUCCESS;
+}
+
+/* -------------------------------------------------------------------------- */
+
 DXFEED_API ERRORCODE
 dxf_get_last_event (dxf_connection_t connection, int event_type, dxf_const_string_t symbol, OUT
                     dxf_event_data_t *data) {
@@ -821,6 +913,22 @@ dxf_get_last_event (dxf_connection_t connection, int event_type, dxf_const_strin
 
 /* -------------------------------------------------------------------------- */
 
+DXFEED_API ERRORCODE dxf_set_last_event_types (dxf_connection_t connection, int event_types) {
+	dx_perform_common_actions(DX_RESET_ERROR);
+
+	if (!dx_validate_connection_handle(connection, false)) {
+		return DXF_FAILURE;
+	}
+
+	if (!dx_set_last_event_types(connection, event_types)) {
+		return DXF_FAILURE;
+	}
+
+	return DXF_SUCCESS;
+}
+
+/* -------------------------------------------------------------------------- */
+
 DXFEED_API ERRORCODE dxf_get_last_error (OUT int *error_code, OUT dxf_const_string_t *error_descr) {
 	if (error_code == NULL) {
 		dx_set_error_code(dx_ec_invalid_func_param);
@@ -954,41 +1062,84 @@ DXFEED_API ERRORCODE dxf_add_order_source (dxf_subscription_t subscription, cons
 
 /* -------------------------------------------------------------------------- */
 
-ERRORCODE dxf_create_snapshot_impl (dxf_connection_t connection, dx_event_id_t event_id,
-                                    dxf_const_string_t symbol, dxf_const_string_t source,
-                                    dxf_long_t time, OUT dxf_snapshot_t *snapshot) {
-	dxf_subscription_t subscription = NULL;
-	dx_record_info_id_t record_info_id;
-	dxf_const_string_t order_source_value = NULL;
-	ERRORCODE error_code;
-	int event_types = DX_EVENT_BIT_MASK(event_id);
+/* Returns the records, the subscription flags and the order source of the snapshots of the events */
+int dx_get_snapshot_subscription_params (dx_event_id_t event_id, dxf_const_string_t source,
+                                         OUT dx_record_info_id_t *record_info_id,
+                                         OUT dx_event_subscr_flag *subscr_flags,
+                                         OUT dxf_const_string_t *order_source_value) {
 	size_t source_len = (source == NULL ? 0 : dx_string_length(source));
-	dx_event_subscr_flag subscr_flags = dx_esf_time_series;
+
+	*subscr_flags = dx_esf_time_series;
+	*order_source_value = NULL;
 
 	if (event_id == dx_eid_order) {
-		subscr_flags |= dx_esf_single_record;
+		*subscr_flags |= dx_esf_single_record;
 		if (source_len > 0 &&
 		    (dx_compare_strings(source, DXF_ORDER_AGGREGATE_BID_STR) == 0 ||
 		     dx_compare_strings(source, DXF_ORDER_AGGREGATE_ASK_STR) == 0)) {
-			record_info_id = dx_rid_market_maker;
-			subscr_flags |= dx_esf_sr_market_maker_order;
+			*record_info_id = dx_rid_market_maker;
+			*subscr_flags |= dx_esf_sr_market_maker_order;
 		} else {
-			record_info_id = dx_rid_order;
+			*record_info_id = dx_rid_order;
 			if (source_len > 0)
-				order_source_value = source;
+				*order_source_value = source;
 		}
 	} else if (event_id == dx_eid_candle) {
-		record_info_id = dx_rid_candle;
+		*record_info_id = dx_rid_candle;
 	} else if (event_id == dx_eid_spread_order) {
-		record_info_id = dx_rid_spread_order;
+		*record_info_id = dx_rid_spread_order;
 	} else if (event_id == dx_eid_time_and_sale) {
-		record_info_id = dx_rid_time_and_sale;
+		*record_info_id = dx_rid_time_and_sale;
 	} else if (event_id == dx_eid_greeks) {
-		record_info_id = dx_rid_greeks;
+		*record_info_id = dx_rid_greeks;
 	} else if (event_id == dx_eid_series) {
-		record_info_id = dx_rid_series;
+		*record_info_id = dx_rid_series;
 	} else {
-		dx_set_error_code(dx_ssec_invalid_event_id);
+		return dx_set_error_code(dx_ssec_invalid_event_id);
+	}
+
+	return true;
+}
+
+/* -------------------------------------------------------------------------- */
+
+/* Closes the snapshot handle, and its subscription or symbol along with the snapshot if it's the last handle */
+int dx_close_snapshot_handle (dxf_snapshot_t snapshot) {
+	dxf_subscription_t subscription = NULL;
+	dxf_string_t symbol = NULL;
+	int res = dx_close_snapshot(snapshot, &subscription, &symbol);
+
+	if (subscription == dx_invalid_subscription) {
+		return res;
+	}
+
+	if (symbol != NULL) {
+		/* the subscription is shared with the other snapshots created at once */
+		dxf_const_string_t symbols[] = {symbol};
+
+		res = dx_remove_symbols_impl(subscription, symbols, 1, DX_KEEP_ERROR) == DXF_SUCCESS && res;
+		dx_free(symbol);
+
+		return res;
+	}
+
+	return dx_close_subscription(subscription, DX_KEEP_ERROR) == DXF_SUCCESS && res;
+}
+
+/* -------------------------------------------------------------------------- */
+
+ERRORCODE dxf_create_snapshot_impl (dxf_connection_t connection, dx_event_id_t event_id,
+                                    dxf_const_string_t symbol, dxf_const_string_t source,
+                                    dxf_long_t time, OUT dxf_snapshot_t *snapshot) {
+	dxf_subscription_t subscription = NULL;
+	dxf_subscription_t snapshot_subscription = NULL;
+	dx_record_info_id_t record_info_id;
+	dxf_const_string_t order_source_value = NULL;
+	ERRORCODE error_code;
+	int event_types = DX_EVENT_BIT_MASK(event_id);
+	dx_event_subscr_flag subscr_flags;
+
+	if (!dx_get_snapshot_subscription_params(event_id, source, &record_info_id, &subscr_flags, &order_source_value)) {
 		return DXF_FAILURE;
 	}
 
@@ -1004,6 +1155,15 @@ ERRORCODE dxf_create_snapshot_impl (dxf_connection_t connection, dx_event_id_t e
 		return DXF_FAILURE;
 	}
 
+	/* the snapshot open already is shared, it's received once */
+	if (!dx_share_snapshot(connection, event_id, record_info_id, symbol, order_source_value, time, snapshot)) {
+		return DXF_FAILURE;
+	}
+
+	if (*snapshot != dx_invalid_snapshot) {
+		return DXF_SUCCESS;
+	}
+
 	error_code = dxf_create_subscription_impl(connection, event_types, subscr_flags, time, &subscription);
 	if (error_code == DXF_FAILURE)
 		return error_code;
@@ -1020,10 +1180,19 @@ ERRORCODE dxf_create_snapshot_impl (dxf_connection_t connection, dx_event_id_t e
 		return DXF_FAILURE;
 	}
 
+	if (!dx_get_snapshot_subscription(*snapshot, &snapshot_subscription)) {
+		return DXF_FAILURE;
+	}
+
+	if (snapshot_subscription != subscription) {
+		/* the same snapshot has been created by another thread meanwhile */
+		dx_close_subscription(subscription, DX_KEEP_ERROR);
+		return DXF_SUCCESS;
+	}
+
 	error_code = dxf_add_symbol(subscription, symbol);
 	if (error_code == DXF_FAILURE) {
-		dx_close_snapshot(*snapshot);
-		dxf_close_subscription(subscription);
+		dx_close_snapshot_handle(*snapshot);
 		*snapshot = dx_invalid_snapshot;
 		return error_code;
 	}
@@ -1034,6 +1203,108 @@ ERRORCODE dxf_create_snapshot_impl (dxf_connection_t connection, dx_event_id_t e
 
 /* -------------------------------------------------------------------------- */
 
+ERRORCODE dxf_create_snapshots_impl (dxf_connection_t connection, dx_event_id_t event_id,
+                                     dxf_const_string_t *symbols, int symbol_count, dxf_const_string_t source,
+                                     dxf_long_t time, OUT dxf_snapshot_t *snapshots) {
+	dxf_subscription_t subscription = NULL;
+	dx_record_info_id_t record_info_id;
+	dxf_const_string_t order_source_value = NULL;
+	dxf_const_string_t *routed_symbols = NULL;
+	int routed_symbol_count = 0;
+	int new_snapshot_count = 0;
+	int event_types = DX_EVENT_BIT_MASK(event_id);
+	dx_event_subscr_flag subscr_flags;
+	int failed = false;
+	int i = 0;
+
+	if (!dx_get_snapshot_subscription_params(event_id, source, &record_info_id, &subscr_flags, &order_source_value)) {
+		return DXF_FAILURE;
+	}
+
+	dx_perform_common_actions(DX_RESET_ERROR);
+
+	if (symbols == NULL || symbol_count < 0 || snapshots == NULL) {
+		dx_set_error_code(dx_ec_invalid_func_param);
+		return DXF_FAILURE;
+	}
+
+	for (i = 0; i < symbol_count; ++i) {
+		snapshots[i] = dx_invalid_snapshot;
+
+		if (symbols[i] == NULL || dx_string_length(symbols[i]) == 0) {
+			dx_set_error_code(dx_ssec_invalid_symbol);
+			return DXF_FAILURE;
+		}
+	}
+
+	/* the snapshots open already are shared, the others are received with one subscription */
+	for (i = 0; i < symbol_count && !failed; ++i) {
+		failed = !dx_share_snapshot(connection, event_id, record_info_id, symbols[i], order_source_value, time,
+		                            snapshots + i);
+		if (snapshots[i] == dx_invalid_snapshot)
+			new_snapshot_count++;
+	}
+
+	if (!failed && new_snapshot_count > 0) {
+		failed = dxf_create_subscription_impl(connection, event_types, subscr_flags, time, &subscription) ==
+		         DXF_FAILURE;
+	}
+
+	if (!failed && new_snapshot_count > 0) {
+		if (record_info_id == dx_rid_order) {
+			dx_clear_order_source(subscription);
+			if (order_source_value != NULL)
+				dx_add_order_source(subscription, order_source_value);
+		}
+
+		failed = !dx_create_snapshots(connection, subscription, event_id, record_info_id, symbols, symbol_count,
+		                              order_source_value, time, snapshots) ||
+		         (routed_symbols = dx_calloc(new_snapshot_count, sizeof(dxf_const_string_t))) == NULL;
+
+		/* the symbols of the snapshots created by another thread meanwhile aren't subscribed twice */
+		for (i = 0; i < symbol_count && !failed; ++i) {
+			dxf_subscription_t snapshot_subscription = NULL;
+
+			if (dx_get_snapshot_subscription(snapshots[i], &snapshot_subscription) &&
+			    snapshot_subscription == subscription) {
+				routed_symbols[routed_symbol_count++] = symbols[i];
+			}
+		}
+
+		if (!failed && routed_symbol_count > 0) {
+			failed = dxf_add_symbols(subscription, routed_symbols, routed_symbol_count) == DXF_FAILURE;
+		}
+
+		CHECKED_FREE(routed_symbols);
+	}
+
+	/* the subscription is closed along with the last snapshot using it */
+	if (failed) {
+		for (i = 0; i < symbol_count; ++i) {
+			dxf_subscription_t snapshot_subscription = NULL;
+
+			if (snapshots[i] == dx_invalid_snapshot)
+				continue;
+
+			if (dx_get_snapshot_subscription(snapshots[i], &snapshot_subscription) &&
+			    snapshot_subscription == subscription) {
+				routed_symbol_count++;
+			}
+
+			dx_close_snapshot_handle(snapshots[i]);
+			snapshots[i] = dx_invalid_snapshot;
+		}
+	}
+
+	if (subscription != NULL && routed_symbol_count == 0) {
+		dx_close_subscription(subscription, DX_KEEP_ERROR);
+	}
+
+	return failed ? DXF_FAILURE : DXF_SUCCESS;
+}
+
+/* -------------------------------------------------------------------------- */
+
 DXFEED_API ERRORCODE dxf_create_snapshot (dxf_connection_t connection, dx_event_id_t event_id,
                                           dxf_const_string_t symbol, const char *source,
                                           dxf_long_t time, OUT dxf_snapshot_t *snapshot) {
@@ -1048,6 +1319,20 @@ DXFEED_API ERRORCODE dxf_create_snapshot (dxf_connection_t connection, dx_event_
 
 /* -------------------------------------------------------------------------- */
 
+DXFEED_API ERRORCODE dxf_create_snapshots (dxf_connection_t connection, dx_event_id_t event_id,
+                                           dxf_const_string_t *symbols, int symbol_count, const char *source,
+                                           dxf_long_t time, OUT dxf_snapshot_t *snapshots) {
+	dxf_string_t source_str = NULL;
+	ERRORCODE res;
+	if (source != NULL)
+		source_str = dx_ansi_to_unicode(source);
+	res = dxf_create_snapshots_impl(connection, event_id, symbols, symbol_count, source_str, time, snapshots);
+	dx_free(source_str);
+	return res;
+}
+
+/* -------------------------------------------------------------------------- */
+
 DXFEED_API ERRORCODE dxf_create_order_snapshot (dxf_connection_t connection,
                                                 dxf_const_string_t symbol, const char *source,
                                                 dxf_long_t time, OUT dxf_snapshot_t *snapshot) {
@@ -1076,8 +1361,6 @@ DXFEED_API ERRORCODE dxf_create_candle_snapshot (dxf_connection_t connection,
 /* -------------------------------------------------------------------------- */
 
 DXFEED_API ERRORCODE dxf_close_snapshot (dxf_snapshot_t snapshot) {
-	dxf_subscription_t subscription = NULL;
-
 	dx_perform_common_actions(DX_RESET_ERROR);
 
 	if (snapshot == NULL) {
@@ -1085,10 +1368,8 @@ DXFEED_API ERRORCODE dxf_close_snapshot (dxf_snapshot_t snapshot) {
 		return DXF_FAILURE;
 	}
 
-	if (!dx_get_snapshot_subscription(snapshot, &subscription) ||
-	    !dxf_close_subscription(subscription) ||
-	    !dx_close_snapshot(snapshot)) {
-
+	/* the subscription is closed along with the last handle of the snapshot */
+	if (!dx_close_snapshot_handle(snapshot)) {
 		return DXF_FAILURE;
 	}
 
@@ -1171,6 +1452,43 @@ dxf_detach_snapshot_inc_listener (dxf_snapshot_t snapshot, dxf_snapshot_inc_list
 
 /* -------------------------------------------------------------------------- */
 
+DXFEED_API ERRORCODE dxf_set_snapshot_publication_policy (dxf_snapshot_t snapshot,
+                                                          const dxf_snapshot_publication_policy_t* policy) {
+	dx_perform_common_actions(DX_RESET_ERROR);
+
+	if (snapshot == dx_invalid_snapshot || policy == NULL) {
+		dx_set_error_code(dx_ec_invalid_func_param);
+
+		return DXF_FAILURE;
+	}
+
+	if (!dx_set_snapshot_publication_policy(snapshot, policy)) {
+		return DXF_FAILURE;
+	}
+
+	return DXF_SUCCESS;
+}
+
+/* -------------------------------------------------------------------------- */
+
+DXFEED_API ERRORCODE dxf_request_full_snapshot (dxf_snapshot_t snapshot) {
+	dx_perform_common_actions(DX_RESET_ERROR);
+
+	if (snapshot == dx_invalid_snapshot) {
+		dx_set_error_code(dx_ec_invalid_func_param);
+
+		return DXF_FAILURE;
+	}
+
+	if (!dx_request_full_snapshot(snapshot)) {
+		return DXF_FAILURE;
+	}
+
+	return DXF_SUCCESS;
+}
+
+/* -------------------------------------------------------------------------- */
+
 DXFEED_API ERRORCODE dxf_get_snapshot_symbol (dxf_snapshot_t snapshot, OUT dxf_string_t *symbol) {
 	dx_perform_common_actions(DX_RESET_ERROR);
 
@@ -1510,6 +1828,33 @@ DXFEED_API ERRORCODE dxf_get_current_connection_status (dxf_connection_t connect
 	return DXF_SUCCESS;
 }
 
+DXFEED_API ERRORCODE dxf_get_connection_compression_statistics (dxf_connection_t connection,
+																OUT dxf_compression_statistics_t *statistics) {
+	if (!dx_get_compression_statistics(connection, statistics)) {
+		return DXF_FAILURE;
+	}
+
+	return DXF_SUCCESS;
+}
+
+DXFEED_API ERRORCODE dxf_get_connection_transcoding_statistics (dxf_connection_t connection,
+																OUT dxf_transcoding_statistics_t *statistics) {
+	if (!dx_get_transcoding_statistics(connection, statistics)) {
+		return DXF_FAILURE;
+	}
+
+	return DXF_SUCCESS;
+}
+
+DXFEED_API ERRORCODE dxf_set_skipped_record_fields (dxf_connection_t connection, dx_record_info_id_t record_info_id,
+													dxf_const_string_t* field_names, int field_count) {
+	if (!dx_set_skipped_record_fields(connection, record_info_id, field_names, field_count)) {
+		return DXF_FAILURE;
+	}
+
+	return DXF_SUCCESS;
+}
+
 DXFEED_API ERRORCODE dxf_free (void *pointer) {
 	dx_free(pointer);
 	return DXF_SUCCESS;
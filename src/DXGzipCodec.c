@@ -0,0 +1,291 @@
+/*
+ * The contents of this file are subject to the Mozilla Public License Version
+ * 1.1 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ * http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+ * for the specific language governing rights and limitations under the
+ * License.
+ *
+ * The Initial Developer of the Original Code is Devexperts LLC.
+ * Portions created by the Initial Developer are Copyright (C) 2010
+ * the Initial Developer. All Rights Reserved.
+ *
+ * Contributor(s):
+ *
+ */
+
+#include "DXGzipCodec.h"
+
+#ifdef DXFEED_CODEC_GZIP_ENABLED
+
+#include <string.h>
+#include <zlib.h>
+
+#include "DXAlgorithms.h"
+#include "DXErrorHandling.h"
+#include "DXMemory.h"
+#include "DXSockets.h"
+#include "Logger.h"
+
+/* -------------------------------------------------------------------------- */
+/*
+ *	Codec data
+ */
+/* -------------------------------------------------------------------------- */
+
+#define INPUT_BUFFER_SIZE		  65536
+#define INITIAL_OUTPUT_BUFFER_SIZE 4096
+
+/* the gzip header is expected on both streams, 32 also makes the inflater accept the zlib header */
+#define DEFLATE_WINDOW_BITS (MAX_WBITS + 16)
+#define INFLATE_WINDOW_BITS (MAX_WBITS + 32)
+
+#define INFLATER_FIELD_FLAG (1 << 0)
+#define DEFLATER_FIELD_FLAG (1 << 1)
+
+typedef struct {
+	z_stream inflater;
+	z_stream deflater;
+
+	Bytef* input;
+	Bytef* output;
+	int output_capacity;
+
+	int set_fields_flags;
+} dx_gzip_codec_data_t;
+
+/* -------------------------------------------------------------------------- */
+
+static int dx_gzip_codec_check(int zlib_result, const z_stream* stream) {
+	switch (zlib_result) {
+	case Z_OK:
+	case Z_STREAM_END:
+		return true;
+	case Z_MEM_ERROR:
+		return dx_set_error_code(dx_mec_insufficient_memory);
+	case Z_DATA_ERROR:
+		if (stream->msg != NULL) {
+			dxf_string_t w_msg = dx_ansi_to_unicode(stream->msg);
+
+			if (w_msg != NULL) {
+				dx_logging_error(w_msg);
+				dx_free(w_msg);
+			}
+		}
+
+		return dx_set_error_code(dx_gzec_data_corrupted);
+	default:
+		return dx_set_error_code(dx_gzec_stream_error);
+	}
+}
+
+/* -------------------------------------------------------------------------- */
+/*
+ *	Codec lifecycle functions implementation
+ */
+/* -------------------------------------------------------------------------- */
+
+int dx_gzip_codec_create(OUT dx_gzip_codec_t* codec) {
+	dx_gzip_codec_data_t* data = NULL;
+
+	if (codec == NULL) {
+		return dx_set_error_code(dx_ec_invalid_func_param_internal);
+	}
+
+	data = dx_calloc(1, sizeof(dx_gzip_codec_data_t));
+
+	if (data == NULL) {
+		return false;
+	}
+
+	data->input = dx_malloc(INPUT_BUFFER_SIZE);
+	data->output = dx_malloc(INITIAL_OUTPUT_BUFFER_SIZE);
+	data->output_capacity = INITIAL_OUTPUT_BUFFER_SIZE;
+
+	if (data->input == NULL || data->output == NULL) {
+		dx_gzip_codec_destroy(data);
+
+		return false;
+	}
+
+	if (!dx_gzip_codec_check(inflateInit2(&data->inflater, INFLATE_WINDOW_BITS), &data->inflater)) {
+		dx_gzip_codec_destroy(data);
+
+		return false;
+	}
+
+	data->set_fields_flags |= INFLATER_FIELD_FLAG;
+
+	if (!dx_gzip_codec_check(deflateInit2(&data->deflater, Z_DEFAULT_COMPRESSION, Z_DEFLATED, DEFLATE_WINDOW_BITS, 8,
+		Z_DEFAULT_STRATEGY), &data->deflater)) {
+		dx_gzip_codec_destroy(data);
+
+		return false;
+	}
+
+	data->set_fields_flags |= DEFLATER_FIELD_FLAG;
+	*codec = data;
+
+	return true;
+}
+
+/* -------------------------------------------------------------------------- */
+
+void dx_gzip_codec_destroy(dx_gzip_codec_t codec) {
+	dx_gzip_codec_data_t* data = codec;
+
+	if (data == NULL) {
+		return;
+	}
+
+	if (IS_FLAG_SET(data->set_fields_flags, INFLATER_FIELD_FLAG)) {
+		inflateEnd(&data->inflater);
+	}
+
+	if (IS_FLAG_SET(data->set_fields_flags, DEFLATER_FIELD_FLAG)) {
+		deflateEnd(&data->deflater);
+	}
+
+	CHECKED_FREE(data->input);
+	CHECKED_FREE(data->output);
+
+	dx_free(data);
+}
+
+/* -------------------------------------------------------------------------- */
+
+int dx_gzip_codec_reset(dx_gzip_codec_t codec) {
+	dx_gzip_codec_data_t* data = codec;
+
+	data->inflater.next_in = NULL;
+	data->inflater.avail_in = 0;
+
+	return dx_gzip_codec_check(inflateReset(&data->inflater), &data->inflater) &&
+		dx_gzip_codec_check(deflateReset(&data->deflater), &data->deflater);
+}
+
+/* -------------------------------------------------------------------------- */
+/*
+ *	Inflating functions implementation
+ */
+/* -------------------------------------------------------------------------- */
+
+void dx_gzip_codec_get_input_buffer(dx_gzip_codec_t codec, OUT void** buffer, OUT int* buffer_size) {
+	dx_gzip_codec_data_t* data = codec;
+
+	*buffer = data->input;
+	*buffer_size = INPUT_BUFFER_SIZE;
+}
+
+/* -------------------------------------------------------------------------- */
+
+void dx_gzip_codec_set_input(dx_gzip_codec_t codec, int data_size) {
+	dx_gzip_codec_data_t* data = codec;
+
+	data->inflater.next_in = data->input;
+	data->inflater.avail_in = (uInt)data_size;
+}
+
+/* -------------------------------------------------------------------------- */
+
+int dx_gzip_codec_has_pending_input(dx_gzip_codec_t codec) {
+	return ((dx_gzip_codec_data_t*)codec)->inflater.avail_in > 0;
+}
+
+/* -------------------------------------------------------------------------- */
+
+int dx_gzip_codec_inflate(dx_gzip_codec_t codec, OUT void* buffer, int buffer_size) {
+	dx_gzip_codec_data_t* data = codec;
+	z_stream* stream = &data->inflater;
+
+	stream->next_out = (Bytef*)buffer;
+	stream->avail_out = (uInt)buffer_size;
+
+	while (stream->avail_in > 0 && stream->avail_out > 0) {
+		int res = inflate(stream, Z_SYNC_FLUSH);
+
+		if (res == Z_BUF_ERROR) {
+			/* no progress is possible until more input arrives */
+
+			break;
+		}
+
+		if (!dx_gzip_codec_check(res, stream)) {
+			return INVALID_DATA_SIZE;
+		}
+
+		/* the server may start a new gzip member, e.g. after flushing the previous one completely */
+		if (res == Z_STREAM_END && !dx_gzip_codec_check(inflateReset(stream), stream)) {
+			return INVALID_DATA_SIZE;
+		}
+	}
+
+	return buffer_size - (int)stream->avail_out;
+}
+
+/* -------------------------------------------------------------------------- */
+/*
+ *	Deflating functions implementation
+ */
+/* -------------------------------------------------------------------------- */
+
+static int dx_gzip_codec_grow_output(dx_gzip_codec_data_t* data) {
+	int new_capacity = data->output_capacity * 2;
+	Bytef* new_output = dx_malloc(new_capacity);
+
+	if (new_output == NULL) {
+		return false;
+	}
+
+	memcpy(new_output, data->output, data->output_capacity);
+	dx_free(data->output);
+
+	data->output = new_output;
+	data->output_capacity = new_capacity;
+
+	return true;
+}
+
+/* -------------------------------------------------------------------------- */
+
+int dx_gzip_codec_deflate(dx_gzip_codec_t codec, const void* source, int source_size,
+						OUT const void** compressed_data, OUT int* compressed_data_size) {
+	dx_gzip_codec_data_t* data = codec;
+	z_stream* stream = &data->deflater;
+	int compressed_size = 0;
+	int res = Z_OK;
+
+	stream->next_in = (Bytef*)source;
+	stream->avail_in = (uInt)source_size;
+
+	for (;;) {
+		stream->next_out = data->output + compressed_size;
+		stream->avail_out = (uInt)(data->output_capacity - compressed_size);
+
+		res = deflate(stream, Z_SYNC_FLUSH);
+
+		/* no progress means the previous call has filled the buffer with the whole flushed data */
+		if (res != Z_BUF_ERROR) {
+			CHECKED_CALL_2(dx_gzip_codec_check, res, stream);
+		}
+
+		compressed_size = data->output_capacity - (int)stream->avail_out;
+
+		/* the flush is complete when there's some space left in the output buffer */
+		if (res == Z_BUF_ERROR || stream->avail_out > 0) {
+			break;
+		}
+
+		CHECKED_CALL(dx_gzip_codec_grow_output, data);
+	}
+
+	*compressed_data = data->output;
+	*compressed_data_size = compressed_size;
+
+	return true;
+}
+
+#endif	// DXFEED_CODEC_GZIP_ENABLED
@@ -0,0 +1,87 @@
+/*
+ * The contents of this file are subject to the Mozilla Public License Version
+ * 1.1 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ * http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+ * for the specific language governing rights and limitations under the
+ * License.
+ *
+ * The Initial Developer of the Original Code is Devexperts LLC.
+ * Portions created by the Initial Developer are Copyright (C) 2010
+ * the Initial Developer. All Rights Reserved.
+ *
+ * Contributor(s):
+ *
+ */
+
+/*
+ *	The gzip codec inflates the data read from the socket and deflates the data sent to it
+ *  for the connections with the 'gzip+' address prefix.
+ *  The inflating and the deflating sides are independent streams, so the reader may use the former
+ *  while the sender uses the latter under the socket guard.
+ */
+
+#ifndef DX_GZIP_CODEC_H_INCLUDED
+#define DX_GZIP_CODEC_H_INCLUDED
+
+#include "PrimitiveTypes.h"
+
+typedef void* dx_gzip_codec_t;
+
+#ifdef DXFEED_CODEC_GZIP_ENABLED
+
+/* -------------------------------------------------------------------------- */
+/*
+ *	Codec lifecycle functions
+ */
+/* -------------------------------------------------------------------------- */
+
+int dx_gzip_codec_create (OUT dx_gzip_codec_t* codec);
+void dx_gzip_codec_destroy (dx_gzip_codec_t codec);
+
+/* Forgets the state of both streams, must be called for every newly opened socket */
+int dx_gzip_codec_reset (dx_gzip_codec_t codec);
+
+/* -------------------------------------------------------------------------- */
+/*
+ *	Inflating functions
+ */
+/* -------------------------------------------------------------------------- */
+
+/*
+ *	Returns the buffer to read the compressed data into. Must be called only when there is no pending
+ *  input, i.e. the data previously read has been inflated completely.
+ */
+void dx_gzip_codec_get_input_buffer (dx_gzip_codec_t codec, OUT void** buffer, OUT int* buffer_size);
+
+/* Makes the data read into the input buffer available for inflating */
+void dx_gzip_codec_set_input (dx_gzip_codec_t codec, int data_size);
+
+/* Returns true if the compressed data read earlier didn't fit into the output buffer */
+int dx_gzip_codec_has_pending_input (dx_gzip_codec_t codec);
+
+/*
+ *	Inflates the pending input into the buffer. Returns the number of the inflated bytes, which is zero
+ *  if the input doesn't contain a complete deflate block yet, or INVALID_DATA_SIZE on error.
+ */
+int dx_gzip_codec_inflate (dx_gzip_codec_t codec, OUT void* buffer, int buffer_size);
+
+/* -------------------------------------------------------------------------- */
+/*
+ *	Deflating functions
+ */
+/* -------------------------------------------------------------------------- */
+
+/*
+ *	Deflates the data and flushes the stream, so that the receiver is able to inflate everything sent so far.
+ *  The compressed data is stored in the codec buffer that stays valid until the next call.
+ */
+int dx_gzip_codec_deflate (dx_gzip_codec_t codec, const void* data, int data_size,
+						OUT const void** compressed_data, OUT int* compressed_data_size);
+
+#endif	// DXFEED_CODEC_GZIP_ENABLED
+
+#endif /* DX_GZIP_CODEC_H_INCLUDED */
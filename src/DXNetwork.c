@@ -21,6 +21,7 @@
  *	Implementation of the network functions
  */
 
+#include <limits.h>
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -37,7 +38,9 @@
 #include "DXAddressParser.h"
 #include "DXAlgorithms.h"
 #include "DXErrorHandling.h"
+#include "DXGzipCodec.h"
 #include "DXNetwork.h"
+#include "DXReactor.h"
 #include "DXSockets.h"
 #include "DXThreads.h"
 #include "EventSubscription.h"
@@ -123,8 +126,44 @@ typedef struct {
 	int queue_thread_termination_trigger;
 	int reader_thread_state;
 	int queue_thread_state;
+	int is_reader_idle;
 	dx_error_code_t queue_thread_error;
 
+	/* incremented every time a new socket is opened */
+	int socket_generation;
+
+	/* set if the connection is served by the I/O reactor instead of its own threads */
+	int uses_reactor;
+	dx_reactor_registration_t reactor_registration;
+
+	/*
+	 *	the data the non-blocking socket of the reactor mode had no room for, sent by the reactor thread when
+	 *  the socket becomes writable. Guarded by the socket guard
+	 */
+	char* send_queue;
+	int send_queue_size;
+	int send_queue_capacity;
+
+	/* reestablishes the connection served by the reactor, so the blocking calls don't stall the reactor thread */
+	dx_thread_t restorer_thread;
+	/* set by the reactor thread when the restorer thread is started, reset by the restorer thread when it's done */
+	long long is_restoring;
+
+#ifdef DXFEED_CODEC_GZIP_ENABLED
+	dx_gzip_codec_t gzip_codec;
+
+	/* set if the data of the current socket is compressed */
+	int is_gzip_enabled;
+#endif	// DXFEED_CODEC_GZIP_ENABLED
+
+	/* the socket traffic before and after the decompression, updated by the reader */
+	long long received_compressed_bytes;
+	long long received_uncompressed_bytes;
+
+	/* the socket traffic before and after the compression, updated under the socket guard */
+	long long sent_uncompressed_bytes;
+	long long sent_compressed_bytes;
+
 	dx_task_queue_t tq;
 
 	FILE* raw_dump_file;
@@ -150,6 +189,7 @@ static int g_tls_init_guard_initialized = false;
 #define TASK_QUEUE_FIELD_FLAG		(1 << 3)
 #define QUEUE_THREAD_FIELD_FLAG		(1 << 4)
 #define DUMPING_RAW_DATA_FIELD_FLAG (1 << 5)
+#define RESTORER_THREAD_FIELD_FLAG	(1 << 6)
 #define PROPERTIES_BACKUP_FLAG		(1 << 8)
 #define STATUS_GUARD_FLAG			(1 << 16)
 
@@ -210,6 +250,8 @@ DX_CONNECTION_SUBSYS_INIT_PROTO(dx_ccs_network) {
 
 static int dx_close_socket(dx_network_connection_context_t* context);
 
+static int dx_join_connection_restorer(dx_network_connection_context_t* context);
+
 DX_CONNECTION_SUBSYS_DEINIT_PROTO(dx_ccs_network) {
 	int res = true;
 	dx_network_connection_context_t* context = dx_get_subsystem_data(connection, dx_ccs_network, &res);
@@ -218,9 +260,24 @@ DX_CONNECTION_SUBSYS_DEINIT_PROTO(dx_ccs_network) {
 		return dx_on_connection_destroyed() && res;
 	}
 
+	if (context->reactor_registration != NULL) {
+		/* the queued tasks must not wake up the registration after it's freed */
+		res = dx_set_task_queue_wakeup_notifier(context->tq, NULL, NULL) && res;
+		res = dx_reactor_detach(context->reactor_registration) && res;
+		context->reactor_registration = NULL;
+
+		/* the reactor doesn't start the restorer anymore, the running one stops after the current attempt */
+		context->reader_thread_termination_trigger = true;
+
+		res = dx_join_connection_restorer(context) && res;
+		res = dx_close_socket(context) && res;
+		dx_log_debug_message(L"Connection detached from the reactor");
+	}
+
 	if (IS_FLAG_SET(context->set_fields_flags, QUEUE_THREAD_FIELD_FLAG)) {
 		context->queue_thread_termination_trigger = true;
 
+		res = dx_wake_up_task_queue(context->tq) && res;
 		res = dx_wait_for_thread(context->queue_thread, NULL) && res;
 		dx_log_debug_message(L"Queue thread exited");
 	}
@@ -250,6 +307,12 @@ DX_CONNECTION_SUBSYS_CHECK_PROTO(dx_ccs_network) {
 		return true;
 	}
 
+	if (context->reactor_registration != NULL) {
+		return !dx_reactor_is_reactor_thread(context->reactor_registration) &&
+			!(IS_FLAG_SET(context->set_fields_flags, RESTORER_THREAD_FIELD_FLAG) &&
+			  dx_compare_threads(cur_thread, context->restorer_thread));
+	}
+
 	return !dx_compare_threads(cur_thread, context->queue_thread) &&
 		!dx_compare_threads(cur_thread, context->reader_thread);
 }
@@ -436,7 +499,12 @@ int dx_clear_connection_data(dx_network_connection_context_t* context) {
 		success = dx_mutex_destroy(&context->status_guard) && success;
 	}
 
+#ifdef DXFEED_CODEC_GZIP_ENABLED
+	dx_gzip_codec_destroy(context->gzip_codec);
+#endif	// DXFEED_CODEC_GZIP_ENABLED
+
 	CHECKED_FREE(context->address);
+	CHECKED_FREE(context->send_queue);
 
 	dx_protocol_property_clear(context);
 
@@ -470,6 +538,16 @@ static int dx_close_socket(dx_network_connection_context_t* context) {
 	res = dx_close(context->s);
 #endif	// DXFEED_CODEC_TLS_ENABLED
 
+#ifdef DXFEED_CODEC_GZIP_ENABLED
+	if (context->is_gzip_enabled) {
+		dx_logging_verbose_info(L"Gzip codec totals: received %lld bytes inflated to %lld, sent %lld bytes deflated to %lld",
+			context->received_compressed_bytes, context->received_uncompressed_bytes,
+			context->sent_uncompressed_bytes, context->sent_compressed_bytes);
+	}
+#endif	// DXFEED_CODEC_GZIP_ENABLED
+
+	/* the queued data belongs to the closed socket, the reestablished connection starts with the protocol description */
+	context->send_queue_size = 0;
 	context->set_fields_flags &= ~SOCKET_FIELD_FLAG;
 
 	return dx_mutex_unlock(&(context->socket_guard)) && res;
@@ -508,14 +586,79 @@ void dx_notify_conn_termination(dx_network_connection_context_t* context, OUT in
 
 /* -------------------------------------------------------------------------- */
 
+static int dx_get_milliseconds_until(time_t deadline) {
+	const double diff = difftime(deadline, time(NULL));
+
+	if (diff <= 0) {
+		return 0;
+	}
+
+	return diff >= INT_MAX / 1000 ? INT_MAX : (int)(diff * 1000);
+}
+
+/* -------------------------------------------------------------------------- */
+
+#define QUEUE_IDLE_TIMEOUT 100
+#define QUEUE_PENDING_TASKS_TIMEOUT 25
+
+/*
+ *	Sends the heartbeats, checks the server heartbeat timeout and executes the queued tasks.
+ *  Returns the number of milliseconds the caller may sleep until the next step, unless a new task is submitted.
+ */
+static int dx_queue_executor_step(dx_network_connection_context_t* context) {
+	int queue_empty = true;
+	int timeout = 0;
+
+	const time_t last_server_heartbeat = atomic_read_time(&context->last_server_heartbeat);
+	if (last_server_heartbeat != 0 && difftime(time(NULL), last_server_heartbeat) >= context->heartbeat_timeout) {
+		dx_logging_info(L"No messages from server for at least %d seconds. Disconnecting...",
+						context->heartbeat_timeout);
+		dx_close_socket(context);
+		return QUEUE_IDLE_TIMEOUT;
+	}
+	if (difftime(time(NULL), context->next_heartbeat) >= 0) {
+		if (!dx_send_heartbeat(context->connection, true)) {
+			return QUEUE_IDLE_TIMEOUT;
+		}
+		time(&context->next_heartbeat);
+		context->next_heartbeat += context->heartbeat_period;
+	}
+
+	if (!context->reader_thread_state || !context->queue_thread_state) {
+		return QUEUE_IDLE_TIMEOUT;
+	}
+
+	if (!dx_execute_task_queue(context->tq) || !dx_is_queue_empty(context->tq, &queue_empty)) {
+		context->queue_thread_error = dx_get_error_code();
+		context->queue_thread_state = false;
+
+		return 0;
+	}
+
+	/*
+	 *	Sleeping until a new task is submitted or the next heartbeat is due. The tasks that stay in the queue
+	 *  (e.g. the describe protocol timeout countdown) are polled more frequently.
+	 */
+	timeout = dx_get_milliseconds_until(context->next_heartbeat);
+
+	if (last_server_heartbeat != 0) {
+		timeout = MIN(timeout, dx_get_milliseconds_until(last_server_heartbeat + context->heartbeat_timeout));
+	}
+
+	if (!queue_empty) {
+		timeout = MIN(timeout, QUEUE_PENDING_TASKS_TIMEOUT);
+	}
+
+	return timeout;
+}
+
+/* -------------------------------------------------------------------------- */
+
 #if !defined(_WIN32) || defined(USE_PTHREADS)
 void* dx_queue_executor(void* arg) {
 #else
 unsigned dx_queue_executor(void* arg) {
 #endif
-	static const int s_idle_timeout = 100;
-	static const int s_small_timeout = 25;
-
 	dx_network_connection_context_t* context = NULL;
 
 	if (arg == NULL) {
@@ -538,56 +681,16 @@ unsigned dx_queue_executor(void* arg) {
 	time(&context->next_heartbeat);
 
 	for (;;) {
-		int queue_empty = true;
-
-		const time_t last_server_heartbeat = atomic_read_time(&context->last_server_heartbeat);
-		if (last_server_heartbeat != 0 && difftime(time(NULL), last_server_heartbeat) >= context->heartbeat_timeout) {
-			dx_logging_info(L"No messages from server for at least %d seconds. Disconnecting...",
-							context->heartbeat_timeout);
-			dx_close_socket(context);
-			dx_sleep(s_idle_timeout);
-			continue;
-		}
-		if (difftime(time(NULL), context->next_heartbeat) >= 0) {
-			if (!dx_send_heartbeat(context->connection, true)) {
-				dx_sleep(s_idle_timeout);
-				continue;
-			}
-			time(&context->next_heartbeat);
-			context->next_heartbeat += context->heartbeat_period;
-		}
+		const int timeout = dx_queue_executor_step(context);
 
 		if (context->queue_thread_termination_trigger) {
 			break;
 		}
 
-		if (!context->reader_thread_state || !context->queue_thread_state) {
-			dx_sleep(s_idle_timeout);
-
-			continue;
-		}
-
-		if (!dx_is_queue_empty(context->tq, &queue_empty)) {
+		if (!dx_wait_for_task_queue(context->tq, timeout)) {
 			context->queue_thread_error = dx_get_error_code();
 			context->queue_thread_state = false;
-
-			continue;
 		}
-
-		if (queue_empty) {
-			dx_sleep(s_idle_timeout);
-
-			continue;
-		}
-
-		if (!dx_execute_task_queue(context->tq)) {
-			context->queue_thread_error = dx_get_error_code();
-			context->queue_thread_state = false;
-
-			continue;
-		}
-
-		dx_sleep(s_small_timeout);
 	}
 
 	return DX_THREAD_RETVAL_NULL;
@@ -636,7 +739,7 @@ unsigned dx_socket_reader_wrapper(void* arg) {
 #define WAIT_FOR_SUBSCRIPTION_TIMEOUT 1000
 #define WAIT_FOR_SUBSCRIPTION_SLEEP_PERIOD 100
 
-int dx_read_from_file(dx_network_connection_context_t* context, char *read_buf, int *number_of_bytes_read, int *eof) {
+int dx_read_from_file(dx_network_connection_context_t* context, char *read_buf, int read_buf_size, int *number_of_bytes_read, int *eof) {
 	if (*number_of_bytes_read <= 0) {
 		int remaining = WAIT_FOR_SUBSCRIPTION_TIMEOUT;
 
@@ -657,7 +760,7 @@ int dx_read_from_file(dx_network_connection_context_t* context, char *read_buf,
 		}
 	}
 
-	*number_of_bytes_read = (int)fread((void*)read_buf, sizeof(char), READ_CHUNK_SIZE, context->raw_dump_file);
+	*number_of_bytes_read = (int)fread((void*)read_buf, sizeof(char), read_buf_size, context->raw_dump_file);
 
 	if (feof(context->raw_dump_file)) {
 		*eof = true;
@@ -675,11 +778,189 @@ int dx_read_from_file(dx_network_connection_context_t* context, char *read_buf,
 
 int dx_reestablish_connection(dx_network_connection_context_t* context);
 
+/* Notifies about the connection termination, after which the reader is idle until the connection is reestablished */
+static void dx_socket_reader_check_termination(dx_network_connection_context_t* context) {
+	if (context->reader_thread_state && !context->queue_thread_state) {
+		context->reader_thread_state = false;
+		context->queue_thread_state = true;
+
+		dx_set_error_code(context->queue_thread_error);
+	}
+
+	if (!context->reader_thread_state && !context->is_reader_idle) {
+		if (context->uses_reactor) {
+			/* there is no server heartbeat to wait for until the connection is reestablished */
+			atomic_write_time(&context->last_server_heartbeat, 0);
+		}
+
+		dx_notify_conn_termination(context, &context->is_reader_idle);
+	}
+}
+
+/* -------------------------------------------------------------------------- */
+
+/*
+ *	Notifies about the connection termination and reestablishes the connection if needed.
+ *  Returns true if the connection is ready to read the data.
+ */
+static int dx_socket_reader_restore(dx_network_connection_context_t* context) {
+	dx_socket_reader_check_termination(context);
+
+	if (context->is_reader_idle) {
+		if (!dx_reestablish_connection(context)) {
+			/* no waiting is required here, because there is a timeout within 'dx_reestablish_connection' */
+
+			return false;
+		}
+
+		context->reader_thread_state = true;
+		context->is_reader_idle = false;
+
+		if (context->uses_reactor) {
+			atomic_write_time(&context->last_server_heartbeat, time(NULL));
+		}
+
+		dx_wake_up_task_queue(context->tq);
+	}
+
+	return true;
+}
+
+/* -------------------------------------------------------------------------- */
+
+/* Reads the data that is available in the socket, blocks if there's none */
+static int dx_read_socket_data(dx_network_connection_context_t* context, OUT void* read_buf, int read_buf_size) {
+	int number_of_bytes_read = INVALID_DATA_SIZE;
+
+	/* the time of the blocking read start, the reactor only reads the data that has already arrived */
+	if (!context->uses_reactor) {
+		atomic_write_time(&context->last_server_heartbeat, time(NULL));
+	}
+#ifdef DXFEED_CODEC_TLS_ENABLED
+	if (dx_get_current_address(context)->tls.enabled) {
+		number_of_bytes_read = (int)tls_read(context->tls_context, read_buf, read_buf_size);
+		if (number_of_bytes_read == -1) dx_logging_ansi_error(tls_error(context->tls_context));
+	} else {
+		number_of_bytes_read = dx_recv(context->s, read_buf, read_buf_size);
+	}
+#else
+	number_of_bytes_read = dx_recv(context->s, read_buf, read_buf_size);
+#endif	// DXFEED_CODEC_TLS_ENABLED
+	atomic_write_time(&context->last_server_heartbeat, !context->uses_reactor ? 0 : time(NULL));
+
+	if (number_of_bytes_read != INVALID_DATA_SIZE) {
+		atomic_write(&context->received_compressed_bytes, context->received_compressed_bytes + number_of_bytes_read);
+	}
+
+	return number_of_bytes_read;
+}
+
+/* -------------------------------------------------------------------------- */
+
+#ifdef DXFEED_CODEC_GZIP_ENABLED
+/*
+ *	Inflates the socket data into the buffer. The socket is read only when the data read earlier has been
+ *  inflated completely, so zero is returned if the data read doesn't contain a complete deflate block yet.
+ */
+static int dx_read_compressed_socket_data(dx_network_connection_context_t* context, OUT void* read_buf,
+										int read_buf_size) {
+	if (!dx_gzip_codec_has_pending_input(context->gzip_codec)) {
+		void* input_buf = NULL;
+		int input_buf_size = 0;
+		int number_of_bytes_read = 0;
+
+		dx_gzip_codec_get_input_buffer(context->gzip_codec, &input_buf, &input_buf_size);
+
+		number_of_bytes_read = dx_read_socket_data(context, input_buf, input_buf_size);
+
+		if (number_of_bytes_read == INVALID_DATA_SIZE) {
+			return INVALID_DATA_SIZE;
+		}
+
+		dx_gzip_codec_set_input(context->gzip_codec, number_of_bytes_read);
+	}
+
+	return dx_gzip_codec_inflate(context->gzip_codec, read_buf, read_buf_size);
+}
+#endif	// DXFEED_CODEC_GZIP_ENABLED
+
+/* -------------------------------------------------------------------------- */
+
+/* Returns true if the data read from the socket earlier hasn't been passed to the receiver completely */
+static int dx_has_pending_socket_data(dx_network_connection_context_t* context) {
+#ifdef DXFEED_CODEC_GZIP_ENABLED
+	return context->is_gzip_enabled && dx_gzip_codec_has_pending_input(context->gzip_codec);
+#else
+	return false;
+#endif	// DXFEED_CODEC_GZIP_ENABLED
+}
+
+/* -------------------------------------------------------------------------- */
+
+/*
+ *	Reads the next portion of the data and passes it to the receiver. Blocks until the data is available, except
+ *  for the non-blocking socket of the reactor mode, which is read only when it's readable or there's pending socket data.
+ */
+static void dx_socket_reader_read(dx_network_connection_context_t* context, int* number_of_bytes_read, int* eof) {
+	dx_connection_context_data_t* context_data = &(context->context_data);
+	char local_read_buf[READ_CHUNK_SIZE];
+	char* read_buf = local_read_buf;
+	int read_buf_size = READ_CHUNK_SIZE;
+
+	if (context_data->buffer_provider != NULL &&
+		!context_data->buffer_provider(context->connection, (void**)&read_buf, &read_buf_size)) {
+		context->reader_thread_state = false;
+
+		return;
+	}
+
+	if (IS_FLAG_SET(context->set_fields_flags, DUMPING_RAW_DATA_FIELD_FLAG)) {
+		dx_read_from_file(context, read_buf, read_buf_size, number_of_bytes_read, eof);
+	} else {
+#ifdef DXFEED_CODEC_GZIP_ENABLED
+		if (context->is_gzip_enabled) {
+			*number_of_bytes_read = dx_read_compressed_socket_data(context, (void*)read_buf, read_buf_size);
+		} else {
+			*number_of_bytes_read = dx_read_socket_data(context, (void*)read_buf, read_buf_size);
+		}
+#else
+		*number_of_bytes_read = dx_read_socket_data(context, (void*)read_buf, read_buf_size);
+#endif	// DXFEED_CODEC_GZIP_ENABLED
+
+		if (*number_of_bytes_read == 0) {
+			/* the compressed data is incomplete or the non-blocking socket has no data, there's nothing to report yet */
+
+			return;
+		}
+
+		if (*number_of_bytes_read != INVALID_DATA_SIZE) {
+			atomic_write(&context->received_uncompressed_bytes,
+				context->received_uncompressed_bytes + *number_of_bytes_read);
+		}
+	}
+
+	if (*number_of_bytes_read == INVALID_DATA_SIZE) {
+		context->reader_thread_state = false;
+
+		return;
+	}
+
+	/* reporting the read data */
+	context->reader_thread_state =
+		context_data->receiver(context->connection, (const void*)read_buf, *number_of_bytes_read);
+
+	if (IS_FLAG_SET(context->set_fields_flags, DUMPING_RAW_DATA_FIELD_FLAG) && *eof) {
+		*number_of_bytes_read = INVALID_DATA_SIZE;
+		context->set_fields_flags |= READER_THREAD_FIELD_FLAG;
+		dx_notify_conn_termination(context, &context->is_reader_idle);
+		context->reader_thread_termination_trigger = true;
+	}
+}
+
+/* -------------------------------------------------------------------------- */
+
 void dx_socket_reader(dx_network_connection_context_t* context) {
 	dx_connection_context_data_t* context_data = NULL;
-	int is_thread_idle = false;
-
-	char read_buf[READ_CHUNK_SIZE];
 	int number_of_bytes_read = 0;
 	int eof = 0;
 
@@ -708,62 +989,255 @@ void dx_socket_reader(dx_network_connection_context_t* context) {
 			break;
 		}
 
-		if (context->reader_thread_state && !context->queue_thread_state) {
-			context->reader_thread_state = false;
-			context->queue_thread_state = true;
-
-			dx_set_error_code(context->queue_thread_error);
+		if (!dx_socket_reader_restore(context)) {
+			continue;
 		}
 
-		if (!context->reader_thread_state && !is_thread_idle) {
-			dx_notify_conn_termination(context, &is_thread_idle);
-		}
+		dx_socket_reader_read(context, &number_of_bytes_read, &eof);
+	}
+}
+
+/* -------------------------------------------------------------------------- */
+/*
+ *	Reactor mode handler
+ */
+/* -------------------------------------------------------------------------- */
+
+static dx_socket_t dx_reactor_get_connection_socket(void* data, OUT int* generation) {
+	dx_network_connection_context_t* context = data;
 
-		if (is_thread_idle) {
+	*generation = context->socket_generation;
+
+	/* the socket being opened by the restorer thread is registered when the restoration is complete */
+	if (atomic_read(&context->is_restoring)) {
+		return INVALID_SOCKET;
+	}
+
+	return IS_FLAG_SET(context->set_fields_flags, SOCKET_FIELD_FLAG) ? context->s : INVALID_SOCKET;
+}
+
+/* -------------------------------------------------------------------------- */
+
+#if !defined(_WIN32) || defined(USE_PTHREADS)
+static void* dx_connection_restorer(void* arg) {
+#else
+static unsigned dx_connection_restorer(void* arg) {
+#endif
+	dx_network_connection_context_t* context = (dx_network_connection_context_t*)arg;
+
+	if (dx_init_error_subsystem()) {
+		while (!context->reader_thread_termination_trigger) {
+			/* no waiting is required here, because there is a timeout within 'dx_reestablish_connection' */
 			if (dx_reestablish_connection(context)) {
 				context->reader_thread_state = true;
-				is_thread_idle = false;
-			} else {
-				/* no waiting is required here, because there is a timeout within 'dx_reestablish_connection' */
+				context->is_reader_idle = false;
+				atomic_write_time(&context->last_server_heartbeat, time(NULL));
 
-				continue;
+				break;
 			}
 		}
+	}
 
-		if (IS_FLAG_SET(context->set_fields_flags, DUMPING_RAW_DATA_FIELD_FLAG)) {
-			dx_read_from_file(context, read_buf, &number_of_bytes_read, &eof);
-		} else {
-			atomic_write_time(&context->last_server_heartbeat, time(NULL));
-#ifdef DXFEED_CODEC_TLS_ENABLED
-			if (dx_get_current_address(context)->tls.enabled) {
-				number_of_bytes_read = (int)tls_read(context->tls_context, (void*)read_buf, READ_CHUNK_SIZE);
-				if (number_of_bytes_read == -1) dx_logging_ansi_error(tls_error(context->tls_context));
-			} else {
-				number_of_bytes_read = dx_recv(context->s, (void*)read_buf, READ_CHUNK_SIZE);
-			}
-#else
-			number_of_bytes_read = dx_recv(context->s, (void*)read_buf, READ_CHUNK_SIZE);
-#endif	// DXFEED_CODEC_TLS_ENABLED
-			atomic_write_time(&context->last_server_heartbeat, 0);
+	atomic_write(&context->is_restoring, false);
+
+	/* waking up the reactor thread to register the new socket */
+	dx_wake_up_task_queue(context->tq);
+
+	return DX_THREAD_RETVAL_NULL;
+}
+
+/* -------------------------------------------------------------------------- */
+
+/* Waits for the restorer thread that is done or told to terminate */
+static int dx_join_connection_restorer(dx_network_connection_context_t* context) {
+	int res = true;
+
+	if (!IS_FLAG_SET(context->set_fields_flags, RESTORER_THREAD_FIELD_FLAG)) {
+		return true;
+	}
+
+	res = dx_wait_for_thread(context->restorer_thread, NULL) && res;
+	res = dx_close_thread_handle(context->restorer_thread) && res;
+
+	context->set_fields_flags &= ~RESTORER_THREAD_FIELD_FLAG;
+
+	return res;
+}
+
+/* -------------------------------------------------------------------------- */
+
+/*
+ *	Starts reestablishing the connection on the restorer thread. Returns false if the thread can't be started,
+ *  then the connection is reestablished on the reactor thread.
+ */
+static int dx_start_connection_restorer(dx_network_connection_context_t* context) {
+	/* the previous restorer thread has reset the flag and is about to exit */
+	CHECKED_CALL(dx_join_connection_restorer, context);
+
+	atomic_write(&context->is_restoring, true);
+
+	if (!dx_thread_create(&(context->restorer_thread), NULL, dx_connection_restorer, context)) {
+		atomic_write(&context->is_restoring, false);
+
+		return false;
+	}
+
+	context->set_fields_flags |= RESTORER_THREAD_FIELD_FLAG;
+
+	return true;
+}
+
+/* -------------------------------------------------------------------------- */
+
+static int dx_reactor_process_connection_io(void* data, int readable) {
+	dx_network_connection_context_t* context = data;
+	const int socket_generation = context->socket_generation;
+	int number_of_bytes_read = 0;
+	int eof = false;
+
+	if (atomic_read(&context->is_restoring)) {
+		/* the restorer thread wakes the reactor up when it's done */
+		return false;
+	}
+
+	if (context->reader_thread_state && !IS_FLAG_SET(context->set_fields_flags, SOCKET_FIELD_FLAG)) {
+		/* the socket has been closed, e.g. on the server heartbeat timeout */
+		context->reader_thread_state = false;
+	}
+
+	dx_socket_reader_check_termination(context);
+
+	if (context->is_reader_idle) {
+		if (dx_start_connection_restorer(context)) {
+			return false;
 		}
 
-		if (number_of_bytes_read == INVALID_DATA_SIZE) {
-			context->reader_thread_state = false;
+		dx_logging_last_error();
 
-			continue;
+		if (!dx_socket_reader_restore(context)) {
+			return true;
+		}
+	}
+
+	/* the readiness reported for the previous socket doesn't apply to a reestablished connection */
+	if ((readable && socket_generation == context->socket_generation) || dx_has_pending_socket_data(context)) {
+		dx_socket_reader_read(context, &number_of_bytes_read, &eof);
+	}
+
+	return !context->reader_thread_state || dx_has_pending_socket_data(context);
+}
+
+/* -------------------------------------------------------------------------- */
+
+static int dx_reactor_process_connection_output(void* data) {
+	dx_network_connection_context_t* context = data;
+	int sent_count = 0;
+	int has_queued_data = false;
+
+	if (!dx_mutex_lock(&(context->socket_guard))) {
+		dx_logging_last_error();
+
+		return false;
+	}
+
+	if (context->send_queue_size > 0 && IS_FLAG_SET(context->set_fields_flags, SOCKET_FIELD_FLAG)) {
+		sent_count = dx_send(context->s, context->send_queue, context->send_queue_size);
+
+		if (sent_count == INVALID_DATA_SIZE) {
+			/* the broken socket is detected by the reader and the connection is reestablished */
+			dx_logging_last_error();
+
+			context->send_queue_size = 0;
+		} else if (sent_count > 0) {
+			dx_logging_send_data(context->send_queue, sent_count);
+
+			context->send_queue_size -= sent_count;
+			dx_memmove(context->send_queue, context->send_queue + sent_count, context->send_queue_size);
 		}
+	}
+
+	has_queued_data = context->send_queue_size > 0;
 
-		/* reporting the read data */
-		context->reader_thread_state =
-			context_data->receiver(context->connection, (const void*)read_buf, number_of_bytes_read);
+	dx_mutex_unlock(&(context->socket_guard));
 
-		if (IS_FLAG_SET(context->set_fields_flags, DUMPING_RAW_DATA_FIELD_FLAG) && eof) {
-			number_of_bytes_read = INVALID_DATA_SIZE;
-			context->set_fields_flags |= READER_THREAD_FIELD_FLAG;
-			dx_notify_conn_termination(context, &is_thread_idle);
-			context->reader_thread_termination_trigger = true;
+	return has_queued_data;
+}
+
+/* -------------------------------------------------------------------------- */
+
+static int dx_reactor_process_connection_timer(void* data) {
+	return dx_queue_executor_step((dx_network_connection_context_t*)data);
+}
+
+/* -------------------------------------------------------------------------- */
+
+static int dx_reactor_on_connection_attached(void* data) {
+	dx_network_connection_context_t* context = data;
+	dx_connection_context_data_t* context_data = &(context->context_data);
+
+	if (context_data->stcn != NULL && context_data->stcn(context->connection, context_data->notifier_user_data) == 0) {
+		/* zero return value means fatal client side error */
+
+		return false;
+	}
+
+	time(&context->next_heartbeat);
+	atomic_write_time(&context->last_server_heartbeat, time(NULL));
+
+	/* see the comment in 'dx_socket_reader' */
+	context->reader_thread_state = true;
+
+	return true;
+}
+
+/* -------------------------------------------------------------------------- */
+
+static void dx_reactor_on_connection_detached(void* data) {
+	dx_network_connection_context_t* context = data;
+	dx_connection_context_data_t* context_data = &(context->context_data);
+
+	if (context_data->stdn != NULL) {
+		context_data->stdn(context->connection, context_data->notifier_user_data);
+	}
+}
+
+/* -------------------------------------------------------------------------- */
+
+static int dx_can_use_reactor(dx_network_connection_context_t* context) {
+	size_t i = 0;
+
+	if (!dx_reactor_is_enabled() || IS_FLAG_SET(context->set_fields_flags, DUMPING_RAW_DATA_FIELD_FLAG)) {
+		return false;
+	}
+
+	/* the TLS reads may block until the whole record arrives, so such connections keep their own threads */
+	for (; i < context->addr_context.size; ++i) {
+		if (context->addr_context.elements[i].tls.enabled) {
+			return false;
 		}
 	}
+
+	return true;
+}
+
+/* -------------------------------------------------------------------------- */
+
+static int dx_attach_to_reactor(dx_network_connection_context_t* context) {
+	dx_reactor_handler_t handler;
+
+	handler.data = context;
+	handler.get_socket = dx_reactor_get_connection_socket;
+	handler.process_io = dx_reactor_process_connection_io;
+	handler.process_output = dx_reactor_process_connection_output;
+	handler.process_timer = dx_reactor_process_connection_timer;
+	handler.on_attach = dx_reactor_on_connection_attached;
+	handler.on_detach = dx_reactor_on_connection_detached;
+
+	CHECKED_CALL_2(dx_reactor_attach, &handler, &(context->reactor_registration));
+
+	dx_set_task_queue_wakeup_notifier(context->tq, dx_reactor_wake_up, context->reactor_registration);
+
+	return true;
 }
 
 /* -------------------------------------------------------------------------- */
@@ -1038,6 +1512,29 @@ static int dx_connect_via_tls(dx_network_connection_context_t* context, dx_ext_a
 
 /* -------------------------------------------------------------------------- */
 
+#ifdef DXFEED_CODEC_GZIP_ENABLED
+/* Prepares the codec for the socket that is about to be opened to the address */
+static int dx_setup_gzip_codec(dx_network_connection_context_t* context, const dx_ext_address_t* address) {
+	context->is_gzip_enabled = false;
+
+	if (!address->gzip.enabled) {
+		return true;
+	}
+
+	if (context->gzip_codec == NULL) {
+		CHECKED_CALL(dx_gzip_codec_create, &(context->gzip_codec));
+	}
+
+	CHECKED_CALL(dx_gzip_codec_reset, context->gzip_codec);
+
+	context->is_gzip_enabled = true;
+
+	return true;
+}
+
+/* -------------------------------------------------------------------------- */
+#endif	// DXFEED_CODEC_GZIP_ENABLED
+
 int dx_connect_to_resolved_addresses(dx_network_connection_context_t* context) {
 	dx_address_resolution_context_t* ctx = &(context->addr_context);
 
@@ -1082,6 +1579,13 @@ int dx_connect_to_resolved_addresses(dx_network_connection_context_t* context) {
 			}
 		}
 
+#ifdef DXFEED_CODEC_GZIP_ENABLED
+		if (!dx_setup_gzip_codec(context, cur_addr)) {
+			dx_mutex_unlock(&(context->socket_guard));
+			return false;
+		}
+#endif	// DXFEED_CODEC_GZIP_ENABLED
+
 #ifdef DXFEED_CODEC_TLS_ENABLED
 		if (cur_addr->tls.enabled) {
 			if (dx_connect_via_tls(context, cur_addr)) break;
@@ -1101,7 +1605,16 @@ int dx_connect_to_resolved_addresses(dx_network_connection_context_t* context) {
 		return dx_set_error_code(dx_nec_open_connection_error);
 	}
 
+	/* the reactor thread must never block on the socket, the data that doesn't fit is queued by 'dx_send_data' */
+	if (context->uses_reactor && !dx_set_socket_nonblocking(context->s)) {
+		dx_close(context->s);
+		dx_mutex_unlock(&(context->socket_guard));
+
+		return false;
+	}
+
 	context->set_fields_flags |= SOCKET_FIELD_FLAG;
+	++context->socket_generation;
 
 	return dx_mutex_unlock(&(context->socket_guard));
 }
@@ -1185,8 +1698,14 @@ int dx_bind_to_address(dxf_connection_t connection, const char* address, const d
 
 	context->set_fields_flags |= MUTEX_FIELD_FLAG;
 
-	if ((context->address = dx_ansi_create_string_src(address)) == NULL || !dx_resolve_address(context) ||
-		!dx_connect_to_resolved_addresses(context)) {
+	if ((context->address = dx_ansi_create_string_src(address)) == NULL || !dx_resolve_address(context)) {
+		return false;
+	}
+
+	/* the mode is known before the socket is opened, because the reactor mode sockets are non-blocking */
+	context->uses_reactor = dx_can_use_reactor(context);
+
+	if (!dx_connect_to_resolved_addresses(context)) {
 		return false;
 	}
 
@@ -1200,6 +1719,10 @@ int dx_bind_to_address(dxf_connection_t connection, const char* address, const d
 	key is created before any secondary thread is created. */
 	CHECKED_CALL_0(dx_init_error_subsystem);
 
+	if (context->uses_reactor) {
+		return dx_attach_to_reactor(context);
+	}
+
 	if (!dx_thread_create(&(context->queue_thread), NULL, dx_queue_executor, context)) {
 		return false;
 	}
@@ -1219,6 +1742,60 @@ int dx_bind_to_address(dxf_connection_t connection, const char* address, const d
 
 /* -------------------------------------------------------------------------- */
 
+/* Appends the data to the send queue of the reactor mode connection, must be called under the socket guard */
+static int dx_enqueue_send_data(dx_network_connection_context_t* context, const char* data, int data_size) {
+	if (context->send_queue_size + data_size > context->send_queue_capacity) {
+		const int capacity = MAX(context->send_queue_capacity * 2, context->send_queue_size + data_size);
+		char* send_queue = dx_malloc(capacity);
+
+		if (send_queue == NULL) {
+			return false;
+		}
+
+		if (context->send_queue_size > 0) {
+			dx_memcpy(send_queue, context->send_queue, context->send_queue_size);
+		}
+
+		CHECKED_FREE(context->send_queue);
+		context->send_queue = send_queue;
+		context->send_queue_capacity = capacity;
+	}
+
+	dx_memcpy(context->send_queue + context->send_queue_size, data, data_size);
+	context->send_queue_size += data_size;
+
+	dx_reactor_request_output(context->reactor_registration);
+
+	return true;
+}
+
+/* -------------------------------------------------------------------------- */
+
+/*
+ *	Sends the data to the non-blocking socket of the reactor mode, must be called under the socket guard.
+ *  The socket takes as much data as fits into its send buffer, the rest is queued and sent by the reactor thread
+ *  when the socket becomes writable. Nothing is sent directly while the queue isn't empty, to keep the data in order.
+ */
+static int dx_send_reactor_data(dx_network_connection_context_t* context, const char* data, int data_size) {
+	int sent_count = 0;
+
+	if (context->send_queue_size == 0) {
+		sent_count = dx_send(context->s, (const void*)data, data_size);
+
+		if (sent_count == INVALID_DATA_SIZE) {
+			return false;
+		}
+
+		if (sent_count > 0) {
+			dx_logging_send_data(data, sent_count);
+		}
+	}
+
+	return sent_count == data_size || dx_enqueue_send_data(context, data + sent_count, data_size - sent_count);
+}
+
+/* -------------------------------------------------------------------------- */
+
 int dx_send_data(dxf_connection_t connection, const void* buffer, int buffer_size) {
 	dx_network_connection_context_t* context = NULL;
 	const char* char_buf = (const char*)buffer;
@@ -1247,6 +1824,30 @@ int dx_send_data(dxf_connection_t connection, const void* buffer, int buffer_siz
 		return dx_set_error_code(dx_nec_connection_closed);
 	}
 
+	atomic_write(&context->sent_uncompressed_bytes, context->sent_uncompressed_bytes + buffer_size);
+
+#ifdef DXFEED_CODEC_GZIP_ENABLED
+	if (context->is_gzip_enabled && !IS_FLAG_SET(context->set_fields_flags, DUMPING_RAW_DATA_FIELD_FLAG)) {
+		const void* compressed_buf = NULL;
+
+		if (!dx_gzip_codec_deflate(context->gzip_codec, buffer, buffer_size, &compressed_buf, &buffer_size)) {
+			dx_mutex_unlock(&(context->socket_guard));
+
+			return false;
+		}
+
+		char_buf = (const char*)compressed_buf;
+	}
+#endif	// DXFEED_CODEC_GZIP_ENABLED
+
+	atomic_write(&context->sent_compressed_bytes, context->sent_compressed_bytes + buffer_size);
+
+	if (context->uses_reactor) {
+		res = dx_send_reactor_data(context, char_buf, buffer_size);
+
+		return dx_mutex_unlock(&(context->socket_guard)) && res;
+	}
+
 	do {
 		int sent_count = INVALID_DATA_SIZE;
 		if (IS_FLAG_SET(context->set_fields_flags, DUMPING_RAW_DATA_FIELD_FLAG)) {
@@ -1311,6 +1912,25 @@ int dx_add_worker_thread_task(dxf_connection_t connection, dx_task_processor_t p
 	return dx_add_task_to_queue(context->tq, processor, data);
 }
 
+/* -------------------------------------------------------------------------- */
+
+int dx_wake_up_worker_thread(dxf_connection_t connection) {
+	dx_network_connection_context_t* context = NULL;
+	int res = true;
+
+	context = dx_get_subsystem_data(connection, dx_ccs_network, &res);
+
+	if (context == NULL) {
+		if (res) {
+			dx_set_error_code(dx_cec_connection_context_not_initialized);
+		}
+
+		return false;
+	}
+
+	return dx_wake_up_task_queue(context->tq);
+}
+
 /* -------------------------------------------------------------------------- */
 /*
  *	Connection status functions
@@ -1645,6 +2265,34 @@ int dx_get_current_connected_address(dxf_connection_t connection, OUT char** ppA
 	return true;
 }
 
+int dx_get_compression_statistics(dxf_connection_t connection, OUT dxf_compression_statistics_t* statistics) {
+	int res = true;
+	dx_network_connection_context_t* context = NULL;
+
+	if (statistics == NULL) {
+		return dx_set_error_code(dx_ec_invalid_func_param);
+	}
+
+	context = dx_get_subsystem_data(connection, dx_ccs_network, &res);
+
+	if (context == NULL) {
+		if (res) {
+			dx_set_error_code(dx_cec_connection_context_not_initialized);
+		}
+
+		return false;
+	}
+
+	statistics->received_compressed_bytes = (dxf_ulong_t)atomic_read(&context->received_compressed_bytes);
+	statistics->received_uncompressed_bytes = (dxf_ulong_t)atomic_read(&context->received_uncompressed_bytes);
+	statistics->sent_uncompressed_bytes = (dxf_ulong_t)atomic_read(&context->sent_uncompressed_bytes);
+	statistics->sent_compressed_bytes = (dxf_ulong_t)atomic_read(&context->sent_compressed_bytes);
+
+	return true;
+}
+
+/* -------------------------------------------------------------------------- */
+
 dx_connection_context_data_t* dx_get_connection_context_data(dxf_connection_t connection) {
 	int res = true;
 
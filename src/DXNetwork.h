@@ -40,9 +40,11 @@
 /* -------------------------------------------------------------------------- */
 
 typedef int (*dx_socket_data_receiver_t) (dxf_connection_t connection, const void* buffer, int buffer_size);
+typedef int (*dx_socket_buffer_provider_t) (dxf_connection_t connection, OUT void** buffer, OUT int* buffer_size);
 
 typedef struct dx_connection_context_data_t {
 	dx_socket_data_receiver_t receiver; /* a callback to pass the read data to */
+	dx_socket_buffer_provider_t buffer_provider; /* an optional callback that provides the buffer the data is read directly into */
 	dxf_conn_termination_notifier_t notifier; /* a callback to notify client the current connection is to be finished and reestablished */
 	dxf_conn_status_notifier_t conn_status_notifier; /* the callback to inform the client side that the connection status has changed */
 	dxf_socket_thread_creation_notifier_t stcn; /* a callback that's called on a socket thread creation */
@@ -67,7 +69,9 @@ typedef struct dx_connection_context_data_t {
 			be a computer name or a domain name or an IP address string,
 			and <port> is a text representation of a port number.
 		ccd - a pointer to the connection context data structure, which must have
-			a 'receiver' field assigned a non-NULL value.
+			a 'receiver' field assigned a non-NULL value. If the 'buffer_provider' field
+			is not NULL, the socket data is read directly into the buffer it returns and
+			then this very buffer is passed to the 'receiver'.
 
 	Return value:
 		true - the connection has been successfully bound to the host.
@@ -113,6 +117,15 @@ int dx_send_data (dxf_connection_t connection, const void* buffer, int buffer_si
 
 int dx_add_worker_thread_task (dxf_connection_t connection, dx_task_processor_t processor, void* data);
 
+/* -------------------------------------------------------------------------- */
+/*
+ *	Makes the worker thread re-run the pending tasks without waiting for the next task to be submitted.
+ *  Used when a task that blocks the queue may have become ready, e.g. on the describe protocol receipt.
+ */
+/* -------------------------------------------------------------------------- */
+
+int dx_wake_up_worker_thread (dxf_connection_t connection);
+
 /* -------------------------------------------------------------------------- */
 /*
  *	Connection status functions
@@ -147,6 +160,9 @@ int dx_protocol_configure_custom_auth(dxf_connection_t connection,
 
 int dx_get_current_connected_address(dxf_connection_t connection, OUT char** ppAddress);
 
+/* The counters are cumulative for all the sockets of the connection, they're equal for the uncompressed sockets */
+int dx_get_compression_statistics(dxf_connection_t connection, OUT dxf_compression_statistics_t* statistics);
+
 dx_connection_context_data_t* dx_get_connection_context_data(dxf_connection_t connection);
 
 int dx_set_on_server_heartbeat_notifier(dxf_connection_t connection, dxf_conn_on_server_heartbeat_notifier_t notifier,
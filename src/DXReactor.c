@@ -0,0 +1,800 @@
+/*
+ * The contents of this file are subject to the Mozilla Public License Version
+ * 1.1 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ * http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+ * for the specific language governing rights and limitations under the
+ * License.
+ *
+ * The Initial Developer of the Original Code is Devexperts LLC.
+ * Portions created by the Initial Developer are Copyright (C) 2010
+ * the Initial Developer. All Rights Reserved.
+ *
+ * Contributor(s):
+ *
+ */
+
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+/* for the thread affinity functions */
+#	define _GNU_SOURCE
+#endif
+
+#include "DXReactor.h"
+#include "Configuration.h"
+#include "DXAlgorithms.h"
+#include "DXErrorHandling.h"
+#include "DXMemory.h"
+#include "DXThreads.h"
+#include "Logger.h"
+
+#if defined(__linux__)
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdint.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <time.h>
+
+/* -------------------------------------------------------------------------- */
+/*
+ *	Reactor data
+ */
+/* -------------------------------------------------------------------------- */
+
+#define MAX_EPOLL_EVENTS 64
+#define MAX_IDLE_TIMEOUT 1000
+#define DETACH_WAIT_TIMEOUT 100
+
+struct dx_reactor_tag;
+
+typedef struct {
+	dx_reactor_handler_t handler;
+	struct dx_reactor_tag* reactor;
+
+	/* the fields below are accessed by the reactor thread only */
+	dx_socket_t registered_socket;
+	int registered_generation;
+	unsigned registered_events;
+	int readable;
+	int writable;
+	int output_pending;
+	int io_pending;
+	int is_active;
+	long long next_timer_call;
+
+	/* set by any thread, reset by the reactor thread */
+	volatile int wakeup_requested;
+	volatile int output_requested;
+
+	/* guarded by the reactor guard */
+	int is_detached;
+} dx_reactor_registration_data_t;
+
+typedef struct {
+	dx_reactor_registration_data_t** elements;
+	size_t size;
+	size_t capacity;
+} dx_registration_array_t;
+
+typedef struct dx_reactor_tag {
+	dx_thread_t thread;
+	/* the index of the thread among the CPUs it may run on, or -1 if the thread isn't pinned */
+	int cpu_index;
+	int epoll_fd;
+	int wakeup_fd;
+
+	/* accessed by the reactor thread only */
+	dx_registration_array_t registrations;
+
+	dx_mutex_t guard;
+	dx_condition_t detach_condition;
+	dx_registration_array_t attach_queue;
+	dx_registration_array_t detach_queue;
+	int termination_trigger;
+} dx_reactor_t;
+
+static pthread_once_t g_reactor_pool_guard_once = PTHREAD_ONCE_INIT;
+static dx_mutex_t g_reactor_pool_guard;
+static int g_reactor_pool_guard_initialized = false;
+
+static dx_reactor_t* g_reactors = NULL;
+static int g_reactor_count = 0;
+static int g_next_reactor_index = 0;
+static size_t g_registration_count = 0;
+
+/* -------------------------------------------------------------------------- */
+/*
+ *	Helper functions
+ */
+/* -------------------------------------------------------------------------- */
+
+/* The pool guard is created once, even if the first connections are attached concurrently */
+static void dx_init_reactor_pool_guard(void) {
+	g_reactor_pool_guard_initialized = dx_mutex_create(&g_reactor_pool_guard);
+}
+
+/* -------------------------------------------------------------------------- */
+
+static long long dx_reactor_timestamp(void) {
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return (long long)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+/* -------------------------------------------------------------------------- */
+
+static void dx_reactor_signal(dx_reactor_t* reactor) {
+	uint64_t value = 1;
+
+	/* the only possible failure is the counter overflow, which means the reactor will wake up anyway */
+	(void)!write(reactor->wakeup_fd, &value, sizeof(value));
+}
+
+/* -------------------------------------------------------------------------- */
+
+static int dx_reactor_sync_socket(dx_reactor_t* reactor, dx_reactor_registration_data_t* reg) {
+	int generation = 0;
+	dx_socket_t s = reg->handler.get_socket(reg->handler.data, &generation);
+	/* the socket is watched for the writability only while there's queued output, it's writable almost always */
+	const unsigned events = EPOLLIN | (reg->output_pending ? EPOLLOUT : 0);
+	struct epoll_event ev;
+
+	if (s == INVALID_SOCKET) {
+		/*
+		 *	The closed socket is removed from the epoll set automatically, the connection must be restored.
+		 *  While there's no socket, the handler is called again only if it asks for that, so the reactor
+		 *  doesn't spin while the connection is being restored by another thread.
+		 */
+		if (reg->registered_socket != INVALID_SOCKET || generation != reg->registered_generation) {
+			reg->io_pending = true;
+		}
+
+		reg->registered_socket = INVALID_SOCKET;
+		reg->registered_generation = generation;
+
+		return true;
+	}
+
+	ev.events = events;
+	ev.data.ptr = reg;
+
+	if (s == reg->registered_socket && generation == reg->registered_generation) {
+		if (events != reg->registered_events && epoll_ctl(reactor->epoll_fd, EPOLL_CTL_MOD, s, &ev) != 0) {
+			return dx_set_error_code(dx_errno_code_to_internal());
+		}
+
+		reg->registered_events = events;
+
+		return true;
+	}
+
+	if (epoll_ctl(reactor->epoll_fd, EPOLL_CTL_ADD, s, &ev) != 0 &&
+		(errno != EEXIST || epoll_ctl(reactor->epoll_fd, EPOLL_CTL_MOD, s, &ev) != 0)) {
+		return dx_set_error_code(dx_errno_code_to_internal());
+	}
+
+	reg->registered_socket = s;
+	reg->registered_generation = generation;
+	reg->registered_events = events;
+
+	return true;
+}
+
+/* -------------------------------------------------------------------------- */
+
+/* Removes the socket of the registration from the epoll set, so its events don't refer to the registration anymore */
+static void dx_reactor_unregister_socket(dx_reactor_t* reactor, dx_reactor_registration_data_t* reg) {
+	int generation = 0;
+	dx_socket_t s = reg->handler.get_socket(reg->handler.data, &generation);
+
+	/* the descriptor of a socket closed since the last synchronization may belong to another connection already */
+	if (s != INVALID_SOCKET && s == reg->registered_socket && generation == reg->registered_generation &&
+		epoll_ctl(reactor->epoll_fd, EPOLL_CTL_DEL, s, NULL) != 0) {
+		dx_set_error_code(dx_errno_code_to_internal());
+		dx_logging_last_error();
+	}
+
+	reg->registered_socket = INVALID_SOCKET;
+}
+
+/* -------------------------------------------------------------------------- */
+
+static int dx_reactor_get_timeout(dx_reactor_t* reactor) {
+	long long now = dx_reactor_timestamp();
+	long long timeout = MAX_IDLE_TIMEOUT;
+	size_t i = 0;
+
+	for (; i < reactor->registrations.size; ++i) {
+		dx_reactor_registration_data_t* reg = reactor->registrations.elements[i];
+
+		if (!reg->is_active) {
+			continue;
+		}
+
+		if (reg->io_pending || reg->wakeup_requested || reg->output_requested) {
+			return 0;
+		}
+
+		timeout = MIN(timeout, reg->next_timer_call - now);
+	}
+
+	return (int)MAX(timeout, 0);
+}
+
+/* -------------------------------------------------------------------------- */
+
+static void dx_reactor_dispatch(dx_reactor_t* reactor) {
+	size_t i = 0;
+
+	for (; i < reactor->registrations.size; ++i) {
+		dx_reactor_registration_data_t* reg = reactor->registrations.elements[i];
+
+		if (!reg->is_active) {
+			continue;
+		}
+
+		if (reg->readable || reg->io_pending) {
+			const int readable = reg->readable;
+
+			reg->readable = false;
+			reg->io_pending = reg->handler.process_io(reg->handler.data, readable);
+
+			if (!dx_reactor_sync_socket(reactor, reg)) {
+				dx_logging_last_error();
+			}
+		}
+
+		if (__sync_lock_test_and_set(&reg->output_requested, false) || reg->writable) {
+			reg->writable = false;
+			reg->output_pending = reg->handler.process_output != NULL && reg->handler.process_output(reg->handler.data);
+
+			if (!dx_reactor_sync_socket(reactor, reg)) {
+				dx_logging_last_error();
+			}
+		}
+
+		if (__sync_lock_test_and_set(&reg->wakeup_requested, false) ||
+			dx_reactor_timestamp() >= reg->next_timer_call) {
+			const int delay = reg->handler.process_timer(reg->handler.data);
+
+			reg->next_timer_call = dx_reactor_timestamp() + delay;
+
+			if (!dx_reactor_sync_socket(reactor, reg)) {
+				dx_logging_last_error();
+			}
+		}
+	}
+}
+
+/* -------------------------------------------------------------------------- */
+
+/*
+ *	The attachments and detachments are processed between the event batches, and the sockets of the detached
+ *  registrations are removed from the epoll set, so the events returned by epoll never refer to a freed registration.
+ *  Returns false if the reactor thread must terminate.
+ */
+static int dx_reactor_process_commands(dx_reactor_t* reactor) {
+	dx_registration_array_t attach_queue;
+	dx_registration_array_t detach_queue;
+	int termination_trigger = false;
+	size_t i = 0;
+
+	if (!dx_mutex_lock(&reactor->guard)) {
+		return true;
+	}
+
+	attach_queue = reactor->attach_queue;
+	detach_queue = reactor->detach_queue;
+	termination_trigger = reactor->termination_trigger;
+	dx_memset(&reactor->attach_queue, 0, sizeof(dx_registration_array_t));
+	dx_memset(&reactor->detach_queue, 0, sizeof(dx_registration_array_t));
+
+	dx_mutex_unlock(&reactor->guard);
+
+	for (i = 0; i < attach_queue.size; ++i) {
+		dx_reactor_registration_data_t* reg = attach_queue.elements[i];
+		int failed = false;
+
+		DX_ARRAY_INSERT(reactor->registrations, dx_reactor_registration_data_t*, reg, reactor->registrations.size,
+						dx_capacity_manager_halfer, failed);
+
+		if (failed) {
+			dx_logging_last_error();
+
+			continue;
+		}
+
+		reg->is_active = reg->handler.on_attach == NULL || reg->handler.on_attach(reg->handler.data);
+		reg->next_timer_call = dx_reactor_timestamp();
+
+		if (reg->is_active && !dx_reactor_sync_socket(reactor, reg)) {
+			dx_logging_last_error();
+		}
+	}
+
+	for (i = 0; i < detach_queue.size; ++i) {
+		dx_reactor_registration_data_t* reg = detach_queue.elements[i];
+		size_t index = 0;
+		int found = false;
+		int failed = false;
+
+		DX_ARRAY_SEARCH(reactor->registrations.elements, 0, reactor->registrations.size, reg,
+						DX_NUMERIC_COMPARATOR, false, found, index);
+
+		if (found) {
+			DX_ARRAY_DELETE(reactor->registrations, dx_reactor_registration_data_t*, index,
+							dx_capacity_manager_halfer, failed);
+
+			if (failed) {
+				dx_logging_last_error();
+			}
+
+			/* the socket is closed by the owner after the detachment, when the registration is freed already */
+			dx_reactor_unregister_socket(reactor, reg);
+
+			if (reg->is_active && reg->handler.on_detach != NULL) {
+				reg->handler.on_detach(reg->handler.data);
+			}
+		}
+	}
+
+	CHECKED_FREE(attach_queue.elements);
+
+	if (detach_queue.size > 0 && dx_mutex_lock(&reactor->guard)) {
+		for (i = 0; i < detach_queue.size; ++i) {
+			detach_queue.elements[i]->is_detached = true;
+		}
+
+		dx_condition_broadcast(&reactor->detach_condition);
+		dx_mutex_unlock(&reactor->guard);
+	}
+
+	CHECKED_FREE(detach_queue.elements);
+
+	return !termination_trigger;
+}
+
+/* -------------------------------------------------------------------------- */
+
+/* Binds the calling thread to the CPU of the index among the CPUs the process may run on, round-robin */
+static void dx_pin_reactor_thread(int cpu_index) {
+	cpu_set_t allowed_cpus;
+	cpu_set_t thread_cpu;
+	int cpu = 0;
+
+	if (sched_getaffinity(0, sizeof(cpu_set_t), &allowed_cpus) != 0 || CPU_COUNT(&allowed_cpus) == 0) {
+		dx_set_error_code(dx_errno_code_to_internal());
+		dx_logging_last_error();
+
+		return;
+	}
+
+	cpu_index %= CPU_COUNT(&allowed_cpus);
+
+	for (; cpu < CPU_SETSIZE; ++cpu) {
+		if (CPU_ISSET(cpu, &allowed_cpus) && cpu_index-- == 0) {
+			break;
+		}
+	}
+
+	CPU_ZERO(&thread_cpu);
+	CPU_SET(cpu, &thread_cpu);
+
+	/* the thread that can't be pinned still works, just without the affinity */
+	if (pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &thread_cpu) != 0) {
+		dx_logging_info(L"Failed to pin the I/O reactor thread to CPU %d", cpu);
+
+		return;
+	}
+
+	dx_logging_verbose_info(L"I/O reactor thread is pinned to CPU %d", cpu);
+}
+
+/* -------------------------------------------------------------------------- */
+
+static void* dx_reactor_thread(void* arg) {
+	dx_reactor_t* reactor = arg;
+	struct epoll_event events[MAX_EPOLL_EVENTS];
+
+	if (!dx_init_error_subsystem()) {
+		return DX_THREAD_RETVAL_NULL;
+	}
+
+	if (reactor->cpu_index >= 0) {
+		dx_pin_reactor_thread(reactor->cpu_index);
+	}
+
+	for (;;) {
+		int count = epoll_wait(reactor->epoll_fd, events, MAX_EPOLL_EVENTS, dx_reactor_get_timeout(reactor));
+		dx_reactor_registration_data_t* reg = NULL;
+		int i = 0;
+
+		if (count < 0) {
+			if (errno != EINTR) {
+				dx_set_error_code(dx_errno_code_to_internal());
+				dx_logging_last_error();
+			}
+
+			count = 0;
+		}
+
+		for (; i < count; ++i) {
+			if (events[i].data.ptr == NULL) {
+				uint64_t value;
+
+				(void)!read(reactor->wakeup_fd, &value, sizeof(value));
+
+				continue;
+			}
+
+			reg = events[i].data.ptr;
+
+			if (events[i].events & (EPOLLIN | EPOLLERR | EPOLLHUP)) {
+				reg->readable = true;
+			}
+
+			if (events[i].events & EPOLLOUT) {
+				reg->writable = true;
+			}
+		}
+
+		dx_reactor_dispatch(reactor);
+
+		if (!dx_reactor_process_commands(reactor)) {
+			break;
+		}
+	}
+
+	return DX_THREAD_RETVAL_NULL;
+}
+
+/* -------------------------------------------------------------------------- */
+
+static void dx_clear_reactor_data(dx_reactor_t* reactor) {
+	if (reactor->epoll_fd >= 0) {
+		close(reactor->epoll_fd);
+	}
+
+	if (reactor->wakeup_fd >= 0) {
+		close(reactor->wakeup_fd);
+	}
+
+	dx_mutex_destroy(&reactor->guard);
+	dx_condition_destroy(&reactor->detach_condition);
+
+	CHECKED_FREE(reactor->registrations.elements);
+	CHECKED_FREE(reactor->attach_queue.elements);
+	CHECKED_FREE(reactor->detach_queue.elements);
+}
+
+/* -------------------------------------------------------------------------- */
+
+static int dx_start_reactor(dx_reactor_t* reactor, int cpu_index) {
+	struct epoll_event ev;
+
+	reactor->cpu_index = cpu_index;
+	reactor->epoll_fd = -1;
+	reactor->wakeup_fd = -1;
+
+	CHECKED_CALL(dx_mutex_create, &reactor->guard);
+
+	if (!dx_condition_create(&reactor->detach_condition)) {
+		dx_mutex_destroy(&reactor->guard);
+
+		return false;
+	}
+
+	reactor->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+	reactor->wakeup_fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+
+	ev.events = EPOLLIN;
+	ev.data.ptr = NULL;
+
+	if (reactor->epoll_fd < 0 || reactor->wakeup_fd < 0 ||
+		epoll_ctl(reactor->epoll_fd, EPOLL_CTL_ADD, reactor->wakeup_fd, &ev) != 0) {
+		dx_set_error_code(dx_errno_code_to_internal());
+		dx_clear_reactor_data(reactor);
+
+		return false;
+	}
+
+	if (!dx_thread_create(&reactor->thread, NULL, dx_reactor_thread, reactor)) {
+		dx_clear_reactor_data(reactor);
+
+		return false;
+	}
+
+	return true;
+}
+
+/* -------------------------------------------------------------------------- */
+
+static int dx_stop_reactor(dx_reactor_t* reactor) {
+	int res = true;
+
+	CHECKED_CALL(dx_mutex_lock, &reactor->guard);
+
+	reactor->termination_trigger = true;
+
+	res = dx_mutex_unlock(&reactor->guard) && res;
+
+	dx_reactor_signal(reactor);
+
+	res = dx_wait_for_thread(reactor->thread, NULL) && res;
+
+	dx_clear_reactor_data(reactor);
+
+	return res;
+}
+
+/* -------------------------------------------------------------------------- */
+
+/* must be called with the pool guard locked */
+static int dx_stop_reactor_pool(void) {
+	int res = true;
+	int i = 0;
+
+	for (; i < g_reactor_count; ++i) {
+		res = dx_stop_reactor(&g_reactors[i]) && res;
+	}
+
+	CHECKED_FREE(g_reactors);
+	g_reactor_count = 0;
+	g_next_reactor_index = 0;
+
+	dx_logging_info(L"I/O reactor threads stopped");
+
+	return res;
+}
+
+/* -------------------------------------------------------------------------- */
+
+/* must be called with the pool guard locked */
+static int dx_start_reactor_pool(void) {
+	const int thread_count = dx_get_network_reactor_threads(0);
+	const int pin_threads = dx_get_network_reactor_pin_threads(false);
+
+	g_reactors = dx_calloc(thread_count, sizeof(dx_reactor_t));
+
+	if (g_reactors == NULL) {
+		return false;
+	}
+
+	for (; g_reactor_count < thread_count; ++g_reactor_count) {
+		if (!dx_start_reactor(&g_reactors[g_reactor_count], pin_threads ? g_reactor_count : -1)) {
+			dx_stop_reactor_pool();
+
+			return false;
+		}
+	}
+
+	dx_logging_info(L"Started %d I/O reactor thread(s)%ls", g_reactor_count, pin_threads ? L" pinned to the CPUs" : L"");
+
+	return true;
+}
+
+/* -------------------------------------------------------------------------- */
+/*
+ *	Reactor functions implementation
+ */
+/* -------------------------------------------------------------------------- */
+
+int dx_reactor_is_enabled(void) {
+	return dx_get_network_reactor_threads(0) > 0;
+}
+
+/* -------------------------------------------------------------------------- */
+
+int dx_reactor_attach(const dx_reactor_handler_t* handler, OUT dx_reactor_registration_t* registration) {
+	dx_reactor_registration_data_t* reg = NULL;
+	dx_reactor_t* reactor = NULL;
+	int failed = false;
+
+	if (handler == NULL || handler->get_socket == NULL || handler->process_io == NULL ||
+		handler->process_timer == NULL || registration == NULL) {
+		return dx_set_error_code(dx_ec_invalid_func_param_internal);
+	}
+
+	if (pthread_once(&g_reactor_pool_guard_once, dx_init_reactor_pool_guard) != 0 || !g_reactor_pool_guard_initialized) {
+		return dx_set_error_code(dx_tec_generic_error);
+	}
+
+	reg = dx_calloc(1, sizeof(dx_reactor_registration_data_t));
+
+	if (reg == NULL) {
+		return false;
+	}
+
+	reg->handler = *handler;
+	reg->registered_socket = INVALID_SOCKET;
+	/* the data queued before the attachment is sent on the first dispatch */
+	reg->output_requested = true;
+
+	if (!dx_mutex_lock(&g_reactor_pool_guard)) {
+		dx_free(reg);
+
+		return false;
+	}
+
+	if (g_reactor_count == 0 && !dx_start_reactor_pool()) {
+		dx_mutex_unlock(&g_reactor_pool_guard);
+		dx_free(reg);
+
+		return false;
+	}
+
+	reactor = &g_reactors[g_next_reactor_index];
+	g_next_reactor_index = (g_next_reactor_index + 1) % g_reactor_count;
+	reg->reactor = reactor;
+
+	if (dx_mutex_lock(&reactor->guard)) {
+		DX_ARRAY_INSERT(reactor->attach_queue, dx_reactor_registration_data_t*, reg, reactor->attach_queue.size,
+						dx_capacity_manager_halfer, failed);
+
+		failed = !dx_mutex_unlock(&reactor->guard) || failed;
+	} else {
+		failed = true;
+	}
+
+	if (failed) {
+		if (g_registration_count == 0) {
+			dx_stop_reactor_pool();
+		}
+
+		dx_mutex_unlock(&g_reactor_pool_guard);
+		dx_free(reg);
+
+		return false;
+	}
+
+	++g_registration_count;
+
+	dx_reactor_signal(reactor);
+
+	*registration = reg;
+
+	return dx_mutex_unlock(&g_reactor_pool_guard);
+}
+
+/* -------------------------------------------------------------------------- */
+
+int dx_reactor_detach(dx_reactor_registration_t registration) {
+	dx_reactor_registration_data_t* reg = registration;
+	dx_reactor_t* reactor = NULL;
+	int failed = false;
+	int res = true;
+
+	if (reg == NULL) {
+		return dx_set_error_code(dx_ec_invalid_func_param_internal);
+	}
+
+	reactor = reg->reactor;
+
+	if (dx_compare_threads(dx_get_thread_id(), reactor->thread)) {
+		return dx_set_error_code(dx_ec_internal_assert_violation);
+	}
+
+	CHECKED_CALL(dx_mutex_lock, &reactor->guard);
+
+	DX_ARRAY_INSERT(reactor->detach_queue, dx_reactor_registration_data_t*, reg, reactor->detach_queue.size,
+					dx_capacity_manager_halfer, failed);
+
+	if (failed) {
+		dx_mutex_unlock(&reactor->guard);
+
+		return false;
+	}
+
+	dx_reactor_signal(reactor);
+
+	while (!reg->is_detached && res) {
+		res = dx_condition_wait(&reactor->detach_condition, &reactor->guard, DETACH_WAIT_TIMEOUT);
+	}
+
+	res = dx_mutex_unlock(&reactor->guard) && res;
+
+	if (!res) {
+		/* the registration may still be referenced by the reactor thread, so it's leaked intentionally */
+
+		return false;
+	}
+
+	dx_free(reg);
+
+	CHECKED_CALL(dx_mutex_lock, &g_reactor_pool_guard);
+
+	if (--g_registration_count == 0) {
+		res = dx_stop_reactor_pool() && res;
+	}
+
+	return dx_mutex_unlock(&g_reactor_pool_guard) && res;
+}
+
+/* -------------------------------------------------------------------------- */
+
+void dx_reactor_wake_up(void* registration) {
+	dx_reactor_registration_data_t* reg = registration;
+
+	if (reg == NULL) {
+		return;
+	}
+
+	reg->wakeup_requested = true;
+	__sync_synchronize();
+
+	dx_reactor_signal(reg->reactor);
+}
+
+/* -------------------------------------------------------------------------- */
+
+void dx_reactor_request_output(void* registration) {
+	dx_reactor_registration_data_t* reg = registration;
+
+	if (reg == NULL) {
+		return;
+	}
+
+	reg->output_requested = true;
+	__sync_synchronize();
+
+	/* the reactor thread checks the request before waiting for the events again */
+	if (!dx_compare_threads(dx_get_thread_id(), reg->reactor->thread)) {
+		dx_reactor_signal(reg->reactor);
+	}
+}
+
+/* -------------------------------------------------------------------------- */
+
+int dx_reactor_is_reactor_thread(dx_reactor_registration_t registration) {
+	dx_reactor_registration_data_t* reg = registration;
+
+	return reg != NULL && dx_compare_threads(dx_get_thread_id(), reg->reactor->thread);
+}
+
+#else /* defined(__linux__) */
+
+/* -------------------------------------------------------------------------- */
+/*
+ *	The reactor mode is not supported on the other platforms yet, the connections use their own threads
+ */
+/* -------------------------------------------------------------------------- */
+
+int dx_reactor_is_enabled(void) {
+	return false;
+}
+
+/* -------------------------------------------------------------------------- */
+
+int dx_reactor_attach(const dx_reactor_handler_t* handler, OUT dx_reactor_registration_t* registration) {
+	return dx_set_error_code(dx_ec_internal_assert_violation);
+}
+
+/* -------------------------------------------------------------------------- */
+
+int dx_reactor_detach(dx_reactor_registration_t registration) {
+	return dx_set_error_code(dx_ec_internal_assert_violation);
+}
+
+/* -------------------------------------------------------------------------- */
+
+void dx_reactor_wake_up(void* registration) {
+}
+
+/* -------------------------------------------------------------------------- */
+
+void dx_reactor_request_output(void* registration) {
+}
+
+/* -------------------------------------------------------------------------- */
+
+int dx_reactor_is_reactor_thread(dx_reactor_registration_t registration) {
+	return false;
+}
+
+#endif /* defined(__linux__) */
@@ -0,0 +1,119 @@
+/*
+ * The contents of this file are subject to the Mozilla Public License Version
+ * 1.1 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ * http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+ * for the specific language governing rights and limitations under the
+ * License.
+ *
+ * The Initial Developer of the Original Code is Devexperts LLC.
+ * Portions created by the Initial Developer are Copyright (C) 2010
+ * the Initial Developer. All Rights Reserved.
+ *
+ * Contributor(s):
+ *
+ */
+
+/*
+ *	The I/O reactor serves the sockets of many connections on a fixed set of threads instead of
+ *  the dedicated socket reader and task queue threads of each connection.
+ *  Every connection is bound to a single reactor thread, so its data is still processed in order.
+ */
+
+#ifndef DX_REACTOR_H_INCLUDED
+#define DX_REACTOR_H_INCLUDED
+
+#include "DXSockets.h"
+#include "PrimitiveTypes.h"
+
+/* -------------------------------------------------------------------------- */
+/*
+ *	Reactor handler
+ */
+/* -------------------------------------------------------------------------- */
+
+/*
+ *	Returns the socket to wait the data on or INVALID_SOCKET if the connection has no open socket.
+ *  The generation must change every time a new socket is opened, even if its descriptor is reused.
+ */
+typedef dx_socket_t (*dx_reactor_socket_getter_t) (void* data, OUT int* generation);
+
+/*
+ *	Processes the socket data. Called with 'readable' set when the socket has data to read, and without it
+ *  when the previous call asked to be called again or the socket of the connection has been closed.
+ *  Returns true if the handler must be called again as soon as possible (e.g. the connection is being restored).
+ */
+typedef int (*dx_reactor_io_processor_t) (void* data, int readable);
+
+/*
+ *	Sends the data queued for the socket. Called when the output is requested and then every time the socket becomes
+ *  writable while the previous call reports there's queued data left. Returns true if some data is still queued.
+ */
+typedef int (*dx_reactor_output_processor_t) (void* data);
+
+/*
+ *	Does the periodic and the queued work of the connection.
+ *  Returns the number of milliseconds until the next call.
+ */
+typedef int (*dx_reactor_timer_processor_t) (void* data);
+
+/* Called on the reactor thread when the connection is attached; false return value disables the handler */
+typedef int (*dx_reactor_attach_notifier_t) (void* data);
+
+/* Called on the reactor thread when the connection is detached */
+typedef void (*dx_reactor_detach_notifier_t) (void* data);
+
+typedef struct {
+	void* data;
+
+	dx_reactor_socket_getter_t get_socket;
+	dx_reactor_io_processor_t process_io;
+	dx_reactor_output_processor_t process_output; /* may be NULL if the handler never queues any data */
+	dx_reactor_timer_processor_t process_timer;
+	dx_reactor_attach_notifier_t on_attach;
+	dx_reactor_detach_notifier_t on_detach;
+} dx_reactor_handler_t;
+
+typedef void* dx_reactor_registration_t;
+
+/* -------------------------------------------------------------------------- */
+/*
+ *	Reactor functions
+ */
+/* -------------------------------------------------------------------------- */
+
+/*
+ *	Returns true if the reactor mode is enabled by the 'network.reactorThreads' property and is supported
+ *  on the current platform.
+ */
+int dx_reactor_is_enabled (void);
+
+/*
+ *	Binds the handler to one of the reactor threads. The threads are started on the first attachment and
+ *  stopped when the last registration is detached.
+ */
+int dx_reactor_attach (const dx_reactor_handler_t* handler, OUT dx_reactor_registration_t* registration);
+
+/*
+ *	Unbinds the handler and frees the registration. When the function returns, the handler is not called
+ *  anymore and its socket is not watched by the reactor, so the socket may be closed afterwards.
+ *  Must not be called on the reactor thread that serves the registration.
+ */
+int dx_reactor_detach (dx_reactor_registration_t registration);
+
+/* Makes the reactor thread call the timer processor of the registration as soon as possible */
+void dx_reactor_wake_up (void* registration);
+
+/*
+ *	Makes the reactor thread call the output processor of the registration as soon as possible, and then whenever
+ *  its socket becomes writable until all the queued data is sent
+ */
+void dx_reactor_request_output (void* registration);
+
+/* Returns true if the calling thread is the reactor thread that serves the registration */
+int dx_reactor_is_reactor_thread (dx_reactor_registration_t registration);
+
+#endif /* DX_REACTOR_H_INCLUDED */
@@ -344,7 +344,13 @@ int dx_send (dx_socket_t s, const void* buffer, int buflen) {
 	int res = send(s, (const char*)buffer, buflen, 0);
 
 	if (res == SOCKET_ERROR) {
-		dx_set_error_code(dx_wsa_error_code_to_internal(WSAGetLastError()));
+		const int wsa_code = WSAGetLastError();
+
+		if (wsa_code == WSAEWOULDBLOCK) {
+			return 0;
+		}
+
+		dx_set_error_code(dx_wsa_error_code_to_internal(wsa_code));
 
 		return INVALID_DATA_SIZE;
 	}
@@ -363,6 +369,10 @@ int dx_recv (dx_socket_t s, void* buffer, int buflen) {
 
 		break;
 	case SOCKET_ERROR:
+		if (WSAGetLastError() == WSAEWOULDBLOCK) {
+			return 0;
+		}
+
 		dx_set_error_code(dx_wsa_error_code_to_internal(WSAGetLastError()));
 
 		break;
@@ -376,14 +386,29 @@ int dx_recv (dx_socket_t s, void* buffer, int buflen) {
 /* -------------------------------------------------------------------------- */
 
 int dx_close (dx_socket_t s) {
+	int res = true;
+
+	/* the shutdown fails if the connection is reset already, the socket must be closed anyway */
 	if (shutdown(s, SD_BOTH) == INVALID_SOCKET) {
-		return dx_set_error_code(dx_wsa_error_code_to_internal(WSAGetLastError()));
+		res = dx_set_error_code(dx_wsa_error_code_to_internal(WSAGetLastError()));
 	}
 
 	if (closesocket(s) == INVALID_SOCKET) {
 		return dx_set_error_code(dx_wsa_error_code_to_internal(WSAGetLastError()));
 	}
 
+	return res;
+}
+
+/* -------------------------------------------------------------------------- */
+
+int dx_set_socket_nonblocking (dx_socket_t s) {
+	u_long mode = 1;
+
+	if (ioctlsocket(s, FIONBIO, &mode) == SOCKET_ERROR) {
+		return dx_set_error_code(dx_wsa_error_code_to_internal(WSAGetLastError()));
+	}
+
 	return true;
 }
 
@@ -515,6 +540,10 @@ int dx_send (dx_socket_t s, const void* buffer, int buflen) {
 	int res = send(s, (const char*)buffer, buflen, 0);
 
 	if (res == SOCKET_ERROR) {
+		if (errno == EAGAIN || errno == EWOULDBLOCK) {
+			return 0;
+		}
+
 		dx_set_error_code(dx_errno_code_to_internal());
 
 		return INVALID_DATA_SIZE;
@@ -534,6 +563,10 @@ int dx_recv (dx_socket_t s, void* buffer, int buflen) {
 
 		break;
 	case SOCKET_ERROR:
+		if (errno == EAGAIN || errno == EWOULDBLOCK) {
+			return 0;
+		}
+
 		dx_set_error_code(dx_errno_code_to_internal());
 
 		break;
@@ -547,14 +580,29 @@ int dx_recv (dx_socket_t s, void* buffer, int buflen) {
 /* -------------------------------------------------------------------------- */
 
 int dx_close (dx_socket_t s) {
+	int res = true;
+
+	/* the shutdown fails if the connection is reset already, the socket must be closed anyway */
 	if (shutdown(s, SHUT_RDWR) == INVALID_SOCKET) {
-		return dx_set_error_code(dx_errno_code_to_internal());
+		res = dx_set_error_code(dx_errno_code_to_internal());
 	}
 
 	if (close(s) == INVALID_SOCKET) {
 		return dx_set_error_code(dx_errno_code_to_internal());
 	}
 
+	return res;
+}
+
+/* -------------------------------------------------------------------------- */
+
+int dx_set_socket_nonblocking (dx_socket_t s) {
+	const int flags = fcntl(s, F_GETFL, 0);
+
+	if (flags == -1 || fcntl(s, F_SETFL, flags | O_NONBLOCK) == -1) {
+		return dx_set_error_code(dx_errno_code_to_internal());
+	}
+
 	return true;
 }
 
@@ -41,6 +41,7 @@
 #	include <netinet/in.h>
 #	include <netdb.h>
 #	include <errno.h>
+#	include <fcntl.h>
 
 #	define INVALID_SOCKET -1
 #	define SOCKET_ERROR -1
@@ -48,6 +49,7 @@
 typedef int dx_socket_t;
 #endif /* _WIN32 */
 
+#include "DXErrorCodes.h"
 #include "PrimitiveTypes.h"
 
 #define INVALID_DATA_SIZE (-1)
@@ -72,8 +74,19 @@ int dx_connect (dx_socket_t s, const struct sockaddr* addr, socklen_t addrlen);
 int dx_send (dx_socket_t s, const void* buffer, int buflen);
 int dx_recv (dx_socket_t s, void* buffer, int buflen);
 int dx_close (dx_socket_t s);
+
+/*
+ *	Switches the socket to the non-blocking mode. 'dx_send' and 'dx_recv' of such a socket return zero
+ *  instead of blocking when there's no room for the data to send or no data to receive.
+ */
+int dx_set_socket_nonblocking (dx_socket_t s);
 int dx_getaddrinfo (const char* nodename, const char* servname,
 					const struct addrinfo* hints, struct addrinfo** res);
 void dx_freeaddrinfo (struct addrinfo* res);
 
+#ifndef _WIN32
+/* converts the current 'errno' value into the internal socket error code */
+dx_error_code_t dx_errno_code_to_internal (void);
+#endif /* _WIN32 */
+
 #endif /* DX_SOCKETS_H_INCLUDED */
\ No newline at end of file
@@ -303,6 +303,104 @@ int dx_mutex_unlock (dx_mutex_t* mutex) {
 	}
 }
 
+/* -------------------------------------------------------------------------- */
+
+int dx_condition_create (dx_condition_t* condition) {
+	int res = pthread_cond_init(condition, NULL);
+
+	switch (res) {
+	case EAGAIN:
+		return dx_set_error_code(dx_tec_not_enough_sys_resources);
+	case ENOMEM:
+		return dx_set_error_code(dx_tec_not_enough_memory);
+	case EBUSY:
+		return dx_set_error_code(dx_tec_resource_busy);
+	case EINVAL:
+		return dx_set_error_code(dx_tec_invalid_resource_id);
+	default:
+		return dx_set_error_code(dx_tec_generic_error);
+	case 0:
+		return true;
+	}
+}
+
+/* -------------------------------------------------------------------------- */
+
+int dx_condition_destroy (dx_condition_t* condition) {
+	int res = pthread_cond_destroy(condition);
+
+	switch (res) {
+	case EBUSY:
+		return dx_set_error_code(dx_tec_resource_busy);
+	case EINVAL:
+		return dx_set_error_code(dx_tec_invalid_resource_id);
+	default:
+		return dx_set_error_code(dx_tec_generic_error);
+	case 0:
+		return true;
+	}
+}
+
+/* -------------------------------------------------------------------------- */
+
+int dx_condition_signal (dx_condition_t* condition) {
+	int res = pthread_cond_signal(condition);
+
+	switch (res) {
+	case EINVAL:
+		return dx_set_error_code(dx_tec_invalid_resource_id);
+	default:
+		return dx_set_error_code(dx_tec_generic_error);
+	case 0:
+		return true;
+	}
+}
+
+/* -------------------------------------------------------------------------- */
+
+int dx_condition_broadcast (dx_condition_t* condition) {
+	int res = pthread_cond_broadcast(condition);
+
+	switch (res) {
+	case EINVAL:
+		return dx_set_error_code(dx_tec_invalid_resource_id);
+	default:
+		return dx_set_error_code(dx_tec_generic_error);
+	case 0:
+		return true;
+	}
+}
+
+/* -------------------------------------------------------------------------- */
+
+int dx_condition_wait (dx_condition_t* condition, dx_mutex_t* mutex, int timeout) {
+	struct timespec deadline;
+	int res;
+
+	clock_gettime(CLOCK_REALTIME, &deadline);
+	deadline.tv_sec += timeout / 1000;
+	deadline.tv_nsec += (long)(timeout % 1000) * 1000000;
+
+	if (deadline.tv_nsec >= 1000000000) {
+		++deadline.tv_sec;
+		deadline.tv_nsec -= 1000000000;
+	}
+
+	res = pthread_cond_timedwait(condition, &mutex->mutex, &deadline);
+
+	switch (res) {
+	case EINVAL:
+		return dx_set_error_code(dx_tec_invalid_resource_id);
+	case EPERM:
+		return dx_set_error_code(dx_tec_invalid_res_operation);
+	default:
+		return dx_set_error_code(dx_tec_generic_error);
+	case 0:
+	case ETIMEDOUT:
+		return true;
+	}
+}
+
 /* -------------------------------------------------------------------------- */
 /*
  *	Implementation of wrappers without error handling mechanism
@@ -545,6 +643,50 @@ int dx_mutex_unlock (dx_mutex_t* mutex) {
 	return true;
 }
 
+/* -------------------------------------------------------------------------- */
+
+int dx_condition_create (dx_condition_t* condition) {
+	*condition = dx_calloc(1, sizeof(CONDITION_VARIABLE));
+
+	if (*condition == NULL) {
+		return dx_set_error_code(dx_mec_insufficient_memory);
+	}
+
+	InitializeConditionVariable(*condition);
+	return true;
+}
+
+/* -------------------------------------------------------------------------- */
+
+int dx_condition_destroy (dx_condition_t* condition) {
+	free(*condition);
+	return true;
+}
+
+/* -------------------------------------------------------------------------- */
+
+int dx_condition_signal (dx_condition_t* condition) {
+	WakeConditionVariable(*condition);
+	return true;
+}
+
+/* -------------------------------------------------------------------------- */
+
+int dx_condition_broadcast (dx_condition_t* condition) {
+	WakeAllConditionVariable(*condition);
+	return true;
+}
+
+/* -------------------------------------------------------------------------- */
+
+int dx_condition_wait (dx_condition_t* condition, dx_mutex_t* mutex, int timeout) {
+	if (!SleepConditionVariableCS(*condition, *mutex, (DWORD)timeout) && GetLastError() != ERROR_TIMEOUT) {
+		return dx_set_error_code(dx_tec_generic_error);
+	}
+
+	return true;
+}
+
 /* -------------------------------------------------------------------------- */
 /*
  *	Implementation of wrappers without error handling mechanism
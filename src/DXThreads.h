@@ -36,6 +36,7 @@ typedef struct {
 	pthread_mutex_t mutex;
 	pthread_mutexattr_t attr;
 } dx_mutex_t;
+typedef pthread_cond_t dx_condition_t;
 typedef void* (*dx_start_routine_t)(void*);
 #define DX_THREAD_RETVAL_NULL NULL
 #else /* !defined(_WIN32) || defined(USE_PTHREADS) */
@@ -47,6 +48,7 @@ typedef void* (*dx_start_routine_t)(void*);
 typedef HANDLE dx_thread_t;
 typedef DWORD dx_key_t;
 typedef LPCRITICAL_SECTION dx_mutex_t;
+typedef PCONDITION_VARIABLE dx_condition_t;
 //typedef void pthread_attr_t;
 typedef unsigned (*dx_start_routine_t)(void*);
 #define DX_THREAD_RETVAL_NULL 0
@@ -102,6 +104,15 @@ int dx_mutex_create (dx_mutex_t* mutex);
 int dx_mutex_destroy (dx_mutex_t* mutex);
 int dx_mutex_lock (dx_mutex_t* mutex);
 int dx_mutex_unlock (dx_mutex_t* mutex);
+int dx_condition_create (dx_condition_t* condition);
+int dx_condition_destroy (dx_condition_t* condition);
+int dx_condition_signal (dx_condition_t* condition);
+int dx_condition_broadcast (dx_condition_t* condition);
+/*
+ *	Waits on the condition at most 'timeout' milliseconds. The mutex must be locked by the calling thread
+ *  exactly once. The expiration of the timeout is not considered an error.
+ */
+int dx_condition_wait (dx_condition_t* condition, dx_mutex_t* mutex, int timeout);
 
 /* -------------------------------------------------------------------------- */
 /*
@@ -18,6 +18,8 @@
  */
 
 
+#include <stddef.h>
+
 #include "DXFeed.h"
 
 #include "DataStructures.h"
@@ -25,11 +27,13 @@
 #include "DXAlgorithms.h"
 #include "ConnectionContextData.h"
 #include "DXErrorHandling.h"
+#include "EventSubscription.h"
 #include "Logger.h"
 #include "ServerMessageProcessor.h"
 
 
-#define DX_RECORD_FIELD_STDOPS(r, f) DX_RECORD_FIELD_SETTER_NAME(r, f), DX_RECORD_FIELD_DEF_VAL_NAME(r, f), DX_RECORD_FIELD_GETTER_NAME(r, f)
+#define DX_RECORD_FIELD_STDOPS(r, f) DX_RECORD_FIELD_SETTER_NAME(r, f), DX_RECORD_FIELD_DEF_VAL_NAME(r, f), DX_RECORD_FIELD_GETTER_NAME(r, f), \
+	(int)offsetof(r, f), (int)sizeof(((r*)NULL)->f)
 
 /* -------------------------------------------------------------------------- */
 /*
@@ -395,6 +399,9 @@ typedef struct {
 	dx_record_server_support_state_list_t record_server_support_states;
 	dx_record_list_t records_list;
 	dx_mutex_t guard_records_list;
+
+	/* the bitmasks of the skipped field indices of each record info, guarded by guard_records_list */
+	int skipped_record_fields[dx_rid_count];
 } dx_data_structures_connection_context_t;
 
 #define CTX(context) \
@@ -686,6 +693,67 @@ int dx_find_record_field(const dx_record_item_t* record_info, dxf_const_string_t
 
 /* -------------------------------------------------------------------------- */
 
+int dx_set_skipped_record_fields(dxf_connection_t connection, dx_record_info_id_t record_info_id,
+								dxf_const_string_t* field_names, int field_count) {
+	dx_data_structures_connection_context_t* dscc = NULL;
+	const dx_record_info_t* record_info = NULL;
+	int skipped_fields = 0;
+	int i = 0;
+
+	if (record_info_id < dx_rid_begin || record_info_id >= dx_rid_count || field_count < 0 ||
+		(field_names == NULL && field_count > 0)) {
+
+		return dx_set_error_code(dx_ec_invalid_func_param);
+	}
+
+	CHECKED_CALL_2(dx_validate_connection_handle, connection, false);
+
+	dscc = dx_get_data_structures_connection_context(connection);
+	if (dscc == NULL) {
+		return dx_set_error_code(dx_cec_connection_context_not_initialized);
+	}
+
+	record_info = &g_record_info[record_info_id];
+
+	for (; i < field_count; ++i) {
+		int field_index = 0;
+
+		for (; field_index < record_info->field_count; ++field_index) {
+			if (field_names[i] != NULL && dx_compare_strings(record_info->fields[field_index].name, field_names[i]) == 0) {
+				break;
+			}
+		}
+
+		/* the time fields identify the records of the time series and are always needed */
+		if (field_index == record_info->field_count || record_info->fields[field_index].time != dx_ft_common_field) {
+			return dx_set_error_code(dx_ec_invalid_func_param);
+		}
+
+		skipped_fields |= INDEX_BITMASK(field_index);
+	}
+
+	CHECKED_CALL(dx_mutex_lock, &dscc->guard_records_list);
+
+	dscc->skipped_record_fields[record_info_id] = skipped_fields;
+
+	return dx_mutex_unlock(&dscc->guard_records_list);
+}
+
+/* -------------------------------------------------------------------------- */
+
+int dx_get_skipped_record_fields(void* context, dx_record_info_id_t record_info_id) {
+	dx_data_structures_connection_context_t* dscc = CTX(context);
+	int skipped_fields = 0;
+
+	dx_mutex_lock(&dscc->guard_records_list);
+	skipped_fields = dscc->skipped_record_fields[record_info_id];
+	dx_mutex_unlock(&dscc->guard_records_list);
+
+	return skipped_fields;
+}
+
+/* -------------------------------------------------------------------------- */
+
 dxf_char_t dx_get_record_exchange_code(void* context, dx_record_id_t record_id) {
 	dx_data_structures_connection_context_t* dscc = CTX(context);
 	dx_record_list_t* records_list = &(dscc->records_list);
@@ -813,6 +881,7 @@ int dx_add_record_to_list(dxf_connection_t connection, dx_record_item_t record,
 	new_record.fields = record.fields;
 	new_record.info_id = record.info_id;
 	dx_memcpy(new_record.suffix, record.suffix, sizeof(record.suffix));
+	new_record.suffix_hash = (dx_string_length(new_record.suffix) > 0) ? dx_symbol_name_hasher(new_record.suffix) : 0;
 	new_record.exchange_code = record.exchange_code;
 
 	DX_ARRAY_INSERT(dscc->records_list, dx_record_item_t, new_record, index, dx_capacity_manager_halfer, failed);
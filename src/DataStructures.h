@@ -88,6 +88,9 @@ typedef struct {
 	dx_record_field_setter_t setter;
 	dx_record_field_def_val_getter_t def_val_getter;
 	dx_record_field_getter_t getter;
+	/* the location of the field in the record structure, lets the decoder store the values directly */
+	int offset;
+	int size;
 	dx_scheme_field_time_t time;
 } dx_field_info_t;
 
@@ -105,6 +108,7 @@ typedef struct {
 	const dx_field_info_t* fields;
 	dx_record_info_id_t info_id;
 	dxf_char_t suffix[DXF_RECORD_SUFFIX_SIZE];
+	dxf_ulong_t suffix_hash; /* the dx_symbol_name_hasher value of the suffix, 0 if there's no suffix */
 	dxf_char_t exchange_code;
 } dx_record_item_t;
 
@@ -139,6 +143,21 @@ void dx_drop_unsubscribe_counter(void* context);
 
 int dx_find_record_field(const dx_record_item_t* record_info, dxf_const_string_t field_name,
 						dxf_int_t field_type);
+/*
+ * Sets the fields of the records of the record info that the connection skips: they aren't decoded, the events
+ * get the default values instead, and they aren't described to the server. Replaces the fields set before.
+ * The time fields can't be skipped.
+ *
+ * connection     - the connection handle
+ * record_info_id - the record info of the records
+ * field_names    - the names of the skipped fields, may be NULL if field_count is 0
+ * field_count    - the number of the names
+ * return true if no errors occur otherwise returns false
+ */
+int dx_set_skipped_record_fields(dxf_connection_t connection, dx_record_info_id_t record_info_id,
+								dxf_const_string_t* field_names, int field_count);
+/* Returns the bitmask of the skipped field indices, the fields are indexed as in dx_record_item_t */
+int dx_get_skipped_record_fields(void* context, dx_record_info_id_t record_info_id);
 dxf_char_t dx_get_record_exchange_code(void* context, dx_record_id_t record_id);
 int dx_set_record_exchange_code(void* context, dx_record_id_t record_id, dxf_char_t exchange_code);
 /*
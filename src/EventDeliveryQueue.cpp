@@ -0,0 +1,869 @@
+/*
+ * The contents of this file are subject to the Mozilla Public License Version
+ * 1.1 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ * http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+ * for the specific language governing rights and limitations under the
+ * License.
+ *
+ * The Initial Developer of the Original Code is Devexperts LLC.
+ * Portions created by the Initial Developer are Copyright (C) 2010
+ * the Initial Developer. All Rights Reserved.
+ *
+ * Contributor(s):
+ *
+ */
+
+extern "C" {
+
+#include "DXAlgorithms.h"
+#include "DXErrorHandling.h"
+#include "DXMemory.h"
+#include "DXThreads.h"
+#include "EventData.h"
+#include "EventManager.h"
+
+}
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <thread>
+
+#include "EventDeliveryQueue.hpp"
+
+namespace dx {
+
+// The largest capacity of a queue
+static const int MAX_QUEUE_CAPACITY = 1 << 24;
+
+// The number of the events an executor task delivers in the last value mode before it yields to the other tasks
+static const std::size_t LAST_VALUE_TASK_SIZE = 1024;
+
+// The event types whose newer events override the older ones, only they can be delivered in the last value mode
+static const unsigned LAST_VALUE_EVENT_TYPES = DXF_ET_TRADE | DXF_ET_QUOTE | DXF_ET_SUMMARY | DXF_ET_PROFILE |
+											   DXF_ET_GREEKS | DXF_ET_THEO_PRICE | DXF_ET_UNDERLYING |
+											   DXF_ET_TRADE_ETH | DXF_ET_CONFIGURATION;
+
+// How long the waiting threads sleep at most, in case they are woken up too early to notice the change
+static const auto CONSUMER_WAIT_TIMEOUT = std::chrono::milliseconds(100);
+static const auto PRODUCER_WAIT_TIMEOUT = std::chrono::milliseconds(10);
+
+// The queue whose events the current thread is delivering
+static thread_local DeliveryQueue* currentDeliveryQueue = nullptr;
+
+DeliveryQueue::DeliveryQueue(const Target& target, const dxf_delivery_options_t& options, std::size_t capacity,
+							 std::size_t eventSize)
+	: target(target),
+	  lastValueMode{options.mode == dxf_dm_last_value},
+	  overflowPolicy{options.overflow_policy},
+	  executor{options.executor},
+	  executorData{options.executor_data},
+	  capacity{capacity},
+	  eventSize{eventSize},
+	  slots{lastValueMode ? nullptr : new Slot[capacity]},
+	  slotEvents(lastValueMode ? 0 : capacity * eventSize),
+	  takenEvents(DELIVERY_BATCH_SIZE),
+	  takenEventData(DELIVERY_BATCH_SIZE * eventSize),
+	  runEventData(DELIVERY_BATCH_SIZE * eventSize),
+	  runEventParams(DELIVERY_BATCH_SIZE) {}
+
+std::shared_ptr<DeliveryQueue> DeliveryQueue::create(const Target& target, unsigned eventTypes,
+													 const dxf_delivery_options_t& options) {
+	std::size_t capacity = 1;
+	std::size_t eventSize = 0;
+
+	if (options.mode == dxf_dm_last_value) {
+		if ((eventTypes & ~LAST_VALUE_EVENT_TYPES) != 0) {
+			dx_set_error_code(dx_ec_invalid_func_param);
+
+			return nullptr;
+		}
+
+		capacity = LAST_VALUE_TASK_SIZE;
+	} else if (options.mode != dxf_dm_queue || options.queue_capacity <= 0 ||
+			   options.queue_capacity > MAX_QUEUE_CAPACITY || options.overflow_policy < dxf_dop_block ||
+			   options.overflow_policy > dxf_dop_conflate) {
+		dx_set_error_code(dx_ec_invalid_func_param);
+
+		return nullptr;
+	} else {
+		while (capacity < static_cast<std::size_t>(options.queue_capacity)) {
+			capacity <<= 1;
+		}
+	}
+
+	// the slots fit the largest event of the subscription and keep the events aligned
+	for (int eventId = dx_eid_begin; eventId < dx_eid_count; ++eventId) {
+		if (eventTypes & DX_EVENT_BIT_MASK(static_cast<unsigned>(eventId))) {
+			eventSize = (std::max)(eventSize, static_cast<std::size_t>(dx_get_event_data_struct_size(eventId)));
+		}
+	}
+
+	if (eventSize == 0) {
+		dx_set_error_code(dx_esec_invalid_event_type);
+
+		return nullptr;
+	}
+
+	eventSize = (eventSize + alignof(std::max_align_t) - 1) / alignof(std::max_align_t) * alignof(std::max_align_t);
+
+	return std::shared_ptr<DeliveryQueue>(new DeliveryQueue(target, options, capacity, eventSize));
+}
+
+unsigned char* DeliveryQueue::getSlotEvent(std::uint64_t index) {
+	return slotEvents.data() + static_cast<std::size_t>(index & (capacity - 1)) * eventSize;
+}
+
+unsigned char* DeliveryQueue::getLastValueEvent(std::size_t slotIndex) {
+	return lastValueEvents.data() + slotIndex * eventSize;
+}
+
+bool DeliveryQueue::isEmpty() const {
+	if (lastValueMode) {
+		return updatedSlotCount.load() == 0;
+	}
+
+	return head.load() == tail.load();
+}
+
+/*
+ * The event is left consistent on error, it gets an empty symbol if the symbol can't be copied and no strings if
+ * they can't.
+ */
+bool DeliveryQueue::storeEvent(Event& event, unsigned char* eventData, dx_event_id_t eventId, const void* symbolKey,
+							   dxf_const_string_t symbolName, dxf_const_event_data_t data,
+							   const dxf_event_params_t* eventParams) {
+	std::size_t symbolLength = dx_string_length(symbolName);
+	bool res = true;
+
+	event.eventId = eventId;
+	event.symbolKey = symbolKey;
+	event.longSymbolName = nullptr;
+
+	if (eventParams != nullptr) {
+		event.eventParams = *eventParams;
+	} else {
+		dx_memset(&event.eventParams, 0, sizeof(dxf_event_params_t));
+	}
+
+	if (symbolLength < SYMBOL_BUFFER_SIZE) {
+		dx_memcpy(event.symbolName, symbolName, (symbolLength + 1) * sizeof(dxf_char_t));
+	} else if ((event.longSymbolName = dx_create_string_src(symbolName)) == nullptr) {
+		event.symbolName[0] = 0;
+		res = false;
+	}
+
+	dx_memcpy(eventData, data, dx_get_event_data_struct_size(eventId));
+
+	return dx_copy_event_strings(eventId, eventData) && res;
+}
+
+void DeliveryQueue::freeEvent(Event& event, unsigned char* eventData) {
+	dx_free_event_strings(event.eventId, eventData);
+	CHECKED_FREE(event.longSymbolName);
+
+	event.longSymbolName = nullptr;
+}
+
+/*
+ * Drops the event at the head unless the consumer is taking it at the moment, the caller checks the room again anyway.
+ */
+void DeliveryQueue::dropOldestEvent() {
+	auto index = head.load(std::memory_order_acquire);
+
+	if (tail.load(std::memory_order_relaxed) - index < capacity) {
+		return;
+	}
+
+	Slot& slot = slots[static_cast<std::size_t>(index & (capacity - 1))];
+	int state = ReadySlot;
+
+	if (!slot.state.compare_exchange_strong(state, BusySlot, std::memory_order_acquire)) {
+		std::this_thread::yield();
+
+		return;
+	}
+
+	if (head.load(std::memory_order_acquire) != index) {
+		slot.state.store(ReadySlot, std::memory_order_release);
+
+		return;
+	}
+
+	freeEvent(slot.event, getSlotEvent(index));
+	slot.state.store(EmptySlot, std::memory_order_relaxed);
+	head.store(index + 1, std::memory_order_release);
+	droppedEvents.fetch_add(1, std::memory_order_relaxed);
+}
+
+/*
+ * Replaces the last queued event of the same symbol and type, returns false if there's no such event or the consumer
+ * is taking it at the moment.
+ */
+bool DeliveryQueue::conflateEvent(dx_event_id_t eventId, const void* symbolKey, dxf_const_string_t symbolName,
+								  dxf_const_event_data_t data, const dxf_event_params_t* eventParams, OUT bool& res) {
+	auto found = lastEventIndices.find(ConflationKey{symbolKey, eventId});
+
+	if (found == lastEventIndices.end()) {
+		return false;
+	}
+
+	auto index = found->second;
+
+	if (index < head.load(std::memory_order_acquire) || index >= tail.load(std::memory_order_relaxed)) {
+		return false;
+	}
+
+	Slot& slot = slots[static_cast<std::size_t>(index & (capacity - 1))];
+	int state = ReadySlot;
+
+	if (!slot.state.compare_exchange_strong(state, BusySlot, std::memory_order_acquire)) {
+		return false;
+	}
+
+	// the slot may have been taken and reused by the later event
+	if (head.load(std::memory_order_acquire) > index || slot.event.eventId != eventId ||
+		slot.event.symbolKey != symbolKey || dx_compare_strings(slot.event.getSymbolName(), symbolName) != 0) {
+		slot.state.store(ReadySlot, std::memory_order_release);
+
+		return false;
+	}
+
+	freeEvent(slot.event, getSlotEvent(index));
+	res = storeEvent(slot.event, getSlotEvent(index), eventId, symbolKey, symbolName, data, eventParams);
+	slot.state.store(ReadySlot, std::memory_order_release);
+	conflatedEvents.fetch_add(1, std::memory_order_relaxed);
+
+	return true;
+}
+
+void DeliveryQueue::rememberEventIndex(dx_event_id_t eventId, const void* symbolKey, std::uint64_t index) {
+	// the indices of the taken events are forgotten once they are the majority
+	if (lastEventIndices.size() >= 2 * capacity) {
+		auto currentHead = head.load(std::memory_order_acquire);
+
+		for (auto it = lastEventIndices.begin(); it != lastEventIndices.end();) {
+			if (it->second < currentHead) {
+				it = lastEventIndices.erase(it);
+			} else {
+				++it;
+			}
+		}
+	}
+
+	lastEventIndices[ConflationKey{symbolKey, eventId}] = index;
+}
+
+void DeliveryQueue::waitForRoom() {
+	std::unique_lock<std::mutex> lk(wakeMutex);
+
+	producerWaiting.store(true);
+
+	if (tail.load(std::memory_order_relaxed) - head.load() >= capacity && !closed.load()) {
+		roomFreed.wait_for(lk, PRODUCER_WAIT_TIMEOUT);
+	}
+
+	producerWaiting.store(false, std::memory_order_relaxed);
+}
+
+/*
+ * Returns the slot of the symbol and type, the new ones get a free slot or a new one. The slot found by the key of
+ * another symbol, whose removal hasn't been noticed, is released and the symbol gets a new one. Must be called under
+ * the last value mutex.
+ */
+std::size_t DeliveryQueue::getLastValueSlot(dx_event_id_t eventId, const void* symbolKey,
+											dxf_const_string_t symbolName) {
+	ConflationKey key{symbolKey, eventId};
+	auto found = lastValueIndices.find(key);
+
+	if (found != lastValueIndices.end()) {
+		if (lastValueSlots[found->second].symbolName.compare(symbolName) == 0) {
+			return found->second;
+		}
+
+		releaseLastValueSlot(found->second);
+		lastValueIndices.erase(found);
+	}
+
+	std::size_t slotIndex;
+
+	if (!freeLastValueSlots.empty()) {
+		slotIndex = freeLastValueSlots.back();
+		freeLastValueSlots.pop_back();
+	} else {
+		slotIndex = lastValueSlots.size();
+		lastValueSlots.push_back(LastValueSlot{});
+		lastValueEvents.resize(lastValueEvents.size() + eventSize);
+	}
+
+	lastValueSlots[slotIndex].symbolName.assign(symbolName);
+	lastValueIndices.emplace(key, slotIndex);
+	lastValueSlotCount.store(static_cast<int>(lastValueSlots.size() - freeLastValueSlots.size()),
+							 std::memory_order_relaxed);
+
+	return slotIndex;
+}
+
+// The updated slot is freed when its event is taken, it's delivered as the events queued in the other modes
+void DeliveryQueue::releaseLastValueSlot(std::size_t slotIndex) {
+	LastValueSlot& slot = lastValueSlots[slotIndex];
+
+	if (slot.updated) {
+		slot.removed = true;
+
+		return;
+	}
+
+	slot.symbolName.clear();
+	freeLastValueSlots.push_back(slotIndex);
+	lastValueSlotCount.store(static_cast<int>(lastValueSlots.size() - freeLastValueSlots.size()),
+							 std::memory_order_relaxed);
+}
+
+/*
+ * The new symbols and types get their slots, the slots that haven't been taken since the previous update are
+ * overwritten, the other ones join the updated slots.
+ */
+bool DeliveryQueue::putLastValues(dx_event_id_t eventId, const void* symbolKey, dxf_const_string_t symbolName,
+								  dxf_const_event_data_t data, int dataCount, const dxf_event_params_t* eventParams) {
+	unsigned eventBitmask = DX_EVENT_BIT_MASK(static_cast<unsigned>(eventId));
+	bool res = true;
+
+	{
+		std::lock_guard<std::mutex> lk(lastValueMutex);
+
+		if (closed.load(std::memory_order_acquire)) {
+			return res;
+		}
+
+		for (int i = 0; i < dataCount; ++i) {
+			dxf_const_event_data_t item = dx_get_event_data_item(eventBitmask, data, i);
+			const dxf_event_params_t* itemParams = (eventParams != nullptr) ? eventParams + i : nullptr;
+			std::size_t slotIndex = getLastValueSlot(eventId, symbolKey, symbolName);
+			LastValueSlot& slot = lastValueSlots[slotIndex];
+
+			if (slot.updated) {
+				freeEvent(slot.event, getLastValueEvent(slotIndex));
+				conflatedEvents.fetch_add(1, std::memory_order_relaxed);
+			} else {
+				slot.updated = true;
+				updatedSlots.push_back(slotIndex);
+			}
+
+			if (!storeEvent(slot.event, getLastValueEvent(slotIndex), eventId, symbolKey, symbolName, item,
+							itemParams)) {
+				res = false;
+			}
+		}
+
+		int updatedCount = static_cast<int>(updatedSlots.size());
+
+		updatedSlotCount.store(updatedCount);
+
+		if (updatedCount > maxQueueSize.load(std::memory_order_relaxed)) {
+			maxQueueSize.store(updatedCount, std::memory_order_relaxed);
+		}
+	}
+
+	wakeConsumer();
+
+	return res;
+}
+
+void DeliveryQueue::removeSymbol(const void* symbolKey) {
+	if (!lastValueMode) {
+		// the indices of the queued events are checked along with the symbol names and forgotten as they are taken
+		return;
+	}
+
+	std::lock_guard<std::mutex> lk(lastValueMutex);
+
+	for (int eventId = dx_eid_begin; eventId < dx_eid_count; ++eventId) {
+		auto found = lastValueIndices.find(ConflationKey{symbolKey, static_cast<dx_event_id_t>(eventId)});
+
+		if (found != lastValueIndices.end()) {
+			releaseLastValueSlot(found->second);
+			lastValueIndices.erase(found);
+		}
+	}
+}
+
+void DeliveryQueue::wakeConsumer() {
+	// the published tail must be visible to the consumer that has set its flag after it's checked here
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+
+	if (executor != nullptr) {
+		if (!taskScheduled.load(std::memory_order_relaxed) && !taskScheduled.exchange(true)) {
+			schedule();
+		}
+
+		return;
+	}
+
+	if (consumerWaiting.load(std::memory_order_relaxed)) {
+		std::lock_guard<std::mutex> lk(wakeMutex);
+
+		eventsAdded.notify_one();
+	}
+}
+
+bool DeliveryQueue::enqueue(dx_event_id_t eventId, const void* symbolKey, dxf_const_string_t symbolName,
+							dxf_const_event_data_t data, int dataCount, const dxf_event_params_t* eventParams) {
+	if (lastValueMode) {
+		return putLastValues(eventId, symbolKey, symbolName, data, dataCount, eventParams);
+	}
+
+	unsigned eventBitmask = DX_EVENT_BIT_MASK(static_cast<unsigned>(eventId));
+	bool res = true;
+
+	for (int i = 0; i < dataCount; ++i) {
+		dxf_const_event_data_t item = dx_get_event_data_item(eventBitmask, data, i);
+		const dxf_event_params_t* itemParams = (eventParams != nullptr) ? eventParams + i : nullptr;
+		bool blocked = false;
+		bool conflated = false;
+		bool queueClosed = false;
+
+		for (;;) {
+			if (closed.load(std::memory_order_acquire)) {
+				queueClosed = true;
+
+				break;
+			}
+
+			if (tail.load(std::memory_order_relaxed) - head.load(std::memory_order_acquire) < capacity) {
+				break;
+			}
+
+			if (overflowPolicy == dxf_dop_block) {
+				if (!blocked) {
+					blockedEnqueues.fetch_add(1, std::memory_order_relaxed);
+					blocked = true;
+
+					// the events put by this call aren't scheduled yet, the consumer may be idle
+					wakeConsumer();
+					target.beginWaitForRoom(target.target);
+				}
+
+				waitForRoom();
+			} else if (overflowPolicy == dxf_dop_conflate &&
+					   conflateEvent(eventId, symbolKey, symbolName, item, itemParams, res)) {
+				conflated = true;
+
+				break;
+			} else {
+				dropOldestEvent();
+			}
+		}
+
+		if (blocked) {
+			target.endWaitForRoom(target.target);
+		}
+
+		if (queueClosed) {
+			return res;
+		}
+
+		if (conflated) {
+			continue;
+		}
+
+		auto index = tail.load(std::memory_order_relaxed);
+		Slot& slot = slots[static_cast<std::size_t>(index & (capacity - 1))];
+
+		if (!storeEvent(slot.event, getSlotEvent(index), eventId, symbolKey, symbolName, item, itemParams)) {
+			res = false;
+		}
+
+		slot.state.store(ReadySlot, std::memory_order_relaxed);
+		tail.store(index + 1, std::memory_order_release);
+
+		if (overflowPolicy == dxf_dop_conflate) {
+			rememberEventIndex(eventId, symbolKey, index);
+		}
+
+		int queueSize = static_cast<int>(index + 1 - head.load(std::memory_order_relaxed));
+
+		if (queueSize > maxQueueSize.load(std::memory_order_relaxed)) {
+			maxQueueSize.store(queueSize, std::memory_order_relaxed);
+		}
+	}
+
+	wakeConsumer();
+
+	return res;
+}
+
+int DeliveryQueue::takeEvents(int maxCount) {
+	int count = 0;
+
+	while (count < maxCount) {
+		auto index = head.load(std::memory_order_acquire);
+
+		if (index == tail.load(std::memory_order_acquire)) {
+			break;
+		}
+
+		Slot& slot = slots[static_cast<std::size_t>(index & (capacity - 1))];
+		int state = ReadySlot;
+
+		// the producer is dropping or replacing the event
+		if (!slot.state.compare_exchange_strong(state, BusySlot, std::memory_order_acquire)) {
+			std::this_thread::yield();
+
+			continue;
+		}
+
+		if (head.load(std::memory_order_acquire) != index) {
+			slot.state.store(ReadySlot, std::memory_order_release);
+
+			continue;
+		}
+
+		takenEvents[count] = slot.event;
+		dx_memcpy(takenEventData.data() + count * eventSize, getSlotEvent(index), eventSize);
+		slot.event.longSymbolName = nullptr;
+		slot.state.store(EmptySlot, std::memory_order_relaxed);
+		head.store(index + 1, std::memory_order_release);
+
+		count++;
+	}
+
+	if (count > 0) {
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+
+		if (producerWaiting.load(std::memory_order_relaxed)) {
+			std::lock_guard<std::mutex> lk(wakeMutex);
+
+			roomFreed.notify_one();
+		}
+	}
+
+	return count;
+}
+
+// The taken events own the strings, the slots get the new ones when they are updated
+int DeliveryQueue::takeLastValues(int maxCount) {
+	std::lock_guard<std::mutex> lk(lastValueMutex);
+	int count = 0;
+
+	while (count < maxCount && !updatedSlots.empty()) {
+		std::size_t slotIndex = updatedSlots.front();
+		LastValueSlot& slot = lastValueSlots[slotIndex];
+
+		updatedSlots.pop_front();
+		takenEvents[count] = slot.event;
+		dx_memcpy(takenEventData.data() + count * eventSize, getLastValueEvent(slotIndex), eventSize);
+		slot.event.longSymbolName = nullptr;
+		slot.updated = false;
+
+		if (slot.removed) {
+			slot.removed = false;
+			releaseLastValueSlot(slotIndex);
+		}
+
+		count++;
+	}
+
+	updatedSlotCount.store(static_cast<int>(updatedSlots.size()));
+
+	return count;
+}
+
+void DeliveryQueue::freeTakenEvents(int count) {
+	for (int i = 0; i < count; ++i) {
+		freeEvent(takenEvents[i], takenEventData.data() + i * eventSize);
+	}
+}
+
+/*
+ * The consecutive events of one type and symbol are passed at once, the ones left after the queue is closed by
+ * the listeners are only freed.
+ */
+void DeliveryQueue::passTakenEvents(int count) {
+	for (int i = 0; i < count;) {
+		const Event& first = takenEvents[i];
+		std::size_t size = static_cast<std::size_t>(dx_get_event_data_struct_size(first.eventId));
+		int runLength = 0;
+
+		for (; i < count; ++i, ++runLength) {
+			const Event& event = takenEvents[i];
+
+			if (runLength > 0 && (event.eventId != first.eventId ||
+								  dx_compare_strings(event.getSymbolName(), first.getSymbolName()) != 0)) {
+				break;
+			}
+
+			dx_memcpy(runEventData.data() + runLength * size, takenEventData.data() + i * eventSize, size);
+			runEventParams[runLength] = event.eventParams;
+		}
+
+		if (!closed.load(std::memory_order_acquire)) {
+			target.deliver(target.target, first.eventId, first.getSymbolName(), runEventData.data(), runLength,
+						   runEventParams.data());
+		}
+	}
+
+	freeTakenEvents(count);
+
+	deliveredEvents.fetch_add(static_cast<std::uint64_t>(count), std::memory_order_relaxed);
+}
+
+// Returns the number of the delivered events
+int DeliveryQueue::deliverEvents() {
+	{
+		std::lock_guard<std::mutex> lk(stateMutex);
+
+		if (closed.load()) {
+			return 0;
+		}
+
+		delivering = true;
+	}
+
+	int count = lastValueMode ? takeLastValues(DELIVERY_BATCH_SIZE) : takeEvents(DELIVERY_BATCH_SIZE);
+
+	if (count > 0) {
+		auto previousQueue = currentDeliveryQueue;
+
+		currentDeliveryQueue = this;
+		target.beginDelivery(target.target);
+		passTakenEvents(count);
+		target.endDelivery(target.target);
+		currentDeliveryQueue = previousQueue;
+	}
+
+	{
+		std::lock_guard<std::mutex> lk(stateMutex);
+
+		delivering = false;
+	}
+
+	deliveryEnded.notify_all();
+
+	return count;
+}
+
+void DeliveryQueue::waitForEvents(std::chrono::milliseconds timeout) {
+	std::unique_lock<std::mutex> lk(wakeMutex);
+
+	consumerWaiting.store(true);
+
+	if (isEmpty() && !closed.load()) {
+		eventsAdded.wait_for(lk, timeout);
+	}
+
+	consumerWaiting.store(false, std::memory_order_relaxed);
+}
+
+/*
+ * Delivers the events until the queue is empty. The task yields to the other tasks of the executor after delivering
+ * the capacity of the queue, the next task continues then.
+ */
+void DeliveryQueue::drain() {
+	std::size_t deliveredCount = 0;
+
+	for (;;) {
+		int count = deliverEvents();
+
+		if (count == 0) {
+			taskScheduled.store(false);
+
+			// the producer may have put the events after they have been taken but before the flag is reset
+			if (closed.load() || isEmpty() || taskScheduled.exchange(true)) {
+				return;
+			}
+
+			continue;
+		}
+
+		deliveredCount += static_cast<std::size_t>(count);
+
+		if (deliveredCount >= capacity) {
+			schedule();
+
+			return;
+		}
+	}
+}
+
+void DeliveryQueue::schedule() {
+	auto taskData = new (std::nothrow) std::shared_ptr<DeliveryQueue>(shared_from_this());
+
+	if (taskData == nullptr) {
+		taskScheduled.store(false);
+
+		return;
+	}
+
+	executor(runTask, taskData, executorData);
+}
+
+void DeliveryQueue::runTask(void* taskData) {
+	std::unique_ptr<std::shared_ptr<DeliveryQueue>> queue(static_cast<std::shared_ptr<DeliveryQueue>*>(taskData));
+
+	(*queue)->drain();
+}
+
+#if !defined(_WIN32) || defined(USE_PTHREADS)
+void* DeliveryQueue::runThread(void* arg) {
+#else
+unsigned DeliveryQueue::runThread(void* arg) {
+#endif
+	std::unique_ptr<std::shared_ptr<DeliveryQueue>> queue(static_cast<std::shared_ptr<DeliveryQueue>*>(arg));
+
+	if (!dx_init_error_subsystem()) {
+		return DX_THREAD_RETVAL_NULL;
+	}
+
+	while (!(*queue)->closed.load()) {
+		if ((*queue)->deliverEvents() == 0) {
+			(*queue)->waitForEvents(CONSUMER_WAIT_TIMEOUT);
+		}
+	}
+
+	return DX_THREAD_RETVAL_NULL;
+}
+
+bool DeliveryQueue::start() {
+	if (executor != nullptr) {
+		return true;
+	}
+
+	auto arg = new (std::nothrow) std::shared_ptr<DeliveryQueue>(shared_from_this());
+
+	if (arg == nullptr) {
+		return dx_set_error_code(dx_mec_insufficient_memory);
+	}
+
+	if (!dx_thread_create(&thread, nullptr, runThread, arg)) {
+		delete arg;
+
+		return false;
+	}
+
+	hasThread = true;
+
+	return true;
+}
+
+int DeliveryQueue::poll(OUT dxf_polled_event_t* events, int maxEvents, int timeout) {
+	auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout);
+	int count = 0;
+
+	freeTakenEvents(polledCount);
+	polledCount = 0;
+
+	if (takenEvents.size() < static_cast<std::size_t>(maxEvents)) {
+		takenEvents.resize(static_cast<std::size_t>(maxEvents));
+		takenEventData.resize(static_cast<std::size_t>(maxEvents) * eventSize);
+	}
+
+	for (;;) {
+		count = lastValueMode ? takeLastValues(maxEvents) : takeEvents(maxEvents);
+
+		if (count > 0 || closed.load() || timeout == 0) {
+			break;
+		}
+
+		auto waitTime = CONSUMER_WAIT_TIMEOUT;
+
+		if (timeout > 0) {
+			auto now = std::chrono::steady_clock::now();
+
+			if (now >= deadline) {
+				break;
+			}
+
+			waitTime = (std::min)(waitTime, std::chrono::duration_cast<std::chrono::milliseconds>(deadline - now) +
+												std::chrono::milliseconds(1));
+		}
+
+		waitForEvents(waitTime);
+	}
+
+	for (int i = 0; i < count; ++i) {
+		events[i].event_type = static_cast<int>(DX_EVENT_BIT_MASK(static_cast<unsigned>(takenEvents[i].eventId)));
+		events[i].symbol = takenEvents[i].getSymbolName();
+		events[i].data = takenEventData.data() + i * eventSize;
+		events[i].event_params = takenEvents[i].eventParams;
+	}
+
+	polledCount = count;
+	deliveredEvents.fetch_add(static_cast<std::uint64_t>(count), std::memory_order_relaxed);
+
+	return count;
+}
+
+/*
+ * The listeners closing their subscription don't wait, otherwise they would wait for themselves. The delivery thread
+ * exits on its own then.
+ */
+void DeliveryQueue::close() {
+	{
+		std::unique_lock<std::mutex> lk(stateMutex);
+
+		closed.store(true);
+
+		if (currentDeliveryQueue != this) {
+			deliveryEnded.wait(lk, [this] { return !delivering; });
+		}
+	}
+
+	{
+		std::lock_guard<std::mutex> lk(wakeMutex);
+
+		eventsAdded.notify_all();
+		roomFreed.notify_all();
+	}
+
+	if (!hasThread) {
+		return;
+	}
+
+	hasThread = false;
+
+	if (currentDeliveryQueue == this) {
+		dx_close_thread_handle(thread);
+	} else {
+		dx_wait_for_thread(thread, nullptr);
+	}
+}
+
+void DeliveryQueue::getStatistics(OUT dxf_delivery_statistics_t& statistics) const {
+	if (lastValueMode) {
+		statistics.queue_size = updatedSlotCount.load(std::memory_order_relaxed);
+		statistics.queue_capacity = lastValueSlotCount.load(std::memory_order_relaxed);
+	} else {
+		auto currentHead = head.load(std::memory_order_acquire);
+		auto currentTail = tail.load(std::memory_order_acquire);
+
+		statistics.queue_size = static_cast<int>(currentTail > currentHead ? currentTail - currentHead : 0);
+		statistics.queue_capacity = static_cast<int>(capacity);
+	}
+
+	statistics.max_queue_size = maxQueueSize.load(std::memory_order_relaxed);
+	statistics.delivered_events = deliveredEvents.load(std::memory_order_relaxed);
+	statistics.dropped_events = droppedEvents.load(std::memory_order_relaxed);
+	statistics.conflated_events = conflatedEvents.load(std::memory_order_relaxed);
+	statistics.blocked_enqueues = blockedEnqueues.load(std::memory_order_relaxed);
+}
+
+DeliveryQueue::~DeliveryQueue() {
+	freeTakenEvents(polledCount);
+
+	for (std::size_t slotIndex = 0; slotIndex < lastValueSlots.size(); ++slotIndex) {
+		if (lastValueSlots[slotIndex].updated) {
+			freeEvent(lastValueSlots[slotIndex].event, getLastValueEvent(slotIndex));
+		}
+	}
+
+	for (auto index = head.load(); index < tail.load(); ++index) {
+		freeEvent(slots[static_cast<std::size_t>(index & (capacity - 1))].event, getSlotEvent(index));
+	}
+}
+
+}  // namespace dx
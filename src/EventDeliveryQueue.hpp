@@ -0,0 +1,270 @@
+/*
+ * The contents of this file are subject to the Mozilla Public License Version
+ * 1.1 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ * http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+ * for the specific language governing rights and limitations under the
+ * License.
+ *
+ * The Initial Developer of the Original Code is Devexperts LLC.
+ * Portions created by the Initial Developer are Copyright (C) 2010
+ * the Initial Developer. All Rights Reserved.
+ *
+ * Contributor(s):
+ *
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace dx {
+
+/*
+ * The bounded queue the events of an asynchronous subscription are delivered through, so that its slow listeners
+ * don't stall the thread processing the server data. The events are put by that thread and are taken by the delivery
+ * thread of the queue or by the tasks run by the user executor, one task at a time, so the queue has a single producer
+ * and a single consumer. They don't lock each other: the events are published by moving the head and the tail
+ * indices, and the producer drops or replaces the queued events on overflow only after claiming their slots with
+ * an atomic state, which the consumer takes for the time of copying the event out.
+ *
+ * In the last value mode the queue keeps one slot per symbol and type instead, the producer overwrites the slot and
+ * puts it into the list of the updated slots unless it's there already, and the consumer takes the slots from that
+ * list. The slots are guarded by a mutex, which both sides hold only to copy the events.
+ */
+class DeliveryQueue : public std::enable_shared_from_this<DeliveryQueue> {
+public:
+	// Passes the events of one type and symbol to the listeners of the target, they are consecutive in the queue
+	using DeliverFunction = void (*)(void* target, dx_event_id_t eventId, dxf_const_string_t symbolName,
+									 dxf_const_event_data_t data, int dataCount, const dxf_event_params_t* eventParams);
+
+	// Called before and after the events taken at once are delivered, e.g. to keep the target from being freed
+	using DeliveryBracketFunction = void (*)(void* target);
+
+	// Called by the producer before and after it waits for the room in the full queue of the dxf_dop_block policy
+	using WaitBracketFunction = void (*)(void* target);
+
+	struct Target {
+		void* target;
+		DeliveryBracketFunction beginDelivery;
+		DeliverFunction deliver;
+		DeliveryBracketFunction endDelivery;
+		WaitBracketFunction beginWaitForRoom;
+		WaitBracketFunction endWaitForRoom;
+	};
+
+private:
+	// The symbols shorter than that are stored in the slots, the longer ones are allocated
+	static const std::size_t SYMBOL_BUFFER_SIZE = 32;
+
+	// The number of the events the consumer takes at once
+	static const int DELIVERY_BATCH_SIZE = 64;
+
+	enum SlotState { EmptySlot, ReadySlot, BusySlot };
+
+	struct Event {
+		dx_event_id_t eventId;
+		dxf_event_params_t eventParams;
+		const void* symbolKey;
+		dxf_string_t longSymbolName;
+		dxf_char_t symbolName[SYMBOL_BUFFER_SIZE];
+
+		dxf_const_string_t getSymbolName() const { return longSymbolName != nullptr ? longSymbolName : symbolName; }
+	};
+
+	struct Slot {
+		std::atomic<int> state{EmptySlot};
+		Event event;
+	};
+
+	struct LastValueSlot {
+		Event event;
+		// The event hasn't been taken by the consumer, the slot owns its strings then
+		bool updated;
+		// The symbol has been removed while the event is updated, the slot is freed when the event is taken
+		bool removed;
+		// The symbol of the slot, the symbol key may be reused by another symbol once the symbol is removed
+		std::wstring symbolName;
+	};
+
+	struct ConflationKey {
+		const void* symbolKey;
+		dx_event_id_t eventId;
+
+		bool operator==(const ConflationKey& other) const {
+			return symbolKey == other.symbolKey && eventId == other.eventId;
+		}
+	};
+
+	struct ConflationKeyHash {
+		std::size_t operator()(const ConflationKey& key) const {
+			return std::hash<const void*>{}(key.symbolKey) * 31 + static_cast<std::size_t>(key.eventId);
+		}
+	};
+
+	Target target;
+	bool lastValueMode;
+	dxf_delivery_overflow_policy_t overflowPolicy;
+	dxf_delivery_executor_t executor;
+	void* executorData;
+
+	std::size_t capacity;
+	std::size_t eventSize;
+	std::unique_ptr<Slot[]> slots;
+	std::vector<unsigned char> slotEvents;
+
+	// The index of the next event to take and of the next event to put, they only grow
+	std::atomic<std::uint64_t> head{0};
+	std::atomic<std::uint64_t> tail{0};
+
+	// The index of the last queued event of each symbol and type, it's used by the producer only
+	std::unordered_map<ConflationKey, std::uint64_t, ConflationKeyHash> lastEventIndices{};
+
+	// The slots of the last value mode, their events and the slots updated since they were taken, in order.
+	// The slots of the removed symbols are reused by the new ones
+	std::mutex lastValueMutex{};
+	std::vector<LastValueSlot> lastValueSlots{};
+	std::vector<unsigned char> lastValueEvents{};
+	std::unordered_map<ConflationKey, std::size_t, ConflationKeyHash> lastValueIndices{};
+	std::vector<std::size_t> freeLastValueSlots{};
+	std::deque<std::size_t> updatedSlots{};
+	std::atomic<int> lastValueSlotCount{0};
+	std::atomic<int> updatedSlotCount{0};
+
+	// The events taken by the consumer and the ones of a run passed to the listeners at once. The polled events are
+	// kept until the next poll
+	std::vector<Event> takenEvents;
+	std::vector<unsigned char> takenEventData;
+	std::vector<unsigned char> runEventData;
+	std::vector<dxf_event_params_t> runEventParams;
+	int polledCount = 0;
+
+	std::atomic<int> maxQueueSize{0};
+	std::atomic<std::uint64_t> deliveredEvents{0};
+	std::atomic<std::uint64_t> droppedEvents{0};
+	std::atomic<std::uint64_t> conflatedEvents{0};
+	std::atomic<std::uint64_t> blockedEnqueues{0};
+
+	// The consumer waiting for the events and the producer waiting for the room, they are woken under the mutex only
+	// if they have set their flags
+	std::atomic<bool> consumerWaiting{false};
+	std::atomic<bool> producerWaiting{false};
+	std::mutex wakeMutex{};
+	std::condition_variable eventsAdded{};
+	std::condition_variable roomFreed{};
+
+	// The executor has got a task of the queue that hasn't returned yet
+	std::atomic<bool> taskScheduled{false};
+
+	// The events aren't delivered after the queue is closed, and the deliveries started before are waited for
+	std::atomic<bool> closed{false};
+	std::mutex stateMutex{};
+	std::condition_variable deliveryEnded{};
+	bool delivering = false;
+
+	bool hasThread = false;
+	dx_thread_t thread{};
+
+	DeliveryQueue(const Target& target, const dxf_delivery_options_t& options, std::size_t capacity,
+				  std::size_t eventSize);
+
+	unsigned char* getSlotEvent(std::uint64_t index);
+
+	unsigned char* getLastValueEvent(std::size_t slotIndex);
+
+	bool isEmpty() const;
+
+	static bool storeEvent(Event& event, unsigned char* eventData, dx_event_id_t eventId, const void* symbolKey,
+						   dxf_const_string_t symbolName, dxf_const_event_data_t data,
+						   const dxf_event_params_t* eventParams);
+
+	static void freeEvent(Event& event, unsigned char* eventData);
+
+	void dropOldestEvent();
+
+	bool conflateEvent(dx_event_id_t eventId, const void* symbolKey, dxf_const_string_t symbolName,
+					   dxf_const_event_data_t data, const dxf_event_params_t* eventParams, OUT bool& res);
+
+	void rememberEventIndex(dx_event_id_t eventId, const void* symbolKey, std::uint64_t index);
+
+	void waitForRoom();
+
+	std::size_t getLastValueSlot(dx_event_id_t eventId, const void* symbolKey, dxf_const_string_t symbolName);
+
+	void releaseLastValueSlot(std::size_t slotIndex);
+
+	bool putLastValues(dx_event_id_t eventId, const void* symbolKey, dxf_const_string_t symbolName,
+					   dxf_const_event_data_t data, int dataCount, const dxf_event_params_t* eventParams);
+
+	void wakeConsumer();
+
+	int takeEvents(int maxCount);
+
+	int takeLastValues(int maxCount);
+
+	void freeTakenEvents(int count);
+
+	void passTakenEvents(int count);
+
+	int deliverEvents();
+
+	void waitForEvents(std::chrono::milliseconds timeout);
+
+	void drain();
+
+	void schedule();
+
+	static void runTask(void* taskData);
+
+#if !defined(_WIN32) || defined(USE_PTHREADS)
+	static void* runThread(void* arg);
+#else
+	static unsigned runThread(void* arg);
+#endif
+
+public:
+	// Returns nullptr on error, the events put before the queue is started are delivered after that
+	static std::shared_ptr<DeliveryQueue> create(const Target& target, unsigned eventTypes,
+												 const dxf_delivery_options_t& options);
+
+	// Starts the delivery thread unless the queue has an executor or is polled
+	bool start();
+
+	/*
+	 * Puts the events, must be called by one thread at a time, i.e. by the thread processing the server data.
+	 * The symbol key identifies the symbol for the conflation, it's compared along with the symbol name.
+	 */
+	bool enqueue(dx_event_id_t eventId, const void* symbolKey, dxf_const_string_t symbolName,
+				 dxf_const_event_data_t data, int dataCount, const dxf_event_params_t* eventParams);
+
+	// Forgets the symbol removed from the subscription, its key may be reused by another symbol after that
+	void removeSymbol(const void* symbolKey);
+
+	/*
+	 * Takes the events of a queue that isn't started, waiting for them up to the timeout in milliseconds or until
+	 * the queue is closed if it's negative. The events stay valid until the next poll.
+	 */
+	int poll(OUT dxf_polled_event_t* events, int maxEvents, int timeout);
+
+	// Stops the delivery and waits for the events being delivered by the other threads
+	void close();
+
+	void getStatistics(OUT dxf_delivery_statistics_t& statistics) const;
+
+	~DeliveryQueue();
+};
+
+}  // namespace dx
@@ -273,3 +273,81 @@ dx_event_free_function_t dx_get_event_free_function(dx_event_id_t event_id) {
 	}
 	return g_event_free_functions[event_id];
 }
+
+/* -------------------------------------------------------------------------- */
+
+int dx_get_event_string_fields(dx_event_id_t event_id, dxf_event_data_t obj,
+								OUT dxf_const_string_t* fields[MAX_EVENT_STRING_FIELD_COUNT]) {
+	switch (event_id) {
+	case dx_eid_profile:
+		fields[0] = &((dxf_profile_t*)obj)->description;
+		fields[1] = &((dxf_profile_t*)obj)->status_reason;
+
+		return 2;
+	case dx_eid_order:
+	case dx_eid_spread_order:
+		fields[0] = &((dxf_order_t*)obj)->market_maker;
+
+		return 1;
+	case dx_eid_time_and_sale:
+		fields[0] = &((dxf_time_and_sale_t*)obj)->exchange_sale_conditions;
+		fields[1] = &((dxf_time_and_sale_t*)obj)->buyer;
+		fields[2] = &((dxf_time_and_sale_t*)obj)->seller;
+
+		return 3;
+	case dx_eid_configuration:
+		fields[0] = (dxf_const_string_t*)&((dxf_configuration_t*)obj)->object;
+
+		return 1;
+	default:
+		return 0;
+	}
+}
+
+/* -------------------------------------------------------------------------- */
+
+int dx_copy_event_strings(dx_event_id_t event_id, dxf_event_data_t obj) {
+	dxf_const_string_t* fields[MAX_EVENT_STRING_FIELD_COUNT];
+	int count = dx_get_event_string_fields(event_id, obj, fields);
+	int i = 0;
+
+	for (; i < count; ++i) {
+		dxf_string_t copy = NULL;
+
+		if (*fields[i] == NULL) {
+			continue;
+		}
+
+		if ((copy = dx_create_string_src(*fields[i])) == NULL) {
+			int j = 0;
+
+			for (; j < count; ++j) {
+				if (j < i) {
+					CHECKED_FREE(*fields[j]);
+				}
+
+				*fields[j] = NULL;
+			}
+
+			return false;
+		}
+
+		*fields[i] = copy;
+	}
+
+	return true;
+}
+
+/* -------------------------------------------------------------------------- */
+
+void dx_free_event_strings(dx_event_id_t event_id, dxf_event_data_t obj) {
+	dxf_const_string_t* fields[MAX_EVENT_STRING_FIELD_COUNT];
+	int count = dx_get_event_string_fields(event_id, obj, fields);
+	int i = 0;
+
+	for (; i < count; ++i) {
+		CHECKED_FREE(*fields[i]);
+
+		*fields[i] = NULL;
+	}
+}
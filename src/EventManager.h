@@ -39,4 +39,19 @@ typedef void(*dx_event_free_function_t) (dxf_event_data_t obj);
 dx_event_copy_function_t dx_get_event_copy_function(dx_event_id_t event_id);
 dx_event_free_function_t dx_get_event_free_function(dx_event_id_t event_id);
 
+#define MAX_EVENT_STRING_FIELD_COUNT 3
+
+/* Returns the number of the string fields of the event and the pointers to them */
+int dx_get_event_string_fields(dx_event_id_t event_id, dxf_event_data_t obj,
+								OUT dxf_const_string_t* fields[MAX_EVENT_STRING_FIELD_COUNT]);
+
+/*
+ *	Replaces the strings of the event by their copies, so that a bitwise copy of the event outlives the buffers
+ *  of the record it's decoded from. On error the event gets no strings at all.
+ */
+int dx_copy_event_strings(dx_event_id_t event_id, dxf_event_data_t obj);
+
+/* Frees the strings copied by dx_copy_event_strings */
+void dx_free_event_strings(dx_event_id_t event_id, dxf_event_data_t obj);
+
 #endif /* EVENT_MANAGER_H_INCLUDED */
\ No newline at end of file
@@ -26,22 +26,29 @@ extern "C" {
 #include "DXErrorCodes.h"
 #include "DXErrorHandling.h"
 #include "DXFeed.h"
+#include "DXMemory.h"
 #include "DXThreads.h"
+#include "EventManager.h"
 #include "Logger.h"
 #include "SymbolCodec.h"
 
 }
 
 #include <cmath>
+#include <cstddef>
+#include <cstdint>
 #include <functional>
 #include <mutex>
+#include <new>
 #include <string>
+#include <thread>
 #include <unordered_map>
 #include <unordered_set>
 #include <utility>
 #include <vector>
 
 #include "EventSubscription.hpp"
+#include "EventDeliveryQueue.hpp"
 #include "Configuration.hpp"
 
 /* -------------------------------------------------------------------------- */
@@ -97,27 +104,41 @@ const size_t dx_all_regional_count = 26;
 
 namespace dx {
 
+// The slots and the events in them are aligned like the allocated memory
+static std::uint32_t dx_align_last_event_size(std::size_t size) {
+	const std::size_t alignment = alignof(std::max_align_t);
+
+	return static_cast<std::uint32_t>((size + alignment - 1) / alignment * alignment);
+}
+
+static const std::uint32_t LAST_EVENT_SLAB_HEADER_SIZE = dx_align_last_event_size(sizeof(LastEventSlab));
+static const std::uint32_t LAST_EVENT_OFFSET = dx_align_last_event_size(sizeof(std::atomic<unsigned>));
+
+static dxf_event_data_t dx_get_last_event_of_sequence(std::atomic<unsigned>* sequence) {
+	return reinterpret_cast<unsigned char*>(sequence) + LAST_EVENT_OFFSET;
+}
+
 SymbolData* SymbolData::cleanup(SymbolData* symbolData) {
 	if (symbolData == nullptr) {
 		return nullptr;
 	}
 
-	auto cleanupEventDataArray = [](dxf_event_data_t* dataArray) {
-		int i = dx_eid_begin;
+	for (int i = dx_eid_begin; i < dx_eid_count; ++i) {
+		auto eventId = static_cast<dx_event_id_t>(i);
+		auto sequence = symbolData->getLastEventSequence(eventId);
 
-		if (dataArray == nullptr) {
-			return;
+		if (sequence != nullptr) {
+			dx_free_event_strings(eventId, dx_get_last_event_of_sequence(sequence));
 		}
 
-		for (; i < dx_eid_count; ++i) {
-			CHECKED_FREE(dataArray[i]);
+		if (symbolData->lastEventsAccessed != nullptr && symbolData->lastEventsAccessed[i] != nullptr) {
+			dx_free_event_strings(eventId, symbolData->lastEventsAccessed[i]);
+			dx_free(symbolData->lastEventsAccessed[i]);
 		}
+	}
 
-		dx_free(dataArray);
-	};
-
-	cleanupEventDataArray(symbolData->lastEvents);
-	cleanupEventDataArray(symbolData->lastEventsAccessed);
+	CHECKED_FREE(symbolData->lastEvents);
+	CHECKED_FREE(symbolData->lastEventsAccessed);
 
 	symbolData->subscriptions.clear();
 
@@ -134,29 +155,170 @@ SymbolData* SymbolData::create(dxf_const_string_t name) {
 	}
 
 	res->name = std::wstring(name);
-	res->lastEvents = static_cast<dxf_event_data_t*>(dx_calloc(dx_eid_count, sizeof(dxf_event_data_t)));
-	res->lastEventsAccessed = static_cast<dxf_event_data_t*>(dx_calloc(dx_eid_count, sizeof(dxf_event_data_t)));
 
-	if (res->lastEvents == nullptr || res->lastEventsAccessed == nullptr) {
-		return cleanup(res);
+	return res;
+}
+
+std::atomic<unsigned>* SymbolData::getLastEventSequence(dx_event_id_t eventId) const {
+	if (lastEvents == nullptr || lastEvents->slotOffsets[eventId] == 0) {
+		return nullptr;
+	}
+
+	return reinterpret_cast<std::atomic<unsigned>*>(reinterpret_cast<unsigned char*>(lastEvents) +
+													lastEvents->slotOffsets[eventId]);
+}
+
+/*
+ * Copies the slab with a new slot added. The events in the slab are stored by the calling thread only, so they are
+ * copied as they are, and the slab is replaced under the lock, which the readers hold.
+ */
+std::atomic<unsigned>* SymbolData::addLastEventSlot(EventSubscriptionConnectionContext* context,
+													 dx_event_id_t eventId) {
+	std::uint32_t oldSize = (lastEvents == nullptr) ? LAST_EVENT_SLAB_HEADER_SIZE : lastEvents->size;
+	std::uint32_t newSize = oldSize + LAST_EVENT_OFFSET + dx_align_last_event_size(dx_get_event_data_struct_size(eventId));
+	auto newSlab = static_cast<LastEventSlab*>(dx_calloc(1, newSize));
+
+	if (newSlab == nullptr) {
+		return nullptr;
+	}
+
+	if (lastEvents != nullptr) {
+		dx_memcpy(newSlab, lastEvents, oldSize);
 	}
 
+	newSlab->slotOffsets[eventId] = oldSize;
+	newSlab->size = newSize;
+
 	for (int i = dx_eid_begin; i < dx_eid_count; ++i) {
-		res->lastEvents[i] = dx_calloc(1, dx_get_event_data_struct_size(i));
-		res->lastEventsAccessed[i] = dx_calloc(1, dx_get_event_data_struct_size(i));
+		if (newSlab->slotOffsets[i] != 0) {
+			auto oldSequence = getLastEventSequence(static_cast<dx_event_id_t>(i));
 
-		if (res->lastEvents[i] == nullptr || res->lastEventsAccessed[i] == nullptr) {
-			return cleanup(res);
+			new (reinterpret_cast<unsigned char*>(newSlab) + newSlab->slotOffsets[i])
+				std::atomic<unsigned>(oldSequence != nullptr ? oldSequence->load(std::memory_order_relaxed) : 0);
 		}
 	}
 
-	return res;
+	LastEventSlab* oldSlab = context->process([this, newSlab](EventSubscriptionConnectionContext*) {
+		auto slab = lastEvents;
+
+		lastEvents = newSlab;
+
+		return slab;
+	});
+
+	CHECKED_FREE(oldSlab);
+
+	return getLastEventSequence(eventId);
 }
 
-void SymbolData::storeLastSymbolEvent(dx_event_id_t eventId, dxf_const_event_data_t data) {
-	dx_memcpy(this->lastEvents[eventId],
-			  dx_get_event_data_item(DX_EVENT_BIT_MASK(static_cast<unsigned>(eventId)), data, 0),
-			  dx_get_event_data_struct_size(eventId));
+/*
+ * The strings of the event are copied unless they are equal to the stored ones, and the replaced strings are freed
+ * under the lock, so that the readers holding it don't see them freed while copying.
+ */
+void SymbolData::storeLastSymbolEvent(EventSubscriptionConnectionContext* context, dx_event_id_t eventId,
+									  dxf_const_event_data_t data) {
+	auto sequence = getLastEventSequence(eventId);
+
+	if (sequence == nullptr && (sequence = addLastEventSlot(context, eventId)) == nullptr) {
+		return;
+	}
+
+	dxf_event_data_t event = dx_get_last_event_of_sequence(sequence);
+	dxf_const_string_t* storedFields[MAX_EVENT_STRING_FIELD_COUNT];
+	dxf_const_string_t* newFields[MAX_EVENT_STRING_FIELD_COUNT];
+	dxf_const_string_t strings[MAX_EVENT_STRING_FIELD_COUNT] = {};
+	dxf_const_string_t replacedStrings[MAX_EVENT_STRING_FIELD_COUNT] = {};
+	int fieldCount = dx_get_event_string_fields(eventId, event, storedFields);
+	bool hasReplacedStrings = false;
+
+	dx_get_event_string_fields(eventId, const_cast<dxf_event_data_t>(data), newFields);
+
+	for (int i = 0; i < fieldCount; ++i) {
+		dxf_const_string_t stored = *storedFields[i];
+		dxf_const_string_t received = *newFields[i];
+
+		if (stored != nullptr && received != nullptr && dx_compare_strings(stored, received) == 0) {
+			strings[i] = stored;
+
+			continue;
+		}
+
+		// the string is left empty if it can't be copied
+		strings[i] = (received != nullptr) ? dx_create_string_src(received) : nullptr;
+		replacedStrings[i] = stored;
+		hasReplacedStrings = hasReplacedStrings || stored != nullptr;
+	}
+
+	unsigned oldSequence = sequence->load(std::memory_order_relaxed);
+
+	sequence->store(oldSequence + 1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+
+	dx_memcpy(event, data, dx_get_event_data_struct_size(eventId));
+
+	for (int i = 0; i < fieldCount; ++i) {
+		*storedFields[i] = strings[i];
+	}
+
+	sequence->store(oldSequence + 2, std::memory_order_release);
+
+	if (hasReplacedStrings) {
+		context->process([fieldCount, &replacedStrings](EventSubscriptionConnectionContext*) {
+			for (int i = 0; i < fieldCount; ++i) {
+				CHECKED_FREE(replacedStrings[i]);
+			}
+		});
+	}
+}
+
+/*
+ * The event is copied while its sequence stays the same and is even. The strings of the copy are replaced by their
+ * copies afterwards, the lock keeps the copied pointers valid.
+ */
+dxf_event_data_t SymbolData::getLastSymbolEvent(dx_event_id_t eventId) {
+	auto sequence = getLastEventSequence(eventId);
+
+	if (sequence == nullptr) {
+		return nullptr;
+	}
+
+	if (lastEventsAccessed == nullptr &&
+		(lastEventsAccessed = static_cast<dxf_event_data_t*>(dx_calloc(dx_eid_count, sizeof(dxf_event_data_t)))) ==
+			nullptr) {
+		return nullptr;
+	}
+
+	if (lastEventsAccessed[eventId] == nullptr &&
+		(lastEventsAccessed[eventId] = dx_calloc(1, dx_get_event_data_struct_size(eventId))) == nullptr) {
+		return nullptr;
+	}
+
+	dxf_event_data_t copy = lastEventsAccessed[eventId];
+
+	dx_free_event_strings(eventId, copy);
+
+	while (true) {
+		unsigned before = sequence->load(std::memory_order_acquire);
+
+		if (before & 1u) {
+			std::this_thread::yield();
+
+			continue;
+		}
+
+		dx_memcpy(copy, dx_get_last_event_of_sequence(sequence), dx_get_event_data_struct_size(eventId));
+		std::atomic_thread_fence(std::memory_order_acquire);
+
+		if (sequence->load(std::memory_order_relaxed) == before) {
+			break;
+		}
+	}
+
+	if (!dx_copy_event_strings(eventId, copy)) {
+		return nullptr;
+	}
+
+	return copy;
 }
 
 ListenerContext::ListenerContext(ListenerPtr listener, EventListenerVersion version, void* userData) noexcept
@@ -213,9 +375,9 @@ int SubscriptionData::closeEventSubscription(dxf_subscription_t subscriptionId,
 		if (remove_from_context) {
 			ctx->removeSubscription(subscriptionData);
 		}
-	});
 
-	SubscriptionData::free(subscriptionData);
+		ctx->freeSubscription(subscriptionData);
+	});
 
 	return res;
 }
@@ -224,6 +386,8 @@ void SubscriptionData::clearOrderSource() {
 	orderSource.elements = nullptr;
 	orderSource.size = 0;
 	orderSource.capacity = 0;
+	orderSourceMask.store(0, std::memory_order_relaxed);
+	hasUnnumberedOrderSources.store(false, std::memory_order_relaxed);
 }
 
 EventSubscriptionConnectionContext::EventSubscriptionConnectionContext(dxf_connection_t connectionHandle)
@@ -250,11 +414,10 @@ SymbolData* EventSubscriptionConnectionContext::subscribeSymbol(dxf_const_string
 		res = found->second;
 	}
 
-	if (res->subscriptions.find(owner) != res->subscriptions.end()) {
+	if (!res->subscriptions.add(owner)) {
 		return res;
 	}
 
-	res->subscriptions.insert(owner);
 	res->refCount++;
 
 	return res;
@@ -273,14 +436,19 @@ void EventSubscriptionConnectionContext::removeSymbolData(SymbolData* symbolData
 int EventSubscriptionConnectionContext::unsubscribeSymbol(SymbolData* symbolData, SubscriptionData* owner) {
 	int res = true;
 
-	auto found = symbolData->subscriptions.find(owner);
-
-	if (found == symbolData->subscriptions.end()) {
+	if (!symbolData->subscriptions.remove(owner)) {
 		dx_set_error_code(dx_ec_internal_assert_violation);
 
 		res = false;
-	} else {
-		symbolData->subscriptions.erase(owner);
+	}
+
+	// the queues of the subscription forget the symbol, its data may be reused by another symbol
+	if (owner->deliveryQueue) {
+		owner->deliveryQueue->removeSymbol(symbolData);
+	}
+
+	if (owner->eventQueue) {
+		owner->eventQueue->removeSymbol(symbolData);
 	}
 
 	if (--(symbolData->refCount) == 0) {
@@ -291,7 +459,9 @@ int EventSubscriptionConnectionContext::unsubscribeSymbol(SymbolData* symbolData
 }
 
 SymbolData* EventSubscriptionConnectionContext::findSymbol(dxf_const_string_t symbolName) {
-	auto found = symbols.find(std::wstring(symbolName));
+	symbolKey.assign(symbolName);
+
+	auto found = symbols.find(symbolKey);
 
 	if (found == symbols.end()) {
 		return nullptr;
@@ -303,21 +473,172 @@ SymbolData* EventSubscriptionConnectionContext::findSymbol(dxf_const_string_t sy
 void EventSubscriptionConnectionContext::addSubscription(SubscriptionData* data) {
 	std::lock_guard<std::recursive_mutex> lk(mutex);
 
-	subscriptions.insert(data);
+	if (!subscriptions.insert(data).second) {
+		return;
+	}
+
+	updateWantedEventTypes(data->event_types, 1);
+
+	if (IS_FLAG_SET(data->subscriptionFlags, dx_esf_batch_events)) {
+		batchingSubscriptionCount++;
+	}
 }
 
 void EventSubscriptionConnectionContext::removeSubscription(SubscriptionData* data) {
 	std::lock_guard<std::recursive_mutex> lk(mutex);
 
-	subscriptions.erase(data);
+	if (subscriptions.erase(data) == 0) {
+		return;
+	}
+
+	updateWantedEventTypes(data->event_types, -1);
+
+	if (IS_FLAG_SET(data->subscriptionFlags, dx_esf_batch_events)) {
+		batchingSubscriptionCount--;
+	}
+}
+
+// Must be called under the lock
+void EventSubscriptionConnectionContext::updateWantedEventTypes(unsigned eventTypes, int delta) {
+	unsigned wanted = 0;
+
+	for (int i = dx_eid_begin; i < dx_eid_count; ++i) {
+		if (eventTypes & DX_EVENT_BIT_MASK(static_cast<unsigned>(i))) {
+			eventTypeSubscriptionCounts[i] += delta;
+		}
+
+		if (eventTypeSubscriptionCounts[i] > 0) {
+			wanted |= DX_EVENT_BIT_MASK(static_cast<unsigned>(i));
+		}
+	}
+
+	wantedEventTypes.store(wanted, std::memory_order_relaxed);
+}
+
+void EventSubscriptionConnectionContext::setSubscriptionFlags(SubscriptionData* data, dx_event_subscr_flag flags) {
+	std::lock_guard<std::recursive_mutex> lk(mutex);
+
+	if (subscriptions.find(data) != subscriptions.end()) {
+		bool wasBatching = IS_FLAG_SET(data->subscriptionFlags, dx_esf_batch_events);
+		bool isBatching = IS_FLAG_SET(flags, dx_esf_batch_events);
+
+		if (isBatching && !wasBatching) {
+			batchingSubscriptionCount++;
+		} else if (wasBatching && !isBatching) {
+			batchingSubscriptionCount--;
+		}
+	}
+
+	data->subscriptionFlags = flags;
+}
+
+bool EventSubscriptionConnectionContext::hasBatchingSubscriptions() const {
+	return batchingSubscriptionCount.load(std::memory_order_relaxed) > 0;
+}
+
+unsigned EventSubscriptionConnectionContext::getWantedEventTypes() const {
+	return wantedEventTypes.load(std::memory_order_relaxed);
+}
+
+void EventSubscriptionConnectionContext::setLastEventTypes(unsigned eventTypes) {
+	lastEventTypes.store(eventTypes, std::memory_order_relaxed);
+}
+
+bool EventSubscriptionConnectionContext::isLastEventStored(dx_event_id_t eventId) const {
+	return (lastEventTypes.load(std::memory_order_relaxed) & DX_EVENT_BIT_MASK(static_cast<unsigned>(eventId))) != 0;
+}
+
+// The number of the dispatches the current thread is calling the listeners of
+static thread_local int currentThreadDispatchDepth = 0;
+
+void EventSubscriptionConnectionContext::beginDispatch() {
+	dispatchCount++;
+	currentThreadDispatchDepth++;
+}
+
+void EventSubscriptionConnectionContext::endDispatch() {
+	currentThreadDispatchDepth--;
+
+	if (--dispatchCount > 0) {
+		return;
+	}
+
+	for (auto&& subscriptionData : retiredSubscriptions) {
+		SubscriptionData::free(subscriptionData);
+	}
+
+	retiredSubscriptions.clear();
+	dispatchEpoch++;
+	dispatchEnded.notify_all();
+}
+
+/*
+ * The waiting dispatch rereads the subscriptions and their listeners after the room is freed, so it doesn't call
+ * the listeners detached or closed while it waits.
+ */
+void EventSubscriptionConnectionContext::beginWaitForRoom() {
+	waitingDispatchCount++;
+	dispatchEnded.notify_all();
+}
+
+void EventSubscriptionConnectionContext::endWaitForRoom() {
+	waitingDispatchCount--;
+}
+
+/*
+ * The listeners closing the subscriptions or detaching the listeners don't wait, otherwise they would wait for
+ * themselves.
+ */
+void EventSubscriptionConnectionContext::waitForDispatch() {
+	if (currentThreadDispatchDepth > 0) {
+		return;
+	}
+
+	std::unique_lock<std::recursive_mutex> lk(mutex);
+	auto epoch = dispatchEpoch;
+
+	dispatchEnded.wait(lk, [this, epoch] { return dispatchCount == waitingDispatchCount || dispatchEpoch != epoch; });
+}
+
+void EventSubscriptionConnectionContext::freeSubscription(SubscriptionData* data) {
+	std::lock_guard<std::recursive_mutex> lk(mutex);
+
+	if (dispatchCount > 0) {
+		retiredSubscriptions.push_back(data);
+	} else {
+		SubscriptionData::free(data);
+	}
+}
+
+void EventSubscriptionConnectionContext::releaseSymbolData(SymbolData* symbolData) {
+	if (symbolData != nullptr && --(symbolData->refCount) == 0) {
+		removeSymbolData(symbolData);
+	}
 }
 
 EventSubscriptionConnectionContext::~EventSubscriptionConnectionContext() {
+	// the delivery queues are closed without the lock, their listeners may be waiting for it
+	auto currentSubscriptions = process([](EventSubscriptionConnectionContext* ctx) { return ctx->subscriptions; });
+
+	for (auto&& subscriptionData : currentSubscriptions) {
+		if (subscriptionData->deliveryQueue) {
+			subscriptionData->deliveryQueue->close();
+		}
+
+		if (subscriptionData->eventQueue) {
+			subscriptionData->eventQueue->close();
+		}
+	}
+
 	std::lock_guard<std::recursive_mutex> lk(mutex);
 
 	for (auto&& subscriptionData : subscriptions) {
 		SubscriptionData::closeEventSubscription(static_cast<dxf_subscription_t>(subscriptionData), false);
 	}
+
+	for (auto&& subscriptionData : retiredSubscriptions) {
+		SubscriptionData::free(subscriptionData);
+	}
 }
 bool EventSubscriptionConnectionContext::hasAnySymbol() {
 	return process([this](dx::EventSubscriptionConnectionContext* ctx) {
@@ -436,8 +757,30 @@ dxf_subscription_t dx_create_event_subscription(dxf_connection_t connection, uns
 	return static_cast<dxf_subscription_t>(subscr_data);
 }
 
+/*
+ * The listeners of the subscription aren't called after it returns, as the listeners called before are waited for.
+ */
 int dx_close_event_subscription(dxf_subscription_t subscr_id) {
-	return dx::SubscriptionData::closeEventSubscription(subscr_id, true);
+	if (subscr_id == dx_invalid_subscription) {
+		return dx_set_error_code(dx_esec_invalid_subscr_id);
+	}
+
+	auto subscr_data = static_cast<dx::SubscriptionData*>(subscr_id);
+	auto context = static_cast<dx::EventSubscriptionConnectionContext*>(subscr_data->connection_context);
+
+	if (subscr_data->deliveryQueue) {
+		subscr_data->deliveryQueue->close();
+	}
+
+	if (subscr_data->eventQueue) {
+		subscr_data->eventQueue->close();
+	}
+
+	int res = dx::SubscriptionData::closeEventSubscription(subscr_id, true);
+
+	context->waitForDispatch();
+
+	return res;
 }
 
 /* -------------------------------------------------------------------------- */
@@ -529,9 +872,7 @@ int dx_add_listener_impl(dxf_subscription_t subscr_id, dx::ListenerContext::List
 	auto listener_context = dx::ListenerContext(listener, version, user_data);
 
 	context->process([&subscr_data, listener_context](dx::EventSubscriptionConnectionContext* ctx) {
-		if (subscr_data->listeners.find(listener_context) == subscr_data->listeners.end()) {
-			subscr_data->listeners.emplace(listener_context);
-		}
+		subscr_data->listeners.add(listener_context);
 	});
 
 	return true;
@@ -566,12 +907,12 @@ int dx_remove_listener_impl(dxf_subscription_t subscr_id, dx::ListenerContext::L
 	auto context = static_cast<dx::EventSubscriptionConnectionContext*>(subscr_data->connection_context);
 
 	context->process([&subscr_data, listener](dx::EventSubscriptionConnectionContext* ctx) {
-		auto listener_context_it = subscr_data->listeners.find(dx::ListenerContext::createDummy(listener));
-		if (listener_context_it != subscr_data->listeners.end()) {
-			subscr_data->listeners.erase(listener_context_it);
-		}
+		subscr_data->listeners.remove(dx::ListenerContext::createDummy(listener));
 	});
 
+	// the listener isn't called after it's detached
+	context->waitForDispatch();
+
 	return true;
 }
 
@@ -692,9 +1033,7 @@ int dx_set_event_subscription_flags(dxf_subscription_t subscr_id, dx_event_subsc
 
 	auto context = static_cast<dx::EventSubscriptionConnectionContext*>(subscr_data->connection_context);
 
-	context->process([&subscr_data, subscr_flags](dx::EventSubscriptionConnectionContext* ctx) {
-		subscr_data->subscriptionFlags = subscr_flags;
-	});
+	context->setSubscriptionFlags(subscr_data, subscr_flags);
 
 	return true;
 }
@@ -719,25 +1058,24 @@ int dx_get_event_subscription_time(dxf_subscription_t subscr_id, OUT dxf_long_t*
 
 /* -------------------------------------------------------------------------- */
 
-static void dx_call_subscr_listeners(dx::SubscriptionData* subscr_data, unsigned event_bitmask,
-									 dxf_const_string_t symbol_name, dxf_const_event_data_t data,
-									 const dxf_event_params_t* event_params) {
-	if (subscr_data == nullptr || subscr_data->symbols.find(symbol_name) == subscr_data->symbols.end()) {
-		return;
-	}
+static void dx_call_listeners(const dx::SubscriptionData* subscr_data, unsigned event_bitmask,
+							  dxf_const_string_t symbol_name, dxf_const_event_data_t data, int data_count,
+							  const dxf_event_params_t* event_params) {
+	// the listeners may detach themselves or the other listeners
+	auto listeners = subscr_data->listeners.get();
 
-	for (auto&& listener_context : subscr_data->listeners) {
+	for (auto&& listener_context : *listeners) {
 		switch (listener_context.getVersion()) {
 			case dx::EventListenerVersion::Default: {
 				auto listener = (dxf_event_listener_t)listener_context.getListener();
-				listener(event_bitmask, symbol_name, static_cast<dxf_event_data_t const*>(data), 1,
+				listener(event_bitmask, symbol_name, static_cast<dxf_event_data_t const*>(data), data_count,
 						 listener_context.getUserData());
 				break;
 			}
 
 			case dx::EventListenerVersion::V2: {
 				auto listener = (dxf_event_listener_v2_t)listener_context.getListener();
-				listener(event_bitmask, symbol_name, static_cast<dxf_event_data_t const*>(data), 1,
+				listener(event_bitmask, symbol_name, static_cast<dxf_event_data_t const*>(data), data_count,
 						 event_params, listener_context.getUserData());
 				break;
 			}
@@ -748,48 +1086,201 @@ static void dx_call_subscr_listeners(dx::SubscriptionData* subscr_data, unsigned
 	}
 }
 
+/* -------------------------------------------------------------------------- */
+
+/*
+ * The listeners are called if the subscription has the symbol, i.e. the subscription is among the subscriptions of
+ * the symbol data. It's checked this way to avoid making a string key of the symbol name.
+ * The events are put into the event queue of the subscription too. The events of the asynchronous subscriptions are
+ * queued instead of calling the listeners. The queues get all the events at once, with the symbol data as
+ * the conflation key.
+ */
+static void dx_call_subscr_listeners(dx::SubscriptionData* subscr_data, const dx::SymbolData* named_symbol_data,
+									 dx_event_id_t event_id, dxf_const_string_t symbol_name,
+									 dxf_const_event_data_t data, int data_count,
+									 const dxf_event_params_t* event_params) {
+	if (subscr_data == nullptr || named_symbol_data == nullptr ||
+		!named_symbol_data->subscriptions.contains(subscr_data)) {
+		return;
+	}
+
+	if (subscr_data->eventQueue) {
+		subscr_data->eventQueue->enqueue(event_id, named_symbol_data, symbol_name, data, data_count, event_params);
+	}
+
+	if (subscr_data->deliveryQueue) {
+		subscr_data->deliveryQueue->enqueue(event_id, named_symbol_data, symbol_name, data, data_count, event_params);
+
+		return;
+	}
+
+	unsigned event_bitmask = DX_EVENT_BIT_MASK(static_cast<unsigned>(event_id));
+
+	if (data_count == 1 || IS_FLAG_SET(subscr_data->subscriptionFlags, dx_esf_batch_events)) {
+		dx_call_listeners(subscr_data, event_bitmask, symbol_name, data, data_count, event_params);
+
+		return;
+	}
+
+	// the listeners may remove the symbol while they are called
+	for (int i = 0; i < data_count && named_symbol_data->subscriptions.contains(subscr_data); ++i) {
+		dx_call_listeners(subscr_data, event_bitmask, symbol_name, dx_get_event_data_item(event_bitmask, data, i), 1,
+						  event_params + i);
+	}
+}
+
+/* -------------------------------------------------------------------------- */
+/*
+ *	Order source ids
+ *
+ *  The order sources get small ids, the bits of the source masks of the subscriptions, in the order they are first
+ *  added to a subscription. The ids are never reused, so the sources are looked up without locking. The sources added
+ *  after the ids are exhausted are matched by their names.
+ */
+/* -------------------------------------------------------------------------- */
+
+#define MAX_ORDER_SOURCE_ID_COUNT 64
+
+static std::atomic<std::uint64_t> g_order_source_keys[MAX_ORDER_SOURCE_ID_COUNT];
+static std::atomic<int> g_order_source_id_count{0};
+static std::mutex g_order_source_id_mutex;
+
+/* the source suffixes are at most four characters, so they are packed into one number */
+static std::uint64_t dx_get_order_source_key(dxf_const_string_t source) {
+	std::uint64_t key = 0;
+
+	for (int i = 0; i < DXF_RECORD_SUFFIX_SIZE - 1 && source[i] != 0; ++i) {
+		key = (key << 16) | static_cast<std::uint16_t>(source[i]);
+	}
+
+	return key;
+}
+
+/* returns -1 if the source has no id, the sources of a data message are usually the same, so the last one is cached */
+static int dx_find_order_source_id(std::uint64_t key) {
+	static thread_local std::uint64_t last_key = 0;
+	static thread_local int last_id = -1;
+
+	if (last_id >= 0 && last_key == key) {
+		return last_id;
+	}
+
+	int count = g_order_source_id_count.load(std::memory_order_acquire);
+
+	for (int id = 0; id < count; ++id) {
+		if (g_order_source_keys[id].load(std::memory_order_relaxed) == key) {
+			last_key = key;
+			last_id = id;
+
+			return id;
+		}
+	}
+
+	return -1;
+}
+
+static int dx_get_order_source_id(std::uint64_t key) {
+	int id = dx_find_order_source_id(key);
+
+	if (id >= 0) {
+		return id;
+	}
+
+	std::lock_guard<std::mutex> lk(g_order_source_id_mutex);
+	int count = g_order_source_id_count.load(std::memory_order_relaxed);
+
+	for (id = 0; id < count; ++id) {
+		if (g_order_source_keys[id].load(std::memory_order_relaxed) == key) {
+			return id;
+		}
+	}
+
+	if (count == MAX_ORDER_SOURCE_ID_COUNT) {
+		return -1;
+	}
+
+	g_order_source_keys[count].store(key, std::memory_order_relaxed);
+	g_order_source_id_count.store(count + 1, std::memory_order_release);
+
+	return count;
+}
+
+/* -------------------------------------------------------------------------- */
+
 #define DX_ORDER_SOURCE_COMPARATOR_NONSYM(l, r) (dx_compare_strings(l.suffix, r))
 
-void pass_event_data_to_listeners(dx::EventSubscriptionConnectionContext* ctx, dx::SymbolData* symbol_data,
-								  dx_event_id_t event_id, dxf_const_string_t symbol_name, dxf_const_event_data_t data,
-								  const dxf_event_params_t* event_params) {
-	symbol_data->refCount++;  // TODO replace by std::shared_ptr\std::weak_ptr
+/*
+ * The source bit is the bit of the id of the event source, or 0 if it has no id.
+ */
+static bool dx_is_order_source_subscribed(const dx::SubscriptionData* subscr_data, dx_event_id_t event_id,
+										  dxf_const_event_data_t data, std::uint64_t source_bit) {
+	if (event_id != dx_eid_order || subscr_data->orderSource.size == 0 ||
+		(subscr_data->orderSourceMask.load(std::memory_order_relaxed) & source_bit) != 0) {
+		return true;
+	}
+
+	if (!subscr_data->hasUnnumberedOrderSources.load(std::memory_order_relaxed)) {
+		return false;
+	}
+
+	int found;
+	DX_MAYBE_UNUSED size_t index;
+
+	DX_ARRAY_SEARCH(subscr_data->orderSource.elements, 0, subscr_data->orderSource.size,
+					static_cast<const dxf_order_t*>(data)->source, DX_ORDER_SOURCE_COMPARATOR_NONSYM, false, found,
+					index);
+
+	return found != 0;
+}
+
+/*
+ * The events are of the same record, so the Order events share the source. The subscriptions with
+ * the dx_esf_batch_events flag get all the events in one call with the parameters of the first event,
+ * the other ones get the events one by one.
+ * It's called without locking, the symbol data are referenced and the subscriptions are kept by the dispatch.
+ */
+static void pass_event_data_to_listeners(const dx::SymbolData* symbol_data, const dx::SymbolData* named_symbol_data,
+										 dx_event_id_t event_id, dxf_const_string_t symbol_name,
+										 dxf_const_event_data_t data, int data_count,
+										 const dxf_event_params_t* event_params) {
 	unsigned event_bitmask = DX_EVENT_BIT_MASK(static_cast<unsigned>(event_id));
-	auto subscriptions = symbol_data->subscriptions;  // number of subscriptions may be changed in the listeners
+	auto subscriptions = symbol_data->subscriptions.get();  // number of subscriptions may be changed in the listeners
+	std::uint64_t source_bit = 0;
+
+	if (event_id == dx_eid_order) {
+		int source_id = dx_find_order_source_id(dx_get_order_source_key(static_cast<const dxf_order_t*>(data)->source));
 
-	for (auto&& subscription_data : subscriptions) {
+		source_bit = (source_id >= 0) ? (UINT64_C(1) << source_id) : 0;
+	}
+
+	for (auto&& subscription_data : *subscriptions) {
 		if (!(subscription_data->event_types &
 			  event_bitmask)) { /* subscription doesn't want this specific event type */
 			continue;
 		}
 
-		// Check order source
-		// TODO: optimize
-		if (event_id == dx_eid_order && subscription_data->orderSource.size > 0) {
-			auto order = *static_cast<const dxf_order_t*>(data);
-			int found;
-			DX_MAYBE_UNUSED size_t index;
-
-			DX_ARRAY_SEARCH(subscription_data->orderSource.elements, 0, subscription_data->orderSource.size,
-							order.source, DX_ORDER_SOURCE_COMPARATOR_NONSYM, false, found, index);
-
-			if (found) {
-				dx_call_subscr_listeners(subscription_data, event_bitmask, symbol_name, data, event_params);
-			}
-		} else {
-			dx_call_subscr_listeners(subscription_data, event_bitmask, symbol_name, data, event_params);
+		if (!dx_is_order_source_subscribed(subscription_data, event_id, data, source_bit)) {
+			continue;
 		}
-	}
 
-	// TODO replace by std::shared_ptr\std::weak_ptr
-	symbol_data->refCount--;
-	if (symbol_data->refCount == 0) {
-		ctx->removeSymbolData(symbol_data);
+		dx_call_subscr_listeners(subscription_data, named_symbol_data, event_id, symbol_name, data, data_count,
+								 event_params);
 	}
 }
 
 int dx_process_event_data(dxf_connection_t connection, dx_event_id_t event_id, dxf_const_string_t symbol_name,
 						  dxf_const_event_data_t data, const dxf_event_params_t* event_params) {
+	return dx_process_event_data_batch(connection, event_id, symbol_name, data, 1, event_params);
+}
+
+/* -------------------------------------------------------------------------- */
+
+/*
+ * The symbol data are looked up under the lock, but the last events are stored and the listeners are called without
+ * it, so that the slow listeners don't block the subscription changes made by the other threads.
+ */
+int dx_process_event_data_batch(dxf_connection_t connection, dx_event_id_t event_id, dxf_const_string_t symbol_name,
+								dxf_const_event_data_t data, int data_count, const dxf_event_params_t* event_params) {
 	int res;
 	auto context = static_cast<dx::EventSubscriptionConnectionContext*>(
 		dx_get_subsystem_data(connection, dx_ccs_event_subscription, &res));
@@ -806,24 +1297,283 @@ int dx_process_event_data(dxf_connection_t connection, dx_event_id_t event_id, d
 		return dx_set_error_code(dx_esec_invalid_event_type);
 	}
 
-	context->process(
-		[event_id, symbol_name, data, event_params](dx::EventSubscriptionConnectionContext* ctx) {
-			dx::SymbolData* symbol_data = ctx->findSymbol(symbol_name);
+	if (data_count <= 0) {
+		return dx_set_error_code(dx_ec_invalid_func_param_internal);
+	}
+
+	dx::SymbolData* symbol_data = nullptr;
+	dx::SymbolData* wildcard_symbol_data = nullptr;
 
-			/* symbol_data == nullptr is most likely a correct situation that occurred because the data is received very
-			soon after the symbol subscription has been annulled */
-			if (symbol_data != nullptr) {
-				symbol_data->storeLastSymbolEvent(event_id, data);
-				pass_event_data_to_listeners(ctx, symbol_data, event_id, symbol_name, data, event_params);
-			}
+	context->process([symbol_name, &symbol_data, &wildcard_symbol_data](dx::EventSubscriptionConnectionContext* ctx) {
+		/* symbol_data == nullptr is most likely a correct situation that occurred because the data is received very
+		soon after the symbol subscription has been annulled */
+		symbol_data = ctx->findSymbol(symbol_name);
+		wildcard_symbol_data = ctx->findSymbol(L"*");
 
-			dx::SymbolData* wildcard_symbol_data = ctx->findSymbol(L"*");
+		// the symbol data are kept until the listeners are called, even if they unsubscribe the symbols
+		if (symbol_data != nullptr) {
+			symbol_data->refCount++;  // TODO replace by std::shared_ptr\std::weak_ptr
+		}
 
-			if (wildcard_symbol_data != nullptr) {
-				wildcard_symbol_data->storeLastSymbolEvent(event_id, data);
-				pass_event_data_to_listeners(ctx, wildcard_symbol_data, event_id, symbol_name, data, event_params);
-			}
-		});
+		if (wildcard_symbol_data != nullptr) {
+			wildcard_symbol_data->refCount++;
+		}
+
+		ctx->beginDispatch();
+	});
+
+	if (context->isLastEventStored(event_id)) {
+		dxf_const_event_data_t last_data =
+			dx_get_event_data_item(DX_EVENT_BIT_MASK(static_cast<unsigned>(event_id)), data, data_count - 1);
+
+		if (symbol_data != nullptr) {
+			symbol_data->storeLastSymbolEvent(context, event_id, last_data);
+		}
+
+		if (wildcard_symbol_data != nullptr) {
+			wildcard_symbol_data->storeLastSymbolEvent(context, event_id, last_data);
+		}
+	}
+
+	if (symbol_data != nullptr) {
+		pass_event_data_to_listeners(symbol_data, symbol_data, event_id, symbol_name, data, data_count, event_params);
+	}
+
+	if (wildcard_symbol_data != nullptr) {
+		pass_event_data_to_listeners(wildcard_symbol_data, symbol_data, event_id, symbol_name, data, data_count,
+									 event_params);
+	}
+
+	context->process([symbol_data, wildcard_symbol_data](dx::EventSubscriptionConnectionContext* ctx) {
+		ctx->releaseSymbolData(symbol_data);
+		ctx->releaseSymbolData(wildcard_symbol_data);
+		ctx->endDispatch();
+	});
+
+	return true;
+}
+
+/* -------------------------------------------------------------------------- */
+
+int dx_has_batching_subscriptions(dxf_connection_t connection) {
+	auto context = static_cast<dx::EventSubscriptionConnectionContext*>(
+		dx_get_subsystem_data(connection, dx_ccs_event_subscription, nullptr));
+
+	return context != nullptr && context->hasBatchingSubscriptions();
+}
+
+/* -------------------------------------------------------------------------- */
+
+unsigned dx_get_wanted_event_types(dxf_connection_t connection) {
+	auto context = static_cast<dx::EventSubscriptionConnectionContext*>(
+		dx_get_subsystem_data(connection, dx_ccs_event_subscription, nullptr));
+
+	return (context != nullptr) ? context->getWantedEventTypes() : 0;
+}
+
+/* -------------------------------------------------------------------------- */
+/*
+ *	Asynchronous delivery functions
+ */
+/* -------------------------------------------------------------------------- */
+
+/*
+ * The queued events are delivered as a dispatch, so the subscription closed by the listeners is freed after they
+ * return, and the threads detaching the listeners or closing the subscriptions wait for them.
+ */
+static void dx_begin_queued_delivery(void* subscription) {
+	auto context = static_cast<dx::EventSubscriptionConnectionContext*>(
+		static_cast<dx::SubscriptionData*>(subscription)->connection_context);
+
+	context->process([](dx::EventSubscriptionConnectionContext* ctx) { ctx->beginDispatch(); });
+}
+
+/* -------------------------------------------------------------------------- */
+
+static void dx_end_queued_delivery(void* subscription) {
+	auto context = static_cast<dx::EventSubscriptionConnectionContext*>(
+		static_cast<dx::SubscriptionData*>(subscription)->connection_context);
+
+	context->process([](dx::EventSubscriptionConnectionContext* ctx) { ctx->endDispatch(); });
+}
+
+/* -------------------------------------------------------------------------- */
+
+static void dx_deliver_queued_events(void* subscription, dx_event_id_t event_id, dxf_const_string_t symbol_name,
+									 dxf_const_event_data_t data, int data_count,
+									 const dxf_event_params_t* event_params) {
+	auto subscr_data = static_cast<dx::SubscriptionData*>(subscription);
+	unsigned event_bitmask = DX_EVENT_BIT_MASK(static_cast<unsigned>(event_id));
+
+	if (data_count == 1 || IS_FLAG_SET(subscr_data->subscriptionFlags, dx_esf_batch_events)) {
+		dx_call_listeners(subscr_data, event_bitmask, symbol_name, data, data_count, event_params);
+
+		return;
+	}
+
+	for (int i = 0; i < data_count; ++i) {
+		dx_call_listeners(subscr_data, event_bitmask, symbol_name, dx_get_event_data_item(event_bitmask, data, i), 1,
+						  event_params + i);
+	}
+}
+
+/* -------------------------------------------------------------------------- */
+
+/*
+ * The thread processing the server data waits for the room in the full queue of the dxf_dop_block policy without
+ * calling the listeners, so the threads detaching the listeners or closing the subscriptions don't wait for it.
+ * Otherwise the executor or the polling thread doing that would wait for itself to take the queued events.
+ */
+static void dx_begin_wait_for_room(void* subscription) {
+	auto context = static_cast<dx::EventSubscriptionConnectionContext*>(
+		static_cast<dx::SubscriptionData*>(subscription)->connection_context);
+
+	context->process([](dx::EventSubscriptionConnectionContext* ctx) { ctx->beginWaitForRoom(); });
+}
+
+/* -------------------------------------------------------------------------- */
+
+static void dx_end_wait_for_room(void* subscription) {
+	auto context = static_cast<dx::EventSubscriptionConnectionContext*>(
+		static_cast<dx::SubscriptionData*>(subscription)->connection_context);
+
+	context->process([](dx::EventSubscriptionConnectionContext* ctx) { ctx->endWaitForRoom(); });
+}
+
+/* -------------------------------------------------------------------------- */
+
+int dx_set_event_subscription_delivery(dxf_subscription_t subscr_id, const dxf_delivery_options_t* options) {
+	auto subscr_data = static_cast<dx::SubscriptionData*>(subscr_id);
+
+	if (subscr_id == dx_invalid_subscription) {
+		return dx_set_error_code(dx_esec_invalid_subscr_id);
+	}
+
+	if (options == nullptr || subscr_data->deliveryQueue || !subscr_data->symbols.empty()) {
+		return dx_set_error_code(dx_ec_invalid_func_param);
+	}
+
+	dx::DeliveryQueue::Target target{subscr_data,
+									 dx_begin_queued_delivery,
+									 dx_deliver_queued_events,
+									 dx_end_queued_delivery,
+									 dx_begin_wait_for_room,
+									 dx_end_wait_for_room};
+	auto queue = dx::DeliveryQueue::create(target, subscr_data->event_types, *options);
+
+	if (!queue || !queue->start()) {
+		return false;
+	}
+
+	subscr_data->deliveryQueue = std::move(queue);
+
+	return true;
+}
+
+/* -------------------------------------------------------------------------- */
+
+int dx_get_event_subscription_delivery_statistics(dxf_subscription_t subscr_id,
+												  OUT dxf_delivery_statistics_t* statistics) {
+	auto subscr_data = static_cast<dx::SubscriptionData*>(subscr_id);
+
+	if (subscr_id == dx_invalid_subscription) {
+		return dx_set_error_code(dx_esec_invalid_subscr_id);
+	}
+
+	if (statistics == nullptr) {
+		return dx_set_error_code(dx_ec_invalid_func_param);
+	}
+
+	dx_memset(statistics, 0, sizeof(dxf_delivery_statistics_t));
+
+	if (subscr_data->deliveryQueue) {
+		subscr_data->deliveryQueue->getStatistics(*statistics);
+	}
+
+	return true;
+}
+
+/* -------------------------------------------------------------------------- */
+/*
+ *	Event queue functions
+ */
+/* -------------------------------------------------------------------------- */
+
+/*
+ * The handle keeps the queue, so it can be polled and closed after the subscription is closed.
+ */
+int dx_create_event_queue(dxf_subscription_t subscr_id, const dxf_delivery_options_t* options,
+						  OUT dxf_event_queue_t* queue) {
+	auto subscr_data = static_cast<dx::SubscriptionData*>(subscr_id);
+
+	if (subscr_id == dx_invalid_subscription) {
+		return dx_set_error_code(dx_esec_invalid_subscr_id);
+	}
+
+	if (options == nullptr || options->executor != nullptr || queue == nullptr || subscr_data->eventQueue ||
+		!subscr_data->symbols.empty()) {
+		return dx_set_error_code(dx_ec_invalid_func_param);
+	}
+
+	dx::DeliveryQueue::Target target{subscr_data, nullptr, nullptr, nullptr, dx_begin_wait_for_room,
+									 dx_end_wait_for_room};
+	auto eventQueue = dx::DeliveryQueue::create(target, subscr_data->event_types, *options);
+
+	if (!eventQueue) {
+		return false;
+	}
+
+	auto handle = new (std::nothrow) std::shared_ptr<dx::DeliveryQueue>(eventQueue);
+
+	if (handle == nullptr) {
+		return dx_set_error_code(dx_mec_insufficient_memory);
+	}
+
+	subscr_data->eventQueue = std::move(eventQueue);
+	*queue = static_cast<dxf_event_queue_t>(handle);
+
+	return true;
+}
+
+/* -------------------------------------------------------------------------- */
+
+int dx_poll_events(dxf_event_queue_t queue, OUT dxf_polled_event_t* events, int max_events, int timeout,
+				   OUT int* event_count) {
+	if (queue == nullptr || events == nullptr || max_events <= 0 || event_count == nullptr) {
+		return dx_set_error_code(dx_ec_invalid_func_param);
+	}
+
+	*event_count = (*static_cast<std::shared_ptr<dx::DeliveryQueue>*>(queue))->poll(events, max_events, timeout);
+
+	return true;
+}
+
+/* -------------------------------------------------------------------------- */
+
+int dx_get_event_queue_statistics(dxf_event_queue_t queue, OUT dxf_delivery_statistics_t* statistics) {
+	if (queue == nullptr || statistics == nullptr) {
+		return dx_set_error_code(dx_ec_invalid_func_param);
+	}
+
+	(*static_cast<std::shared_ptr<dx::DeliveryQueue>*>(queue))->getStatistics(*statistics);
+
+	return true;
+}
+
+/* -------------------------------------------------------------------------- */
+
+/*
+ * The subscription keeps the closed queue until it's closed too, the events aren't put into it.
+ */
+int dx_close_event_queue(dxf_event_queue_t queue) {
+	if (queue == nullptr) {
+		return dx_set_error_code(dx_ec_invalid_func_param);
+	}
+
+	auto handle = static_cast<std::shared_ptr<dx::DeliveryQueue>*>(queue);
+
+	(*handle)->close();
+	delete handle;
 
 	return true;
 }
@@ -865,9 +1615,7 @@ int dx_get_last_symbol_event(dxf_connection_t connection, dxf_const_string_t sym
 			return dx_set_error_code(dx_esec_invalid_symbol_name);
 		}
 
-		dx_memcpy(symbol_data->lastEventsAccessed[event_id], symbol_data->lastEvents[event_id],
-				  dx_get_event_data_struct_size(event_id));
-		*event_data = symbol_data->lastEventsAccessed[event_id];
+		*event_data = ctx->isLastEventStored(event_id) ? symbol_data->getLastSymbolEvent(event_id) : nullptr;
 
 		return true;
 	});
@@ -875,6 +1623,30 @@ int dx_get_last_symbol_event(dxf_connection_t connection, dxf_const_string_t sym
 
 /* -------------------------------------------------------------------------- */
 
+int dx_set_last_event_types(dxf_connection_t connection, int event_types) {
+	int res;
+	auto context = static_cast<dx::EventSubscriptionConnectionContext*>(
+		dx_get_subsystem_data(connection, dx_ccs_event_subscription, &res));
+
+	if (context == nullptr) {
+		if (res) {
+			dx_set_error_code(dx_cec_connection_context_not_initialized);
+		}
+
+		return false;
+	}
+
+	if (event_types & DXF_ET_UNUSED) {
+		return dx_set_error_code(dx_esec_invalid_event_type);
+	}
+
+	context->setLastEventTypes(static_cast<unsigned>(event_types));
+
+	return true;
+}
+
+/* -------------------------------------------------------------------------- */
+
 int dx_process_connection_subscriptions(dxf_connection_t connection, dx_subscription_processor_t processor) {
 	int res;
 	auto context = static_cast<dx::EventSubscriptionConnectionContext*>(
@@ -928,6 +1700,16 @@ int dx_add_order_source(dxf_subscription_t subscr_id, dxf_const_string_t source)
 	int found;
 	size_t index = 0;
 	dx_copy_string_len(new_source.suffix, source, DXF_RECORD_SUFFIX_SIZE);
+
+	/* the source is matched by the mask as soon as it's in the list */
+	int source_id = dx_get_order_source_id(dx_get_order_source_key(new_source.suffix));
+
+	if (source_id >= 0) {
+		subscr_data->orderSourceMask.fetch_or(UINT64_C(1) << source_id, std::memory_order_relaxed);
+	} else {
+		subscr_data->hasUnnumberedOrderSources.store(true, std::memory_order_relaxed);
+	}
+
 	if (subscr_data->orderSource.elements == nullptr) {
 		DX_ARRAY_INSERT(subscr_data->orderSource, dx_suffix_t, new_source, index, dx_capacity_manager_halfer, failed);
 	} else {
@@ -77,8 +77,29 @@ int dx_set_event_subscription_flags(dxf_subscription_t subscr_id, dx_event_subsc
 int dx_get_event_subscription_time(dxf_subscription_t subscr_id, OUT dxf_long_t* time);
 int dx_process_event_data(dxf_connection_t connection, dx_event_id_t event_id, dxf_const_string_t symbol_name,
 						   dxf_const_event_data_t data, const dxf_event_params_t* event_params);
+/* passes the consecutive events of one record and symbol, event_params has the parameters of each event */
+int dx_process_event_data_batch(dxf_connection_t connection, dx_event_id_t event_id, dxf_const_string_t symbol_name,
+								dxf_const_event_data_t data, int data_count, const dxf_event_params_t* event_params);
+/* returns true if some subscription of the connection has the dx_esf_batch_events flag */
+int dx_has_batching_subscriptions(dxf_connection_t connection);
+/* the types of the events some subscription of the connection wants, the records of the other types aren't transcoded */
+unsigned dx_get_wanted_event_types(dxf_connection_t connection);
+/* makes the subscription deliver its events through a queue, must be called before the symbols are added */
+int dx_set_event_subscription_delivery(dxf_subscription_t subscr_id, const dxf_delivery_options_t* options);
+/* the counters are zero for the subscriptions calling the listeners on the thread processing the server data */
+int dx_get_event_subscription_delivery_statistics(dxf_subscription_t subscr_id,
+												  OUT dxf_delivery_statistics_t* statistics);
+/* the queue gets the events of the subscription in addition to the listeners, it's created before the symbols are added */
+int dx_create_event_queue(dxf_subscription_t subscr_id, const dxf_delivery_options_t* options,
+						  OUT dxf_event_queue_t* queue);
+int dx_poll_events(dxf_event_queue_t queue, OUT dxf_polled_event_t* events, int max_events, int timeout,
+				   OUT int* event_count);
+int dx_get_event_queue_statistics(dxf_event_queue_t queue, OUT dxf_delivery_statistics_t* statistics);
+int dx_close_event_queue(dxf_event_queue_t queue);
 int dx_get_last_symbol_event(dxf_connection_t connection, dxf_const_string_t symbol_name, int event_type,
 							  OUT dxf_event_data_t* event_data);
+/* the last events of the other types are neither stored nor returned by dx_get_last_symbol_event */
+int dx_set_last_event_types(dxf_connection_t connection, int event_types);
 
 int dx_process_connection_subscriptions(dxf_connection_t connection, dx_subscription_processor_t processor);
 
@@ -19,6 +19,11 @@
 
 #pragma once
 
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
 #include <mutex>
 #include <string>
 #include <unordered_map>
@@ -27,21 +32,121 @@
 
 namespace dx {
 
+/*
+ * The list is immutable and is replaced on every change, so the dispatch takes a reference to the current items instead
+ * of copying them, and keeps iterating them if the listeners change the list. The items are read without locking,
+ * the changes must be serialized by the caller.
+ */
+template <typename T>
+class CopyOnWriteList {
+public:
+	using Items = std::shared_ptr<const std::vector<T>>;
+
+private:
+	Items items;
+
+	static const Items& emptyItems() {
+		static const Items items = std::make_shared<const std::vector<T>>();
+
+		return items;
+	}
+
+	void set(Items newItems) { std::atomic_store(&items, std::move(newItems)); }
+
+public:
+	CopyOnWriteList() : items{emptyItems()} {}
+
+	Items get() const { return std::atomic_load(&items); }
+
+	bool contains(const T& item) const {
+		auto current = get();
+
+		return std::find(current->begin(), current->end(), item) != current->end();
+	}
+
+	bool empty() const { return get()->empty(); }
+
+	// Returns false if the list already has the item
+	bool add(const T& item) {
+		auto current = get();
+
+		if (std::find(current->begin(), current->end(), item) != current->end()) {
+			return false;
+		}
+
+		auto newItems = std::make_shared<std::vector<T>>();
+
+		newItems->reserve(current->size() + 1);
+		newItems->assign(current->begin(), current->end());
+		newItems->push_back(item);
+		set(std::move(newItems));
+
+		return true;
+	}
+
+	// Returns false if the list has no such item
+	bool remove(const T& item) {
+		auto current = get();
+		auto found = std::find(current->begin(), current->end(), item);
+
+		if (found == current->end()) {
+			return false;
+		}
+
+		auto newItems = std::make_shared<std::vector<T>>(current->begin(), found);
+
+		newItems->insert(newItems->end(), found + 1, current->end());
+		set(std::move(newItems));
+
+		return true;
+	}
+
+	void clear() { set(emptyItems()); }
+};
+
 struct SubscriptionData;
+class DeliveryQueue;
+class EventSubscriptionConnectionContext;
+
+/*
+ * The last events of a symbol are stored in one slab, which gets a slot for an event type when the first event of that
+ * type arrives. A slot is the sequence of the event followed by the event itself, the sequence is odd while the event
+ * is being stored, so the event is read without locking by copying it until the sequence is the same before and after
+ * the copy. The strings of the stored events are owned by the slab.
+ */
+struct LastEventSlab {
+	// The offsets of the slots from the beginning of the slab, 0 if the event type has no slot
+	std::uint32_t slotOffsets[dx_eid_count];
+	std::uint32_t size;
+};
 
 struct SymbolData {
 	std::wstring name{};
 	int refCount;
 
-	std::unordered_set<SubscriptionData*> subscriptions{};
-	dxf_event_data_t* lastEvents;
+	CopyOnWriteList<SubscriptionData*> subscriptions{};
+
+	// The slab is stored by the thread processing the server data, it's replaced under the lock of the context
+	LastEventSlab* lastEvents;
+
+	// The copies of the last events returned by dxf_get_last_event, they are allocated on the first call
 	dxf_event_data_t* lastEventsAccessed;
 
 	static SymbolData* cleanup(SymbolData* dataArray);
 
 	static SymbolData* create(dxf_const_string_t name);
 
-	void storeLastSymbolEvent(dx_event_id_t eventId, dxf_const_event_data_t data);
+	// Must be called by the thread processing the server data without the lock
+	void storeLastSymbolEvent(EventSubscriptionConnectionContext* context, dx_event_id_t eventId,
+							  dxf_const_event_data_t data);
+
+	// Returns the copy of the last event or nullptr if there's no event of the type, must be called under the lock
+	dxf_event_data_t getLastSymbolEvent(dx_event_id_t eventId);
+
+private:
+	std::atomic<unsigned>* getLastEventSequence(dx_event_id_t eventId) const;
+
+	std::atomic<unsigned>* addLastEventSlot(EventSubscriptionConnectionContext* context, dx_event_id_t eventId);
 };
 
 enum class EventListenerVersion { Default = 1, V2 = 2 };
@@ -74,31 +179,29 @@ class ListenerContext {
 	}
 };
 
-}  // namespace dx
-
-namespace std {
-
-template <>
-struct hash<dx::ListenerContext> {
-	std::size_t operator()(const dx::ListenerContext& lc) const noexcept {
-		return std::hash<dx::ListenerContext::ListenerPtr>{}(lc.getListener());
-	}
-};
-
-}  // namespace std
-
-namespace dx {
 
 struct SubscriptionData {
 	unsigned event_types;
 	std::unordered_map<std::wstring, SymbolData*> symbols{};
-	std::unordered_set<ListenerContext> listeners{};
+	CopyOnWriteList<ListenerContext> listeners{};
 	dx_order_source_array_t orderSource;
+
+	// The bits of the ids of the order sources, the sources left without ids are matched by their names
+	std::atomic<std::uint64_t> orderSourceMask{0};
+	std::atomic<bool> hasUnnumberedOrderSources{false};
+
 	dx_event_subscr_flag subscriptionFlags;
 	dxf_long_t time;
 
 	std::vector<dxf_const_string_t> symbolNames{};
 
+	// The queue the events are delivered through if the subscription is asynchronous, it's set before the symbols
+	// are added
+	std::shared_ptr<DeliveryQueue> deliveryQueue{};
+
+	// The queue the events are put into for polling along with the listeners, it's set before the symbols are added
+	std::shared_ptr<DeliveryQueue> eventQueue{};
+
 	void* connection_context; /* event subscription connection context */
 
 	static void free(SubscriptionData* subscriptionData);
@@ -114,6 +217,33 @@ class EventSubscriptionConnectionContext {
 	std::unordered_map<std::wstring, SymbolData*> symbols{};
 	std::unordered_set<SubscriptionData*> subscriptions{};
 
+	// The reused key of the symbol lookups, so that the lookups of the received symbols don't allocate
+	std::wstring symbolKey{};
+
+	// The number of the subscriptions with the dx_esf_batch_events flag, the received events are batched while it's
+	// positive. It's read by the thread processing the server data without locking
+	std::atomic<int> batchingSubscriptionCount{0};
+
+	// The number of the subscriptions of every event type and the types having ones, the records are transcoded only
+	// into the events of these types. The mask is read by the thread processing the server data without locking
+	int eventTypeSubscriptionCounts[dx_eid_count] = {};
+	std::atomic<unsigned> wantedEventTypes{0};
+
+	// The types of the events whose last events are stored for dxf_get_last_event
+	std::atomic<unsigned> lastEventTypes{~DXF_ET_UNUSED};
+
+	// The listeners are called without locking, so the subscriptions closed while some events are dispatched are freed
+	// when the last dispatch ends
+	int dispatchCount = 0;
+	std::vector<SubscriptionData*> retiredSubscriptions{};
+
+	// The number of the dispatches waiting for the room in the full delivery queues, they call no listeners meanwhile
+	int waitingDispatchCount = 0;
+
+	// The number of the times the dispatching has ended, it's waited for by the threads closing the subscriptions
+	unsigned long long dispatchEpoch = 0;
+	std::condition_variable_any dispatchEnded{};
+
 public:
 	explicit EventSubscriptionConnectionContext(dxf_connection_t connectionHandle);
 
@@ -142,6 +272,39 @@ class EventSubscriptionConnectionContext {
 
 	void removeSubscription(SubscriptionData* data);
 
+	void updateWantedEventTypes(unsigned eventTypes, int delta);
+
+	void setSubscriptionFlags(SubscriptionData* data, dx_event_subscr_flag flags);
+
+	bool hasBatchingSubscriptions() const;
+
+	unsigned getWantedEventTypes() const;
+
+	void setLastEventTypes(unsigned eventTypes);
+
+	bool isLastEventStored(dx_event_id_t eventId) const;
+
+	// Must be called under the lock, the subscriptions found between these calls stay valid until the latter one
+	void beginDispatch();
+
+	void endDispatch();
+
+	// Must be called under the lock by the dispatch waiting for the room in a full queue, before and after waiting
+	void beginWaitForRoom();
+
+	void endWaitForRoom();
+
+	void freeSubscription(SubscriptionData* data);
+
+	// Releases the symbol data referenced by the dispatch, must be called under the lock
+	void releaseSymbolData(SymbolData* symbolData);
+
+	/*
+	 * Waits until the listeners called by the other threads return, must be called without the lock. The dispatches
+	 * waiting for the room in the full queues aren't waited for, the room may be freed by the current thread only.
+	 */
+	void waitForDispatch();
+
 	~EventSubscriptionConnectionContext();
 };
 
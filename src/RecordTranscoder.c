@@ -233,12 +233,48 @@ const size_t dx_event_sizes[] = {
 	sizeof(dxf_configuration_t)
 };
 
+/* the maximum number of the events passed to the listeners in one call */
+#define MAX_EVENT_BATCH_SIZE 1024
+
+/*
+ *	The events of one type that are passed to the listeners at once. The events are copied from
+ *  the event data buffers, the strings they refer to are kept by the record buffers.
+ */
+typedef struct {
+	dxf_event_flags_t flags;
+	dxf_long_t snapshot_key;
+
+	dxf_byte_t* events;
+	size_t events_capacity; /* in bytes */
+	dxf_event_params_t* params;
+	int params_capacity;
+	int count;
+} dx_event_batch_t;
+
 typedef struct {
 	struct {
 		dxf_event_data_t buffer;
 		int count;
 	} event_buffers[dx_eid_count];
 
+	/*
+	 *	The batches hold the events transcoded from the consecutive records of one record type and symbol,
+	 *  they are flushed in the order of their first events.
+	 */
+	dx_event_batch_t batches[dx_eid_count];
+	dx_event_id_t batch_order[dx_eid_count];
+	int batch_order_size;
+	dx_record_id_t batch_record_id;
+	dxf_const_string_t batch_symbol_name; /* the symbols are interned, so the same symbol has the same string */
+
+	/* the event types wanted by the subscriptions when the current record has started being transcoded */
+	unsigned wanted_event_types;
+
+	/* the counters are written by the thread processing the server data only */
+	long long transcoded_records;
+	long long skipped_records;
+	long long skipped_events;
+
 	dxf_connection_t connection;
 	void* rbcc;
 	void* dscc;
@@ -302,6 +338,11 @@ DX_CONNECTION_SUBSYS_DEINIT_PROTO(dx_ccs_record_transcoder) {
 			dx_free(context->event_buffers[i].buffer);
 	}
 
+	for (int i = dx_eid_begin; i < dx_eid_count; i++) {
+		CHECKED_FREE(context->batches[i].events);
+		CHECKED_FREE(context->batches[i].params);
+	}
+
 	dx_free(context);
 
 	return true;
@@ -354,6 +395,156 @@ dxf_event_data_t dx_get_event_data_buffer(dx_record_transcoder_connection_contex
 			(void**)&(context->event_buffers[event_id].buffer), &(context->event_buffers[event_id].count));
 }
 
+/* -------------------------------------------------------------------------- */
+/*
+ *	Event dispatching functions
+
+ *  the events are batched only while some subscription of the connection wants the batches,
+ *  otherwise each event is passed to the listeners as soon as it's transcoded
+ */
+/* -------------------------------------------------------------------------- */
+
+static int dx_flush_event_batches(dx_record_transcoder_connection_context_t* context) {
+	int order_size = context->batch_order_size;
+	int res = true;
+	int i = 0;
+
+	/* the batches are reset first, so that the events of a failed flush aren't passed again */
+	context->batch_order_size = 0;
+
+	for (; i < order_size; ++i) {
+		dx_event_id_t event_id = context->batch_order[i];
+		dx_event_batch_t* batch = context->batches + event_id;
+		int count = batch->count;
+
+		batch->count = 0;
+		res = dx_process_event_data_batch(context->connection, event_id, context->batch_symbol_name, batch->events,
+										  count, batch->params) && res;
+	}
+
+	return res;
+}
+
+/* -------------------------------------------------------------------------- */
+
+static int dx_is_event_batch_continued(const dx_record_transcoder_connection_context_t* context,
+									const dx_event_batch_t* batch, const dx_record_params_t* record_params,
+									const dxf_event_params_t* event_params) {
+	if (context->batch_order_size == 0) {
+		return true;
+	}
+
+	if (context->batch_record_id != record_params->record_id ||
+		context->batch_symbol_name != record_params->symbol_name) {
+		return false;
+	}
+
+	return batch->count == 0 || (batch->count < MAX_EVENT_BATCH_SIZE && batch->flags == event_params->flags &&
+		batch->snapshot_key == event_params->snapshot_key);
+}
+
+/* -------------------------------------------------------------------------- */
+
+static int dx_reserve_event_batch(dx_event_batch_t* batch, size_t event_size) {
+	size_t events_size = (size_t)(batch->count + 1) * event_size;
+
+	if (events_size > batch->events_capacity) {
+		size_t new_capacity = (batch->events_capacity == 0) ? event_size * 16 : batch->events_capacity * 2;
+		dxf_byte_t* new_events = NULL;
+
+		while (new_capacity < events_size) {
+			new_capacity *= 2;
+		}
+
+		if ((new_events = dx_calloc(1, new_capacity)) == NULL) {
+			return false;
+		}
+
+		if (batch->count > 0) {
+			dx_memcpy(new_events, batch->events, batch->count * event_size);
+		}
+
+		CHECKED_FREE(batch->events);
+
+		batch->events = new_events;
+		batch->events_capacity = new_capacity;
+	}
+
+	if (batch->count == batch->params_capacity) {
+		int new_capacity = (batch->params_capacity == 0) ? 16 : batch->params_capacity * 2;
+		dxf_event_params_t* new_params = dx_calloc(new_capacity, sizeof(dxf_event_params_t));
+
+		if (new_params == NULL) {
+			return false;
+		}
+
+		if (batch->count > 0) {
+			dx_memcpy(new_params, batch->params, batch->count * sizeof(dxf_event_params_t));
+		}
+
+		CHECKED_FREE(batch->params);
+
+		batch->params = new_params;
+		batch->params_capacity = new_capacity;
+	}
+
+	return true;
+}
+
+/* -------------------------------------------------------------------------- */
+
+static int dx_dispatch_event_data(dx_record_transcoder_connection_context_t* context, dx_event_id_t event_id,
+								const dx_record_params_t* record_params, dxf_const_event_data_t event_data,
+								const dxf_event_params_t* event_params) {
+	dx_event_batch_t* batch = context->batches + event_id;
+	size_t event_size = dx_event_sizes[event_id];
+
+	if (!dx_has_batching_subscriptions(context->connection)) {
+		/* the batching subscriptions may have been closed while the events were batched */
+		CHECKED_CALL(dx_flush_event_batches, context);
+
+		return dx_process_event_data(context->connection, event_id, record_params->symbol_name, event_data,
+									 event_params);
+	}
+
+	if (!dx_is_event_batch_continued(context, batch, record_params, event_params)) {
+		CHECKED_CALL(dx_flush_event_batches, context);
+	}
+
+	CHECKED_CALL_2(dx_reserve_event_batch, batch, event_size);
+
+	if (batch->count == 0) {
+		if (context->batch_order_size == 0) {
+			context->batch_record_id = record_params->record_id;
+			context->batch_symbol_name = record_params->symbol_name;
+		}
+
+		context->batch_order[context->batch_order_size++] = event_id;
+		batch->flags = event_params->flags;
+		batch->snapshot_key = event_params->snapshot_key;
+	}
+
+	dx_memcpy(batch->events + batch->count * event_size, event_data, event_size);
+	dx_copy_event_params(event_params, batch->params + batch->count);
+	batch->count++;
+
+	return true;
+}
+
+/* -------------------------------------------------------------------------- */
+
+/* counts the events of the type as skipped if no subscription wants them */
+static int dx_is_event_wanted(dx_record_transcoder_connection_context_t* context, dx_event_id_t event_id,
+							int event_count) {
+	if (context->wanted_event_types & DX_EVENT_BIT_MASK(event_id)) {
+		return true;
+	}
+
+	atomic_write(&context->skipped_events, context->skipped_events + event_count);
+
+	return false;
+}
+
 /* -------------------------------------------------------------------------- */
 /*
  *	Record transcoder macros and prototypes
@@ -413,8 +604,7 @@ static int dx_trade_t_transcoder_impl(dx_record_transcoder_connection_context_t*
 	event_buffer->is_eth = DX_TRADE_GET_ETH(record_buffer);
 	event_buffer->scope = (exchange_code == 0 ? dxf_osc_composite : dxf_osc_regional);
 
-	return dx_process_event_data(context->connection, event_id, record_params->symbol_name, event_buffer,
-								 event_params);
+	return dx_dispatch_event_data(context, event_id, record_params, event_buffer, event_params);
 }
 
 int RECORD_TRANSCODER_NAME(dx_trade_t) (dx_record_transcoder_connection_context_t* context,
@@ -458,8 +648,7 @@ int dx_transcode_quote_to_order_bid (dx_record_transcoder_connection_context_t*
 	dx_memset(event_buffer->source, 0, sizeof(event_buffer->source));
 	event_buffer->market_maker = NULL;
 
-	return dx_process_event_data(context->connection, dx_eid_order, record_params->symbol_name, event_buffer,
-								 event_params);
+	return dx_dispatch_event_data(context, dx_eid_order, record_params, event_buffer, event_params);
 }
 
 /* ---------------------------------- */
@@ -496,8 +685,7 @@ int dx_transcode_quote_to_order_ask (dx_record_transcoder_connection_context_t*
 	dx_memset(event_buffer->source, 0, sizeof(event_buffer->source));
 	event_buffer->market_maker = NULL;
 
-	return dx_process_event_data(context->connection, dx_eid_order, record_params->symbol_name, event_buffer,
-								 event_params);
+	return dx_dispatch_event_data(context, dx_eid_order, record_params, event_buffer, event_params);
 }
 
 /* ---------------------------------- */
@@ -530,8 +718,7 @@ int dx_transcode_quote (dx_record_transcoder_connection_context_t* context,
 	event_buffer->ask_size = record_buffer->ask_size;
 	event_buffer->scope = (exchange_code == 0 ? dxf_osc_composite : dxf_osc_regional);
 
-	return dx_process_event_data(context->connection, dx_eid_quote, record_params->symbol_name, event_buffer,
-								 event_params);
+	return dx_dispatch_event_data(context, dx_eid_quote, record_params, event_buffer, event_params);
 }
 
 /* ---------------------------------- */
@@ -554,16 +741,21 @@ int RECORD_TRANSCODER_NAME(dx_quote_t) (dx_record_transcoder_connection_context_
 		ask_event_params.flags = ask_event_params.flags ^ dxf_ef_snapshot_begin;
 	}
 
-	if (!dx_transcode_quote_to_order_bid(context, record_params, &bid_event_params, (dx_quote_t*)record_buffer)) {
-		return false;
-	}
+	/* the Order events derived from the quotes are transcoded only if some subscription wants the orders */
+	if (dx_is_event_wanted(context, dx_eid_order, 2)) {
+		if (!dx_transcode_quote_to_order_bid(context, record_params, &bid_event_params, (dx_quote_t*)record_buffer)) {
+			return false;
+		}
 
-	if (!dx_transcode_quote_to_order_ask(context, record_params, &ask_event_params, (dx_quote_t*)record_buffer)) {
-		return false;
+		if (!dx_transcode_quote_to_order_ask(context, record_params, &ask_event_params, (dx_quote_t*)record_buffer)) {
+			return false;
+		}
 	}
 
-	if (!dx_transcode_quote(context, record_params, event_params, (dx_quote_t*)record_buffer)) {
-		return false;
+	if (dx_is_event_wanted(context, dx_eid_quote, 1)) {
+		if (!dx_transcode_quote(context, record_params, event_params, (dx_quote_t*)record_buffer)) {
+			return false;
+		}
 	}
 
 	return true;
@@ -604,8 +796,7 @@ int RECORD_TRANSCODER_NAME(dx_summary_t) (dx_record_transcoder_connection_contex
 	event_buffer->prev_day_close_price_type = DX_SUMMARY_GET_PDCPT(record_buffer);
 	event_buffer->scope = (exchange_code == 0 ? dxf_osc_composite : dxf_osc_regional);
 
-	return dx_process_event_data(context->connection, dx_eid_summary, record_params->symbol_name, event_buffer,
-								 event_params);
+	return dx_dispatch_event_data(context, dx_eid_summary, record_params, event_buffer, event_params);
 }
 
 /* -------------------------------------------------------------------------- */
@@ -652,8 +843,7 @@ int RECORD_TRANSCODER_NAME(dx_profile_t) (dx_record_transcoder_connection_contex
 	event_buffer->trading_status = DX_PROFILE_GET_TS(record_buffer);
 	event_buffer->ssr = DX_PROFILE_GET_SSR(record_buffer);
 
-	return dx_process_event_data(context->connection, dx_eid_profile, record_params->symbol_name, event_buffer,
-								 event_params);
+	return dx_dispatch_event_data(context, dx_eid_profile, record_params, event_buffer, event_params);
 }
 
 /* -------------------------------------------------------------------------- */
@@ -676,8 +866,7 @@ int dx_transcode_market_maker_to_order_bid (dx_record_transcoder_connection_cont
 	event_buffer->time = DX_TIME_FIELD_TO_MS(record_buffer->mmbid_time);
 
 	if (IS_FLAG_SET(event_buffer->event_flags, dxf_ef_remove_event)) {
-		return dx_process_event_data(context->connection, dx_eid_order, record_params->symbol_name, event_buffer,
-									 event_params);
+		return dx_dispatch_event_data(context, dx_eid_order, record_params, event_buffer, event_params);
 	}
 
 	event_buffer->sequence = 0;
@@ -695,8 +884,7 @@ int dx_transcode_market_maker_to_order_bid (dx_record_transcoder_connection_cont
 		return false;
 	}
 
-	return dx_process_event_data(context->connection, dx_eid_order, record_params->symbol_name, event_buffer,
-								 event_params);
+	return dx_dispatch_event_data(context, dx_eid_order, record_params, event_buffer, event_params);
 }
 
 /* ---------------------------------- */
@@ -718,8 +906,7 @@ int dx_transcode_market_maker_to_order_ask (dx_record_transcoder_connection_cont
 	event_buffer->time = DX_TIME_FIELD_TO_MS(record_buffer->mmask_time);
 
 	if (IS_FLAG_SET(event_buffer->event_flags, dxf_ef_remove_event)) {
-		return dx_process_event_data(context->connection, dx_eid_order, record_params->symbol_name, event_buffer,
-									 event_params);
+		return dx_dispatch_event_data(context, dx_eid_order, record_params, event_buffer, event_params);
 	}
 
 	event_buffer->sequence = 0;
@@ -737,8 +924,7 @@ int dx_transcode_market_maker_to_order_ask (dx_record_transcoder_connection_cont
 		return false;
 	}
 
-	return dx_process_event_data(context->connection, dx_eid_order, record_params->symbol_name, event_buffer,
-								 event_params);
+	return dx_dispatch_event_data(context, dx_eid_order, record_params, event_buffer, event_params);
 }
 
 /* ---------------------------------- */
@@ -817,8 +1003,7 @@ int RECORD_TRANSCODER_NAME(dx_order_t) (dx_record_transcoder_connection_context_
 	event_buffer->time = DX_TIME_SEQ_TO_MS(record_buffer);
 
 	if (IS_FLAG_SET(event_buffer->event_flags, dxf_ef_remove_event)) {
-		return dx_process_event_data(context->connection, dx_eid_order, record_params->symbol_name, event_buffer,
-									 event_params);
+		return dx_dispatch_event_data(context, dx_eid_order, record_params, event_buffer, event_params);
 	}
 
 	event_buffer->sequence = DX_SEQUENCE(record_buffer);
@@ -848,8 +1033,7 @@ int RECORD_TRANSCODER_NAME(dx_order_t) (dx_record_transcoder_connection_context_
 		return false;
 	}
 
-	return dx_process_event_data(context->connection, dx_eid_order, record_params->symbol_name, event_buffer,
-								 event_params);
+	return dx_dispatch_event_data(context, dx_eid_order, record_params, event_buffer, event_params);
 }
 
 /* -------------------------------------------------------------------------- */
@@ -872,8 +1056,7 @@ int RECORD_TRANSCODER_NAME(dx_time_and_sale_t) (dx_record_transcoder_connection_
 	event_buffer->time = DX_TIME_SEQ_TO_MS(record_buffer);
 
 	if (IS_FLAG_SET(event_buffer->event_flags, dxf_ef_remove_event)) {
-		return dx_process_event_data(context->connection, dx_eid_time_and_sale, record_params->symbol_name, event_buffer,
-									 event_params);
+		return dx_dispatch_event_data(context, dx_eid_time_and_sale, record_params, event_buffer, event_params);
 	}
 
 	event_buffer->exchange_code = record_buffer->exchange_code;
@@ -911,8 +1094,7 @@ int RECORD_TRANSCODER_NAME(dx_time_and_sale_t) (dx_record_transcoder_connection_
 	event_buffer->is_spread_leg = DX_TNS_GET_SPREAD_LEG(record_buffer);
 	event_buffer->scope = (exchange_code == 0 ? dxf_osc_composite : dxf_osc_regional);
 
-	return dx_process_event_data(context->connection, dx_eid_time_and_sale, record_params->symbol_name, event_buffer,
-								 event_params);
+	return dx_dispatch_event_data(context, dx_eid_time_and_sale, record_params, event_buffer, event_params);
 }
 
 /* -------------------------------------------------------------------------- */
@@ -934,8 +1116,7 @@ int RECORD_TRANSCODER_NAME(dx_candle_t) (dx_record_transcoder_connection_context
 	event_buffer->time = DX_TIME_SEQ_TO_MS(record_buffer);
 
 	if (IS_FLAG_SET(event_buffer->event_flags, dxf_ef_remove_event)) {
-		return dx_process_event_data(context->connection, dx_eid_candle, record_params->symbol_name, event_buffer,
-									 event_params);
+		return dx_dispatch_event_data(context, dx_eid_candle, record_params, event_buffer, event_params);
 	}
 
 	event_buffer->sequence = DX_SEQUENCE(record_buffer);
@@ -951,8 +1132,7 @@ int RECORD_TRANSCODER_NAME(dx_candle_t) (dx_record_transcoder_connection_context
 	event_buffer->imp_volatility = record_buffer->imp_volatility;
 	event_buffer->open_interest = record_buffer->open_interest;
 
-	return dx_process_event_data(context->connection, dx_eid_candle, record_params->symbol_name, event_buffer,
-								 event_params);
+	return dx_dispatch_event_data(context, dx_eid_candle, record_params, event_buffer, event_params);
 }
 
 /* -------------------------------------------------------------------------- */
@@ -988,8 +1168,7 @@ int RECORD_TRANSCODER_NAME(dx_spread_order_t) (dx_record_transcoder_connection_c
 	event_buffer->time = DX_TIME_SEQ_TO_MS(record_buffer);
 
 	if (IS_FLAG_SET(event_buffer->event_flags, dxf_ef_remove_event)) {
-		return dx_process_event_data(context->connection, dx_eid_spread_order, record_params->symbol_name, event_buffer,
-									 event_params);
+		return dx_dispatch_event_data(context, dx_eid_spread_order, record_params, event_buffer, event_params);
 	}
 
 	event_buffer->sequence = DX_SEQUENCE(record_buffer);
@@ -1019,8 +1198,7 @@ int RECORD_TRANSCODER_NAME(dx_spread_order_t) (dx_record_transcoder_connection_c
 			return false;
 	}
 
-	return dx_process_event_data(context->connection, dx_eid_spread_order, record_params->symbol_name, event_buffer,
-								 event_params);
+	return dx_dispatch_event_data(context, dx_eid_spread_order, record_params, event_buffer, event_params);
 }
 
 /* -------------------------------------------------------------------------- */
@@ -1042,8 +1220,7 @@ int RECORD_TRANSCODER_NAME(dx_greeks_t) (dx_record_transcoder_connection_context
 	event_buffer->time = DX_TIME_SEQ_TO_MS(record_buffer);
 
 	if (IS_FLAG_SET(event_buffer->event_flags, dxf_ef_remove_event)) {
-		return dx_process_event_data(context->connection, dx_eid_greeks, record_params->symbol_name, event_buffer,
-									 event_params);
+		return dx_dispatch_event_data(context, dx_eid_greeks, record_params, event_buffer, event_params);
 	}
 
 	event_buffer->price = record_buffer->price;
@@ -1054,8 +1231,7 @@ int RECORD_TRANSCODER_NAME(dx_greeks_t) (dx_record_transcoder_connection_context
 	event_buffer->rho = record_buffer->rho;
 	event_buffer->vega = record_buffer->vega;
 
-	return dx_process_event_data(context->connection, dx_eid_greeks, record_params->symbol_name, event_buffer,
-								 event_params);
+	return dx_dispatch_event_data(context, dx_eid_greeks, record_params, event_buffer, event_params);
 }
 
 /* -------------------------------------------------------------------------- */
@@ -1068,8 +1244,7 @@ int RECORD_TRANSCODER_NAME(dx_theo_price_t) (dx_record_transcoder_connection_con
 
 	event_buffer->time = DX_TIME_FIELD_TO_MS(event_buffer->time);
 
-	return dx_process_event_data(context->connection, dx_eid_theo_price, record_params->symbol_name, event_buffer,
-								 event_params);
+	return dx_dispatch_event_data(context, dx_eid_theo_price, record_params, event_buffer, event_params);
 }
 
 /* -------------------------------------------------------------------------- */
@@ -1096,8 +1271,7 @@ int RECORD_TRANSCODER_NAME(dx_underlying_t) (dx_record_transcoder_connection_con
 	   : isnan(record_buffer->call_volume) ? record_buffer->put_volume : (record_buffer->put_volume + record_buffer->call_volume);
 	event_buffer->put_call_ratio = record_buffer->put_call_ratio;
 
-	return dx_process_event_data(context->connection, dx_eid_underlying, record_params->symbol_name, event_buffer,
-								 event_params);
+	return dx_dispatch_event_data(context, dx_eid_underlying, record_params, event_buffer, event_params);
 }
 
 /* -------------------------------------------------------------------------- */
@@ -1118,8 +1292,7 @@ int RECORD_TRANSCODER_NAME(dx_series_t)(dx_record_transcoder_connection_context_
 	event_buffer->time = DX_TIME_SEQ_TO_MS(record_buffer);
 
 	if (IS_FLAG_SET(event_buffer->event_flags, dxf_ef_remove_event)) {
-		return dx_process_event_data(context->connection, dx_eid_series, record_params->symbol_name, event_buffer,
-									 event_params);
+		return dx_dispatch_event_data(context, dx_eid_series, record_params, event_buffer, event_params);
 	}
 
 	event_buffer->sequence = DX_SEQUENCE(record_buffer);
@@ -1135,8 +1308,7 @@ int RECORD_TRANSCODER_NAME(dx_series_t)(dx_record_transcoder_connection_context_
 	event_buffer->dividend = record_buffer->dividend;
 	event_buffer->interest = record_buffer->interest;
 
-	return dx_process_event_data(context->connection, dx_eid_series, record_params->symbol_name, event_buffer,
-								 event_params);
+	return dx_dispatch_event_data(context, dx_eid_series, record_params, event_buffer, event_params);
 }
 
 /* -------------------------------------------------------------------------- */
@@ -1160,8 +1332,7 @@ int RECORD_TRANSCODER_NAME(dx_configuration_t) (dx_record_transcoder_connection_
 		return false;
 	}
 
-	return dx_process_event_data(context->connection, dx_eid_configuration, record_params->symbol_name, event_buffer,
-								 event_params);
+	return dx_dispatch_event_data(context, dx_eid_configuration, record_params, event_buffer, event_params);
 }
 
 /* -------------------------------------------------------------------------- */
@@ -1188,6 +1359,25 @@ static const dx_record_transcoder_t g_record_transcoders[dx_rid_count] = {
 	RECORD_TRANSCODER_NAME(dx_configuration_t)
 };
 
+/* The types of the events each record is transcoded into, the record is skipped if no subscription wants any of them */
+static const unsigned g_record_event_types[dx_rid_count] = {
+	DXF_ET_TRADE,
+	DXF_ET_QUOTE | DXF_ET_ORDER,
+	DXF_ET_SUMMARY,
+	DXF_ET_PROFILE,
+	DXF_ET_ORDER,
+	DXF_ET_ORDER,
+	DXF_ET_TIME_AND_SALE,
+	DXF_ET_CANDLE,
+	DXF_ET_TRADE_ETH,
+	DXF_ET_SPREAD_ORDER,
+	DXF_ET_GREEKS,
+	DXF_ET_THEO_PRICE,
+	DXF_ET_UNDERLYING,
+	DXF_ET_SERIES,
+	DXF_ET_CONFIGURATION
+};
+
 /* -------------------------------------------------------------------------- */
 
 int dx_transcode_record_data (dxf_connection_t connection,
@@ -1195,5 +1385,59 @@ int dx_transcode_record_data (dxf_connection_t connection,
 							const dxf_event_params_t* event_params,
 							void* record_buffer) {
 	dx_record_transcoder_connection_context_t* context = dx_get_subsystem_data(connection, dx_ccs_record_transcoder, NULL);
+
+	context->wanted_event_types = dx_get_wanted_event_types(connection);
+
+	if ((context->wanted_event_types & g_record_event_types[record_params->record_info_id]) == 0) {
+		atomic_write(&context->skipped_records, context->skipped_records + 1);
+
+		return true;
+	}
+
+	atomic_write(&context->transcoded_records, context->transcoded_records + 1);
+
 	return g_record_transcoders[record_params->record_info_id](context, record_params, event_params, record_buffer);
 }
+
+/* -------------------------------------------------------------------------- */
+
+int dx_flush_transcoded_events (dxf_connection_t connection) {
+	dx_record_transcoder_connection_context_t* context = dx_get_subsystem_data(connection, dx_ccs_record_transcoder, NULL);
+
+	return dx_flush_event_batches(context);
+}
+
+/* -------------------------------------------------------------------------- */
+
+int dx_has_pending_transcoded_events (dxf_connection_t connection) {
+	dx_record_transcoder_connection_context_t* context = dx_get_subsystem_data(connection, dx_ccs_record_transcoder, NULL);
+
+	return context->batch_order_size > 0;
+}
+
+/* -------------------------------------------------------------------------- */
+
+int dx_get_transcoding_statistics (dxf_connection_t connection, OUT dxf_transcoding_statistics_t* statistics) {
+	int res = true;
+	dx_record_transcoder_connection_context_t* context = NULL;
+
+	if (statistics == NULL) {
+		return dx_set_error_code(dx_ec_invalid_func_param);
+	}
+
+	context = dx_get_subsystem_data(connection, dx_ccs_record_transcoder, &res);
+
+	if (context == NULL) {
+		if (res) {
+			dx_set_error_code(dx_cec_connection_context_not_initialized);
+		}
+
+		return false;
+	}
+
+	statistics->transcoded_records = (dxf_ulong_t)atomic_read(&context->transcoded_records);
+	statistics->skipped_records = (dxf_ulong_t)atomic_read(&context->skipped_records);
+	statistics->skipped_events = (dxf_ulong_t)atomic_read(&context->skipped_events);
+
+	return true;
+}
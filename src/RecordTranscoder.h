@@ -34,6 +34,7 @@ typedef struct {
 	dxf_const_string_t suffix;
 	dxf_const_string_t symbol_name;
 	dxf_int_t symbol_cipher;
+	dxf_int_t symbol_id; /* the id of the symbol interned by the connection */
 	dxf_event_flags_t flags;
 	dxf_time_int_field_t time_int_field;
 } dx_record_params_t;
@@ -49,4 +50,18 @@ int dx_transcode_record_data (dxf_connection_t connection,
 							const dxf_event_params_t* event_params,
 							void* record_buffer);
 
+/*
+ *	While some subscription has the dx_esf_batch_events flag, the events are batched instead of being passed
+ *  to the listeners at once. The batched events refer to the strings of the record buffers, so the buffers
+ *  must not be freed until the events are flushed, which is done at the end of each data message.
+ */
+int dx_flush_transcoded_events (dxf_connection_t connection);
+int dx_has_pending_transcoded_events (dxf_connection_t connection);
+
+/*
+ *	The records are transcoded only into the events of the types some subscription of the connection wants,
+ *  the statistics count the records and the events skipped because of that.
+ */
+int dx_get_transcoding_statistics (dxf_connection_t connection, OUT dxf_transcoding_statistics_t* statistics);
+
 #endif /* RECORD_TRANSCODER_H_INCLUDED */
\ No newline at end of file
@@ -24,6 +24,7 @@
 #include <string.h>
 
 #include "BufferedInput.h"
+#include "Configuration.h"
 #include "Connection.h"
 #include "ConnectionContextData.h"
 #include "DXAlgorithms.h"
@@ -38,6 +39,7 @@
 #include "RecordTranscoder.h"
 #include "Snapshot.h"
 #include "SymbolCodec.h"
+#include "SymbolTable.h"
 
 /* -------------------------------------------------------------------------- */
 /*
@@ -50,12 +52,17 @@
 #define MIN_FIELD_TYPE_ID 0x00
 #define MAX_FIELD_TYPE_ID 0xFF
 
-#define DEFAULT_BUFFER_CAPACITY     16000
+#define DEFAULT_BUFFER_CAPACITY     (256 * 1024)
+#define MIN_BUFFER_CAPACITY         (16 * 1024)
+#define MIN_READ_CHUNK_SIZE         4096
 
 #define DESCRIBE_PROTOCOL_TIMEOUT   3000
 
 #define MRU_EVENT_FLAGS 1
 
+/* the table is cleared between the data messages when it holds that many symbols */
+#define MAX_INTERNED_SYMBOLS (1 << 20)
+
 #define DX_RECV_PROPERTY_AUTH L"authentication"
 #define DX_RECV_PROPERTY_LOGIN_REQUIRED L"LOGIN "
 
@@ -70,20 +77,91 @@ typedef struct {
 	int local_type; //
 	dx_record_field_setter_t setter;
 	dx_record_field_def_val_getter_t def_val_getter;
+	int offset;
+	int size;
 } dx_field_digest_t, *dx_field_digest_ptr_t;
 
+/*
+ *	The decode plan is compiled from the record digest when the record description is received.
+ *  Every operation reads a field in the server format and stores it in the local format at the offset
+ *  of the record structure field, so the field type dispatch is done once per record description.
+ */
+typedef enum {
+	dx_dop_default, /* the server doesn't send the field, the default value is stored */
+	dx_dop_byte,
+	dx_dop_byte_to_decimal,
+	dx_dop_byte_to_wide_decimal,
+	dx_dop_utf_char,
+	dx_dop_short,
+	dx_dop_short_to_decimal,
+	dx_dop_short_to_wide_decimal,
+	dx_dop_int,
+	dx_dop_int_to_decimal,
+	dx_dop_int_to_wide_decimal,
+	dx_dop_compact_int,
+	dx_dop_compact_int_to_double,
+	dx_dop_compact_decimal,
+	dx_dop_compact_decimal_to_int,
+	dx_dop_compact_long,
+	dx_dop_compact_wide_decimal,
+	dx_dop_compact_wide_decimal_to_int,
+	dx_dop_utf_string,
+	dx_dop_byte_array,
+	dx_dop_utf_char_array,
+	dx_dop_skip_byte_array,		/* the value isn't stored, so it's skipped without materializing */
+	dx_dop_skip_utf_char_array,
+	dx_dop_not_supported
+} dx_decode_opcode_t;
+
+typedef enum {
+	dx_dst_none,	/* the field is unknown locally, the value is only read */
+	dx_dst_direct,	/* the value is copied to the field offset */
+	dx_dst_setter	/* the value size differs from the field size, the setter converts it */
+} dx_decode_store_t;
+
+typedef struct {
+	dx_decode_opcode_t opcode;
+	dx_decode_store_t store;
+	int offset;
+	int size;
+	dx_record_field_setter_t setter;
+	const void* default_value;
+} dx_decode_op_t;
+
 typedef struct {
 	dx_field_digest_ptr_t* elements;
 	int size;
 	int in_sync_with_server;
+
+	dx_decode_op_t* plan;
+	int plan_size;
 } dx_record_digest_t;
 
+/*
+ *	The record digests are published as immutable lists, so that the thread processing the data messages
+ *  reads them without locking. Every change creates a new list, the replaced list (and the replaced digests)
+ *  are retired and freed only when the reader is known not to use them any more.
+ */
 typedef struct {
-	dx_record_digest_t* elements;
+	dx_record_digest_t** elements;
 	size_t size;
-	size_t capacity;
 } dx_record_digest_list_t;
 
+typedef struct dx_retired_record_digests_tag {
+	dx_record_digest_list_t* list;
+	int owns_digests;	/* the digests of the list are retired together with it */
+	dx_record_digest_t* digest;
+	long long epoch;	/* the digests epoch at the moment of the retirement */
+
+	struct dx_retired_record_digests_tag* next;
+} dx_retired_record_digests_t;
+
+/* the reader epoch value meaning that the reader doesn't hold any list */
+#define DX_IDLE_READER_EPOCH LLONG_MAX
+
+/* the records are decoded by the field by field code instead of the plans if it's reset */
+static volatile int g_record_decode_plans_enabled = true;
+
 /* -------------------------------------------------------------------------- */
 /*
  *	Message support data
@@ -114,14 +192,19 @@ typedef struct {
 	dxf_char_t symbol_buffer[SYMBOL_BUFFER_LEN + 1];
 	dxf_string_t symbol_result;
 
-	dxf_string_t last_symbol;
+	dx_symbol_table_t symbol_table;
+	dxf_const_string_t last_symbol; /* interned in the symbol table */
+	dxf_int_t last_symbol_id;
 	dxf_int_t last_cipher;
 	dxf_event_flags_t last_flags;
 	dxf_event_flags_t mru_event_flags;
 
 	dx_record_server_support_state_list_t* record_server_support_states;
-	dx_record_digest_list_t record_digests;
-	dx_mutex_t record_digests_guard;
+	dx_record_digest_list_t* record_digests; /* the current list, NULL until the first record is added */
+	dx_mutex_t record_digests_guard; /* serializes the list replacements, never taken by the reader */
+	long long record_digests_epoch;
+	long long reader_epoch; /* the epoch the reader has entered with or DX_IDLE_READER_EPOCH */
+	dx_retired_record_digests_t* retired_record_digests;
 
 	void* bicc; /* buffered input connection context */
 	void* rbcc; /* record buffers connection context */
@@ -140,14 +223,6 @@ typedef struct {
 
 /* -------------------------------------------------------------------------- */
 
-void dx_init_record_digests_list(dx_record_digest_list_t* record_digests) {
-	if (record_digests == NULL)
-		return;
-	record_digests->elements = NULL;
-	record_digests->size = 0;
-	record_digests->capacity = 0;
-}
-
 DX_CONNECTION_SUBSYS_INIT_PROTO(dx_ccs_server_msg_processor) {
 	dx_server_msg_proc_connection_context_t* context = NULL;
 
@@ -160,7 +235,7 @@ DX_CONNECTION_SUBSYS_INIT_PROTO(dx_ccs_server_msg_processor) {
 	}
 
 	context->connection = connection;
-	dx_init_record_digests_list(&(context->record_digests));
+	context->reader_epoch = DX_IDLE_READER_EPOCH;
 
 	if (!dx_mutex_create(&context->record_digests_guard)) {
 		dx_free(context);
@@ -178,7 +253,8 @@ DX_CONNECTION_SUBSYS_INIT_PROTO(dx_ccs_server_msg_processor) {
 		return dx_set_error_code(dx_cec_connection_context_not_initialized);
 	}
 
-	context->buffer = dx_malloc(DEFAULT_BUFFER_CAPACITY);
+	context->buffer_capacity = MAX(dx_get_network_receive_buffer_size(DEFAULT_BUFFER_CAPACITY), MIN_BUFFER_CAPACITY);
+	context->buffer = dx_malloc(context->buffer_capacity);
 
 	if (context->buffer == NULL) {
 		dx_free(context);
@@ -186,7 +262,12 @@ DX_CONNECTION_SUBSYS_INIT_PROTO(dx_ccs_server_msg_processor) {
 		return false;
 	}
 
-	context->buffer_capacity = DEFAULT_BUFFER_CAPACITY;
+	if ((context->symbol_table = dx_create_symbol_table()) == NULL) {
+		dx_free(context->buffer);
+		dx_free(context);
+
+		return false;
+	}
 
 	context->describe_protocol_status = dx_dps_not_sent;
 
@@ -211,7 +292,7 @@ DX_CONNECTION_SUBSYS_INIT_PROTO(dx_ccs_server_msg_processor) {
 
 /* -------------------------------------------------------------------------- */
 
-void dx_clear_record_digests (dx_server_msg_proc_connection_context_t* context);
+void dx_free_record_digests (dx_server_msg_proc_connection_context_t* context);
 
 DX_CONNECTION_SUBSYS_DEINIT_PROTO(dx_ccs_server_msg_processor) {
 	int res = true;
@@ -222,10 +303,12 @@ DX_CONNECTION_SUBSYS_DEINIT_PROTO(dx_ccs_server_msg_processor) {
 	}
 
 	CHECKED_FREE(context->buffer);
-	CHECKED_FREE(context->last_symbol);
 	CHECKED_FREE(context->raw_dump_file_name);
 
-	dx_clear_record_digests(context);
+	dx_free_symbol_table(context->symbol_table);
+
+	dx_free_record_digests(context);
+	dx_mutex_destroy(&context->record_digests_guard);
 	dx_property_map_free_collection(&context->recv_props);
 	dx_free(context);
 
@@ -244,18 +327,14 @@ DX_CONNECTION_SUBSYS_CHECK_PROTO(dx_ccs_server_msg_processor) {
  */
 /* -------------------------------------------------------------------------- */
 
-dx_record_digest_t* dx_get_record_digest(dx_server_msg_proc_connection_context_t* context, dx_record_id_t record_id) {
-	dx_record_digest_list_t* record_digests = NULL;
-	if (context == NULL)
-		return NULL;
-	record_digests = &(context->record_digests);
-	if (record_digests->elements == NULL || record_id < 0 || record_id >= (dx_record_id_t)record_digests->size)
+const dx_record_digest_t* dx_get_record_digest(const dx_record_digest_list_t* record_digests, dx_record_id_t record_id) {
+	if (record_digests == NULL || record_id < 0 || record_id >= (dx_record_id_t)record_digests->size)
 		return NULL;
-	return &(record_digests->elements[record_id]);
+	return record_digests->elements[record_id];
 }
 
 int dx_create_field_digest (dx_server_msg_proc_connection_context_t* context,
-							dx_record_id_t record_id, const dx_record_item_t* record_info,
+							dx_record_id_t record_id, const dx_record_item_t* record_info, int skipped_fields,
 							OUT dx_field_digest_ptr_t* field_digest) {
 	dxf_string_t field_name = NULL;
 	dxf_int_t field_type;
@@ -286,9 +365,14 @@ int dx_create_field_digest (dx_server_msg_proc_connection_context_t* context,
 	field_index = dx_find_record_field(record_info, field_name, field_type);
 	dx_free(field_name);
 
+	/* the skipped field is read as unknown, and gets the default value as a field not sent by the server */
+	if (field_index != INVALID_INDEX && IS_FLAG_SET(skipped_fields, INDEX_BITMASK(field_index))) {
+		field_index = INVALID_INDEX;
+	}
+
 	*field_digest = dx_calloc(1, sizeof(dx_field_digest_t));
 
-	if (field_digest == NULL) {
+	if (*field_digest == NULL) {
 		return false;
 	}
 
@@ -296,6 +380,8 @@ int dx_create_field_digest (dx_server_msg_proc_connection_context_t* context,
 
 	if (field_index != INVALID_INDEX) {
 		(*field_digest)->setter = record_info->fields[field_index].setter;
+		(*field_digest)->offset = record_info->fields[field_index].offset;
+		(*field_digest)->size = record_info->fields[field_index].size;
 		if (!dx_get_record_server_support_state_value(context->record_server_support_states, record_id, &state)) {
 			return false;
 		}
@@ -309,8 +395,8 @@ int dx_create_field_digest (dx_server_msg_proc_connection_context_t* context,
 /* -------------------------------------------------------------------------- */
 
 int dx_digest_unsupported_fields (dx_server_msg_proc_connection_context_t* context,
-								dx_record_id_t record_id, const dx_record_item_t* record_info) {
-	dx_record_digest_t* record_digest = NULL;
+								dx_record_id_t record_id, const dx_record_item_t* record_info, int skipped_fields,
+								OUT dx_record_digest_t* record_digest) {
 	int field_index = 0;
 
 	if (record_id < 0) {
@@ -319,10 +405,6 @@ int dx_digest_unsupported_fields (dx_server_msg_proc_connection_context_t* conte
 		return true;
 	}
 
-	record_digest = dx_get_record_digest(context, record_id);
-	if (record_digest == NULL)
-		return dx_set_error_code(dx_ec_invalid_func_param_internal);
-
 	for (; field_index < record_info->field_count; ++field_index) {
 		dx_field_digest_ptr_t field_digest = NULL;
 		dx_record_server_support_state_t* state;
@@ -330,7 +412,7 @@ int dx_digest_unsupported_fields (dx_server_msg_proc_connection_context_t* conte
 			return false;
 		}
 
-		if (*state & INDEX_BITMASK(field_index)) {
+		if ((*state & INDEX_BITMASK(field_index)) && !IS_FLAG_SET(skipped_fields, INDEX_BITMASK(field_index))) {
 			/* the field is supported by server, skipping */
 
 			continue;
@@ -344,6 +426,8 @@ int dx_digest_unsupported_fields (dx_server_msg_proc_connection_context_t* conte
 
 		field_digest->setter = record_info->fields[field_index].setter;
 		field_digest->def_val_getter = record_info->fields[field_index].def_val_getter;
+		field_digest->offset = record_info->fields[field_index].offset;
+		field_digest->size = record_info->fields[field_index].size;
 
 		record_digest->elements[(record_digest->size)++] = field_digest;
 	}
@@ -353,12 +437,168 @@ int dx_digest_unsupported_fields (dx_server_msg_proc_connection_context_t* conte
 
 /* -------------------------------------------------------------------------- */
 
+static int dx_is_double_representation(int representation) {
+	return representation == dx_fid_flag_decimal || representation == dx_fid_flag_wide_decimal;
+}
+
+/* -------------------------------------------------------------------------- */
+
+/* Selects the operation and the size of the value it produces, zero size means the size of the field */
+static void dx_select_decode_opcode(const dx_field_digest_t* field_digest, OUT dx_decode_opcode_t* opcode,
+									OUT int* value_size) {
+	int serialization = field_digest->type & dx_fid_mask_serialization;
+	int representation = field_digest->type & dx_fid_mask_representation;
+	int is_local_double = dx_is_double_representation(field_digest->local_type & dx_fid_mask_representation);
+
+	switch (serialization) {
+	case dx_fid_void:
+		*opcode = dx_dop_default;
+		*value_size = 0;
+
+		break;
+	case dx_fid_byte:
+		if (dx_is_double_representation(representation)) {
+			*opcode = representation == dx_fid_flag_decimal ? dx_dop_byte_to_decimal : dx_dop_byte_to_wide_decimal;
+			*value_size = sizeof(dxf_double_t);
+		} else {
+			*opcode = dx_dop_byte;
+			*value_size = sizeof(dxf_byte_t);
+		}
+
+		break;
+	case dx_fid_utf_char:
+		/* No special presentation bits are supported for UTF char */
+		*opcode = dx_dop_utf_char;
+		*value_size = sizeof(dxf_char_t);
+
+		break;
+	case dx_fid_short:
+		if (dx_is_double_representation(representation)) {
+			*opcode = representation == dx_fid_flag_decimal ? dx_dop_short_to_decimal : dx_dop_short_to_wide_decimal;
+			*value_size = sizeof(dxf_double_t);
+		} else {
+			*opcode = dx_dop_short;
+			*value_size = sizeof(dxf_short_t);
+		}
+
+		break;
+	case dx_fid_int:
+		if (dx_is_double_representation(representation)) {
+			*opcode = representation == dx_fid_flag_decimal ? dx_dop_int_to_decimal : dx_dop_int_to_wide_decimal;
+			*value_size = sizeof(dxf_double_t);
+		} else {
+			*opcode = dx_dop_int;
+			*value_size = sizeof(dxf_int_t);
+		}
+
+		break;
+	case dx_fid_compact_int:
+		if (representation == dx_fid_flag_long || representation == dx_fid_flag_time_millis) {
+			*opcode = dx_dop_compact_long;
+			*value_size = sizeof(dxf_long_t);
+		} else if (representation == dx_fid_flag_wide_decimal) {
+			*opcode = is_local_double ? dx_dop_compact_wide_decimal : dx_dop_compact_wide_decimal_to_int;
+			*value_size = is_local_double ? sizeof(dxf_double_t) : sizeof(dxf_int_t);
+		} else if (representation == dx_fid_flag_decimal) {
+			*opcode = is_local_double ? dx_dop_compact_decimal : dx_dop_compact_decimal_to_int;
+			*value_size = is_local_double ? sizeof(dxf_double_t) : sizeof(dxf_int_t);
+		} else {
+			*opcode = is_local_double ? dx_dop_compact_int_to_double : dx_dop_compact_int;
+			*value_size = is_local_double ? sizeof(dxf_double_t) : sizeof(dxf_int_t);
+		}
+
+		break;
+	case dx_fid_byte_array:
+		if (representation == dx_fid_flag_string) {
+			/* Treat as UTF char array with length in bytes */
+			*opcode = dx_dop_utf_string;
+			*value_size = sizeof(dxf_string_t);
+		} else {
+			/*
+			 * Objects goes as byte array to. According to specification (DESCRIBE_RECORDS.txt):
+			 * Unsupported values in those bits are reserved and MUST be ignored.
+			 * such field SHOULD be treated as PLAIN.
+			 */
+			*opcode = dx_dop_byte_array;
+			*value_size = sizeof(dxf_byte_array_t);
+		}
+
+		break;
+	case dx_fid_utf_char_array:
+		*opcode = dx_dop_utf_char_array;
+		*value_size = sizeof(dxf_string_t);
+
+		break;
+	default:
+		/* the error is reported when the record data is received */
+		*opcode = dx_dop_not_supported;
+		*value_size = 0;
+	}
+}
+
+/* -------------------------------------------------------------------------- */
+
+static int dx_compile_decode_plan(dx_record_digest_t* record_digest) {
+	int i = 0;
+
+	CHECKED_FREE(record_digest->plan);
+	record_digest->plan_size = 0;
+
+	if (record_digest->size == 0) {
+		return true;
+	}
+
+	record_digest->plan = dx_calloc(record_digest->size, sizeof(dx_decode_op_t));
+
+	if (record_digest->plan == NULL) {
+		return false;
+	}
+
+	for (; i < record_digest->size; ++i) {
+		const dx_field_digest_t* field_digest = record_digest->elements[i];
+		dx_decode_op_t* op = record_digest->plan + i;
+		int value_size = 0;
+
+		dx_select_decode_opcode(field_digest, &op->opcode, &value_size);
+
+		op->offset = field_digest->offset;
+		op->size = field_digest->size;
+		op->setter = field_digest->setter;
+
+		if (op->opcode == dx_dop_default) {
+			op->default_value = field_digest->def_val_getter != NULL ? field_digest->def_val_getter() : NULL;
+		}
+
+		if (op->setter == NULL || (op->opcode == dx_dop_default && op->default_value == NULL)) {
+			op->store = dx_dst_none;
+
+			if (op->opcode == dx_dop_utf_string || op->opcode == dx_dop_byte_array) {
+				op->opcode = dx_dop_skip_byte_array;
+			} else if (op->opcode == dx_dop_utf_char_array) {
+				op->opcode = dx_dop_skip_utf_char_array;
+			}
+		} else if (value_size == 0 || value_size == op->size) {
+			op->store = dx_dst_direct;
+		} else {
+			op->store = dx_dst_setter;
+		}
+	}
+
+	record_digest->plan_size = record_digest->size;
+
+	return true;
+}
+
+/* -------------------------------------------------------------------------- */
+
 void dx_init_record_digest(dx_record_digest_t* digest) {
 	if (digest == NULL)
 		return;
 	digest->elements = NULL;
 	digest->size = 0;
 	digest->in_sync_with_server = false;
+	digest->plan = NULL;
+	digest->plan_size = 0;
 }
 
 /* -------------------------------------------------------------------------- */
@@ -375,43 +615,255 @@ void dx_clear_record_digest (dx_record_digest_t* digest) {
 	}
 
 	CHECKED_FREE(digest->elements);
+	CHECKED_FREE(digest->plan);
 
 	dx_init_record_digest(digest);
 }
 
 /* -------------------------------------------------------------------------- */
 
-void dx_clear_record_digests (dx_server_msg_proc_connection_context_t* context) {
-	if (!dx_mutex_lock(&(context->record_digests_guard))) {
+dx_record_digest_t* dx_create_record_digest (void) {
+	dx_record_digest_t* digest = dx_malloc(sizeof(dx_record_digest_t));
+
+	dx_init_record_digest(digest);
+
+	return digest;
+}
+
+/* -------------------------------------------------------------------------- */
+
+void dx_free_record_digest (dx_record_digest_t* digest) {
+	if (digest == NULL) {
 		return;
 	}
 
-	if (context->record_digests.elements == NULL) {
-		dx_mutex_unlock(&(context->record_digests_guard));
+	dx_clear_record_digest(digest);
+	dx_free(digest);
+}
+
+/* -------------------------------------------------------------------------- */
+/*
+ *	Record digest list functions
+ */
+/* -------------------------------------------------------------------------- */
 
+void dx_free_record_digest_list (dx_record_digest_list_t* list, int free_digests) {
+	size_t i = 0;
+
+	if (list == NULL) {
 		return;
 	}
 
-	dx_record_id_t count = (dx_record_id_t)context->record_digests.size;
-	for (dx_record_id_t i = 0; i < count; ++i) {
-		dx_record_digest_t* record_digest = dx_get_record_digest(context, i);
-		if (record_digest == NULL)
+	if (free_digests) {
+		for (; i < list->size; ++i) {
+			dx_free_record_digest(list->elements[i]);
+		}
+	}
+
+	CHECKED_FREE(list->elements);
+	dx_free(list);
+}
+
+/* -------------------------------------------------------------------------- */
+
+/*
+ *	Creates a list of the given size sharing the digests of the source list. The elements missing in the source
+ *  list get new empty digests, so do all the elements if the source digests aren't to be shared.
+ */
+dx_record_digest_list_t* dx_copy_record_digest_list (const dx_record_digest_list_t* source, size_t size,
+													int share_digests) {
+	dx_record_digest_list_t* list = dx_calloc(1, sizeof(dx_record_digest_list_t));
+	size_t i = 0;
+
+	if (list == NULL) {
+		return NULL;
+	}
+
+	if (size > 0 && (list->elements = dx_calloc(size, sizeof(dx_record_digest_t*))) == NULL) {
+		dx_free(list);
+
+		return NULL;
+	}
+
+	for (; i < size; ++i) {
+		if (share_digests && source != NULL && i < source->size) {
+			list->elements[i] = source->elements[i];
+		} else if ((list->elements[i] = dx_create_record_digest()) == NULL) {
+			size_t created_from = (share_digests && source != NULL) ? MIN(source->size, i) : 0;
+
+			for (; created_from < i; ++created_from) {
+				dx_free_record_digest(list->elements[created_from]);
+			}
+
+			dx_free_record_digest_list(list, false);
+
+			return NULL;
+		}
+	}
+
+	list->size = size;
+
+	return list;
+}
+
+/* -------------------------------------------------------------------------- */
+
+/* Frees the retired lists and digests the reader is done with. Must be called under the guard */
+void dx_reclaim_record_digests (dx_server_msg_proc_connection_context_t* context) {
+	long long reader_epoch = atomic_read(&context->reader_epoch);
+	dx_retired_record_digests_t** link = &context->retired_record_digests;
+
+	while (*link != NULL) {
+		dx_retired_record_digests_t* retired = *link;
+
+		/* the reader having entered before the retirement may still use the retired list */
+		if (reader_epoch != DX_IDLE_READER_EPOCH && reader_epoch <= retired->epoch) {
+			link = &retired->next;
+
 			continue;
-		dx_clear_record_digest(record_digest);
+		}
+
+		dx_atomic_write_ptr((void* volatile*)link, retired->next);
+		dx_free_record_digest_list(retired->list, retired->owns_digests);
+		dx_free_record_digest(retired->digest);
+		dx_free(retired);
 	}
+}
+
+/* -------------------------------------------------------------------------- */
+
+/*
+ *	Replaces the current list with the new one, retiring the replaced list and the replaced digest if any.
+ *  Must be called under the guard. The new list is freed in case of failure, along with its digests
+ *  if they are replacing the retired ones.
+ */
+int dx_publish_record_digests (dx_server_msg_proc_connection_context_t* context, dx_record_digest_list_t* list,
+								int retire_digests, dx_record_digest_t* retired_digest) {
+	dx_record_digest_list_t* old_list = context->record_digests;
+	dx_retired_record_digests_t* retired = NULL;
 
-	dx_free(context->record_digests.elements);
-	dx_init_record_digests_list(&(context->record_digests));
-	dx_mutex_unlock(&(context->record_digests_guard));
+	if (old_list != NULL || retired_digest != NULL) {
+		retired = dx_calloc(1, sizeof(dx_retired_record_digests_t));
+
+		if (retired == NULL) {
+			dx_free_record_digest_list(list, retire_digests);
+
+			return false;
+		}
+
+		retired->list = old_list;
+		retired->owns_digests = retire_digests;
+		retired->digest = retired_digest;
+		retired->epoch = context->record_digests_epoch;
+		retired->next = context->retired_record_digests;
+	}
+
+	dx_atomic_write_ptr((void* volatile*)&context->record_digests, list);
+
+	if (retired != NULL) {
+		dx_atomic_write_ptr((void* volatile*)&context->retired_record_digests, retired);
+	}
+
+	/* the reader entering from now on can't get the retired list */
+	atomic_write(&context->record_digests_epoch, context->record_digests_epoch + 1);
+	dx_reclaim_record_digests(context);
+
+	return true;
 }
 
 /* -------------------------------------------------------------------------- */
 
-void dx_init_record_digests(dx_server_msg_proc_connection_context_t* context) {
-	dx_record_id_t i;
-	dx_record_id_t count = dx_get_records_list_count(context->dscc);
-	for (i = 0; i < count; i++) {
-		dx_add_record_digest_to_list(context->connection, i);
+/* Replaces all the digests with the empty ones, so the records are to be described by the server again */
+int dx_reset_record_digests (dx_server_msg_proc_connection_context_t* context) {
+	dx_record_digest_list_t* list = NULL;
+	int res = true;
+
+	CHECKED_CALL(dx_mutex_lock, &(context->record_digests_guard));
+
+	list = dx_copy_record_digest_list(NULL, (size_t)dx_get_records_list_count(context->dscc), false);
+
+	res = list != NULL && dx_publish_record_digests(context, list, true, NULL);
+
+	return dx_mutex_unlock(&(context->record_digests_guard)) && res;
+}
+
+/* -------------------------------------------------------------------------- */
+
+/* Replaces the digest of the record with the one filled from the server description */
+int dx_replace_record_digest (dx_server_msg_proc_connection_context_t* context, dx_record_id_t record_id,
+							dx_record_digest_t* digest) {
+	const dx_record_digest_list_t* old_list = NULL;
+	dx_record_digest_list_t* list = NULL;
+	dx_record_digest_t* old_digest = NULL;
+	int res = true;
+
+	if (!dx_mutex_lock(&(context->record_digests_guard))) {
+		dx_free_record_digest(digest);
+
+		return false;
+	}
+
+	old_list = context->record_digests;
+	list = dx_copy_record_digest_list(old_list, MAX(old_list == NULL ? 0 : old_list->size, (size_t)record_id + 1), true);
+
+	if (list == NULL) {
+		dx_free_record_digest(digest);
+		res = false;
+	} else {
+		old_digest = list->elements[record_id];
+		list->elements[record_id] = digest;
+
+		if (old_list == NULL || (size_t)record_id >= old_list->size) {
+			/* the replaced digest has just been created and isn't visible to the reader */
+			dx_free_record_digest(old_digest);
+			old_digest = NULL;
+		}
+
+		if (!dx_publish_record_digests(context, list, false, old_digest)) {
+			dx_free_record_digest(digest);
+			res = false;
+		}
+	}
+
+	return dx_mutex_unlock(&(context->record_digests_guard)) && res;
+}
+
+/* -------------------------------------------------------------------------- */
+
+void dx_free_record_digests (dx_server_msg_proc_connection_context_t* context) {
+	while (context->retired_record_digests != NULL) {
+		dx_retired_record_digests_t* retired = context->retired_record_digests;
+
+		context->retired_record_digests = retired->next;
+		dx_free_record_digest_list(retired->list, retired->owns_digests);
+		dx_free_record_digest(retired->digest);
+		dx_free(retired);
+	}
+
+	dx_free_record_digest_list(context->record_digests, true);
+	context->record_digests = NULL;
+}
+
+/* -------------------------------------------------------------------------- */
+
+/* Makes the current list available to the reader until it leaves it */
+const dx_record_digest_list_t* dx_enter_record_digests (dx_server_msg_proc_connection_context_t* context) {
+	atomic_write(&context->reader_epoch, atomic_read(&context->record_digests_epoch));
+
+	return dx_atomic_read_ptr((void* volatile*)&context->record_digests);
+}
+
+/* -------------------------------------------------------------------------- */
+
+void dx_leave_record_digests (dx_server_msg_proc_connection_context_t* context) {
+	atomic_write(&context->reader_epoch, DX_IDLE_READER_EPOCH);
+
+	/* the lists retired while the reader was using them are freed here */
+	if (dx_atomic_read_ptr((void* volatile*)&context->retired_record_digests) != NULL &&
+		dx_mutex_lock(&(context->record_digests_guard))) {
+
+		dx_reclaim_record_digests(context);
+		dx_mutex_unlock(&(context->record_digests_guard));
 	}
 }
 
@@ -445,9 +897,8 @@ int dx_clear_server_info (dxf_connection_t connection) {
 		*state = 0;
 	}
 
-	/* stage 2 - freeing all the memory allocated by previous synchronization */
-	dx_clear_record_digests(context);
-	dx_init_record_digests(context);
+	/* stage 2 - replacing the digests filled by previous synchronization */
+	CHECKED_CALL(dx_reset_record_digests, context);
 
 	/* stage 3 - dropping all the info about supported message types */
 	CHECKED_CALL(dx_mutex_lock, &(context->describe_protocol_guard));
@@ -847,21 +1298,27 @@ static int dx_read_symbol (dx_server_msg_proc_connection_context_t* context) {
 
 	if ((r & dx_get_codec_valid_cipher()) != 0) {
 		context->last_cipher = r;
-		CHECKED_FREE(context->last_symbol);
-		context->last_symbol = NULL;
+
+		CHECKED_CALL_4(dx_intern_cipher_symbol, context->symbol_table, r,
+			&(context->last_symbol), &(context->last_symbol_id));
 	} else if (r > 0) {
 		context->last_cipher = 0;
-		CHECKED_FREE(context->last_symbol);
-		context->last_symbol = dx_create_string_src_len(context->symbol_buffer, r);
 
-		if (context->last_symbol == NULL) {
-			return false;
-		}
+		CHECKED_CALL_5(dx_intern_string_symbol, context->symbol_table, context->symbol_buffer, r,
+			&(context->last_symbol), &(context->last_symbol_id));
 	} else {
 		if (context->symbol_result != NULL) {
-			context->last_symbol = context->symbol_result;
+			/* the rare long or UTF-8 symbols are still allocated by the codec */
+			int res = dx_intern_string_symbol(context->symbol_table, context->symbol_result,
+				(int)dx_string_length(context->symbol_result), &(context->last_symbol), &(context->last_symbol_id));
+
+			dx_free(context->symbol_result);
 			context->symbol_result = NULL;
 
+			if (!res) {
+				return false;
+			}
+
 			context->last_cipher = dx_encode_symbol_name(context->last_symbol);
 		}
 		if (context->last_cipher == 0 && context->last_symbol == NULL)
@@ -906,33 +1363,200 @@ int dx_read_qdtime_on_remove_event(dx_server_msg_proc_connection_context_t* cont
 	return true;
 }
 
-int dx_read_records (dx_server_msg_proc_connection_context_t* context,
-					dx_record_id_t record_id, void* record_buffer) {
-	int i = 0;
+#define DX_STORE_DECODED_VALUE(op, record_buffer, value) \
+	if ((op)->store == dx_dst_direct) { \
+		memcpy((dxf_byte_t*)(record_buffer) + (op)->offset, &(value), sizeof(value)); \
+	} else if ((op)->store == dx_dst_setter) { \
+		(op)->setter(record_buffer, &(value)); \
+	}
+
+static int dx_execute_decode_plan (dx_server_msg_proc_connection_context_t* context,
+								const dx_record_digest_t* record_digest, void* record_buffer) {
+	const dx_decode_op_t* op = record_digest->plan;
+	const dx_decode_op_t* plan_end = record_digest->plan + record_digest->plan_size;
+	void* bicc = context->bicc;
 	dxf_byte_t read_byte;
 	dxf_short_t read_short;
 	dxf_int_t read_int;
 	dxf_long_t read_long;
 	dxf_char_t read_utf_char;
-	(void)read_utf_char;
 	dxf_double_t read_double;
 	dxf_string_t read_string;
 	dxf_byte_array_t read_byte_array;
 
-	if (IS_FLAG_SET(context->last_flags, dxf_ef_remove_event)) {
-		return dx_read_qdtime_on_remove_event(context, record_id, record_buffer);
-	}
+	for (; op != plan_end; ++op) {
+		switch (op->opcode) {
+		case dx_dop_default:
+			if (op->store == dx_dst_direct) {
+				memcpy((dxf_byte_t*)record_buffer + op->offset, op->default_value, op->size);
+			}
 
-	CHECKED_CALL(dx_mutex_lock, &(context->record_digests_guard));
+			break;
+		case dx_dop_byte:
+			CHECKED_CALL_2(dx_read_byte, bicc, &read_byte);
+			DX_STORE_DECODED_VALUE(op, record_buffer, read_byte)
 
-	const dx_record_digest_t* record_digest = dx_get_record_digest(context, record_id);
+			break;
+		case dx_dop_byte_to_decimal:
+			CHECKED_CALL_2(dx_read_byte, bicc, &read_byte);
+			CHECKED_CALL_2(dx_decimal_int_to_double, read_byte, &read_double);
+			DX_STORE_DECODED_VALUE(op, record_buffer, read_double)
 
-	if (record_digest == NULL) {
-		CHECKED_CALL(dx_mutex_unlock, &(context->record_digests_guard));
+			break;
+		case dx_dop_byte_to_wide_decimal:
+			CHECKED_CALL_2(dx_read_byte, bicc, &read_byte);
+			CHECKED_CALL_2(dx_wide_decimal_long_to_double, read_byte, &read_double);
+			DX_STORE_DECODED_VALUE(op, record_buffer, read_double)
 
-		return dx_set_error_code(dx_ec_invalid_func_param_internal);
+			break;
+		case dx_dop_utf_char:
+			CHECKED_CALL_2(dx_read_utf_char, bicc, &read_int);
+
+			read_utf_char = read_int;
+
+			DX_STORE_DECODED_VALUE(op, record_buffer, read_utf_char)
+
+			break;
+		case dx_dop_short:
+			CHECKED_CALL_2(dx_read_short, bicc, &read_short);
+			DX_STORE_DECODED_VALUE(op, record_buffer, read_short)
+
+			break;
+		case dx_dop_short_to_decimal:
+			CHECKED_CALL_2(dx_read_short, bicc, &read_short);
+			CHECKED_CALL_2(dx_decimal_int_to_double, read_short, &read_double);
+			DX_STORE_DECODED_VALUE(op, record_buffer, read_double)
+
+			break;
+		case dx_dop_short_to_wide_decimal:
+			CHECKED_CALL_2(dx_read_short, bicc, &read_short);
+			CHECKED_CALL_2(dx_wide_decimal_long_to_double, read_short, &read_double);
+			DX_STORE_DECODED_VALUE(op, record_buffer, read_double)
+
+			break;
+		case dx_dop_int:
+			CHECKED_CALL_2(dx_read_int, bicc, &read_int);
+			DX_STORE_DECODED_VALUE(op, record_buffer, read_int)
+
+			break;
+		case dx_dop_int_to_decimal:
+			CHECKED_CALL_2(dx_read_int, bicc, &read_int);
+			CHECKED_CALL_2(dx_decimal_int_to_double, read_int, &read_double);
+			DX_STORE_DECODED_VALUE(op, record_buffer, read_double)
+
+			break;
+		case dx_dop_int_to_wide_decimal:
+			CHECKED_CALL_2(dx_read_int, bicc, &read_int);
+			CHECKED_CALL_2(dx_wide_decimal_long_to_double, read_int, &read_double);
+			DX_STORE_DECODED_VALUE(op, record_buffer, read_double)
+
+			break;
+		case dx_dop_compact_int:
+			CHECKED_CALL_2(dx_read_compact_int, bicc, &read_int);
+			DX_STORE_DECODED_VALUE(op, record_buffer, read_int)
+
+			break;
+		case dx_dop_compact_int_to_double:
+			CHECKED_CALL_2(dx_read_compact_int, bicc, &read_int);
+
+			read_double = read_int;
+
+			DX_STORE_DECODED_VALUE(op, record_buffer, read_double)
+
+			break;
+		case dx_dop_compact_decimal:
+			CHECKED_CALL_2(dx_read_compact_int, bicc, &read_int);
+			CHECKED_CALL_2(dx_decimal_int_to_double, read_int, &read_double);
+			DX_STORE_DECODED_VALUE(op, record_buffer, read_double)
+
+			break;
+		case dx_dop_compact_decimal_to_int:
+			CHECKED_CALL_2(dx_read_compact_int, bicc, &read_int);
+			CHECKED_CALL_2(dx_decimal_int_to_double, read_int, &read_double);
+
+			read_int = (int)read_double;
+
+			DX_STORE_DECODED_VALUE(op, record_buffer, read_int)
+
+			break;
+		case dx_dop_compact_long:
+			CHECKED_CALL_2(dx_read_compact_long, bicc, &read_long);
+			DX_STORE_DECODED_VALUE(op, record_buffer, read_long)
+
+			break;
+		case dx_dop_compact_wide_decimal:
+			CHECKED_CALL_2(dx_read_compact_long, bicc, &read_long);
+			CHECKED_CALL_2(dx_wide_decimal_long_to_double, read_long, &read_double);
+			DX_STORE_DECODED_VALUE(op, record_buffer, read_double)
+
+			break;
+		case dx_dop_compact_wide_decimal_to_int:
+			CHECKED_CALL_2(dx_read_compact_long, bicc, &read_long);
+			CHECKED_CALL_2(dx_wide_decimal_long_to_double, read_long, &read_double);
+
+			read_int = (int)read_double;
+
+			DX_STORE_DECODED_VALUE(op, record_buffer, read_int)
+
+			break;
+		case dx_dop_utf_string:
+			CHECKED_CALL_2(dx_read_utf_string, bicc, &read_string);
+
+			dx_store_string_buffer(context->rbcc, read_string);
+
+			DX_STORE_DECODED_VALUE(op, record_buffer, read_string)
+
+			break;
+		case dx_dop_byte_array:
+			CHECKED_CALL_2(dx_read_byte_array, bicc, &read_byte_array);
+
+			dx_store_byte_array_buffer(context->rbcc, read_byte_array);
+
+			DX_STORE_DECODED_VALUE(op, record_buffer, read_byte_array)
+
+			break;
+		case dx_dop_utf_char_array:
+			CHECKED_CALL_2(dx_read_utf_char_array, bicc, &read_string);
+
+			dx_store_string_buffer(context->rbcc, read_string);
+
+			DX_STORE_DECODED_VALUE(op, record_buffer, read_string)
+
+			break;
+		case dx_dop_skip_byte_array:
+			CHECKED_CALL(dx_skip_byte_array, bicc);
+
+			break;
+		case dx_dop_skip_utf_char_array:
+			CHECKED_CALL(dx_skip_utf_char_array, bicc);
+
+			break;
+		default:
+			return dx_set_error_code(dx_pec_record_field_type_not_supported);
+		}
 	}
 
+	return true;
+}
+
+/* -------------------------------------------------------------------------- */
+
+/*
+ *	The field by field decoding the decode plans have replaced. The field type is dispatched and the setter is called
+ *  for every field of every record. Kept to compare the decoding methods, see 'dx_set_record_decode_plans_enabled'
+ */
+static int dx_read_record_fields (dx_server_msg_proc_connection_context_t* context,
+								const dx_record_digest_t* record_digest, void* record_buffer) {
+	int i = 0;
+	dxf_byte_t read_byte;
+	dxf_short_t read_short;
+	dxf_int_t read_int;
+	dxf_long_t read_long;
+	dxf_char_t read_utf_char;
+	dxf_double_t read_double;
+	dxf_string_t read_string;
+	dxf_byte_array_t read_byte_array;
+
 	for (; i < record_digest->size; ++i) {
 		int serialization = record_digest->elements[i]->type & dx_fid_mask_serialization;
 		int representation = record_digest->elements[i]->type & dx_fid_mask_representation;
@@ -942,7 +1566,10 @@ int dx_read_records (dx_server_msg_proc_connection_context_t* context,
 		case dx_fid_void:
 			/* 0 here means that we're dealing with the field the server does not support;
 				using the default value for it */
-			record_digest->elements[i]->setter(record_buffer, record_digest->elements[i]->def_val_getter());
+			if (record_digest->elements[i]->def_val_getter != NULL) {
+				CHECKED_SET_VALUE(record_digest->elements[i]->setter, record_buffer,
+								record_digest->elements[i]->def_val_getter())
+			}
 
 			break;
 		case dx_fid_byte:
@@ -1065,19 +1692,36 @@ int dx_read_records (dx_server_msg_proc_connection_context_t* context,
 
 			break;
 		default:
-			CHECKED_CALL(dx_mutex_unlock, &(context->record_digests_guard));
-
 			return dx_set_error_code(dx_pec_record_field_type_not_supported);
 		}
 	}
 
-	CHECKED_CALL(dx_mutex_unlock, &(context->record_digests_guard));
-
 	return true;
 }
 
 /* -------------------------------------------------------------------------- */
 
+void dx_set_record_decode_plans_enabled (int enabled) {
+	g_record_decode_plans_enabled = enabled;
+}
+
+/* -------------------------------------------------------------------------- */
+
+int dx_read_records (dx_server_msg_proc_connection_context_t* context, const dx_record_digest_t* record_digest,
+					dx_record_id_t record_id, void* record_buffer) {
+	if (IS_FLAG_SET(context->last_flags, dxf_ef_remove_event)) {
+		return dx_read_qdtime_on_remove_event(context, record_id, record_buffer);
+	}
+
+	if (!g_record_decode_plans_enabled) {
+		return dx_read_record_fields(context, record_digest, record_buffer);
+	}
+
+	return dx_execute_decode_plan(context, record_digest, record_buffer);
+}
+
+/* -------------------------------------------------------------------------- */
+
 #define CHECKED_GET_VALUE(getter, buffer, value) \
 	if (getter != NULL) { \
 		getter(buffer, value); \
@@ -1107,9 +1751,9 @@ dxf_time_int_field_t dx_get_time_int_field(void* dscc, dx_record_id_t record_id,
 
 /* -------------------------------------------------------------------------- */
 
-int dx_process_data_message (dx_server_msg_proc_connection_context_t* context) {
+int dx_process_data_records (dx_server_msg_proc_connection_context_t* context,
+							const dx_record_digest_list_t* record_digests) {
 	context->last_cipher = 0;
-	CHECKED_FREE(context->last_symbol);
 	context->last_symbol = NULL;
 	context->last_flags = 0;
 	context->mru_event_flags = dxf_ef_tx_pending;
@@ -1119,21 +1763,15 @@ int dx_process_data_message (dx_server_msg_proc_connection_context_t* context) {
 		dx_record_id_t record_id;
 		dxf_const_string_t suffix;
 		const dx_record_item_t* record_info = NULL;
-		dx_record_digest_t* record_digest = NULL;
+		const dx_record_digest_t* record_digest = NULL;
 		dx_record_params_t record_params;
 		dxf_event_params_t event_params;
 
 		CHECKED_CALL_1(dx_read_symbol, context);
 
-		if (context->last_symbol == NULL && !dx_decode_symbol_name(context->last_cipher, (dxf_const_string_t*)&context->last_symbol)) {
-			return false;
-		}
-
 		dxf_int_t server_record_id;
 		{
 			if (!dx_read_compact_int(context->bicc, &server_record_id)) {
-				dx_free_buffers(context->rbcc);
-
 				return false;
 			}
 
@@ -1141,19 +1779,15 @@ int dx_process_data_message (dx_server_msg_proc_connection_context_t* context) {
 		}
 
 		if (record_id < 0) {
-			dx_free_buffers(context->rbcc);
 			dx_logging_info(L"Not supported record from server (id=%d)", server_record_id);
 			return dx_set_error_code(dx_pec_record_not_supported);
 		}
 
-		record_digest = dx_get_record_digest(context, record_id);
+		record_digest = dx_get_record_digest(record_digests, record_id);
 		if (record_digest == NULL) {
-			dx_free_buffers(context->rbcc);
 			return dx_set_error_code(dx_ec_invalid_func_param_internal);
 		}
 		if (!record_digest->in_sync_with_server) {
-			dx_free_buffers(context->rbcc);
-
 			return dx_set_error_code(dx_pec_record_description_not_received);
 		}
 
@@ -1165,15 +1799,11 @@ int dx_process_data_message (dx_server_msg_proc_connection_context_t* context) {
 		suffix = dx_string_length(record_info->suffix) > 0 ? record_info->suffix : NULL;
 
 		if (record_buffer == NULL) {
-			dx_free_buffers(context->rbcc);
-
 			return false;
 		}
 
 
-		if (!dx_read_records(context, record_id, record_buffer)) {
-			dx_free_buffers(context->rbcc);
-
+		if (!dx_read_records(context, record_digest, record_id, record_buffer)) {
 			return false;
 		}
 		// TODO: add assert to overlimit in context->bicc limit
@@ -1183,22 +1813,29 @@ int dx_process_data_message (dx_server_msg_proc_connection_context_t* context) {
 		record_params.suffix = suffix;
 		record_params.symbol_name = context->last_symbol;
 		record_params.symbol_cipher = context->last_cipher;
+		record_params.symbol_id = context->last_symbol_id;
 		record_params.flags = context->last_flags;
 		record_params.time_int_field = dx_get_time_int_field(context->dscc, record_id, record_buffer);
 
 		event_params.flags = record_params.flags;
 		event_params.time_int_field = record_params.time_int_field;
-		event_params.snapshot_key = dx_new_snapshot_key(record_info->info_id, record_params.symbol_name, suffix);
+		event_params.snapshot_key = 0;
+
+		/* only the snapshots compare the keys, so they are computed just for the record types that have ones */
+		if (dx_has_record_snapshots(context->connection, record_info->info_id)) {
+			event_params.snapshot_key = dx_make_snapshot_key(record_info->info_id,
+				dx_get_symbol_name_hash(context->symbol_table, record_params.symbol_id), record_info->suffix_hash);
+		}
 
 		if (!dx_transcode_record_data(context->connection, &record_params, &event_params,
 			g_buffer_managers[record_info->info_id].record_buffer_getter(context->rbcc))) {
-
-			dx_free_buffers(context->rbcc);
-
 			return false;
 		}
 
-		dx_free_buffers(context->rbcc);
+		/* the batched events refer to the strings of the record buffers until they are passed to the listeners */
+		if (!dx_has_pending_transcoded_events(context->connection)) {
+			dx_free_buffers(context->rbcc);
+		}
 	}
 
 	return true;
@@ -1206,26 +1843,49 @@ int dx_process_data_message (dx_server_msg_proc_connection_context_t* context) {
 
 /* -------------------------------------------------------------------------- */
 
+int dx_process_data_message (dx_server_msg_proc_connection_context_t* context) {
+	/* the digests may be replaced concurrently on reconnect, the list entered stays valid until left */
+	const dx_record_digest_list_t* record_digests = NULL;
+	int res = true;
+
+	/* the symbols of the previous messages aren't referenced any more */
+	if (dx_get_symbol_table_size(context->symbol_table) >= MAX_INTERNED_SYMBOLS) {
+		dx_clear_symbol_table(context->symbol_table);
+	}
+
+	record_digests = dx_enter_record_digests(context);
+	res = dx_process_data_records(context, record_digests);
+
+	/* the events batched before an error are passed too, as they would have been without batching */
+	res = dx_flush_transcoded_events(context->connection) && res;
+
+	dx_free_buffers(context->rbcc);
+	dx_leave_record_digests(context);
+
+	return res;
+}
+
+/* -------------------------------------------------------------------------- */
+
 int dx_fill_record_digest(dx_server_msg_proc_connection_context_t* context, dx_record_id_t rid, const dx_record_item_t* record_info,
 						dxf_int_t field_count, OUT dx_record_digest_t* record_digest) {
+	int skipped_fields = (record_info == NULL) ? 0 : dx_get_skipped_record_fields(context->dscc, record_info->info_id);
 	int i = 0;
 
 	for (; i != field_count; ++i) {
 		dx_field_digest_ptr_t field_digest = NULL;
 
-		CHECKED_CALL_4(dx_create_field_digest, context, rid, record_info, &field_digest);
+		CHECKED_CALL_5(dx_create_field_digest, context, rid, record_info, skipped_fields, &field_digest);
 
 		if (field_digest != NULL && record_digest->elements != NULL) {
 			record_digest->elements[(record_digest->size)++] = field_digest;
 		}
 	}
 
-	CHECKED_CALL_3(dx_digest_unsupported_fields, context, rid, record_info);
+	CHECKED_CALL_5(dx_digest_unsupported_fields, context, rid, record_info, skipped_fields, record_digest);
 
 	if (rid >= 0) {
-		record_digest = dx_get_record_digest(context, rid);
-		if (record_digest == NULL)
-			return dx_set_error_code(dx_ec_invalid_func_param_internal);
+		CHECKED_CALL(dx_compile_decode_plan, record_digest);
 		record_digest->in_sync_with_server = true;
 	}
 
@@ -1266,22 +1926,31 @@ int dx_process_describe_records (dx_server_msg_proc_connection_context_t* contex
 			if (record_info == NULL)
 				return false;
 
-			record_digest = dx_get_record_digest(context, local_record_id);
-			if (record_digest == NULL || record_digest->size < 0)
-				return dx_set_error_code(dx_ec_invalid_func_param_internal);
-
-			if (record_digest->elements != NULL) {
-				dx_clear_record_digest(record_digest);
+			/* the digest in use by the reader is never modified, the new one replaces it when filled */
+			if ((record_digest = dx_create_record_digest()) == NULL) {
+				return false;
 			}
 
 			/* a generous memory allocation, to allow the maximum possible amount of pointers to be stored,
 			but the overhead is insignificant */
 			if ((record_digest->elements = dx_calloc(server_field_count + record_info->field_count, sizeof(dx_field_digest_ptr_t))) == NULL) {
+				dx_free_record_digest(record_digest);
+
 				return false;
 			}
 		}
 
-		CHECKED_CALL_5(dx_fill_record_digest, context, local_record_id, record_info, server_field_count, record_digest);
+		if (!dx_fill_record_digest(context, local_record_id, record_info, server_field_count, record_digest)) {
+			if (record_digest != &dummy) {
+				dx_free_record_digest(record_digest);
+			}
+
+			return false;
+		}
+
+		if (record_digest != &dummy) {
+			CHECKED_CALL_3(dx_replace_record_digest, context, local_record_id, record_digest);
+		}
 	}
 
 	return true;
@@ -1485,7 +2154,10 @@ int dx_process_describe_protocol (dx_server_msg_proc_connection_context_t* conte
 	if (buf_pos < buf_limit)
 		dx_set_in_buffer_position(context->bicc, buf_limit);
 
-	return dx_mutex_unlock(&(context->describe_protocol_guard));
+	CHECKED_CALL(dx_mutex_unlock, &(context->describe_protocol_guard));
+
+	/* the tasks queued behind the describe protocol timeout countdown may be sent right away */
+	return dx_wake_up_worker_thread(context->connection);
 }
 
 int dx_process_heartbeat_message(dx_server_msg_proc_connection_context_t* context) {
@@ -1563,28 +2235,36 @@ int dx_process_message (dx_server_msg_proc_connection_context_t* context, dx_mes
 
 /* -------------------------------------------------------------------------- */
 
-int dx_append_new_data (dx_server_msg_proc_connection_context_t* context,
-						const dxf_byte_t* new_buffer, dxf_int_t new_buffer_size) {
-	if (context->buffer_size != context->buffer_pos) {
-		/* copy all unprocessed data to beginning of buffer */
+/*
+ *	Makes sure there are at least 'required_size' free bytes at the end of the receive buffer.
+ *  The buffer is linear: fully processed data is simply dropped, and when the free space at the end
+ *  is not enough, the unprocessed tail is compacted by moving it to the beginning of the buffer.
+ *  The buffer grows only when a single incomplete message doesn't fit into it.
+ */
+static int dx_reserve_receive_buffer_space (dx_server_msg_proc_connection_context_t* context, dxf_int_t required_size) {
+	if (context->buffer_pos == context->buffer_size) {
+		context->buffer_pos = context->buffer_size = 0;
+	} else if (context->buffer_capacity - context->buffer_size < required_size && context->buffer_pos > 0) {
+		/* compacting the unprocessed data by moving it to the beginning of the buffer */
 		dx_memmove(context->buffer, context->buffer + context->buffer_pos, context->buffer_size - context->buffer_pos);
 
 		context->buffer_size = context->buffer_size - context->buffer_pos;
 		context->buffer_pos = 0;
-	} else {
-		context->buffer_pos = context->buffer_size = 0;
 	}
 
-	/*
-	*	Appending the new data to the old one (if present).
-	*  That is possible if the server message got split into several network portions
-	*/
-
-	if (context->buffer_capacity < context->buffer_size + new_buffer_size) {
+	if (context->buffer_capacity - context->buffer_size < required_size) {
 		dxf_byte_t* larger_buffer;
+		dxf_int_t new_capacity = context->buffer_capacity;
 
-		context->buffer_capacity = context->buffer_size + new_buffer_size;
-		larger_buffer = dx_malloc(context->buffer_capacity);
+		while (new_capacity - context->buffer_size < required_size) {
+			if (new_capacity > INT_MAX / 2) {
+				return dx_set_error_code(dx_mec_insufficient_memory);
+			}
+
+			new_capacity *= 2;
+		}
+
+		larger_buffer = dx_malloc(new_capacity);
 
 		if (larger_buffer == NULL) {
 			return false;
@@ -1593,9 +2273,28 @@ int dx_append_new_data (dx_server_msg_proc_connection_context_t* context,
 		dx_memcpy(larger_buffer, context->buffer, context->buffer_size);
 		dx_free(context->buffer);
 		context->buffer = larger_buffer;
+		context->buffer_capacity = new_capacity;
 	}
 
-	dx_memcpy(context->buffer + context->buffer_size, new_buffer, new_buffer_size);
+	return true;
+}
+
+/* -------------------------------------------------------------------------- */
+
+int dx_append_new_data (dx_server_msg_proc_connection_context_t* context,
+						const dxf_byte_t* new_buffer, dxf_int_t new_buffer_size) {
+	if (new_buffer != context->buffer + context->buffer_size) {
+		/*
+		*	The data was read somewhere else, so it has to be copied.
+		*  Otherwise it's already in place right after the unprocessed data (if present).
+		*/
+
+		if (!dx_reserve_receive_buffer_space(context, new_buffer_size)) {
+			return false;
+		}
+
+		dx_memcpy(context->buffer + context->buffer_size, new_buffer, new_buffer_size);
+	}
 
 	context->buffer_size += new_buffer_size;
 
@@ -1754,6 +2453,32 @@ int dx_socket_data_receiver (dxf_connection_t connection, const void* buffer, in
 	return dx_process_server_data(connection, buffer, buffer_size);
 }
 
+/* -------------------------------------------------------------------------- */
+
+int dx_get_socket_data_buffer (dxf_connection_t connection, OUT void** buffer, OUT int* buffer_size) {
+	int conn_ctx_res = true;
+	dx_server_msg_proc_connection_context_t* context = dx_get_subsystem_data(connection, dx_ccs_server_msg_processor, &conn_ctx_res);
+
+	if (context == NULL) {
+		if (conn_ctx_res) {
+			return dx_set_error_code(dx_cec_connection_context_not_initialized);
+		}
+
+		return false;
+	}
+
+	if (buffer == NULL || buffer_size == NULL) {
+		return dx_set_error_code(dx_ec_invalid_func_param_internal);
+	}
+
+	CHECKED_CALL_2(dx_reserve_receive_buffer_space, context, MIN_READ_CHUNK_SIZE);
+
+	*buffer = context->buffer + context->buffer_size;
+	*buffer_size = context->buffer_capacity - context->buffer_size;
+
+	return true;
+}
+
 /* -------------------------------------------------------------------------- */
 /*
  *	Records digest management
@@ -1762,7 +2487,9 @@ int dx_socket_data_receiver (dxf_connection_t connection, const void* buffer, in
 
 int dx_add_record_digest_to_list(dxf_connection_t connection, dx_record_id_t index) {
 	int failed = false;
-	dx_record_digest_t new_digest;
+	int res = true;
+	const dx_record_digest_list_t* old_list = NULL;
+	dx_record_digest_list_t* list = NULL;
 	dx_server_msg_proc_connection_context_t* mpcc = dx_get_subsystem_data(connection, dx_ccs_server_msg_processor, &failed);
 	if (mpcc == NULL) {
 		if (failed) {
@@ -1771,19 +2498,19 @@ int dx_add_record_digest_to_list(dxf_connection_t connection, dx_record_id_t ind
 		return false;
 	}
 
-	if (index < (dx_record_id_t)(mpcc->record_digests.size)) {
-		/* Digest with such index already exist, don't insert new record*/
-		return true;
-	}
+	CHECKED_CALL(dx_mutex_lock, &(mpcc->record_digests_guard));
 
-	dx_init_record_digest(&new_digest);
-	DX_ARRAY_INSERT(mpcc->record_digests, dx_record_digest_t, new_digest, index, dx_capacity_manager_halfer, failed);
+	old_list = mpcc->record_digests;
 
-	if (failed) {
-		return dx_set_error_code(dx_sec_not_enough_memory);
+	if (old_list != NULL && index < (dx_record_id_t)(old_list->size)) {
+		/* Digest with such index already exist, don't insert new record*/
+		return dx_mutex_unlock(&(mpcc->record_digests_guard));
 	}
 
-	return true;
+	list = dx_copy_record_digest_list(old_list, (size_t)index + 1, true);
+	res = list != NULL && dx_publish_record_digests(mpcc, list, false, NULL);
+
+	return dx_mutex_unlock(&(mpcc->record_digests_guard)) && res;
 }
 
 /* -------------------------------------------------------------------------- */
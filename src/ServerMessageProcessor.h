@@ -60,6 +60,12 @@ int dx_describe_protocol_sent (dxf_connection_t connection);
 
 int dx_socket_data_receiver (dxf_connection_t connection, const void* buffer, int buffer_size);
 
+/*
+ *	Returns the free space of the connection receive buffer the socket data may be read directly into.
+ *  The data read there must be passed to 'dx_socket_data_receiver' before the next call.
+ */
+int dx_get_socket_data_buffer (dxf_connection_t connection, OUT void** buffer, OUT int* buffer_size);
+
 /* -------------------------------------------------------------------------- */
 /*
  *	Records digest management
@@ -68,6 +74,12 @@ int dx_socket_data_receiver (dxf_connection_t connection, const void* buffer, in
 
 int dx_add_record_digest_to_list(dxf_connection_t connection, dx_record_id_t index);
 
+/*
+ *	Selects the record decoding of all the connections: by the decode plans compiled from the record descriptions
+ *  (the default) or by the former field by field code. Used by the benchmarks to compare the methods in one run
+ */
+void dx_set_record_decode_plans_enabled(int enabled);
+
 /* -------------------------------------------------------------------------- */
 /*
  *	Start dumping incoming raw data into specific file
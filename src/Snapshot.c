@@ -24,8 +24,12 @@
 #include "DXThreads.h"
 #include "EventManager.h"
 #include "EventSubscription.h"
+#include "DXNetwork.h"
 #include "Logger.h"
 #include "Snapshot.h"
+#include "SnapshotKeyTable.h"
+#include "SnapshotRecordTree.h"
+#include "StringArena.h"
 
 /* -------------------------------------------------------------------------- */
 /*
@@ -48,6 +52,8 @@ typedef struct {
 		dxf_snapshot_inc_listener_t inc_listener;
 	};
 	void* user_data;
+	/* the handle the listener is attached with, it's detached when the handle is closed */
+	void* handle;
 } dx_snapshot_listener_context_t;
 
 typedef struct {
@@ -63,32 +69,16 @@ typedef struct {
 } dx_snapshot_records_array_t;
 
 typedef struct {
-	dxf_time_int_field_t time_int_field;
-	dxf_long_t index;
-} dx_snapshot_record_key_t;
-
-typedef struct {
-	dx_snapshot_record_key_t* elements;
-	size_t size;
-	size_t capacity;
-} dx_snapshot_record_keys_t;
-
-typedef struct {
-	dx_string_array_ptr_t* elements;
-	size_t size;
-	size_t capacity;
-} dx_snapshot_record_buffers_t;
-
-typedef struct {
-	/* Store received records */
+	/* Stores the received records ordered by their keys, their strings are kept by the snapshot string arena */
+	dx_snapshot_record_tree_t tree;
+	/* The copy of the records passed to the listeners, it's made when a listener needs it */
 	dx_snapshot_records_array_t records;
-	/* Store keys of snapshot records */
-	dx_snapshot_record_keys_t record_keys;
-	/* Stores a string for snapshot records */
-	dx_snapshot_record_buffers_t record_buffers;
-	/* position of record == position of record_time_ints == position of record_buffer */
+	int records_changed;
 } dx_snapshot_records_t, *dx_snapshot_records_ptr_t;
 
+typedef struct dx_snapshot_handle dx_snapshot_handle_t, *dx_snapshot_handle_ptr_t;
+typedef struct dx_snapshot_router dx_snapshot_router_t, *dx_snapshot_router_ptr_t;
+
 typedef struct {
 	dx_mutex_t guard;
 
@@ -103,15 +93,108 @@ typedef struct {
 	dx_snapshot_status_t status;
 
 	int full_snapshot_published;
+	/* the end of a snapshot has been received, so the listeners attached after that can get its records */
+	int full_snapshot_received;
+	/* some listeners haven't got the records yet, the publisher task passes them the records */
+	int new_listeners_pending;
+	dxf_snapshot_publication_policy_t publication_policy;
+	/* the completed transactions haven't been published yet, the publisher task of the connection is scheduled */
+	int publication_pending;
+	int full_snapshot_requested;
+	int last_publication_time;
 	dx_snapshot_records_t snapshot_records;
 	dx_snapshot_records_t last_tx_records;
+	/* The strings of the records of both sets, it's cleared along with them when a new snapshot begins */
+	dx_string_arena_t strings;
+	/*
+	 *	The listeners are called without the guard. The strings of the records passed to them are retired
+	 *  instead of cleared then, and freed by the publisher task or the event dispatch when the listeners return
+	 */
+	int publishing;
+	int strings_retired;
+	dx_string_arena_t retired_strings;
 
 	dx_snapshot_listener_array_t listeners;
 	int has_inc_listeners;
 
+	/* the open handles of the snapshot, the list is guarded by the connection context guard */
+	dx_snapshot_handle_ptr_t handles;
+	/* the router of the subscription shared with the snapshots created along with this one, or NULL */
+	dx_snapshot_router_ptr_t router;
+
+	/*
+	 *	Set under both guards: the publisher task calls the listeners of the snapshot. The snapshot closed
+	 *  meanwhile is marked closed, and freed by the task or the dispatch that drops the last reference to it
+	 */
+	int publisher_ref;
+	int closed;
+	/*
+	 *	The number of the event dispatches using the snapshot without its guard: the routed ones and the ones
+	 *  calling its listeners. The snapshot closed meanwhile is freed when the last of them returns
+	 */
+	int dispatch_count;
+	/* guarded by the connection context guard: the event dispatch calls the listeners on the dispatch thread */
+	int dispatch_publishing;
+	dx_thread_t dispatch_thread;
+
 	void* sscc;
 } dx_snapshot_data_t, *dx_snapshot_data_ptr_t;
 
+/*
+ * The snapshots are shared by their handles, so the snapshots of the same records, symbol, source and time
+ * are received once. A handle has its own listeners, the snapshot is closed along with its last handle
+ */
+struct dx_snapshot_handle {
+	dx_snapshot_data_ptr_t snapshot_data;
+	dx_snapshot_handle_ptr_t next;
+};
+
+#define SNAPSHOT_DATA(snapshot) \
+	(((dx_snapshot_handle_ptr_t)(snapshot))->snapshot_data)
+
+/*
+ * The snapshots of many symbols created at once are received with one subscription, whose events are passed
+ * to the snapshots by their keys. The snapshots are kept in a snapshot key table, an event's snapshot is looked up
+ * and referenced under the router guard, so a snapshot removed from the table gets no more events, and the event
+ * is passed to it without the guard. A listener closing the last routed snapshot retires the router,
+ * which is freed when the dispatch returns
+ */
+struct dx_snapshot_router {
+	dx_mutex_t guard;
+	dxf_subscription_t subscription;
+	dx_snapshot_key_table_t snapshots;
+	int dispatch_count;
+	int retired;
+};
+
+/* The listener call prepared under the snapshot guard, it's made without any guards */
+typedef struct {
+	dx_snapshot_listener_context_t listener;
+	int full_snapshot;
+} dx_snapshot_listener_call_t;
+
+typedef struct {
+	dx_snapshot_listener_call_t* elements;
+	size_t size;
+	size_t capacity;
+} dx_snapshot_listener_call_array_t;
+
+typedef struct {
+	dx_snapshot_data_ptr_t snapshot_data;
+	dx_snapshot_listener_call_array_t calls;
+	/* the copies of the records taken from the snapshot, so they stay intact while the listeners are called */
+	dx_snapshot_records_array_t full_records;
+	dx_snapshot_records_array_t tx_records;
+} dx_snapshot_publication_t;
+
+typedef struct {
+	dx_snapshot_publication_t* elements;
+	size_t size;
+	size_t capacity;
+} dx_snapshot_publication_array_t;
+
+#define PUBLISHER_WAIT_TIMEOUT 100
+
 /* Snapshots are sorted in ascending order by dx_snapshot_data_ptr_t->key
  * Use DX_ARRAY_BINARY_SEARCH with dx_snapshot_comparator for searching elements and before
  * inserting new once
@@ -138,10 +221,19 @@ typedef struct {
 	dxf_connection_t connection;
 	dx_mutex_t guard;
 	dx_snapshots_data_array_t snapshots_array;
+	/* the number of the open snapshots of each record, the data processing reads it without locking */
+	long long record_snapshot_counts[dx_rid_count];
+	/* the worker thread task publishing the throttled snapshots is in the queue */
+	int publisher_scheduled;
+	/* the publisher task calls the listeners of the snapshots it references on this thread */
+	int publisher_calling;
+	dx_thread_t publisher_thread;
+	dx_condition_t publication_ended;
 	int fields_flags;
 } dx_snapshot_subscription_connection_context_t;
 
-#define GUARD_FIELD_FLAG    (0x1)
+#define GUARD_FIELD_FLAG     (0x1)
+#define CONDITION_FIELD_FLAG (0x2)
 
 #define CTX(context) \
 	((dx_snapshot_subscription_connection_context_t*)context)
@@ -150,6 +242,8 @@ typedef struct {
 
 int dx_clear_snapshot_subscription_connection_context(dx_snapshot_subscription_connection_context_t* context);
 int dx_free_snapshot_data(dx_snapshot_data_ptr_t snapshot_data);
+void dx_remove_routed_snapshot(dx_snapshot_router_ptr_t router, dx_snapshot_data_ptr_t snapshot_data);
+void dx_free_snapshot_router(dx_snapshot_router_ptr_t router);
 
 DX_CONNECTION_SUBSYS_INIT_PROTO(dx_ccs_snapshot_subscription) {
 	dx_snapshot_subscription_connection_context_t* context = NULL;
@@ -172,6 +266,14 @@ DX_CONNECTION_SUBSYS_INIT_PROTO(dx_ccs_snapshot_subscription) {
 
 	context->fields_flags |= GUARD_FIELD_FLAG;
 
+	if (!dx_condition_create(&context->publication_ended)) {
+		dx_clear_snapshot_subscription_connection_context(context);
+
+		return false;
+	}
+
+	context->fields_flags |= CONDITION_FIELD_FLAG;
+
 	if (!dx_set_subsystem_data(connection, dx_ccs_snapshot_subscription, context)) {
 		dx_clear_snapshot_subscription_connection_context(context);
 
@@ -207,13 +309,28 @@ int dx_clear_snapshot_subscription_connection_context(dx_snapshot_subscription_c
 	size_t i = 0;
 
 	for (; i < context->snapshots_array.size; ++i) {
-		res = dx_free_snapshot_data((dx_snapshot_data_t*)context->snapshots_array.elements[i]) && res;
+		dx_snapshot_data_ptr_t snapshot_data = context->snapshots_array.elements[i];
+
+		/* the router is freed along with its last snapshot */
+		if (snapshot_data->router != NULL) {
+			dx_remove_routed_snapshot(snapshot_data->router, snapshot_data);
+
+			if (snapshot_data->router->snapshots.size == 0) {
+				dx_free_snapshot_router(snapshot_data->router);
+			}
+		}
+
+		res = dx_free_snapshot_data(snapshot_data) && res;
 	}
 
 	if (IS_FLAG_SET(context->fields_flags, GUARD_FIELD_FLAG)) {
 		res = dx_mutex_destroy(&(context->guard)) && res;
 	}
 
+	if (IS_FLAG_SET(context->fields_flags, CONDITION_FIELD_FLAG)) {
+		res = dx_condition_destroy(&(context->publication_ended)) && res;
+	}
+
 	if (context->snapshots_array.elements != NULL) {
 		dx_free(context->snapshots_array.elements);
 	}
@@ -229,122 +346,27 @@ int dx_clear_snapshot_subscription_connection_context(dx_snapshot_subscription_c
  */
 /* -------------------------------------------------------------------------- */
 
-int dx_snapshot_records_comparator(dxf_time_int_field_t t1, dxf_time_int_field_t t2) {
-	return t1 > t2 ? -1 : (t1 < t2 ? 1 : 0);
-}
-
-int dx_snapshot_records_comparator2(dx_snapshot_record_key_t key1, dx_snapshot_record_key_t key2) {
-	if (key1.time_int_field > key2.time_int_field) {
-		return -1;
-	} else if (key1.time_int_field < key2.time_int_field) {
-		return 1;
-	}
-
-	return key1.index < key2.index ? -1 : (key1.index > key2.index ? 1 : 0);
-}
-
-int dx_snapshot_insert_record(dx_snapshot_data_ptr_t snapshot_data, dx_snapshot_records_ptr_t recs,
-								dxf_event_data_t obj, const size_t position) {
-	int failed = false;
-	switch (snapshot_data->event_id) {
+/* Returns the size of the records of the snapshot events, 0 for the events that have no snapshots */
+size_t dx_get_snapshot_record_size(dx_event_id_t event_id) {
+	switch (event_id) {
 	case dx_eid_order:
-		DX_ARRAY_INSERT(recs->records, dxf_order_t, *((dxf_order_t*)obj), position,
-			dx_capacity_manager_halfer, failed);
-		break;
-	case dx_eid_candle:
-		DX_ARRAY_INSERT(recs->records, dxf_candle_t, *((dxf_candle_t*)obj), position,
-			dx_capacity_manager_halfer, failed);
-		break;
 	case dx_eid_spread_order:
-		DX_ARRAY_INSERT(recs->records, dxf_order_t, *((dxf_order_t*)obj), position,
-			dx_capacity_manager_halfer, failed);
-		break;
-	case dx_eid_time_and_sale:
-		DX_ARRAY_INSERT(recs->records, dxf_time_and_sale_t, *((dxf_time_and_sale_t*)obj), position,
-			dx_capacity_manager_halfer, failed);
-		break;
-	case dx_eid_greeks:
-		DX_ARRAY_INSERT(recs->records, dxf_greeks_t, *((dxf_greeks_t*)obj), position,
-			dx_capacity_manager_halfer, failed);
-		break;
-	case dx_eid_series:
-		DX_ARRAY_INSERT(recs->records, dxf_series_t, *((dxf_series_t*)obj), position,
-			dx_capacity_manager_halfer, failed);
-		break;
-	default:
-		return dx_set_error_code(dx_ssec_invalid_event_id);
-	}
-
-	return !failed;
-}
-
-int dx_snapshot_delete_record(dx_snapshot_data_ptr_t snapshot_data, dx_snapshot_records_ptr_t recs,
-								const size_t position) {
-	int failed = false;
-	switch (snapshot_data->event_id) {
-	case dx_eid_order:
-		DX_ARRAY_DELETE(recs->records, dxf_order_t, position,
-			dx_capacity_manager_halfer, failed);
-		break;
+		return sizeof(dxf_order_t);
 	case dx_eid_candle:
-		DX_ARRAY_DELETE(recs->records, dxf_candle_t, position,
-			dx_capacity_manager_halfer, failed);
-		break;
-	case dx_eid_spread_order:
-		DX_ARRAY_DELETE(recs->records, dxf_order_t, position,
-			dx_capacity_manager_halfer, failed);
-		break;
+		return sizeof(dxf_candle_t);
 	case dx_eid_time_and_sale:
-		DX_ARRAY_DELETE(recs->records, dxf_time_and_sale_t, position,
-			dx_capacity_manager_halfer, failed);
-		break;
+		return sizeof(dxf_time_and_sale_t);
 	case dx_eid_greeks:
-		DX_ARRAY_DELETE(recs->records, dxf_greeks_t, position,
-			dx_capacity_manager_halfer, failed);
-		break;
+		return sizeof(dxf_greeks_t);
 	case dx_eid_series:
-		DX_ARRAY_DELETE(recs->records, dxf_series_t, position,
-			dx_capacity_manager_halfer, failed);
-		break;
+		return sizeof(dxf_series_t);
 	default:
-		return dx_set_error_code(dx_ssec_invalid_event_id);
+		return 0;
 	}
-
-	return !failed;
 }
 
-int dx_snapshot_set_record(dx_snapshot_data_ptr_t snapshot_data, dx_snapshot_records_ptr_t recs,
-							dxf_event_data_t obj, const size_t position) {
-	switch (snapshot_data->event_id) {
-	case dx_eid_order:
-		dx_memcpy(&(((dxf_order_t*)recs->records.elements)[position]), (dxf_order_t*)obj,
-			sizeof(dxf_order_t));
-		break;
-	case dx_eid_candle:
-		dx_memcpy(&(((dxf_candle_t*)recs->records.elements)[position]), (dxf_candle_t*)obj,
-			sizeof(dxf_candle_t));
-		break;
-	case dx_eid_spread_order:
-		dx_memcpy(&(((dxf_order_t*)recs->records.elements)[position]), (dxf_order_t*)obj,
-			sizeof(dxf_order_t));
-		break;
-	case dx_eid_time_and_sale:
-		dx_memcpy(&(((dxf_time_and_sale_t*)recs->records.elements)[position]), (dxf_time_and_sale_t*)obj,
-			sizeof(dxf_time_and_sale_t));
-		break;
-	case dx_eid_greeks:
-		dx_memcpy(&(((dxf_greeks_t*)recs->records.elements)[position]), (dxf_greeks_t*)obj,
-			sizeof(dxf_greeks_t));
-		break;
-	case dx_eid_series:
-		dx_memcpy(&(((dxf_series_t*)recs->records.elements)[position]), (dxf_series_t*)obj,
-			sizeof(dxf_series_t));
-		break;
-	default:
-		return dx_set_error_code(dx_ssec_invalid_event_id);
-	}
-
-	return true;
+void dx_init_snapshot_records(dx_snapshot_data_ptr_t snapshot_data, dx_snapshot_records_ptr_t recs) {
+	dx_init_snapshot_record_tree(&recs->tree, dx_get_snapshot_record_size(snapshot_data->event_id));
 }
 
 dxf_long_t dx_get_order_index(dx_snapshot_data_ptr_t snapshot_data, const dxf_event_data_t event_data) {
@@ -356,117 +378,65 @@ dxf_long_t dx_get_order_index(dx_snapshot_data_ptr_t snapshot_data, const dxf_ev
 	return 0;
 }
 
-int dx_snapshot_add_event_record(dx_snapshot_data_ptr_t snapshot_data,
-								dx_snapshot_records_ptr_t recs,
-								const dxf_event_params_t* event_params,
-								const dxf_event_data_t event_data, const size_t position) {
-	int failed = false;
-	dxf_event_data_t obj = NULL;
-	dx_event_copy_function_t clone_event = dx_get_event_copy_function(snapshot_data->event_id);
-	dx_event_free_function_t free_event = dx_get_event_free_function(snapshot_data->event_id);
-	dxf_bool_t res = false;
-	dx_string_array_ptr_t string_buffer = NULL;
-	if (clone_event == NULL || free_event == NULL) {
-		return false;
-	}
-	if (!clone_event(event_data, &string_buffer, &obj)) {
-		return false;
-	}
-
-	/* store event data */
-	res = dx_snapshot_insert_record(snapshot_data, recs, obj, position);
-	free_event(obj);
-	if (!res) {
-		dx_string_array_free(string_buffer);
-		dx_free((void*)string_buffer);
-		return false;
-	}
-
-	/* store key */
+dx_snapshot_record_key_t dx_get_snapshot_record_key(dx_snapshot_data_ptr_t snapshot_data,
+													const dxf_event_params_t* event_params,
+													const dxf_event_data_t event_data) {
 	dx_snapshot_record_key_t key = {event_params->time_int_field, dx_get_order_index(snapshot_data, event_data)};
 
-	DX_ARRAY_INSERT(recs->record_keys, dx_snapshot_record_key_t,
-					key, position, dx_capacity_manager_halfer, failed);
-	if (failed) {
-		dx_string_array_free(string_buffer);
-		dx_free((void*)string_buffer);
-		dx_snapshot_delete_record(snapshot_data, recs, position);
-		return dx_set_error_code(dx_mec_insufficient_memory);
-	}
-
-	/* store string buffer */
-	DX_ARRAY_INSERT(recs->record_buffers, dx_string_array_ptr_t, string_buffer,
-		position, dx_capacity_manager_halfer, failed);
-	if (failed) {
-		dx_string_array_free(string_buffer);
-		dx_free((void*)string_buffer);
-		dx_snapshot_delete_record(snapshot_data, recs, position);
-		DX_ARRAY_DELETE(recs->record_keys, dx_snapshot_record_key_t, position,
-						dx_capacity_manager_halfer, failed);
-		return dx_set_error_code(dx_mec_insufficient_memory);
-	}
-	return true;
+	return key;
 }
 
+/* Removes the records, the memory of their copy is kept for the next records */
 int dx_snapshot_clear_records_array(dx_snapshot_data_ptr_t snapshot_data, dx_snapshot_records_ptr_t recs) {
-	size_t i;
-	dx_snapshot_records_array_t* records;
-	dx_snapshot_record_buffers_t* string_buffers;
-
 	if (snapshot_data == NULL || recs == NULL) {
 		return dx_set_error_code(dx_ec_invalid_func_param_internal);
 	}
 
-	/* free records data */
-	records = &(recs->records);
+	dx_clear_snapshot_record_tree(&recs->tree);
+	recs->records.size = 0;
+	recs->records_changed = false;
 
-	dx_free(records->elements);
-	records->elements = NULL;
-	records->size = 0;
-	records->capacity = 0;
-
-	/* free keys */
-	dx_snapshot_record_keys_t* keys = &(recs->record_keys);
-	dx_free(keys->elements);
-	keys->elements = NULL;
-	keys->size = 0;
-	keys->capacity = 0;
+	return true;
+}
 
-	/* clear records string buffers */
-	string_buffers = &(recs->record_buffers);
-	for (i = 0; i < string_buffers->size; ++i) {
-		dx_string_array_free(string_buffers->elements[i]);
-		dx_free((void*)string_buffers->elements[i]);
-	}
-	dx_free(string_buffers->elements);
-	string_buffers->elements = NULL;
-	string_buffers->size = 0;
-	string_buffers->capacity = 0;
+void dx_snapshot_free_records(dx_snapshot_data_ptr_t snapshot_data, dx_snapshot_records_ptr_t recs) {
+	dx_snapshot_clear_records_array(snapshot_data, recs);
 
-	return true;
+	CHECKED_FREE(recs->records.elements);
+	recs->records.capacity = 0;
 }
 
-int dx_snapshot_remove_event_record(dx_snapshot_data_ptr_t snapshot_data, dx_snapshot_records_ptr_t recs,
-									size_t position) {
-	int failed = false;
+/* Returns the records in their order, the copy is updated only if they have changed since it's made */
+dxf_event_data_t dx_snapshot_get_records(dx_snapshot_records_ptr_t recs) {
+	size_t size = recs->tree.size;
 
-	if (snapshot_data == NULL || recs == NULL || position < 0 || position >= recs->records.size) {
-		return dx_set_error_code(dx_ec_invalid_func_param_internal);
+	if (!recs->records_changed) {
+		return recs->records.elements;
 	}
 
-	dx_string_array_free(recs->record_buffers.elements[position]);
-	dx_free((void*)recs->record_buffers.elements[position]);
+	if (size > recs->records.capacity) {
+		size_t new_capacity = (recs->records.capacity == 0) ? 16 : recs->records.capacity;
+		dxf_event_data_t new_elements = NULL;
+
+		while (new_capacity < size) {
+			new_capacity *= 2;
+		}
 
-	if (!dx_snapshot_delete_record(snapshot_data, recs, position)) return false;
+		if ((new_elements = dx_calloc(new_capacity, recs->tree.record_size)) == NULL) {
+			return NULL;
+		}
 
-	DX_ARRAY_DELETE(recs->record_keys, dx_snapshot_record_key_t, position, dx_capacity_manager_halfer, failed);
+		CHECKED_FREE(recs->records.elements);
 
-	if (failed) return dx_set_error_code(dx_mec_insufficient_memory);
+		recs->records.elements = new_elements;
+		recs->records.capacity = new_capacity;
+	}
 
-	DX_ARRAY_DELETE(recs->record_buffers, dx_string_array_ptr_t, position, dx_capacity_manager_halfer, failed);
+	dx_copy_snapshot_records(&recs->tree, recs->records.elements);
+	recs->records.size = size;
+	recs->records_changed = false;
 
-	if (failed) return dx_set_error_code(dx_mec_insufficient_memory);
-	return true;
+	return recs->records.elements;
 }
 
 int dx_snapshot_remove_event_records(dx_snapshot_data_ptr_t snapshot_data, dx_snapshot_records_ptr_t recs,
@@ -476,115 +446,120 @@ int dx_snapshot_remove_event_records(dx_snapshot_data_ptr_t snapshot_data, dx_sn
 		return dx_set_error_code(dx_ec_invalid_func_param_internal);
 	}
 
-	dx_snapshot_record_keys_t* keys = &(recs->record_keys);
-	dx_snapshot_record_key_t key = {event_params->time_int_field,
-									dx_get_order_index(snapshot_data, (const dxf_event_data_t)data)};
-
-	int found = false;
-	size_t index = 0;
-
-	DX_ARRAY_BINARY_SEARCH(keys->elements, 0, keys->size, key,
-						   dx_snapshot_records_comparator2, found, index);
-
-	if (found) {
-		if (!dx_snapshot_remove_event_record(snapshot_data, recs, index)) {
-			return false;
-		}
+	if (dx_remove_snapshot_record(&recs->tree,
+			dx_get_snapshot_record_key(snapshot_data, event_params, (const dxf_event_data_t)data))) {
+		recs->records_changed = true;
 	}
 
 	return true;
 }
 
-int dx_snapshot_replace_record(dx_snapshot_data_ptr_t snapshot_data, dx_snapshot_records_ptr_t recs,
-								size_t position, const dxf_event_data_t new_record) {
-	dx_event_free_function_t free_event = NULL;
-	dx_event_copy_function_t clone_event = NULL;
-	dxf_event_data_t new_obj = NULL;
-	int status;
+/* Interns the strings of the event, the record made of the event is to reference them instead of its own strings */
+int dx_snapshot_intern_strings(dx_snapshot_data_ptr_t snapshot_data, const dxf_event_data_t event_data,
+								OUT dxf_const_string_t strings[MAX_EVENT_STRING_FIELD_COUNT], OUT int* count) {
+	dxf_const_string_t* fields[MAX_EVENT_STRING_FIELD_COUNT];
+	int i = 0;
 
-	if (snapshot_data == NULL || recs == NULL || position < 0 || position >= recs->records.size) {
-		return dx_set_error_code(dx_ec_invalid_func_param_internal);
-	}
+	*count = dx_get_event_string_fields(snapshot_data->event_id, event_data, fields);
 
-	free_event = dx_get_event_free_function(snapshot_data->event_id);
-	clone_event = dx_get_event_copy_function(snapshot_data->event_id);
-	if (free_event == NULL || clone_event == NULL) {
-		return false;
+	for (; i < *count; ++i) {
+		strings[i] = NULL;
+
+		if (*fields[i] != NULL) {
+			CHECKED_CALL_3(dx_intern_arena_string, &snapshot_data->strings, *fields[i], strings + i);
+		}
 	}
 
-	dx_string_array_free(recs->record_buffers.elements[position]);
+	return true;
+}
 
-	if (!clone_event(new_record, &(recs->record_buffers.elements[position]), &new_obj)) {
-		return false;
-	}
+void dx_snapshot_set_record(dx_snapshot_data_ptr_t snapshot_data, dx_snapshot_records_ptr_t recs,
+							dxf_event_data_t record, const dxf_event_data_t event_data,
+							const dxf_const_string_t strings[MAX_EVENT_STRING_FIELD_COUNT], int string_count) {
+	dxf_const_string_t* fields[MAX_EVENT_STRING_FIELD_COUNT];
+	int i = 0;
 
-	status = dx_snapshot_set_record(snapshot_data, recs, new_obj, position);
-	if (!status)
-		dx_string_array_free(recs->record_buffers.elements[position]);
+	dx_memcpy(record, event_data, recs->tree.record_size);
+	dx_get_event_string_fields(snapshot_data->event_id, record, fields);
 
-	free_event(new_obj);
+	for (; i < string_count; ++i) {
+		*fields[i] = strings[i];
+	}
 
-	return status;
+	recs->records_changed = true;
 }
 
 int dx_snapshot_update_event_records(dx_snapshot_data_ptr_t snapshot_data, dx_snapshot_records_ptr_t recs,
 									const dxf_event_data_t* data, const dxf_event_params_t* event_params) {
+	dx_snapshot_record_key_t key;
+	dxf_event_data_t record = NULL;
+	dxf_const_string_t strings[MAX_EVENT_STRING_FIELD_COUNT];
+	int string_count = 0;
+
 	if (snapshot_data == NULL || recs == NULL) {
 		return dx_set_error_code(dx_ec_invalid_func_param_internal);
 	}
 
-	dx_snapshot_record_keys_t* keys = &(recs->record_keys);
-	dx_snapshot_record_key_t key = {event_params->time_int_field,
-									dx_get_order_index(snapshot_data, (const dxf_event_data_t)data)};
+	if (recs->tree.record_size == 0) {
+		return dx_set_error_code(dx_ssec_invalid_event_id);
+	}
 
-	int found = false;
-	size_t index = 0;
+	key = dx_get_snapshot_record_key(snapshot_data, event_params, (const dxf_event_data_t)data);
 
-	DX_ARRAY_BINARY_SEARCH(keys->elements, 0, keys->size, key,
-						   dx_snapshot_records_comparator2, found, index);
+	CHECKED_CALL_4(dx_snapshot_intern_strings, snapshot_data, (const dxf_event_data_t)data, strings, &string_count);
 
 	/* add or update record */
-	if (found) {
-		if (!dx_snapshot_replace_record(snapshot_data, recs, index, (const dxf_event_data_t)(data))) {
-			return false;
-		}
-	} else {
-		if (!dx_snapshot_add_event_record(snapshot_data, recs, event_params, (const dxf_event_data_t)(data), index)) {
-			return false;
-		}
+	if ((record = dx_find_snapshot_record(&recs->tree, key)) == NULL &&
+		(record = dx_insert_snapshot_record(&recs->tree, key)) == NULL) {
+		return dx_set_error_code(dx_mec_insufficient_memory);
 	}
 
+	dx_snapshot_set_record(snapshot_data, recs, record, (const dxf_event_data_t)data, strings, string_count);
+
 	return true;
 }
 
-int dx_snapshot_call_listeners(dx_snapshot_data_ptr_t snapshot_data, int new_snapshot) {
-	size_t cur_listener_index = 0;
-
-	for (; cur_listener_index < snapshot_data->listeners.size; ++cur_listener_index) {
-		dx_snapshot_listener_context_t* listener_context = snapshot_data->listeners.elements + cur_listener_index;
-		dxf_snapshot_data_t callback_data;
-		callback_data.event_type = snapshot_data->event_type;
-		callback_data.symbol = dx_create_string_src(snapshot_data->symbol);
-
-		if (listener_context->incremental) {
-			if (new_snapshot || !listener_context->full_snapshot_seen) {
-				callback_data.records_count = snapshot_data->snapshot_records.records.size;
-				callback_data.records = snapshot_data->snapshot_records.records.elements;
-				listener_context->inc_listener(&callback_data, true, listener_context->user_data);
-				listener_context->full_snapshot_seen = true;
-			} else {
-				callback_data.records_count = snapshot_data->last_tx_records.records.size;
-				callback_data.records = snapshot_data->last_tx_records.records.elements;
-				listener_context->inc_listener(&callback_data, false, listener_context->user_data);
-			}
-		} else {
-			callback_data.records_count = snapshot_data->snapshot_records.records.size;
-			callback_data.records = snapshot_data->snapshot_records.records.elements;
-			listener_context->full_listener(&callback_data, listener_context->user_data);
-		}
-		dx_free(callback_data.symbol);
+/*
+ *	Returns the records to pass to the listener, or NULL if it isn't to be called. Only the listeners that haven't
+ *  got the records yet are called if new_listeners_only is set
+ */
+dx_snapshot_records_ptr_t dx_get_snapshot_listener_records(dx_snapshot_data_ptr_t snapshot_data,
+															const dx_snapshot_listener_context_t* listener_context,
+															int new_snapshot, int new_listeners_only) {
+	if (new_listeners_only && listener_context->full_snapshot_seen) {
+		return NULL;
 	}
-	return true;
+
+	if (listener_context->incremental && !new_snapshot && listener_context->full_snapshot_seen) {
+		return &snapshot_data->last_tx_records;
+	}
+
+	if (!listener_context->incremental && !new_snapshot && listener_context->full_snapshot_seen &&
+		snapshot_data->publication_policy.full_snapshot_on_demand) {
+		/* all the records are passed to the full listeners only with a new snapshot or on request */
+		return NULL;
+	}
+
+	return &snapshot_data->snapshot_records;
+}
+
+void dx_call_snapshot_listener(const dx_snapshot_data_ptr_t snapshot_data,
+								const dx_snapshot_listener_context_t* listener_context,
+								dxf_event_data_t records, size_t records_count, int full_snapshot) {
+	dxf_snapshot_data_t callback_data;
+
+	callback_data.event_type = snapshot_data->event_type;
+	callback_data.records_count = records_count;
+	callback_data.records = records;
+	callback_data.symbol = dx_create_string_src(snapshot_data->symbol);
+
+	if (listener_context->incremental) {
+		listener_context->inc_listener(&callback_data, full_snapshot, listener_context->user_data);
+	} else {
+		listener_context->full_listener(&callback_data, listener_context->user_data);
+	}
+
+	dx_free(callback_data.symbol);
 }
 
 int dx_is_snapshot_event(const dx_snapshot_data_ptr_t snapshot_data, const dxf_event_params_t* event_params) {
@@ -599,187 +574,914 @@ int dx_is_zero_event(dx_event_id_t event_id, const dxf_event_data_t* event_data)
 	return ((dxf_order_t*)event_data)->size == 0;
 }
 
-void event_listener(int event_type, dxf_const_string_t symbol_name,
-					const dxf_event_data_t* data, int data_count,
-					const dxf_event_params_t* event_params, void* user_data) {
-	dx_snapshot_data_ptr_t snapshot_data = (dx_snapshot_data_ptr_t)user_data;
+/* Starts a new transaction when the changes of the completed ones are passed to the listeners */
+void dx_snapshot_published(dx_snapshot_data_ptr_t snapshot_data) {
+	/* for sure */
+	snapshot_data->full_snapshot_published = true;
+	snapshot_data->full_snapshot_requested = false;
+	snapshot_data->publication_pending = false;
+	snapshot_data->last_publication_time = dx_millisecond_timestamp();
+	/* start new transaction */
+	dx_snapshot_clear_records_array(snapshot_data, &snapshot_data->last_tx_records);
+}
 
-	int sb = IS_FLAG_SET(event_params->flags, dxf_ef_snapshot_begin);
-	int se = IS_FLAG_SET(event_params->flags, dxf_ef_snapshot_end) || IS_FLAG_SET(event_params->flags, dxf_ef_snapshot_snip);
-	int tx = IS_FLAG_SET(event_params->flags, dxf_ef_tx_pending);
+/* Clears the strings of the records when a new snapshot begins, must be called under the snapshot guard */
+void dx_snapshot_clear_strings(dx_snapshot_data_ptr_t snapshot_data) {
+	if (!snapshot_data->publishing || snapshot_data->strings_retired) {
+		/* the strings interned after the publication has started aren't passed to its listeners */
+		dx_clear_string_arena(&snapshot_data->strings);
 
-	/* It should be no-op, really */
-	if (!dx_is_snapshot_event(snapshot_data, event_params)) {
 		return;
 	}
 
-	int rm = IS_FLAG_SET(event_params->flags, dxf_ef_remove_event) || dx_is_zero_event(snapshot_data->event_id, data);
+	snapshot_data->retired_strings = snapshot_data->strings;
+	snapshot_data->strings_retired = true;
+	dx_init_string_arena(&snapshot_data->strings);
+}
 
-	/* Ok, process this event */
-	if (sb) {
-		/* Clear snapshot */
-		dx_snapshot_clear_records_array(snapshot_data, &snapshot_data->snapshot_records);
-		dx_snapshot_clear_records_array(snapshot_data, &snapshot_data->last_tx_records);
-		snapshot_data->status = dx_status_begin;
-		snapshot_data->full_snapshot_published = false;
-	}
-	if (snapshot_data->status == dx_status_unknown) {
-		/* If we in unknown state, skip */
-		return;
-	}
+/* -------------------------------------------------------------------------- */
+/*
+ *	Snapshot publisher task
+ */
+/* -------------------------------------------------------------------------- */
 
-	/* Process this event */
-	if (rm) {
-		dx_snapshot_remove_event_records(snapshot_data, &snapshot_data->snapshot_records, data, event_params);
-	} else {
-		dx_snapshot_update_event_records(snapshot_data, &snapshot_data->snapshot_records, data, event_params);
-	}
-	/* Add to the current tx, if it is pending transaction, may be only with one event, add even "rm" event */
-	if (snapshot_data->has_inc_listeners && snapshot_data->full_snapshot_published) {
-		dx_snapshot_update_event_records(snapshot_data, &snapshot_data->last_tx_records, data, event_params);
+/* Moves the copy of the records to the publication, the snapshot makes a new copy when it needs one */
+int dx_snapshot_take_records(dx_snapshot_records_ptr_t recs, OUT dx_snapshot_records_array_t* records) {
+	if (dx_snapshot_get_records(recs) == NULL && recs->tree.size > 0) {
+		return dx_set_error_code(dx_mec_insufficient_memory);
 	}
 
-	/* Set end-of-snapshot */
-	if (se) {
-		snapshot_data->status = dx_status_full;
-	}
+	*records = recs->records;
+	dx_memset(&recs->records, 0, sizeof(dx_snapshot_records_array_t));
+	recs->records_changed = true;
 
-	if (tx && snapshot_data->status == dx_status_full) {
-		snapshot_data->status = dx_status_pending;
-	} else if (!tx && snapshot_data->status == dx_status_pending) {
-		snapshot_data->status = dx_status_full;
-	}
+	return true;
+}
 
-	/* And call all consumers  if it is end of transaction */
-	if (snapshot_data->status == dx_status_full) {
-		/* Lock guard to be sure that source list is intact */
-		if (!dx_mutex_lock(&snapshot_data->guard))
-			return;
-		dx_snapshot_call_listeners(snapshot_data, !snapshot_data->full_snapshot_published);
-		dx_mutex_unlock(&snapshot_data->guard);
-		/* for sure */
-		snapshot_data->full_snapshot_published = true;
-		/* start new transaction */
-		dx_snapshot_clear_records_array(snapshot_data, &snapshot_data->last_tx_records);
+/* Gives the memory of the copy back to the snapshot, unless it has made a new copy meanwhile */
+void dx_snapshot_return_records(dx_snapshot_records_ptr_t recs, dx_snapshot_records_array_t* records) {
+	if (recs->records.elements == NULL) {
+		recs->records.elements = records->elements;
+		recs->records.capacity = records->capacity;
+	} else {
+		CHECKED_FREE(records->elements);
 	}
+
+	dx_memset(records, 0, sizeof(dx_snapshot_records_array_t));
 }
 
 /*
- * Function generate key for snapshot object using record_info_id, symbol and source
- *
- * snapshot key format:
- * 64 - 56     55 - 24  23 - 0
- * record_id | symbol | source
- *
- * record_info_id - record type of snapshot subscription
- * symbol - string symbol of snapshot subscription
- * order_source - source for Order records or keyword for MarketMaker; can be NULL also
- * returns 64 bit unsigned decimal
+ *	Prepares the listener calls made without the guards by the publisher task or the event dispatch: the changes
+ *  of the completed transactions if publish is set, and the records for the listeners that haven't got them yet.
+ *  Must be called under the snapshot guard
  */
-dxf_ulong_t dx_new_snapshot_key(dx_record_info_id_t record_info_id, dxf_const_string_t symbol,
-								dxf_const_string_t order_source) {
-	dxf_ulong_t symbol_hash = dx_symbol_name_hasher(symbol);
-	dxf_ulong_t order_source_hash = (order_source == NULL ? 0u : dx_symbol_name_hasher(order_source));
-	return ((dxf_ulong_t)record_info_id << 56u) |
-		((dxf_ulong_t)symbol_hash << 24u) |
-		(order_source_hash & SNAPSHOT_KEY_SOURCE_MASK);
-}
+int dx_prepare_snapshot_publication(dx_snapshot_data_ptr_t snapshot_data, int publish,
+									OUT dx_snapshot_publication_t* publication) {
+	const int new_snapshot = !snapshot_data->full_snapshot_published || snapshot_data->full_snapshot_requested;
+	int new_listeners_only = !publish;
+	int res = true;
 
-int dx_snapshots_comparator(dx_snapshot_data_ptr_t s1, dx_snapshot_data_ptr_t s2) {
-	return DX_NUMERIC_COMPARATOR(s1->key, s2->key);
-}
+	dx_memset(publication, 0, sizeof(dx_snapshot_publication_t));
+	publication->snapshot_data = snapshot_data;
 
-void dx_clear_snapshot_listener_array(dx_snapshot_listener_array_t* listeners) {
-	dx_free(listeners->elements);
+	/* the changes are passed to all the listeners first, then the records to the new ones if there are some */
+	for (; new_listeners_only <= snapshot_data->new_listeners_pending; ++new_listeners_only) {
+		size_t listener_index = 0;
 
-	listeners->elements = NULL;
-	listeners->size = 0;
-	listeners->capacity = 0;
-}
+		for (; listener_index < snapshot_data->listeners.size; ++listener_index) {
+			dx_snapshot_listener_context_t* listener_context = snapshot_data->listeners.elements + listener_index;
+			dx_snapshot_records_ptr_t recs = dx_get_snapshot_listener_records(snapshot_data, listener_context,
+				new_snapshot || new_listeners_only, new_listeners_only);
+			dx_snapshot_records_array_t* records = NULL;
+			dx_snapshot_listener_call_t call;
+			int failed = false;
 
-int dx_snapshot_listener_comparator(dx_snapshot_listener_context_t e1,
-									dx_snapshot_listener_context_t e2) {
-	return e1.incremental == e2.incremental ? DX_FORCED_NUMERIC_COMPARATOR(e1.full_listener, e2.full_listener) : -1;
-}
+			if (recs == NULL) {
+				continue;
+			}
 
-size_t dx_find_snapshot_listener_in_array(dx_snapshot_listener_array_t* listeners,
-									int incremental, void *listener, OUT int* found) {
-	size_t listener_index;
-	dx_snapshot_listener_context_t listener_context = { incremental, false, {.full_listener = *(dxf_snapshot_listener_t*)(&listener)}, NULL };
+			call.listener = *listener_context;
+			call.full_snapshot = (recs == &snapshot_data->snapshot_records);
+			records = call.full_snapshot ? &publication->full_records : &publication->tx_records;
 
-	DX_ARRAY_SEARCH(listeners->elements, 0, listeners->size, listener_context,
-		dx_snapshot_listener_comparator, false, *found, listener_index);
+			/* the copy of the records is taken once, the listener gets the next snapshot if it can't be made */
+			if (records->elements == NULL && recs->tree.size > 0 && !dx_snapshot_take_records(recs, records)) {
+				res = false;
 
-	return listener_index;
-}
+				continue;
+			}
+
+			DX_ARRAY_INSERT(publication->calls, dx_snapshot_listener_call_t, call, publication->calls.size,
+				dx_capacity_manager_halfer, failed);
+
+			if (failed) {
+				res = dx_set_error_code(dx_mec_insufficient_memory);
+
+				continue;
+			}
+
+			records->size = recs->tree.size;
+			listener_context->full_snapshot_seen = true;
+		}
+	}
+
+	if (publish) {
+		dx_snapshot_published(snapshot_data);
+	}
+
+	snapshot_data->new_listeners_pending = false;
+	snapshot_data->publishing = true;
+
+	return res;
+}
+
+/*
+ *	Returns true if the listener of the call is still attached: a listener called without the guards may close
+ *  the handles of the listeners called after it, and they mustn't be called then
+ */
+int dx_is_snapshot_listener_call_valid(dx_snapshot_data_ptr_t snapshot_data, const dx_snapshot_listener_call_t* call) {
+	int found = false;
+	size_t i = 0;
+
+	if (!dx_mutex_lock(&snapshot_data->guard)) {
+		return false;
+	}
+
+	for (; !snapshot_data->closed && !found && i < snapshot_data->listeners.size; ++i) {
+		const dx_snapshot_listener_context_t* listener_context = snapshot_data->listeners.elements + i;
+
+		found = listener_context->handle == call->listener.handle &&
+			listener_context->incremental == call->listener.incremental &&
+			listener_context->full_listener == call->listener.full_listener &&
+			listener_context->user_data == call->listener.user_data;
+	}
+
+	dx_mutex_unlock(&snapshot_data->guard);
+
+	return found;
+}
+
+/* Calls the listeners of the publication that are still attached, the listeners are called without any guards */
+void dx_make_snapshot_publication(dx_snapshot_publication_t* publication) {
+	size_t i = 0;
+
+	for (; i < publication->calls.size; ++i) {
+		const dx_snapshot_listener_call_t* call = publication->calls.elements + i;
+		const dx_snapshot_records_array_t* records =
+			call->full_snapshot ? &publication->full_records : &publication->tx_records;
+
+		if (!dx_is_snapshot_listener_call_valid(publication->snapshot_data, call)) {
+			continue;
+		}
+
+		dx_call_snapshot_listener(publication->snapshot_data, &call->listener, records->elements, records->size,
+			call->full_snapshot);
+	}
+}
+
+/* Returns the resources of the publication to its snapshot, must be called under the snapshot guard */
+void dx_return_snapshot_publication(dx_snapshot_publication_t* publication) {
+	dx_snapshot_data_ptr_t snapshot_data = publication->snapshot_data;
+
+	dx_snapshot_return_records(&snapshot_data->snapshot_records, &publication->full_records);
+	dx_snapshot_return_records(&snapshot_data->last_tx_records, &publication->tx_records);
+
+	if (snapshot_data->strings_retired) {
+		dx_free_string_arena(&snapshot_data->retired_strings);
+		snapshot_data->strings_retired = false;
+	}
+
+	snapshot_data->publishing = false;
+}
+
+/* Returns true if the closed snapshot is referenced no more and must be freed, must be called under its guard */
+int dx_is_snapshot_data_released(dx_snapshot_data_ptr_t snapshot_data) {
+	return snapshot_data->closed && !snapshot_data->publisher_ref && snapshot_data->dispatch_count == 0;
+}
+
+/* Returns the resources of the publication made by the publisher task, must be called under the context guard */
+void dx_finish_snapshot_publication(dx_snapshot_publication_t* publication) {
+	dx_snapshot_data_ptr_t snapshot_data = publication->snapshot_data;
+	int released = false;
+
+	if (dx_mutex_lock(&snapshot_data->guard)) {
+		dx_return_snapshot_publication(publication);
+		snapshot_data->publisher_ref = false;
+		released = dx_is_snapshot_data_released(snapshot_data);
+		dx_mutex_unlock(&snapshot_data->guard);
+	}
+
+	CHECKED_FREE(publication->full_records.elements);
+	CHECKED_FREE(publication->tx_records.elements);
+	CHECKED_FREE(publication->calls.elements);
+
+	if (released) {
+		/* the snapshot has been closed by a listener called by the publisher task */
+		dx_free_snapshot_data(snapshot_data);
+	}
+}
+
+/*
+ *	Drops the reference of the event dispatch to the snapshot, and returns the resources of its publication
+ *  if there is one. The snapshot closed meanwhile is freed when it's referenced no more
+ */
+void dx_release_dispatched_snapshot(dx_snapshot_data_ptr_t snapshot_data, dx_snapshot_publication_t* publication) {
+	int released = false;
+
+	if (dx_mutex_lock(&snapshot_data->guard)) {
+		if (publication != NULL) {
+			dx_return_snapshot_publication(publication);
+		}
+
+		snapshot_data->dispatch_count--;
+		released = dx_is_snapshot_data_released(snapshot_data);
+		dx_mutex_unlock(&snapshot_data->guard);
+	}
+
+	if (publication != NULL) {
+		CHECKED_FREE(publication->full_records.elements);
+		CHECKED_FREE(publication->tx_records.elements);
+		CHECKED_FREE(publication->calls.elements);
+	}
+
+	if (released) {
+		dx_free_snapshot_data(snapshot_data);
+	}
+}
+
+/* -------------------------------------------------------------------------- */
+
+/*
+ *	The worker thread task publishing the snapshots whose publication is throttled or requested. The task stays
+ *  in the queue, which is polled every few tens of milliseconds, while some snapshot has pending changes.
+ *  The due publications are prepared under the guards and the listeners are called without them, so a listener
+ *  may close the snapshots; the snapshots referenced by the task are freed by it then
+ */
+int dx_snapshot_publisher_task(void* data, int command) {
+	dx_snapshot_subscription_connection_context_t* context = data;
+	dx_snapshot_publication_array_t publications = { NULL, 0, 0 };
+	int now = dx_millisecond_timestamp();
+	int pending = false;
+	size_t i = 0;
+
+	if (!dx_mutex_lock(&context->guard)) {
+		return dx_tes_dont_advance;
+	}
+
+	for (; i < context->snapshots_array.size; ++i) {
+		dx_snapshot_data_ptr_t snapshot_data = context->snapshots_array.elements[i];
+
+		if (!dx_mutex_lock(&snapshot_data->guard)) {
+			pending = true;
+
+			continue;
+		}
+
+		if (IS_FLAG_SET(command, dx_tc_free_resources)) {
+			/* the task is dropped along with the others on reconnection, the next transaction schedules it again */
+			snapshot_data->publication_pending = false;
+			snapshot_data->new_listeners_pending = false;
+		} else if (snapshot_data->status != dx_status_full || snapshot_data->publishing) {
+			/* the changes are published when the snapshot is received and the event dispatch has published it */
+			pending = pending || snapshot_data->publication_pending || snapshot_data->new_listeners_pending;
+		} else {
+			const int publish = snapshot_data->publication_pending &&
+				(snapshot_data->full_snapshot_requested ||
+				dx_millisecond_timestamp_diff(now, snapshot_data->last_publication_time) >=
+					snapshot_data->publication_policy.min_interval);
+			int failed = false;
+
+			if (publish || snapshot_data->new_listeners_pending) {
+				dx_snapshot_publication_t publication = { NULL };
+
+				DX_ARRAY_INSERT(publications, dx_snapshot_publication_t, publication, publications.size,
+					dx_capacity_manager_halfer, failed);
+
+				if (failed) {
+					/* the publication is retried by the next run of the task */
+					pending = true;
+				} else {
+					dx_prepare_snapshot_publication(snapshot_data, publish, &publications.elements[publications.size - 1]);
+					snapshot_data->publisher_ref = true;
+				}
+			}
+
+			pending = pending || snapshot_data->publication_pending;
+		}
+
+		dx_mutex_unlock(&snapshot_data->guard);
+	}
+
+	if (IS_FLAG_SET(command, dx_tc_free_resources) || !pending) {
+		context->publisher_scheduled = false;
+	}
+
+	context->publisher_calling = (publications.size > 0);
+	context->publisher_thread = dx_get_thread_id();
+
+	dx_mutex_unlock(&context->guard);
+
+	for (i = 0; i < publications.size; ++i) {
+		dx_make_snapshot_publication(publications.elements + i);
+	}
+
+	if (publications.size > 0 && dx_mutex_lock(&context->guard)) {
+		for (i = 0; i < publications.size; ++i) {
+			dx_finish_snapshot_publication(publications.elements + i);
+		}
+
+		context->publisher_calling = false;
+		dx_condition_broadcast(&context->publication_ended);
+		dx_mutex_unlock(&context->guard);
+	}
+
+	CHECKED_FREE(publications.elements);
+
+	if (IS_FLAG_SET(command, dx_tc_free_resources)) {
+		return dx_tes_success;
+	}
+
+	return pending ? dx_tes_success : (dx_tes_pop_me | dx_tes_success);
+}
+
+/* -------------------------------------------------------------------------- */
+
+/* Returns true if the caller is a listener called by the publisher task, must be called under the context guard */
+int dx_is_snapshot_publisher_thread(dx_snapshot_subscription_connection_context_t* context) {
+	return context->publisher_calling && dx_compare_threads(dx_get_thread_id(), context->publisher_thread);
+}
+
+/* Returns true if the caller is a listener called by the event dispatch, must be called under the context guard */
+int dx_is_snapshot_dispatch_thread(dx_snapshot_data_ptr_t snapshot_data) {
+	return snapshot_data->dispatch_publishing && dx_compare_threads(dx_get_thread_id(), snapshot_data->dispatch_thread);
+}
+
+/*
+ *	Waits until the publisher task and the event dispatch call no listeners of the snapshot, so the listeners
+ *  removed by the caller are not called anymore. The listeners called by them don't wait, otherwise they would
+ *  wait for themselves. Must be called under the connection context guard
+ */
+void dx_wait_for_snapshot_publisher(dx_snapshot_subscription_connection_context_t* context,
+									dx_snapshot_data_ptr_t snapshot_data) {
+	if (dx_is_snapshot_publisher_thread(context) || dx_is_snapshot_dispatch_thread(snapshot_data)) {
+		return;
+	}
+
+	while (snapshot_data->publisher_ref || snapshot_data->dispatch_publishing) {
+		if (!dx_condition_wait(&context->publication_ended, &context->guard, PUBLISHER_WAIT_TIMEOUT)) {
+			dx_logging_last_error();
+
+			return;
+		}
+	}
+}
+
+/* Must be called without the snapshot guard, see dx_wait_for_snapshot_publisher */
+int dx_snapshot_listeners_removed(dx_snapshot_data_ptr_t snapshot_data) {
+	dx_snapshot_subscription_connection_context_t* context = CTX(snapshot_data->sscc);
+
+	CHECKED_CALL(dx_mutex_lock, &(context->guard));
+
+	dx_wait_for_snapshot_publisher(context, snapshot_data);
+
+	return dx_mutex_unlock(&(context->guard));
+}
+
+/* -------------------------------------------------------------------------- */
+
+/* Must be called without the snapshot guard, which the publisher task takes after the connection context guard */
+int dx_schedule_snapshot_publisher(dx_snapshot_subscription_connection_context_t* context) {
+	int schedule = false;
+
+	CHECKED_CALL(dx_mutex_lock, &context->guard);
+
+	if (!context->publisher_scheduled) {
+		context->publisher_scheduled = true;
+		schedule = true;
+	}
+
+	CHECKED_CALL(dx_mutex_unlock, &context->guard);
+
+	if (schedule && !dx_add_worker_thread_task(context->connection, dx_snapshot_publisher_task, context)) {
+		if (dx_mutex_lock(&context->guard)) {
+			context->publisher_scheduled = false;
+			dx_mutex_unlock(&context->guard);
+		}
+
+		return false;
+	}
+
+	return true;
+}
+
+/* -------------------------------------------------------------------------- */
+
+/*
+ *	Calls the listeners of the publication prepared by the event dispatch without the guards, so they may close
+ *  the snapshots and create the new ones, and drops the reference of the dispatch to the snapshot
+ */
+void dx_make_dispatched_snapshot_publication(dx_snapshot_data_ptr_t snapshot_data,
+											dx_snapshot_publication_t* publication) {
+	dx_snapshot_subscription_connection_context_t* context = CTX(snapshot_data->sscc);
+
+	if (publication->calls.size > 0 && dx_mutex_lock(&context->guard)) {
+		snapshot_data->dispatch_publishing = true;
+		snapshot_data->dispatch_thread = dx_get_thread_id();
+		dx_mutex_unlock(&context->guard);
+
+		dx_make_snapshot_publication(publication);
+
+		if (dx_mutex_lock(&context->guard)) {
+			snapshot_data->dispatch_publishing = false;
+			dx_condition_broadcast(&context->publication_ended);
+			dx_mutex_unlock(&context->guard);
+		}
+	}
+
+	dx_release_dispatched_snapshot(snapshot_data, publication);
+}
+
+void event_listener(int event_type, dxf_const_string_t symbol_name,
+					const dxf_event_data_t* data, int data_count,
+					const dxf_event_params_t* event_params, void* user_data) {
+	dx_snapshot_data_ptr_t snapshot_data = (dx_snapshot_data_ptr_t)user_data;
+	dx_snapshot_publication_t publication;
+	int schedule_publication = false;
+	int publish = false;
+
+	int sb = IS_FLAG_SET(event_params->flags, dxf_ef_snapshot_begin);
+	int se = IS_FLAG_SET(event_params->flags, dxf_ef_snapshot_end) || IS_FLAG_SET(event_params->flags, dxf_ef_snapshot_snip);
+	int tx = IS_FLAG_SET(event_params->flags, dxf_ef_tx_pending);
+
+	/* It should be no-op, really */
+	if (!dx_is_snapshot_event(snapshot_data, event_params)) {
+		return;
+	}
+
+	int rm = IS_FLAG_SET(event_params->flags, dxf_ef_remove_event) || dx_is_zero_event(snapshot_data->event_id, data);
+
+	/* The records may be published by the worker thread at the same time, and the listener list must be intact */
+	if (!dx_mutex_lock(&snapshot_data->guard))
+		return;
+
+	/* Ok, process this event */
+	if (sb) {
+		/* Clear snapshot */
+		dx_snapshot_clear_records_array(snapshot_data, &snapshot_data->snapshot_records);
+		dx_snapshot_clear_records_array(snapshot_data, &snapshot_data->last_tx_records);
+		dx_snapshot_clear_strings(snapshot_data);
+		snapshot_data->status = dx_status_begin;
+		snapshot_data->full_snapshot_published = false;
+	}
+	if (snapshot_data->status == dx_status_unknown || snapshot_data->closed) {
+		/* If we in unknown state, or the routed snapshot has been closed meanwhile, skip */
+		dx_mutex_unlock(&snapshot_data->guard);
+		return;
+	}
+
+	/* Process this event */
+	if (rm) {
+		dx_snapshot_remove_event_records(snapshot_data, &snapshot_data->snapshot_records, data, event_params);
+	} else {
+		dx_snapshot_update_event_records(snapshot_data, &snapshot_data->snapshot_records, data, event_params);
+	}
+	/* Add to the current tx, if it is pending transaction, may be only with one event, add even "rm" event */
+	if (snapshot_data->has_inc_listeners && snapshot_data->full_snapshot_published) {
+		dx_snapshot_update_event_records(snapshot_data, &snapshot_data->last_tx_records, data, event_params);
+	}
+
+	/* Set end-of-snapshot */
+	if (se) {
+		snapshot_data->status = dx_status_full;
+		snapshot_data->full_snapshot_received = true;
+	}
+
+	if (tx && snapshot_data->status == dx_status_full) {
+		snapshot_data->status = dx_status_pending;
+	} else if (!tx && snapshot_data->status == dx_status_pending) {
+		snapshot_data->status = dx_status_full;
+	}
+
+	/*
+	 *	And call all consumers if it is end of transaction, the throttled ones are called by the publisher task.
+	 *  So are the listeners being called by the publisher task, they get the changes when it's done.
+	 *  The listeners are called without the snapshot guard: the publisher task takes it after the context guard,
+	 *  which a listener closing a snapshot takes
+	 */
+	if (snapshot_data->status == dx_status_full) {
+		if (snapshot_data->publication_policy.min_interval > 0 || snapshot_data->publishing) {
+			/* the changes of the transactions completed until the publication are passed at once */
+			schedule_publication = !snapshot_data->publication_pending;
+			snapshot_data->publication_pending = true;
+		} else {
+			dx_prepare_snapshot_publication(snapshot_data, true, &publication);
+			snapshot_data->dispatch_count++;
+			publish = true;
+		}
+	}
+
+	dx_mutex_unlock(&snapshot_data->guard);
+
+	if (publish) {
+		dx_make_dispatched_snapshot_publication(snapshot_data, &publication);
+	}
+
+	if (schedule_publication) {
+		dx_schedule_snapshot_publisher(CTX(snapshot_data->sscc));
+	}
+}
+
+/* -------------------------------------------------------------------------- */
+/*
+ *	Snapshot router functions
+ */
+/* -------------------------------------------------------------------------- */
+
+/* The keys of the routed snapshots are unique, as the ones of all the snapshots of the connection */
+int dx_add_routed_snapshot(dx_snapshot_router_ptr_t router, dx_snapshot_data_ptr_t snapshot_data) {
+	return dx_add_snapshot_key_value(&router->snapshots, snapshot_data->key, snapshot_data);
+}
+
+void dx_remove_routed_snapshot(dx_snapshot_router_ptr_t router, dx_snapshot_data_ptr_t snapshot_data) {
+	dx_remove_snapshot_key_value(&router->snapshots, snapshot_data->key, snapshot_data);
+}
+
+dx_snapshot_router_ptr_t dx_new_snapshot_router(dxf_subscription_t subscription) {
+	dx_snapshot_router_ptr_t router = dx_calloc(1, sizeof(dx_snapshot_router_t));
+
+	if (router == NULL) {
+		return NULL;
+	}
+
+	if (!dx_mutex_create(&router->guard)) {
+		dx_free(router);
+
+		return NULL;
+	}
+
+	router->subscription = subscription;
+	dx_init_snapshot_key_table(&router->snapshots);
+
+	return router;
+}
+
+void dx_free_snapshot_router(dx_snapshot_router_ptr_t router) {
+	dx_free_snapshot_key_table(&router->snapshots);
+	dx_mutex_destroy(&router->guard);
+	dx_free(router);
+}
+
+/* The listener of the subscription of the snapshots created at once */
+void dx_snapshot_router_listener(int event_type, dxf_const_string_t symbol_name,
+								const dxf_event_data_t* data, int data_count,
+								const dxf_event_params_t* event_params, void* user_data) {
+	dx_snapshot_router_ptr_t router = (dx_snapshot_router_ptr_t)user_data;
+	dx_snapshot_data_ptr_t snapshot_data = NULL;
+
+	int retired = false;
+
+	if (!dx_mutex_lock(&router->guard))
+		return;
+
+	/* the snapshot is referenced, so it's freed after the event is passed if it's closed meanwhile */
+	if ((snapshot_data = dx_find_snapshot_key_value(&router->snapshots, event_params->snapshot_key)) != NULL &&
+		dx_mutex_lock(&snapshot_data->guard)) {
+
+		snapshot_data->dispatch_count++;
+		router->dispatch_count++;
+		dx_mutex_unlock(&snapshot_data->guard);
+	} else {
+		snapshot_data = NULL;
+	}
+
+	dx_mutex_unlock(&router->guard);
+
+	if (snapshot_data == NULL) {
+		return;
+	}
+
+	/* the listeners of a snapshot don't hold up the other snapshots of the router */
+	event_listener(event_type, symbol_name, data, data_count, event_params, snapshot_data);
+	dx_release_dispatched_snapshot(snapshot_data, NULL);
+
+	if (!dx_mutex_lock(&router->guard))
+		return;
+
+	retired = (--router->dispatch_count == 0 && router->retired);
+
+	dx_mutex_unlock(&router->guard);
+
+	if (retired) {
+		/* the last routed snapshot has been closed by its listener */
+		dx_free_snapshot_router(router);
+	}
+}
+
+/*
+ *	Frees the router of the closed last routed snapshot. The subscription listener is removed already, so only
+ *  the dispatch of the calling thread may be using the router, a listener called by it closing the snapshot
+ */
+int dx_retire_snapshot_router(dx_snapshot_router_ptr_t router) {
+	int retired = false;
+
+	CHECKED_CALL(dx_mutex_lock, &router->guard);
+
+	router->retired = true;
+	retired = (router->dispatch_count == 0);
+
+	CHECKED_CALL(dx_mutex_unlock, &router->guard);
+
+	if (retired) {
+		dx_free_snapshot_router(router);
+	}
+
+	return true;
+}
+
+/* -------------------------------------------------------------------------- */
+
+/*
+ * Function generate key for snapshot object using record_info_id, symbol and source
+ *
+ * snapshot key format:
+ * 64 - 56     55 - 24  23 - 0
+ * record_id | symbol | source
+ *
+ * record_info_id - record type of snapshot subscription
+ * symbol - string symbol of snapshot subscription
+ * order_source - source for Order records or keyword for MarketMaker; can be NULL also
+ * returns 64 bit unsigned decimal
+ */
+dxf_ulong_t dx_new_snapshot_key(dx_record_info_id_t record_info_id, dxf_const_string_t symbol,
+								dxf_const_string_t order_source) {
+	dxf_ulong_t symbol_hash = dx_symbol_name_hasher(symbol);
+	dxf_ulong_t order_source_hash = (order_source == NULL ? 0u : dx_symbol_name_hasher(order_source));
+	return dx_make_snapshot_key(record_info_id, symbol_hash, order_source_hash);
+}
+
+/* Generates the key of dx_new_snapshot_key from the hashes computed beforehand, the source hash is 0 without a source */
+dxf_ulong_t dx_make_snapshot_key(dx_record_info_id_t record_info_id, dxf_ulong_t symbol_hash,
+								dxf_ulong_t order_source_hash) {
+	return ((dxf_ulong_t)record_info_id << 56u) |
+		((dxf_ulong_t)symbol_hash << 24u) |
+		(order_source_hash & SNAPSHOT_KEY_SOURCE_MASK);
+}
+
+/* -------------------------------------------------------------------------- */
+
+int dx_has_record_snapshots(dxf_connection_t connection, dx_record_info_id_t record_info_id) {
+	dx_snapshot_subscription_connection_context_t* context = dx_get_subsystem_data(connection, dx_ccs_snapshot_subscription, NULL);
+
+	return context != NULL && atomic_read(&context->record_snapshot_counts[record_info_id]) > 0;
+}
+
+int dx_snapshots_comparator(dx_snapshot_data_ptr_t s1, dx_snapshot_data_ptr_t s2) {
+	return DX_NUMERIC_COMPARATOR(s1->key, s2->key);
+}
+
+void dx_clear_snapshot_listener_array(dx_snapshot_listener_array_t* listeners) {
+	dx_free(listeners->elements);
+
+	listeners->elements = NULL;
+	listeners->size = 0;
+	listeners->capacity = 0;
+}
+
+int dx_snapshot_listener_comparator(dx_snapshot_listener_context_t e1,
+									dx_snapshot_listener_context_t e2) {
+	return e1.incremental == e2.incremental && e1.handle == e2.handle ?
+		DX_FORCED_NUMERIC_COMPARATOR(e1.full_listener, e2.full_listener) : -1;
+}
+
+size_t dx_find_snapshot_listener_in_array(dx_snapshot_listener_array_t* listeners, void* handle,
+									int incremental, void *listener, OUT int* found) {
+	size_t listener_index;
+	dx_snapshot_listener_context_t listener_context = { incremental, false, {.full_listener = *(dxf_snapshot_listener_t*)(&listener)}, NULL, handle };
+
+	DX_ARRAY_SEARCH(listeners->elements, 0, listeners->size, listener_context,
+		dx_snapshot_listener_comparator, false, *found, listener_index);
+
+	return listener_index;
+}
+
+void dx_update_has_inc_listeners(dx_snapshot_data_ptr_t snapshot_data) {
+	size_t listener_index = 0;
+
+	snapshot_data->has_inc_listeners = false;
+
+	for (; !snapshot_data->has_inc_listeners && listener_index < snapshot_data->listeners.size; listener_index++) {
+		snapshot_data->has_inc_listeners |= snapshot_data->listeners.elements[listener_index].incremental;
+	}
+}
+
+/* Removes the listeners attached with the handle, must be called under the snapshot guard */
+int dx_remove_handle_snapshot_listeners(dx_snapshot_data_ptr_t snapshot_data, dx_snapshot_handle_ptr_t handle) {
+	size_t listener_index = snapshot_data->listeners.size;
+	int failed = false;
+
+	while (listener_index-- > 0) {
+		if (snapshot_data->listeners.elements[listener_index].handle == handle) {
+			DX_ARRAY_DELETE(snapshot_data->listeners, dx_snapshot_listener_context_t, listener_index,
+				dx_capacity_manager_halfer, failed);
+
+			if (failed) {
+				return dx_set_error_code(dx_mec_insufficient_memory);
+			}
+		}
+	}
+
+	dx_update_has_inc_listeners(snapshot_data);
+
+	return true;
+}
 
 int dx_free_snapshot_data(dx_snapshot_data_ptr_t snapshot_data) {
 	if (snapshot_data == NULL) {
 		return false;
 	}
 
-	/* remove listeners */
-	dx_clear_snapshot_listener_array(&(snapshot_data->listeners));
+	if (snapshot_data->sscc != NULL) {
+		dx_atomic_add(&CTX(snapshot_data->sscc)->record_snapshot_counts[snapshot_data->record_info_id], -1);
+	}
+
+	/* the handles left open by the time the connection is closed */
+	while (snapshot_data->handles != NULL) {
+		dx_snapshot_handle_ptr_t handle = snapshot_data->handles;
+
+		snapshot_data->handles = handle->next;
+		dx_free(handle);
+	}
+
+	/* remove listeners */
+	dx_clear_snapshot_listener_array(&(snapshot_data->listeners));
+
+	/* remove records */
+	dx_snapshot_free_records(snapshot_data, &snapshot_data->snapshot_records);
+	dx_snapshot_free_records(snapshot_data, &snapshot_data->last_tx_records);
+	dx_free_string_arena(&snapshot_data->strings);
+
+	if (snapshot_data->strings_retired) {
+		dx_free_string_arena(&snapshot_data->retired_strings);
+	}
+
+	if (snapshot_data->symbol != NULL)
+		dx_free(snapshot_data->symbol);
+	if (snapshot_data->order_source != NULL)
+		dx_free(snapshot_data->order_source);
+
+	dx_mutex_destroy(&snapshot_data->guard);
+	dx_free(snapshot_data);
+	return true;
+}
+
+/*
+ *	Frees the closed snapshot, which gets no events anymore. A listener called by the event dispatch or the publisher
+ *  task may be closing it though, the snapshot is freed when they return then and its listeners aren't called anymore
+ */
+int dx_retire_snapshot_data(dx_snapshot_data_ptr_t snapshot_data) {
+	int released = false;
+
+	CHECKED_CALL(dx_mutex_lock, &(snapshot_data->guard));
+
+	snapshot_data->closed = true;
+
+	if (!(released = dx_is_snapshot_data_released(snapshot_data))) {
+		dx_clear_snapshot_listener_array(&(snapshot_data->listeners));
+	}
+
+	CHECKED_CALL(dx_mutex_unlock, &(snapshot_data->guard));
+
+	return !released || dx_free_snapshot_data(snapshot_data);
+}
+
+/* -------------------------------------------------------------------------- */
+/*
+ *	Subscription functions implementation
+ */
+/* -------------------------------------------------------------------------- */
+
+/* Returns a new handle of the snapshot, must be called under the connection context guard */
+dx_snapshot_handle_ptr_t dx_new_snapshot_handle(dx_snapshot_data_ptr_t snapshot_data) {
+	dx_snapshot_handle_ptr_t handle = dx_calloc(1, sizeof(dx_snapshot_handle_t));
+
+	if (handle == NULL) {
+		return NULL;
+	}
+
+	handle->snapshot_data = snapshot_data;
+	handle->next = snapshot_data->handles;
+	snapshot_data->handles = handle;
+
+	return handle;
+}
+
+/* The snapshots can be shared only if they have the same parameters, the keys of different symbols may be the same */
+int dx_is_same_snapshot(dx_snapshot_data_ptr_t snapshot_data, dx_event_id_t event_id, dxf_const_string_t symbol,
+						dxf_const_string_t order_source, dxf_long_t time) {
+	return snapshot_data->event_id == event_id && snapshot_data->time == time &&
+		dx_compare_strings(snapshot_data->symbol, symbol) == 0 &&
+		(snapshot_data->order_source == NULL || order_source == NULL ?
+			snapshot_data->order_source == order_source :
+			dx_compare_strings(snapshot_data->order_source, order_source) == 0);
+}
+
+/* Returns the open snapshot with the key or NULL, must be called under the connection context guard */
+dx_snapshot_data_ptr_t dx_find_snapshot_data(dx_snapshot_subscription_connection_context_t* context, dxf_ulong_t key,
+											OUT size_t* position) {
+	dx_snapshot_data_t snapshot_key;
+	int found = false;
+
+	*position = 0;
+
+	if (context->snapshots_array.size == 0) {
+		return NULL;
+	}
+
+	snapshot_key.key = key;
 
-	/* remove records */
-	dx_snapshot_clear_records_array(snapshot_data, &snapshot_data->snapshot_records);
-	dx_snapshot_clear_records_array(snapshot_data, &snapshot_data->last_tx_records);
+	DX_ARRAY_BINARY_SEARCH(context->snapshots_array.elements, 0, context->snapshots_array.size,
+		&snapshot_key, dx_snapshots_comparator, found, *position);
 
-	if (snapshot_data->symbol != NULL)
-		dx_free(snapshot_data->symbol);
-	if (snapshot_data->order_source != NULL)
-		dx_free(snapshot_data->order_source);
+	return found ? context->snapshots_array.elements[*position] : NULL;
+}
 
-	dx_mutex_destroy(&snapshot_data->guard);
-	dx_free(snapshot_data);
-	return true;
+dx_snapshot_subscription_connection_context_t* dx_get_snapshot_context(dxf_connection_t connection) {
+	dx_snapshot_subscription_connection_context_t* context = NULL;
+	int res = false;
+
+	if (!dx_validate_connection_handle(connection, false)) {
+		return NULL;
+	}
+
+	context = dx_get_subsystem_data(connection, dx_ccs_snapshot_subscription, &res);
+	if (context == NULL && res) {
+		dx_set_error_code(dx_cec_connection_context_not_initialized);
+	}
+
+	return context;
 }
 
 /* -------------------------------------------------------------------------- */
-/*
- *	Subscription functions implementation
- */
+
+int dx_publish_snapshots(dxf_connection_t connection) {
+	dx_snapshot_subscription_connection_context_t* context = dx_get_snapshot_context(connection);
+
+	return context != NULL && IS_FLAG_SET(dx_snapshot_publisher_task(context, 0), dx_tes_success);
+}
+
 /* -------------------------------------------------------------------------- */
 
-dxf_snapshot_t dx_create_snapshot(dxf_connection_t connection,
-								dxf_subscription_t subscription,
-								dx_event_id_t event_id,
-								dx_record_info_id_t record_info_id,
-								dxf_const_string_t symbol,
-								dxf_const_string_t order_source,
-								dxf_long_t time) {
+int dx_share_snapshot(dxf_connection_t connection,
+					dx_event_id_t event_id,
+					dx_record_info_id_t record_info_id,
+					dxf_const_string_t symbol,
+					dxf_const_string_t order_source,
+					dxf_long_t time,
+					OUT dxf_snapshot_t* snapshot) {
 	dx_snapshot_subscription_connection_context_t* context = NULL;
-	dx_snapshot_data_t *snapshot_data = NULL;
-	int failed = false;
-	int found = false;
-	int res = false;
+	dx_snapshot_data_ptr_t snapshot_data = NULL;
 	size_t position = 0;
-	unsigned event_types;
 
-	if (!dx_validate_connection_handle(connection, false)) {
-		return dx_invalid_snapshot;
+	*snapshot = dx_invalid_snapshot;
+
+	if ((context = dx_get_snapshot_context(connection)) == NULL) {
+		return false;
 	}
 
-	context = dx_get_subsystem_data(connection, dx_ccs_snapshot_subscription, &res);
-	if (context == NULL) {
-		if (res) {
-			dx_set_error_code(dx_cec_connection_context_not_initialized);
-		}
+	CHECKED_CALL(dx_mutex_lock, &(context->guard));
 
-		return dx_invalid_snapshot;
-	}
+	snapshot_data = dx_find_snapshot_data(context, dx_new_snapshot_key(record_info_id, symbol, order_source), &position);
 
-	if (!dx_get_event_subscription_event_types(subscription, &event_types)) {
-		return dx_invalid_snapshot;
+	if (snapshot_data != NULL && dx_is_same_snapshot(snapshot_data, event_id, symbol, order_source, time)) {
+		if ((*snapshot = (dxf_snapshot_t)dx_new_snapshot_handle(snapshot_data)) == dx_invalid_snapshot) {
+			dx_mutex_unlock(&(context->guard));
+
+			return false;
+		}
 	}
 
-	snapshot_data = dx_calloc(1, sizeof(dx_snapshot_data_t));
+	return dx_mutex_unlock(&(context->guard));
+}
+
+/* -------------------------------------------------------------------------- */
+
+/* Makes the snapshot, the records of its type get the snapshot keys from now on */
+dx_snapshot_data_ptr_t dx_new_snapshot_data(dx_snapshot_subscription_connection_context_t* context,
+											dxf_subscription_t subscription,
+											unsigned event_types,
+											dx_event_id_t event_id,
+											dx_record_info_id_t record_info_id,
+											dxf_const_string_t symbol,
+											dxf_const_string_t order_source,
+											dxf_long_t time) {
+	dx_snapshot_data_t *snapshot_data = dx_calloc(1, sizeof(dx_snapshot_data_t));
+
 	if (snapshot_data == NULL) {
-		return dx_invalid_snapshot;
+		return NULL;
 	}
 	if (!dx_mutex_create(&snapshot_data->guard)) {
 		dx_free(snapshot_data);
-		return dx_invalid_snapshot;
+		return NULL;
 	}
 	snapshot_data->key = dx_new_snapshot_key(record_info_id, symbol, order_source);
 	snapshot_data->record_info_id = record_info_id;
@@ -793,6 +1495,85 @@ dxf_snapshot_t dx_create_snapshot(dxf_connection_t connection,
 	snapshot_data->full_snapshot_published = true;
 	snapshot_data->sscc = context;
 	snapshot_data->subscription = subscription;
+	dx_init_snapshot_records(snapshot_data, &snapshot_data->snapshot_records);
+	dx_init_snapshot_records(snapshot_data, &snapshot_data->last_tx_records);
+	dx_init_string_arena(&snapshot_data->strings);
+
+	/* the records of this type get the snapshot keys from now on */
+	dx_atomic_add(&context->record_snapshot_counts[record_info_id], 1);
+
+	return snapshot_data;
+}
+
+/*
+ *	Adds the snapshot to the connection and returns its first handle. If the same snapshot has been created meanwhile,
+ *  returns a new handle of that snapshot and sets shared, the snapshot is to be freed by the caller then, as well as
+ *  on error. Must be called under the connection context guard
+ */
+dx_snapshot_handle_ptr_t dx_add_snapshot_data(dx_snapshot_subscription_connection_context_t* context,
+											dx_snapshot_data_ptr_t snapshot_data, OUT int* shared) {
+	dx_snapshot_data_ptr_t shared_snapshot_data = NULL;
+	dx_snapshot_handle_ptr_t handle = NULL;
+	size_t position = 0;
+	int failed = false;
+
+	*shared = false;
+
+	shared_snapshot_data = dx_find_snapshot_data(context, snapshot_data->key, &position);
+
+	if (shared_snapshot_data != NULL) {
+		if (!dx_is_same_snapshot(shared_snapshot_data, snapshot_data->event_id, snapshot_data->symbol,
+			snapshot_data->order_source, snapshot_data->time)) {
+			dx_set_error_code(dx_ssec_snapshot_exist);
+
+			return NULL;
+		}
+
+		*shared = true;
+
+		return dx_new_snapshot_handle(shared_snapshot_data);
+	}
+
+	if ((handle = dx_new_snapshot_handle(snapshot_data)) == NULL) {
+		return NULL;
+	}
+
+	/* add snapshot to array */
+	DX_ARRAY_INSERT(context->snapshots_array, dx_snapshot_data_ptr_t, snapshot_data, position,
+		dx_capacity_manager_halfer, failed);
+
+	/* the handle is freed along with the snapshot */
+	return failed ? NULL : handle;
+}
+
+/* -------------------------------------------------------------------------- */
+
+dxf_snapshot_t dx_create_snapshot(dxf_connection_t connection,
+								dxf_subscription_t subscription,
+								dx_event_id_t event_id,
+								dx_record_info_id_t record_info_id,
+								dxf_const_string_t symbol,
+								dxf_const_string_t order_source,
+								dxf_long_t time) {
+	dx_snapshot_subscription_connection_context_t* context = NULL;
+	dx_snapshot_data_t *snapshot_data = NULL;
+	dx_snapshot_handle_ptr_t handle = NULL;
+	int shared = false;
+	unsigned event_types;
+
+	if ((context = dx_get_snapshot_context(connection)) == NULL) {
+		return dx_invalid_snapshot;
+	}
+
+	if (!dx_get_event_subscription_event_types(subscription, &event_types)) {
+		return dx_invalid_snapshot;
+	}
+
+	snapshot_data = dx_new_snapshot_data(context, subscription, event_types, event_id, record_info_id, symbol,
+		order_source, time);
+	if (snapshot_data == NULL) {
+		return dx_invalid_snapshot;
+	}
 
 	if (!dx_add_listener_v2(snapshot_data->subscription, event_listener, (void*)snapshot_data)) {
 		dx_free_snapshot_data(snapshot_data);
@@ -804,66 +1585,230 @@ dxf_snapshot_t dx_create_snapshot(dxf_connection_t connection,
 		return dx_invalid_snapshot;
 	}
 
-	if (context->snapshots_array.size > 0) {
-		DX_ARRAY_BINARY_SEARCH(context->snapshots_array.elements, 0, context->snapshots_array.size,
-			snapshot_data, dx_snapshots_comparator, found, position);
-		if (found) {
+	handle = dx_add_snapshot_data(context, snapshot_data, &shared);
+
+	if (!dx_mutex_unlock(&(context->guard))) {
+		return dx_invalid_snapshot;
+	}
+
+	if (handle == NULL || shared) {
+		/* the same snapshot has been created meanwhile, it's shared then and the subscription stays unused */
+		dx_remove_listener_v2(subscription, event_listener);
+		dx_free_snapshot_data(snapshot_data);
+	}
+
+	return (dxf_snapshot_t)handle;
+}
+
+/* -------------------------------------------------------------------------- */
+
+int dx_create_snapshots(dxf_connection_t connection,
+						dxf_subscription_t subscription,
+						dx_event_id_t event_id,
+						dx_record_info_id_t record_info_id,
+						dxf_const_string_t* symbols,
+						int symbol_count,
+						dxf_const_string_t order_source,
+						dxf_long_t time,
+						dxf_snapshot_t* snapshots) {
+	dx_snapshot_subscription_connection_context_t* context = NULL;
+	dx_snapshot_router_ptr_t router = NULL;
+	size_t routed_count = 0;
+	int failed = false;
+	int i = 0;
+	unsigned event_types;
+
+	if ((context = dx_get_snapshot_context(connection)) == NULL) {
+		return false;
+	}
+
+	CHECKED_CALL_2(dx_get_event_subscription_event_types, subscription, &event_types);
+
+	if ((router = dx_new_snapshot_router(subscription)) == NULL) {
+		return false;
+	}
+
+	/* the snapshots are added to the router without growing the table, so they are added for sure */
+	if (!dx_reserve_snapshot_key_table(&router->snapshots, (size_t)symbol_count)) {
+		dx_free_snapshot_router(router);
+
+		return false;
+	}
+
+	if (!dx_add_listener_v2(subscription, dx_snapshot_router_listener, (void*)router)) {
+		dx_free_snapshot_router(router);
+
+		return false;
+	}
+
+	for (; i < symbol_count && !failed; ++i) {
+		dx_snapshot_data_ptr_t snapshot_data = NULL;
+		dx_snapshot_handle_ptr_t handle = NULL;
+		int shared = false;
+
+		if (snapshots[i] != dx_invalid_snapshot) {
+			continue;
+		}
+
+		snapshot_data = dx_new_snapshot_data(context, subscription, event_types, event_id, record_info_id,
+			symbols[i], order_source, time);
+		if (snapshot_data == NULL || !dx_mutex_lock(&(context->guard))) {
 			dx_free_snapshot_data(snapshot_data);
-			dx_set_error_code(dx_ssec_snapshot_exist);
-			dx_mutex_unlock(&(context->guard));
-			return dx_invalid_snapshot;
+			failed = true;
+
+			break;
+		}
+
+		snapshot_data->router = router;
+		handle = dx_add_snapshot_data(context, snapshot_data, &shared);
+
+		/* the router guard can't be taken under the connection context guard, see dx_snapshot_router_listener */
+		failed = !dx_mutex_unlock(&(context->guard)) || handle == NULL;
+
+		if (handle == NULL || shared) {
+			/* the same snapshot has been created meanwhile, it's shared then and it isn't routed */
+			dx_free_snapshot_data(snapshot_data);
+		} else {
+			/* the snapshot can be shared by another thread already, and the table has room for it */
+			if (dx_mutex_lock(&router->guard)) {
+				dx_add_routed_snapshot(router, snapshot_data);
+				dx_mutex_unlock(&router->guard);
+			}
+
+			routed_count++;
 		}
+
+		snapshots[i] = (dxf_snapshot_t)handle;
 	}
 
-	/* add snapshot to array */
-	DX_ARRAY_INSERT(context->snapshots_array, dx_snapshot_data_ptr_t, snapshot_data, position,
-		dx_capacity_manager_halfer, failed);
-	if (failed) {
-		dx_free_snapshot_data(snapshot_data);
-		snapshot_data = dx_invalid_snapshot;
+	/* the router is freed along with its last snapshot otherwise */
+	if (routed_count == 0) {
+		dx_remove_listener_v2(subscription, dx_snapshot_router_listener);
+		dx_free_snapshot_router(router);
 	}
 
-	return (dx_mutex_unlock(&(context->guard)) ? (dxf_snapshot_t)snapshot_data : dx_invalid_snapshot);
+	return !failed;
 }
 
-int dx_close_snapshot(dxf_snapshot_t snapshot) {
+int dx_close_snapshot(dxf_snapshot_t snapshot, OUT dxf_subscription_t* subscription, OUT dxf_string_t* symbol) {
 	dx_snapshot_subscription_connection_context_t* context = NULL;
+	dx_snapshot_handle_ptr_t handle = (dx_snapshot_handle_ptr_t)snapshot;
+	dx_snapshot_handle_ptr_t* handle_link = NULL;
 	dx_snapshot_data_ptr_t snapshot_data = NULL;
+	dx_snapshot_router_ptr_t router = NULL;
+	int last_handle = false;
+	int last_routed = false;
 	int found = false;
 	int failed = false;
+	int res = true;
 	size_t position = 0;
 
+	*subscription = dx_invalid_subscription;
+	*symbol = NULL;
+
 	if (snapshot == dx_invalid_snapshot) {
 		return dx_set_error_code(dx_ssec_invalid_snapshot_id);
 	}
 
-	snapshot_data = (dx_snapshot_data_ptr_t)snapshot;
+	snapshot_data = handle->snapshot_data;
 	context = CTX(snapshot_data->sscc);
+	router = snapshot_data->router;
 
 	/* locking a guard mutex */
 	CHECKED_CALL(dx_mutex_lock, &(context->guard));
 
-	/* remove item from snapshots_array */
-	DX_ARRAY_BINARY_SEARCH(context->snapshots_array.elements, 0, context->snapshots_array.size,
-		snapshot_data, dx_snapshots_comparator, found, position);
-	if (found) {
-		DX_ARRAY_DELETE(context->snapshots_array, dx_snapshot_data_ptr_t, position,
-			dx_capacity_manager_halfer, failed);
-		if (failed) {
-			dx_set_error_code(dx_mec_insufficient_memory);
-		}
-		dx_free_snapshot_data(snapshot_data);
-		dx_mutex_unlock(&(context->guard));
-		return !failed;
+	for (handle_link = &snapshot_data->handles; *handle_link != NULL && *handle_link != handle;
+		handle_link = &(*handle_link)->next) {
 	}
-	else {
+
+	if (*handle_link == NULL) {
 		dx_mutex_unlock(&(context->guard));
 		return dx_set_error_code(dx_ssec_invalid_snapshot_id);
 	}
+
+	*handle_link = handle->next;
+	last_handle = (snapshot_data->handles == NULL);
+
+	if (last_handle) {
+		/* remove item from snapshots_array */
+		DX_ARRAY_BINARY_SEARCH(context->snapshots_array.elements, 0, context->snapshots_array.size,
+			snapshot_data, dx_snapshots_comparator, found, position);
+		if (found) {
+			DX_ARRAY_DELETE(context->snapshots_array, dx_snapshot_data_ptr_t, position,
+				dx_capacity_manager_halfer, failed);
+			if (failed) {
+				dx_set_error_code(dx_mec_insufficient_memory);
+			}
+		}
+
+		/* the snapshot closed by a listener is freed when the listener returns, see dx_retire_snapshot_data */
+		dx_wait_for_snapshot_publisher(context, snapshot_data);
+	}
+
+	res = dx_mutex_unlock(&(context->guard)) && !failed;
+
+	if (!last_handle) {
+		/* the other handles keep the snapshot open */
+		if (dx_mutex_lock(&(snapshot_data->guard))) {
+			res = dx_remove_handle_snapshot_listeners(snapshot_data, handle) && res;
+			res = dx_mutex_unlock(&(snapshot_data->guard)) && res;
+			res = dx_snapshot_listeners_removed(snapshot_data) && res;
+		} else {
+			res = false;
+		}
+	} else if (router == NULL) {
+		/* the snapshot isn't used by the subscription after its listener is removed, the caller closes it */
+		*subscription = snapshot_data->subscription;
+		res = dx_remove_listener_v2(snapshot_data->subscription, event_listener) && res;
+		res = dx_retire_snapshot_data(snapshot_data) && res;
+	} else {
+		/* the snapshot gets no events after it's removed from the router */
+		if (dx_mutex_lock(&router->guard)) {
+			dx_remove_routed_snapshot(router, snapshot_data);
+			last_routed = (router->snapshots.size == 0);
+			res = dx_mutex_unlock(&router->guard) && res;
+		} else {
+			res = false;
+		}
+
+		/* the subscription is closed by the caller along with the last routed snapshot, the symbol is removed otherwise */
+		*subscription = snapshot_data->subscription;
+
+		if (last_routed) {
+			res = dx_remove_listener_v2(snapshot_data->subscription, dx_snapshot_router_listener) && res;
+			res = dx_retire_snapshot_router(router) && res;
+		} else if ((*symbol = dx_create_string_src(snapshot_data->symbol)) == NULL) {
+			res = false;
+		}
+
+		res = dx_retire_snapshot_data(snapshot_data) && res;
+	}
+
+	dx_free(handle);
+
+	return res;
+}
+
+/* -------------------------------------------------------------------------- */
+
+/*
+ *	Unlocks the snapshot guard locked to add a listener. The listener gets the records of the snapshot received
+ *  already from the publisher task, e.g. the listener of a shared snapshot attached with a new handle
+ */
+int dx_snapshot_listener_added(dx_snapshot_data_ptr_t snapshot_data, int failed) {
+	int schedule_publication = !failed && snapshot_data->full_snapshot_received;
+
+	if (schedule_publication) {
+		snapshot_data->new_listeners_pending = true;
+	}
+
+	CHECKED_CALL(dx_mutex_unlock, &(snapshot_data->guard));
+
+	return !failed && (!schedule_publication || dx_schedule_snapshot_publisher(CTX(snapshot_data->sscc)));
 }
 
 int dx_add_snapshot_listener(dxf_snapshot_t snapshot, dxf_snapshot_listener_t listener, void* user_data) {
-	dx_snapshot_data_ptr_t snapshot_data = (dx_snapshot_data_ptr_t)snapshot;
+	dx_snapshot_data_ptr_t snapshot_data = NULL;
 	size_t listener_index;
 	int failed;
 	int found = false;
@@ -876,9 +1821,11 @@ int dx_add_snapshot_listener(dxf_snapshot_t snapshot, dxf_snapshot_listener_t li
 		return dx_set_error_code(dx_ssec_invalid_listener);
 	}
 
+	snapshot_data = SNAPSHOT_DATA(snapshot);
+
 	CHECKED_CALL(dx_mutex_lock, &(snapshot_data->guard));
 
-	listener_index = dx_find_snapshot_listener_in_array(&(snapshot_data->listeners), false, *(void**)(&listener), &found);
+	listener_index = dx_find_snapshot_listener_in_array(&(snapshot_data->listeners), snapshot, false, *(void**)(&listener), &found);
 
 	if (found) {
 		return dx_mutex_unlock(&snapshot_data->guard);
@@ -889,17 +1836,18 @@ int dx_add_snapshot_listener(dxf_snapshot_t snapshot, dxf_snapshot_listener_t li
 			.incremental = false,
 			.full_snapshot_seen = false,
 			.full_listener = listener,
-			.user_data = user_data
+			.user_data = user_data,
+			.handle = snapshot
 		};
 		DX_ARRAY_INSERT(snapshot_data->listeners, dx_snapshot_listener_context_t, listener_context,
 			listener_index, dx_capacity_manager_halfer, failed);
 	}
 
-	return dx_mutex_unlock(&(snapshot_data->guard)) && !failed;
+	return dx_snapshot_listener_added(snapshot_data, failed);
 }
 
 int dx_remove_snapshot_listener(dxf_snapshot_t snapshot, dxf_snapshot_listener_t listener) {
-	dx_snapshot_data_ptr_t snapshot_data = (dx_snapshot_data_ptr_t)snapshot;
+	dx_snapshot_data_ptr_t snapshot_data = NULL;
 	size_t listener_index;
 	int failed;
 	int found = false;
@@ -912,8 +1860,10 @@ int dx_remove_snapshot_listener(dxf_snapshot_t snapshot, dxf_snapshot_listener_t
 		return dx_set_error_code(dx_ssec_invalid_listener);
 	}
 
+	snapshot_data = SNAPSHOT_DATA(snapshot);
+
 	CHECKED_CALL(dx_mutex_lock, &(snapshot_data->guard));
-	listener_index = dx_find_snapshot_listener_in_array(&(snapshot_data->listeners), false, *(void**)(&listener), &found);
+	listener_index = dx_find_snapshot_listener_in_array(&(snapshot_data->listeners), snapshot, false, *(void**)(&listener), &found);
 
 	if (!found) {
 		return dx_mutex_unlock(&snapshot_data->guard);
@@ -927,11 +1877,11 @@ int dx_remove_snapshot_listener(dxf_snapshot_t snapshot, dxf_snapshot_listener_t
 	DX_ARRAY_DELETE(snapshot_data->listeners, dx_snapshot_listener_context_t, listener_index,
 		dx_capacity_manager_halfer, failed);
 
-	return dx_mutex_unlock(&snapshot_data->guard) && !failed;
+	return dx_mutex_unlock(&snapshot_data->guard) && !failed && dx_snapshot_listeners_removed(snapshot_data);
 }
 
 int dx_add_snapshot_inc_listener(dxf_snapshot_t snapshot, dxf_snapshot_inc_listener_t listener, void* user_data) {
-	dx_snapshot_data_ptr_t snapshot_data = (dx_snapshot_data_ptr_t)snapshot;
+	dx_snapshot_data_ptr_t snapshot_data = NULL;
 	size_t listener_index;
 	int failed;
 	int found = false;
@@ -944,8 +1894,10 @@ int dx_add_snapshot_inc_listener(dxf_snapshot_t snapshot, dxf_snapshot_inc_liste
 		return dx_set_error_code(dx_ssec_invalid_listener);
 	}
 
+	snapshot_data = SNAPSHOT_DATA(snapshot);
+
 	CHECKED_CALL(dx_mutex_lock, &(snapshot_data->guard));
-	listener_index = dx_find_snapshot_listener_in_array(&(snapshot_data->listeners), true, *(void**)(&listener), &found);
+	listener_index = dx_find_snapshot_listener_in_array(&(snapshot_data->listeners), snapshot, true, *(void**)(&listener), &found);
 
 	if (found) {
 		return dx_mutex_unlock(&snapshot_data->guard);
@@ -956,18 +1908,19 @@ int dx_add_snapshot_inc_listener(dxf_snapshot_t snapshot, dxf_snapshot_inc_liste
 			.incremental = true,
 			.full_snapshot_seen = false,
 			.inc_listener = listener,
-			.user_data = user_data
+			.user_data = user_data,
+			.handle = snapshot
 		};
 		DX_ARRAY_INSERT(snapshot_data->listeners, dx_snapshot_listener_context_t, listener_context,
 			listener_index, dx_capacity_manager_halfer, failed);
 		snapshot_data->has_inc_listeners = true;
 	}
 
-	return dx_mutex_unlock(&snapshot_data->guard) && !failed;
+	return dx_snapshot_listener_added(snapshot_data, failed);
 }
 
 int dx_remove_snapshot_inc_listener(dxf_snapshot_t snapshot, dxf_snapshot_inc_listener_t listener) {
-	dx_snapshot_data_ptr_t snapshot_data = (dx_snapshot_data_ptr_t)snapshot;
+	dx_snapshot_data_ptr_t snapshot_data = NULL;
 	size_t listener_index;
 	int failed;
 	int found = false;
@@ -980,8 +1933,10 @@ int dx_remove_snapshot_inc_listener(dxf_snapshot_t snapshot, dxf_snapshot_inc_li
 		return dx_set_error_code(dx_ssec_invalid_listener);
 	}
 
+	snapshot_data = SNAPSHOT_DATA(snapshot);
+
 	CHECKED_CALL(dx_mutex_lock, &(snapshot_data->guard));
-	listener_index = dx_find_snapshot_listener_in_array(&(snapshot_data->listeners), true, *(void**)(&listener), &found);
+	listener_index = dx_find_snapshot_listener_in_array(&(snapshot_data->listeners), snapshot, true, *(void**)(&listener), &found);
 
 	if (!found) {
 		return dx_mutex_unlock(&snapshot_data->guard);
@@ -991,28 +1946,69 @@ int dx_remove_snapshot_inc_listener(dxf_snapshot_t snapshot, dxf_snapshot_inc_li
 		dx_capacity_manager_halfer, failed);
 
 	/* Check, do we have anymore incremental listeners */
-	for (listener_index = 0; !snapshot_data->has_inc_listeners && listener_index < snapshot_data->listeners.size; listener_index++) {
-		snapshot_data->has_inc_listeners |= snapshot_data->listeners.elements[listener_index].incremental;
-	}
+	dx_update_has_inc_listeners(snapshot_data);
 
-	return dx_mutex_unlock(&snapshot_data->guard) && !failed;
+	return dx_mutex_unlock(&snapshot_data->guard) && !failed && dx_snapshot_listeners_removed(snapshot_data);
 }
 
 int dx_get_snapshot_subscription(dxf_snapshot_t snapshot, OUT dxf_subscription_t *subscription) {
 	if (snapshot == dx_invalid_snapshot) {
 		return dx_set_error_code(dx_ssec_invalid_snapshot_id);
 	}
-	*subscription = ((dx_snapshot_data_t*)snapshot)->subscription;
+	*subscription = SNAPSHOT_DATA(snapshot)->subscription;
 	return true;
 }
 
 dxf_string_t dx_get_snapshot_symbol(dxf_snapshot_t snapshot) {
-	dx_snapshot_data_ptr_t snapshot_data = (dx_snapshot_data_ptr_t)snapshot;
-
 	if (snapshot == dx_invalid_snapshot) {
 		dx_set_error_code(dx_ssec_invalid_snapshot_id);
 		return NULL;
 	}
 
-	return snapshot_data->symbol;
+	return SNAPSHOT_DATA(snapshot)->symbol;
+}
+
+/* -------------------------------------------------------------------------- */
+
+int dx_set_snapshot_publication_policy(dxf_snapshot_t snapshot, const dxf_snapshot_publication_policy_t* policy) {
+	dx_snapshot_data_ptr_t snapshot_data = NULL;
+
+	if (snapshot == dx_invalid_snapshot) {
+		return dx_set_error_code(dx_ssec_invalid_snapshot_id);
+	}
+
+	if (policy == NULL || policy->min_interval < 0) {
+		return dx_set_error_code(dx_ec_invalid_func_param);
+	}
+
+	snapshot_data = SNAPSHOT_DATA(snapshot);
+
+	CHECKED_CALL(dx_mutex_lock, &(snapshot_data->guard));
+
+	snapshot_data->publication_policy = *policy;
+
+	return dx_mutex_unlock(&(snapshot_data->guard));
+}
+
+/* -------------------------------------------------------------------------- */
+
+int dx_request_full_snapshot(dxf_snapshot_t snapshot) {
+	dx_snapshot_data_ptr_t snapshot_data = NULL;
+	int schedule_publication = false;
+
+	if (snapshot == dx_invalid_snapshot) {
+		return dx_set_error_code(dx_ssec_invalid_snapshot_id);
+	}
+
+	snapshot_data = SNAPSHOT_DATA(snapshot);
+
+	CHECKED_CALL(dx_mutex_lock, &(snapshot_data->guard));
+
+	snapshot_data->full_snapshot_requested = true;
+	schedule_publication = !snapshot_data->publication_pending;
+	snapshot_data->publication_pending = true;
+
+	CHECKED_CALL(dx_mutex_unlock, &(snapshot_data->guard));
+
+	return !schedule_publication || dx_schedule_snapshot_publisher(CTX(snapshot_data->sscc));
 }
@@ -38,7 +38,21 @@ extern const dxf_snapshot_t dx_invalid_snapshot;
  */
 /* -------------------------------------------------------------------------- */
 
-/* returns dx_invalid_snapshot on error */
+/*
+ *	Opens a new handle of the snapshot with the same parameters if it's open already, the snapshot is shared
+ *  by its handles then. Sets the snapshot to dx_invalid_snapshot if there's no such snapshot
+ */
+int dx_share_snapshot(dxf_connection_t connection,
+					dx_event_id_t event_id,
+					dx_record_info_id_t record_info_id,
+					dxf_const_string_t symbol,
+					dxf_const_string_t order_source,
+					dxf_long_t time,
+					OUT dxf_snapshot_t* snapshot);
+/*
+ *	Returns dx_invalid_snapshot on error. If the same snapshot has been created meanwhile, a handle of that snapshot
+ *  is returned and the subscription isn't used by it
+ */
 dxf_snapshot_t dx_create_snapshot(dxf_connection_t connection,
 								dxf_subscription_t subscription,
 								dx_event_id_t event_id,
@@ -46,14 +60,47 @@ dxf_snapshot_t dx_create_snapshot(dxf_connection_t connection,
 								dxf_const_string_t symbol,
 								dxf_const_string_t order_source,
 								dxf_long_t time);
-int dx_close_snapshot(dxf_snapshot_t snapshot);
+/*
+ *	Creates the snapshots of the symbols received with one subscription, their events are passed to the snapshots
+ *  by their keys. The symbols whose snapshots are given already are skipped, the snapshots of the other symbols
+ *  are the same as the ones created by dx_create_snapshot. The subscription isn't used by the snapshots if none
+ *  of them is new. On error the snapshots created are left to be closed by the caller
+ */
+int dx_create_snapshots(dxf_connection_t connection,
+						dxf_subscription_t subscription,
+						dx_event_id_t event_id,
+						dx_record_info_id_t record_info_id,
+						dxf_const_string_t* symbols,
+						int symbol_count,
+						dxf_const_string_t order_source,
+						dxf_long_t time,
+						dxf_snapshot_t* snapshots);
+/*
+ *	Closes the handle along with its listeners. The snapshot is closed with its last handle, its subscription
+ *  is returned then, it's dx_invalid_subscription otherwise. The caller closes the subscription, unless it's shared
+ *  with the other snapshots created at once, the symbol to remove from the subscription is returned in that case
+ *  and is to be freed by the caller
+ */
+int dx_close_snapshot(dxf_snapshot_t snapshot, OUT dxf_subscription_t* subscription, OUT dxf_string_t* symbol);
 int dx_add_snapshot_listener(dxf_snapshot_t snapshot, dxf_snapshot_listener_t listener, void* user_data);
 int dx_remove_snapshot_listener(dxf_snapshot_t snapshot, dxf_snapshot_listener_t listener);
 int dx_add_snapshot_inc_listener(dxf_snapshot_t snapshot, dxf_snapshot_inc_listener_t listener, void* user_data);
 int dx_remove_snapshot_inc_listener(dxf_snapshot_t snapshot, dxf_snapshot_inc_listener_t listener);
 int dx_get_snapshot_subscription(dxf_snapshot_t snapshot, OUT dxf_subscription_t *subscription);
+int dx_set_snapshot_publication_policy(dxf_snapshot_t snapshot, const dxf_snapshot_publication_policy_t* policy);
+/* the next publication passes all the records to the listeners, it's made by the worker thread */
+int dx_request_full_snapshot(dxf_snapshot_t snapshot);
+/*
+ *	Makes the due publications of the throttled and requested snapshots of the connection at once, as the worker
+ *  thread does while some snapshot has pending changes. Used where there's no worker thread, e.g. by the tests
+ */
+int dx_publish_snapshots(dxf_connection_t connection);
 dxf_ulong_t dx_new_snapshot_key(dx_record_info_id_t record_info_id, dxf_const_string_t symbol,
 								dxf_const_string_t order_source);
+dxf_ulong_t dx_make_snapshot_key(dx_record_info_id_t record_info_id, dxf_ulong_t symbol_hash,
+								dxf_ulong_t order_source_hash);
+/* returns true if there are open snapshots of the record type, so its records need the snapshot keys */
+int dx_has_record_snapshots(dxf_connection_t connection, dx_record_info_id_t record_info_id);
 dxf_string_t dx_get_snapshot_symbol(dxf_snapshot_t snapshot);
 
 #endif /* SNAPSHOT_H_INCLUDED */
\ No newline at end of file
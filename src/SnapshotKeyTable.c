@@ -0,0 +1,177 @@
+/*
+ * The contents of this file are subject to the Mozilla Public License Version
+ * 1.1 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ * http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+ * for the specific language governing rights and limitations under the
+ * License.
+ *
+ * The Initial Developer of the Original Code is Devexperts LLC.
+ * Portions created by the Initial Developer are Copyright (C) 2010
+ * the Initial Developer. All Rights Reserved.
+ *
+ * Contributor(s):
+ *
+ */
+
+#include "SnapshotKeyTable.h"
+
+#include "DXAlgorithms.h"
+#include "DXMemory.h"
+
+/* -------------------------------------------------------------------------- */
+/*
+ *	Snapshot key table data
+ */
+/* -------------------------------------------------------------------------- */
+
+#define MIN_SLOT_COUNT 16
+
+/* -------------------------------------------------------------------------- */
+/*
+ *	Helper functions
+ */
+/* -------------------------------------------------------------------------- */
+
+/* Returns the slot of the value with the key or the free slot the value is to be put to */
+static dx_snapshot_key_table_slot_t* dx_find_snapshot_key_slot (const dx_snapshot_key_table_t* table,
+																dxf_ulong_t key) {
+	size_t mask = table->slot_count - 1;
+	size_t index = dx_get_snapshot_key_home_index(table, key);
+
+	while (table->slots[index].value != NULL && table->slots[index].key != key) {
+		index = (index + 1) & mask;
+	}
+
+	return table->slots + index;
+}
+
+/* -------------------------------------------------------------------------- */
+
+static int dx_grow_snapshot_key_table (dx_snapshot_key_table_t* table) {
+	dx_snapshot_key_table_slot_t* old_slots = table->slots;
+	size_t old_slot_count = table->slot_count;
+	size_t new_slot_count = (old_slot_count == 0) ? MIN_SLOT_COUNT : old_slot_count * 2;
+	size_t i = 0;
+
+	if ((table->slots = dx_calloc(new_slot_count, sizeof(dx_snapshot_key_table_slot_t))) == NULL) {
+		table->slots = old_slots;
+
+		return false;
+	}
+
+	table->slot_count = new_slot_count;
+
+	for (; i < old_slot_count; ++i) {
+		if (old_slots[i].value != NULL) {
+			*dx_find_snapshot_key_slot(table, old_slots[i].key) = old_slots[i];
+		}
+	}
+
+	CHECKED_FREE(old_slots);
+
+	return true;
+}
+
+/* -------------------------------------------------------------------------- */
+/*
+ *	Snapshot key table functions implementation
+ */
+/* -------------------------------------------------------------------------- */
+
+void dx_init_snapshot_key_table (dx_snapshot_key_table_t* table) {
+	dx_memset(table, 0, sizeof(dx_snapshot_key_table_t));
+}
+
+/* -------------------------------------------------------------------------- */
+
+void dx_free_snapshot_key_table (dx_snapshot_key_table_t* table) {
+	CHECKED_FREE(table->slots);
+
+	table->slot_count = 0;
+	table->size = 0;
+}
+
+/* -------------------------------------------------------------------------- */
+
+int dx_reserve_snapshot_key_table (dx_snapshot_key_table_t* table, size_t count) {
+	while (count * 2 > table->slot_count) {
+		if (!dx_grow_snapshot_key_table(table)) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/* -------------------------------------------------------------------------- */
+
+size_t dx_get_snapshot_key_home_index (const dx_snapshot_key_table_t* table, dxf_ulong_t key) {
+	/* the symbol hash bits of the keys are spread over the slots by the Fibonacci hashing */
+	return (size_t)((key * 0x9E3779B97F4A7C15ull) >> 32u) & (table->slot_count - 1);
+}
+
+/* -------------------------------------------------------------------------- */
+
+int dx_add_snapshot_key_value (dx_snapshot_key_table_t* table, dxf_ulong_t key, void* value) {
+	dx_snapshot_key_table_slot_t* slot = NULL;
+
+	if (!dx_reserve_snapshot_key_table(table, table->size + 1)) {
+		return false;
+	}
+
+	slot = dx_find_snapshot_key_slot(table, key);
+	slot->key = key;
+	slot->value = value;
+	table->size++;
+
+	return true;
+}
+
+/* -------------------------------------------------------------------------- */
+
+void* dx_find_snapshot_key_value (const dx_snapshot_key_table_t* table, dxf_ulong_t key) {
+	if (table->size == 0) {
+		return NULL;
+	}
+
+	return dx_find_snapshot_key_slot(table, key)->value;
+}
+
+/* -------------------------------------------------------------------------- */
+
+/* The entries probed after the removed one are shifted back, so the table needs no removed slot marks */
+int dx_remove_snapshot_key_value (dx_snapshot_key_table_t* table, dxf_ulong_t key, void* value) {
+	size_t mask = table->slot_count - 1;
+	size_t index = 0;
+	size_t next = 0;
+
+	if (table->size == 0) {
+		return false;
+	}
+
+	index = (size_t)(dx_find_snapshot_key_slot(table, key) - table->slots);
+
+	if (table->slots[index].value == NULL || table->slots[index].value != value) {
+		return false;
+	}
+
+	table->slots[index].value = NULL;
+	table->size--;
+
+	for (next = (index + 1) & mask; table->slots[next].value != NULL; next = (next + 1) & mask) {
+		size_t home_index = dx_get_snapshot_key_home_index(table, table->slots[next].key);
+
+		/* the entry can fill the free slot if the slot is between its home slot and its slot */
+		if (((next - home_index) & mask) >= ((next - index) & mask)) {
+			table->slots[index] = table->slots[next];
+			table->slots[next].value = NULL;
+			index = next;
+		}
+	}
+
+	return true;
+}
@@ -0,0 +1,68 @@
+/*
+ * The contents of this file are subject to the Mozilla Public License Version
+ * 1.1 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ * http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+ * for the specific language governing rights and limitations under the
+ * License.
+ *
+ * The Initial Developer of the Original Code is Devexperts LLC.
+ * Portions created by the Initial Developer are Copyright (C) 2010
+ * the Initial Developer. All Rights Reserved.
+ *
+ * Contributor(s):
+ *
+ */
+
+/*
+ *	The snapshot key table maps the snapshot keys to the values, e.g. the snapshots whose events are received with
+ *  one subscription. It's an open addressing hash table with linear probing, kept at most half full, whose removed
+ *  entries are filled by the entries probed after them, so a lookup stops at the first empty slot.
+ *  The table is not thread-safe.
+ */
+
+#ifndef SNAPSHOT_KEY_TABLE_H_INCLUDED
+#define SNAPSHOT_KEY_TABLE_H_INCLUDED
+
+#include "DXTypes.h"
+#include "PrimitiveTypes.h"
+
+typedef struct {
+	dxf_ulong_t key;
+	void* value; /* NULL marks a free slot */
+} dx_snapshot_key_table_slot_t;
+
+typedef struct {
+	dx_snapshot_key_table_slot_t* slots;
+	size_t slot_count; /* a power of two, at least twice the number of the entries */
+	size_t size; /* the number of the entries */
+} dx_snapshot_key_table_t;
+
+/* -------------------------------------------------------------------------- */
+/*
+ *	Snapshot key table functions
+ */
+/* -------------------------------------------------------------------------- */
+
+void dx_init_snapshot_key_table (dx_snapshot_key_table_t* table);
+void dx_free_snapshot_key_table (dx_snapshot_key_table_t* table);
+
+/* Grows the table so that it takes the entries up to the count without growing */
+int dx_reserve_snapshot_key_table (dx_snapshot_key_table_t* table, size_t count);
+
+/* Returns the slot the probing for the key starts from, the table must have the slots */
+size_t dx_get_snapshot_key_home_index (const dx_snapshot_key_table_t* table, dxf_ulong_t key);
+
+/* Adds the value with the key, which must not be in the table. The value must not be NULL */
+int dx_add_snapshot_key_value (dx_snapshot_key_table_t* table, dxf_ulong_t key, void* value);
+
+/* Returns the value with the key or NULL */
+void* dx_find_snapshot_key_value (const dx_snapshot_key_table_t* table, dxf_ulong_t key);
+
+/* Removes the value with the key, returns false if there's no such value */
+int dx_remove_snapshot_key_value (dx_snapshot_key_table_t* table, dxf_ulong_t key, void* value);
+
+#endif /* SNAPSHOT_KEY_TABLE_H_INCLUDED */
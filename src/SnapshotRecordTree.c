@@ -0,0 +1,454 @@
+/*
+ * The contents of this file are subject to the Mozilla Public License Version
+ * 1.1 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ * http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+ * for the specific language governing rights and limitations under the
+ * License.
+ *
+ * The Initial Developer of the Original Code is Devexperts LLC.
+ * Portions created by the Initial Developer are Copyright (C) 2010
+ * the Initial Developer. All Rights Reserved.
+ *
+ * Contributor(s):
+ *
+ */
+
+#include "SnapshotRecordTree.h"
+
+#include "DXMemory.h"
+
+/* -------------------------------------------------------------------------- */
+/*
+ *	Snapshot record tree data
+ */
+/* -------------------------------------------------------------------------- */
+
+#define LEAF_CAPACITY 32
+#define BRANCH_CAPACITY 32
+
+/* the nodes having fewer entries are merged with a sibling if the entries of both fit into one node */
+#define LEAF_MIN_COUNT (LEAF_CAPACITY / 4)
+#define BRANCH_MIN_COUNT (BRANCH_CAPACITY / 4)
+
+struct dx_snapshot_record_leaf {
+	int count;
+	dx_snapshot_record_leaf_t* next;
+	dx_snapshot_record_key_t keys[LEAF_CAPACITY];
+	/* followed by LEAF_CAPACITY records at LEAF_RECORDS_OFFSET */
+};
+
+typedef struct {
+	int count; /* the number of the children */
+	dx_snapshot_record_key_t keys[BRANCH_CAPACITY]; /* the least keys of the children, keys[0] isn't compared */
+	void* children[BRANCH_CAPACITY];
+} dx_snapshot_record_branch_t;
+
+/* the records are aligned like the allocated memory */
+#define LEAF_RECORDS_OFFSET ((sizeof(dx_snapshot_record_leaf_t) + 15) & ~(size_t)15)
+
+/* -------------------------------------------------------------------------- */
+/*
+ *	Helper functions
+ */
+/* -------------------------------------------------------------------------- */
+
+static dxf_byte_t* dx_get_leaf_record (const dx_snapshot_record_tree_t* tree, dx_snapshot_record_leaf_t* leaf,
+									int index) {
+	return (dxf_byte_t*)leaf + LEAF_RECORDS_OFFSET + (size_t)index * tree->record_size;
+}
+
+/* -------------------------------------------------------------------------- */
+
+static int dx_get_node_count (void* node, int level) {
+	return (level == 0) ? ((dx_snapshot_record_leaf_t*)node)->count : ((dx_snapshot_record_branch_t*)node)->count;
+}
+
+/* -------------------------------------------------------------------------- */
+
+/* Returns the position of the first key not less than the key */
+static int dx_find_leaf_position (const dx_snapshot_record_leaf_t* leaf, dx_snapshot_record_key_t key,
+								OUT int* found) {
+	int low = 0;
+	int high = leaf->count;
+
+	while (low < high) {
+		int middle = (low + high) / 2;
+
+		if (dx_snapshot_record_key_comparator(leaf->keys[middle], key) < 0) {
+			low = middle + 1;
+		} else {
+			high = middle;
+		}
+	}
+
+	*found = low < leaf->count && dx_snapshot_record_key_comparator(leaf->keys[low], key) == 0;
+
+	return low;
+}
+
+/* -------------------------------------------------------------------------- */
+
+/* Returns the index of the child whose subtree may have the key */
+static int dx_find_child_index (const dx_snapshot_record_branch_t* branch, dx_snapshot_record_key_t key) {
+	int low = 1;
+	int high = branch->count;
+
+	while (low < high) {
+		int middle = (low + high) / 2;
+
+		if (dx_snapshot_record_key_comparator(branch->keys[middle], key) <= 0) {
+			low = middle + 1;
+		} else {
+			high = middle;
+		}
+	}
+
+	return low - 1;
+}
+
+/* -------------------------------------------------------------------------- */
+
+static dx_snapshot_record_leaf_t* dx_create_leaf (const dx_snapshot_record_tree_t* tree) {
+	return dx_calloc(1, LEAF_RECORDS_OFFSET + LEAF_CAPACITY * tree->record_size);
+}
+
+/* -------------------------------------------------------------------------- */
+
+/* Moves the upper half of the full child to a new node put next to it, the branch must not be full */
+static int dx_split_child (dx_snapshot_record_tree_t* tree, dx_snapshot_record_branch_t* branch, int child_index,
+						int child_level) {
+	void* new_node = NULL;
+	dx_snapshot_record_key_t new_key;
+	int position = child_index + 1;
+
+	if (child_level == 0) {
+		dx_snapshot_record_leaf_t* leaf = branch->children[child_index];
+		dx_snapshot_record_leaf_t* new_leaf = dx_create_leaf(tree);
+		int kept = leaf->count - leaf->count / 2;
+
+		if (new_leaf == NULL) {
+			return false;
+		}
+
+		new_leaf->count = leaf->count - kept;
+		dx_memcpy(new_leaf->keys, leaf->keys + kept, new_leaf->count * sizeof(dx_snapshot_record_key_t));
+		dx_memcpy(dx_get_leaf_record(tree, new_leaf, 0), dx_get_leaf_record(tree, leaf, kept),
+			new_leaf->count * tree->record_size);
+		leaf->count = kept;
+
+		new_leaf->next = leaf->next;
+		leaf->next = new_leaf;
+		new_node = new_leaf;
+		new_key = new_leaf->keys[0];
+	} else {
+		dx_snapshot_record_branch_t* child = branch->children[child_index];
+		dx_snapshot_record_branch_t* new_branch = dx_calloc(1, sizeof(dx_snapshot_record_branch_t));
+		int kept = child->count - child->count / 2;
+
+		if (new_branch == NULL) {
+			return false;
+		}
+
+		new_branch->count = child->count - kept;
+		dx_memcpy(new_branch->keys, child->keys + kept, new_branch->count * sizeof(dx_snapshot_record_key_t));
+		dx_memcpy(new_branch->children, child->children + kept, new_branch->count * sizeof(void*));
+		child->count = kept;
+		new_node = new_branch;
+		new_key = new_branch->keys[0];
+	}
+
+	dx_memmove(branch->keys + position + 1, branch->keys + position,
+		(branch->count - position) * sizeof(dx_snapshot_record_key_t));
+	dx_memmove(branch->children + position + 1, branch->children + position,
+		(branch->count - position) * sizeof(void*));
+	branch->keys[position] = new_key;
+	branch->children[position] = new_node;
+	branch->count++;
+
+	return true;
+}
+
+/* -------------------------------------------------------------------------- */
+
+/* Merges the underfull child with a sibling if their entries fit into one node */
+static void dx_merge_child (dx_snapshot_record_tree_t* tree, dx_snapshot_record_branch_t* branch, int child_index,
+						int child_level) {
+	int left_index = (child_index > 0) ? child_index - 1 : child_index;
+	int right_index = left_index + 1;
+	void* left = branch->children[left_index];
+	void* right = branch->children[right_index];
+	int capacity = (child_level == 0) ? LEAF_CAPACITY : BRANCH_CAPACITY;
+
+	if (dx_get_node_count(left, child_level) + dx_get_node_count(right, child_level) > capacity) {
+		return;
+	}
+
+	if (child_level == 0) {
+		dx_snapshot_record_leaf_t* left_leaf = left;
+		dx_snapshot_record_leaf_t* right_leaf = right;
+
+		dx_memcpy(left_leaf->keys + left_leaf->count, right_leaf->keys,
+			right_leaf->count * sizeof(dx_snapshot_record_key_t));
+		dx_memcpy(dx_get_leaf_record(tree, left_leaf, left_leaf->count), dx_get_leaf_record(tree, right_leaf, 0),
+			right_leaf->count * tree->record_size);
+		left_leaf->count += right_leaf->count;
+
+		left_leaf->next = right_leaf->next;
+	} else {
+		dx_snapshot_record_branch_t* left_branch = left;
+		dx_snapshot_record_branch_t* right_branch = right;
+
+		dx_memcpy(left_branch->keys + left_branch->count, right_branch->keys,
+			right_branch->count * sizeof(dx_snapshot_record_key_t));
+		dx_memcpy(left_branch->children + left_branch->count, right_branch->children,
+			right_branch->count * sizeof(void*));
+
+		/* the first key of the right node isn't kept up to date, the separator of the parent is its least key */
+		left_branch->keys[left_branch->count] = branch->keys[right_index];
+		left_branch->count += right_branch->count;
+	}
+
+	dx_free(right);
+
+	dx_memmove(branch->keys + right_index, branch->keys + right_index + 1,
+		(branch->count - right_index - 1) * sizeof(dx_snapshot_record_key_t));
+	dx_memmove(branch->children + right_index, branch->children + right_index + 1,
+		(branch->count - right_index - 1) * sizeof(void*));
+	branch->count--;
+}
+
+/* -------------------------------------------------------------------------- */
+
+static int dx_remove_from_subtree (dx_snapshot_record_tree_t* tree, void* node, int level,
+								dx_snapshot_record_key_t key) {
+	if (level == 0) {
+		dx_snapshot_record_leaf_t* leaf = node;
+		int found = false;
+		int position = dx_find_leaf_position(leaf, key, &found);
+		int tail = leaf->count - position - 1;
+
+		if (!found) {
+			return false;
+		}
+
+		dx_memmove(leaf->keys + position, leaf->keys + position + 1, tail * sizeof(dx_snapshot_record_key_t));
+		dx_memmove(dx_get_leaf_record(tree, leaf, position), dx_get_leaf_record(tree, leaf, position + 1),
+			tail * tree->record_size);
+		leaf->count--;
+
+		return true;
+	} else {
+		dx_snapshot_record_branch_t* branch = node;
+		int child_index = dx_find_child_index(branch, key);
+		int min_count = (level == 1) ? LEAF_MIN_COUNT : BRANCH_MIN_COUNT;
+
+		if (!dx_remove_from_subtree(tree, branch->children[child_index], level - 1, key)) {
+			return false;
+		}
+
+		if (branch->count > 1 && dx_get_node_count(branch->children[child_index], level - 1) < min_count) {
+			dx_merge_child(tree, branch, child_index, level - 1);
+		}
+
+		return true;
+	}
+}
+
+/* -------------------------------------------------------------------------- */
+
+static void dx_free_subtree (void* node, int level) {
+	int i = 0;
+
+	if (level > 0) {
+		dx_snapshot_record_branch_t* branch = node;
+
+		for (; i < branch->count; ++i) {
+			dx_free_subtree(branch->children[i], level - 1);
+		}
+	}
+
+	dx_free(node);
+}
+
+/* -------------------------------------------------------------------------- */
+/*
+ *	Snapshot record tree functions implementation
+ */
+/* -------------------------------------------------------------------------- */
+
+int dx_snapshot_record_key_comparator (dx_snapshot_record_key_t key1, dx_snapshot_record_key_t key2) {
+	if (key1.time_int_field > key2.time_int_field) {
+		return -1;
+	} else if (key1.time_int_field < key2.time_int_field) {
+		return 1;
+	}
+
+	return key1.index < key2.index ? -1 : (key1.index > key2.index ? 1 : 0);
+}
+
+/* -------------------------------------------------------------------------- */
+
+void dx_init_snapshot_record_tree (dx_snapshot_record_tree_t* tree, size_t record_size) {
+	dx_memset(tree, 0, sizeof(dx_snapshot_record_tree_t));
+
+	tree->record_size = record_size;
+}
+
+/* -------------------------------------------------------------------------- */
+
+void dx_clear_snapshot_record_tree (dx_snapshot_record_tree_t* tree) {
+	if (tree->root != NULL) {
+		dx_free_subtree(tree->root, tree->height);
+	}
+
+	tree->root = NULL;
+	tree->height = 0;
+	tree->size = 0;
+	tree->first_leaf = NULL;
+}
+
+/* -------------------------------------------------------------------------- */
+
+dxf_event_data_t dx_find_snapshot_record (dx_snapshot_record_tree_t* tree, dx_snapshot_record_key_t key) {
+	void* node = tree->root;
+	int level = tree->height;
+	int found = false;
+	int position;
+
+	if (node == NULL) {
+		return NULL;
+	}
+
+	for (; level > 0; --level) {
+		dx_snapshot_record_branch_t* branch = node;
+
+		node = branch->children[dx_find_child_index(branch, key)];
+	}
+
+	position = dx_find_leaf_position(node, key, &found);
+
+	if (!found) {
+		return NULL;
+	}
+
+	return dx_get_leaf_record(tree, node, position);
+}
+
+/* -------------------------------------------------------------------------- */
+
+/*
+ *	The full nodes are split on the way down, so that the node getting a new entry always has room for it, and
+ *  a failed allocation leaves the tree intact.
+ */
+dxf_event_data_t dx_insert_snapshot_record (dx_snapshot_record_tree_t* tree, dx_snapshot_record_key_t key) {
+	dx_snapshot_record_leaf_t* leaf = NULL;
+	dxf_byte_t* record = NULL;
+	void* node = NULL;
+	int level = 0;
+	int found = false;
+	int position;
+	int tail;
+
+	if (tree->root == NULL) {
+		if ((leaf = dx_create_leaf(tree)) == NULL) {
+			return NULL;
+		}
+
+		tree->root = leaf;
+		tree->first_leaf = leaf;
+	}
+
+	if (dx_get_node_count(tree->root, tree->height) == ((tree->height == 0) ? LEAF_CAPACITY : BRANCH_CAPACITY)) {
+		dx_snapshot_record_branch_t* new_root = dx_calloc(1, sizeof(dx_snapshot_record_branch_t));
+
+		if (new_root == NULL) {
+			return NULL;
+		}
+
+		new_root->count = 1;
+		new_root->children[0] = tree->root;
+
+		if (!dx_split_child(tree, new_root, 0, tree->height)) {
+			dx_free(new_root);
+
+			return NULL;
+		}
+
+		tree->root = new_root;
+		tree->height++;
+	}
+
+	node = tree->root;
+
+	for (level = tree->height; level > 0; --level) {
+		dx_snapshot_record_branch_t* branch = node;
+		int child_index = dx_find_child_index(branch, key);
+		int child_capacity = (level == 1) ? LEAF_CAPACITY : BRANCH_CAPACITY;
+
+		if (dx_get_node_count(branch->children[child_index], level - 1) == child_capacity) {
+			if (!dx_split_child(tree, branch, child_index, level - 1)) {
+				return NULL;
+			}
+
+			if (dx_snapshot_record_key_comparator(key, branch->keys[child_index + 1]) >= 0) {
+				child_index++;
+			}
+		}
+
+		node = branch->children[child_index];
+	}
+
+	leaf = node;
+	position = dx_find_leaf_position(leaf, key, &found);
+	tail = leaf->count - position;
+	record = dx_get_leaf_record(tree, leaf, position);
+
+	dx_memmove(leaf->keys + position + 1, leaf->keys + position, tail * sizeof(dx_snapshot_record_key_t));
+	dx_memmove(record + tree->record_size, record, tail * tree->record_size);
+
+	leaf->keys[position] = key;
+	dx_memset(record, 0, tree->record_size);
+	leaf->count++;
+	tree->size++;
+
+	return record;
+}
+
+/* -------------------------------------------------------------------------- */
+
+int dx_remove_snapshot_record (dx_snapshot_record_tree_t* tree, dx_snapshot_record_key_t key) {
+	if (tree->root == NULL || !dx_remove_from_subtree(tree, tree->root, tree->height, key)) {
+		return false;
+	}
+
+	tree->size--;
+
+	/* the root left with one child is replaced by it */
+	while (tree->height > 0 && ((dx_snapshot_record_branch_t*)tree->root)->count == 1) {
+		void* old_root = tree->root;
+
+		tree->root = ((dx_snapshot_record_branch_t*)old_root)->children[0];
+		tree->height--;
+		dx_free(old_root);
+	}
+
+	return true;
+}
+
+/* -------------------------------------------------------------------------- */
+
+void dx_copy_snapshot_records (const dx_snapshot_record_tree_t* tree, OUT dxf_event_data_t records) {
+	dx_snapshot_record_leaf_t* leaf = tree->first_leaf;
+	dxf_byte_t* destination = records;
+
+	for (; leaf != NULL; leaf = leaf->next) {
+		size_t size = leaf->count * tree->record_size;
+
+		dx_memcpy(destination, dx_get_leaf_record(tree, leaf, 0), size);
+		destination += size;
+	}
+}
@@ -0,0 +1,78 @@
+/*
+ * The contents of this file are subject to the Mozilla Public License Version
+ * 1.1 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ * http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+ * for the specific language governing rights and limitations under the
+ * License.
+ *
+ * The Initial Developer of the Original Code is Devexperts LLC.
+ * Portions created by the Initial Developer are Copyright (C) 2010
+ * the Initial Developer. All Rights Reserved.
+ *
+ * Contributor(s):
+ *
+ */
+
+/*
+ *	The snapshot record tree keeps the records of a snapshot ordered by their keys in a B+ tree. The leaves hold
+ *  the records themselves along with their keys, so adding or removing a record moves only
+ *  the records of one leaf, and the records are visited in order through the linked leaves.
+ *  The tree is not thread-safe.
+ */
+
+#ifndef SNAPSHOT_RECORD_TREE_H_INCLUDED
+#define SNAPSHOT_RECORD_TREE_H_INCLUDED
+
+#include "DXTypes.h"
+#include "EventData.h"
+#include "PrimitiveTypes.h"
+
+typedef struct {
+	dxf_time_int_field_t time_int_field;
+	dxf_long_t index;
+} dx_snapshot_record_key_t;
+
+typedef struct dx_snapshot_record_leaf dx_snapshot_record_leaf_t;
+
+typedef struct {
+	void* root; /* a leaf if the height is 0, a branch otherwise; NULL until the first record is added */
+	int height;
+	size_t size; /* the number of the records */
+	size_t record_size;
+	dx_snapshot_record_leaf_t* first_leaf;
+} dx_snapshot_record_tree_t;
+
+/* -------------------------------------------------------------------------- */
+/*
+ *	Snapshot record tree functions
+ */
+/* -------------------------------------------------------------------------- */
+
+/* The records are ordered by the descending time and then by the ascending index */
+int dx_snapshot_record_key_comparator (dx_snapshot_record_key_t key1, dx_snapshot_record_key_t key2);
+
+void dx_init_snapshot_record_tree (dx_snapshot_record_tree_t* tree, size_t record_size);
+
+/* Removes all the records */
+void dx_clear_snapshot_record_tree (dx_snapshot_record_tree_t* tree);
+
+/* Returns the record with the key or NULL */
+dxf_event_data_t dx_find_snapshot_record (dx_snapshot_record_tree_t* tree, dx_snapshot_record_key_t key);
+
+/*
+ *	Adds a zeroed record with the key, which must not be in the tree, and returns it to be filled by the caller.
+ *  Returns NULL on error.
+ */
+dxf_event_data_t dx_insert_snapshot_record (dx_snapshot_record_tree_t* tree, dx_snapshot_record_key_t key);
+
+/* Removes the record with the key, returns false if there's no such record */
+int dx_remove_snapshot_record (dx_snapshot_record_tree_t* tree, dx_snapshot_record_key_t key);
+
+/* Copies the records in their order to the array of the tree size */
+void dx_copy_snapshot_records (const dx_snapshot_record_tree_t* tree, OUT dxf_event_data_t records);
+
+#endif /* SNAPSHOT_RECORD_TREE_H_INCLUDED */
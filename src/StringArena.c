@@ -0,0 +1,269 @@
+/*
+ * The contents of this file are subject to the Mozilla Public License Version
+ * 1.1 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ * http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+ * for the specific language governing rights and limitations under the
+ * License.
+ *
+ * The Initial Developer of the Original Code is Devexperts LLC.
+ * Portions created by the Initial Developer are Copyright (C) 2010
+ * the Initial Developer. All Rights Reserved.
+ *
+ * Contributor(s):
+ *
+ */
+#include "StringArena.h"
+
+#include "DXAlgorithms.h"
+#include "DXErrorHandling.h"
+#include "DXMemory.h"
+
+/* -------------------------------------------------------------------------- */
+/*
+ *	String arena data
+ */
+/* -------------------------------------------------------------------------- */
+
+#define MIN_CHUNK_CAPACITY 1024
+#define MAX_CHUNK_CAPACITY 65536
+#define INITIAL_SLOT_COUNT 64
+
+struct dx_string_arena_chunk {
+	dx_string_arena_chunk_t* previous;
+	size_t capacity; /* the number of the characters */
+	size_t used;
+	/* followed by the characters */
+};
+
+/* -------------------------------------------------------------------------- */
+/*
+ *	Helper functions
+ */
+/* -------------------------------------------------------------------------- */
+
+static dxf_char_t* dx_get_chunk_chars (dx_string_arena_chunk_t* chunk) {
+	return (dxf_char_t*)(chunk + 1);
+}
+
+/* -------------------------------------------------------------------------- */
+
+static dxf_uint_t dx_string_hash (dxf_const_string_t string, size_t length) {
+	dxf_uint_t hash = 2166136261u;
+	size_t i = 0;
+
+	for (; i < length; ++i) {
+		hash = (hash ^ (dxf_uint_t)string[i]) * 16777619u;
+	}
+
+	return hash;
+}
+
+/* -------------------------------------------------------------------------- */
+
+/* Returns the slot holding the string or the free slot it's to be stored in */
+static dx_string_arena_slot_t* dx_find_string_slot (dx_string_arena_t* arena, dxf_const_string_t string,
+													dxf_uint_t hash) {
+	size_t mask = arena->slot_count - 1;
+	size_t index = hash & mask;
+
+	for (;; index = (index + 1) & mask) {
+		dx_string_arena_slot_t* slot = arena->slots + index;
+
+		if (slot->string == NULL || (slot->hash == hash && dx_compare_strings(slot->string, string) == 0)) {
+			return slot;
+		}
+	}
+}
+
+/* -------------------------------------------------------------------------- */
+
+static int dx_grow_string_slots (dx_string_arena_t* arena) {
+	size_t new_slot_count = (arena->slot_count == 0) ? INITIAL_SLOT_COUNT : arena->slot_count * 2;
+	dx_string_arena_slot_t* new_slots = dx_calloc(new_slot_count, sizeof(dx_string_arena_slot_t));
+	size_t i = 0;
+
+	if (new_slots == NULL) {
+		return false;
+	}
+
+	/* the strings are distinct, so each one just takes the first free slot */
+	for (; i < arena->slot_count; ++i) {
+		size_t mask = new_slot_count - 1;
+		size_t index = arena->slots[i].hash & mask;
+
+		if (arena->slots[i].string == NULL) {
+			continue;
+		}
+
+		while (new_slots[index].string != NULL) {
+			index = (index + 1) & mask;
+		}
+
+		new_slots[index] = arena->slots[i];
+	}
+
+	CHECKED_FREE(arena->slots);
+
+	arena->slots = new_slots;
+	arena->slot_count = new_slot_count;
+
+	return true;
+}
+
+/* -------------------------------------------------------------------------- */
+
+static dx_string_arena_chunk_t* dx_create_chunk (size_t capacity) {
+	dx_string_arena_chunk_t* chunk = dx_malloc(sizeof(dx_string_arena_chunk_t) + capacity * sizeof(dxf_char_t));
+
+	if (chunk == NULL) {
+		return NULL;
+	}
+
+	chunk->previous = NULL;
+	chunk->capacity = capacity;
+	chunk->used = 0;
+
+	return chunk;
+}
+
+/* -------------------------------------------------------------------------- */
+
+/* Returns the room for the characters, a new chunk is added if the current one can't hold them */
+static dxf_char_t* dx_allocate_chars (dx_string_arena_t* arena, size_t count) {
+	dx_string_arena_chunk_t* chunk = arena->chunk;
+	dxf_char_t* chars = NULL;
+
+	if (chunk == NULL || chunk->capacity - chunk->used < count) {
+		size_t capacity = (chunk == NULL) ? MIN_CHUNK_CAPACITY : chunk->capacity * 2;
+
+		if (capacity > MAX_CHUNK_CAPACITY) {
+			capacity = MAX_CHUNK_CAPACITY;
+		}
+
+		if (capacity < count) {
+			capacity = count;
+		}
+
+		if ((chunk = dx_create_chunk(capacity)) == NULL) {
+			return NULL;
+		}
+
+		chunk->previous = arena->chunk;
+		arena->chunk = chunk;
+		arena->chunks_capacity += capacity;
+	}
+
+	chars = dx_get_chunk_chars(chunk) + chunk->used;
+	chunk->used += count;
+
+	return chars;
+}
+
+/* -------------------------------------------------------------------------- */
+
+static void dx_free_chunks (dx_string_arena_t* arena) {
+	while (arena->chunk != NULL) {
+		dx_string_arena_chunk_t* previous = arena->chunk->previous;
+
+		dx_free(arena->chunk);
+		arena->chunk = previous;
+	}
+
+	arena->chunks_capacity = 0;
+}
+
+/* -------------------------------------------------------------------------- */
+/*
+ *	String arena functions implementation
+ */
+/* -------------------------------------------------------------------------- */
+
+void dx_init_string_arena (dx_string_arena_t* arena) {
+	dx_memset(arena, 0, sizeof(dx_string_arena_t));
+}
+
+/* -------------------------------------------------------------------------- */
+
+void dx_free_string_arena (dx_string_arena_t* arena) {
+	dx_free_chunks(arena);
+
+	CHECKED_FREE(arena->slots);
+
+	arena->slot_count = 0;
+	arena->size = 0;
+}
+
+/* -------------------------------------------------------------------------- */
+
+void dx_clear_string_arena (dx_string_arena_t* arena) {
+	if (arena->chunk != NULL && arena->chunk->previous != NULL) {
+		size_t capacity = arena->chunks_capacity;
+
+		/* the filled chunks are replaced by one holding as many characters, or are just freed if it can't be made */
+		dx_free_chunks(arena);
+
+		if ((arena->chunk = dx_create_chunk(capacity)) != NULL) {
+			arena->chunks_capacity = capacity;
+		}
+	} else if (arena->chunk != NULL) {
+		arena->chunk->used = 0;
+	}
+
+	if (arena->slots != NULL) {
+		dx_memset(arena->slots, 0, arena->slot_count * sizeof(dx_string_arena_slot_t));
+	}
+
+	arena->size = 0;
+}
+
+/* -------------------------------------------------------------------------- */
+
+int dx_intern_arena_string (dx_string_arena_t* arena, dxf_const_string_t string, OUT dxf_const_string_t* result) {
+	size_t length = 0;
+	dxf_uint_t hash = 0;
+	dx_string_arena_slot_t* slot = NULL;
+	dxf_char_t* chars = NULL;
+
+	if (arena == NULL || string == NULL) {
+		return dx_set_error_code(dx_ec_invalid_func_param_internal);
+	}
+
+	length = dx_string_length(string);
+	hash = dx_string_hash(string, length);
+
+	if (arena->slots != NULL) {
+		slot = dx_find_string_slot(arena, string, hash);
+
+		if (slot->string != NULL) {
+			*result = slot->string;
+
+			return true;
+		}
+	}
+
+	/* a new string */
+
+	if ((arena->size + 1) * 2 > arena->slot_count) {
+		CHECKED_CALL(dx_grow_string_slots, arena);
+
+		slot = dx_find_string_slot(arena, string, hash);
+	}
+
+	if ((chars = dx_allocate_chars(arena, length + 1)) == NULL) {
+		return false;
+	}
+
+	dx_memcpy(chars, string, (length + 1) * sizeof(dxf_char_t));
+
+	slot->hash = hash;
+	slot->string = chars;
+	arena->size++;
+
+	*result = chars;
+
+	return true;
+}
@@ -0,0 +1,65 @@
+/*
+ * The contents of this file are subject to the Mozilla Public License Version
+ * 1.1 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ * http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+ * for the specific language governing rights and limitations under the
+ * License.
+ *
+ * The Initial Developer of the Original Code is Devexperts LLC.
+ * Portions created by the Initial Developer are Copyright (C) 2010
+ * the Initial Developer. All Rights Reserved.
+ *
+ * Contributor(s):
+ *
+ */
+
+/*
+ *	The string arena interns the strings of the events stored by a snapshot. Every distinct string is copied once
+ *  into the large chunks of the arena and stays there until the arena is cleared, so storing an event whose strings
+ *  have been seen before doesn't allocate any memory. Clearing the arena compacts the chunks into one, large enough
+ *  for the strings of the previous fill.
+ *  The arena is not thread-safe.
+ */
+
+#ifndef STRING_ARENA_H_INCLUDED
+#define STRING_ARENA_H_INCLUDED
+
+#include "DXTypes.h"
+#include "PrimitiveTypes.h"
+
+typedef struct dx_string_arena_chunk dx_string_arena_chunk_t;
+
+typedef struct {
+	dxf_uint_t hash;
+	dxf_const_string_t string; /* NULL marks a free slot */
+} dx_string_arena_slot_t;
+
+typedef struct {
+	dx_string_arena_chunk_t* chunk; /* the chunk the strings are added to, linked to the filled ones */
+	size_t chunks_capacity; /* the number of the characters all the chunks can hold */
+
+	dx_string_arena_slot_t* slots; /* the open addressing hash slots of the interned strings */
+	size_t slot_count; /* a power of two, at least twice the number of the strings */
+	size_t size; /* the number of the interned strings */
+} dx_string_arena_t;
+
+/* -------------------------------------------------------------------------- */
+/*
+ *	String arena functions
+ */
+/* -------------------------------------------------------------------------- */
+
+void dx_init_string_arena (dx_string_arena_t* arena);
+void dx_free_string_arena (dx_string_arena_t* arena);
+
+/* Forgets all the strings, the strings returned earlier become invalid */
+void dx_clear_string_arena (dx_string_arena_t* arena);
+
+/* Returns the copy of the string kept by the arena, the same copy for the equal strings */
+int dx_intern_arena_string (dx_string_arena_t* arena, dxf_const_string_t string, OUT dxf_const_string_t* result);
+
+#endif /* STRING_ARENA_H_INCLUDED */
@@ -0,0 +1,297 @@
+/*
+ * The contents of this file are subject to the Mozilla Public License Version
+ * 1.1 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ * http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+ * for the specific language governing rights and limitations under the
+ * License.
+ *
+ * The Initial Developer of the Original Code is Devexperts LLC.
+ * Portions created by the Initial Developer are Copyright (C) 2010
+ * the Initial Developer. All Rights Reserved.
+ *
+ * Contributor(s):
+ *
+ */
+
+#include "SymbolTable.h"
+
+#include "DXAlgorithms.h"
+#include "DXErrorHandling.h"
+#include "DXMemory.h"
+#include "EventSubscription.h"
+#include "SymbolCodec.h"
+
+/* -------------------------------------------------------------------------- */
+/*
+ *	Symbol table data
+ */
+/* -------------------------------------------------------------------------- */
+
+#define INITIAL_SYMBOL_CAPACITY 256
+
+/* the longest symbol that may be penta-encoded */
+#define MAX_CIPHER_SYMBOL_LENGTH 7
+
+typedef struct {
+	dxf_int_t cipher; /* 0 if the symbol isn't encodable */
+	int length;
+	dxf_uint_t hash;
+	dxf_string_t symbol;
+
+	dxf_ulong_t name_hash; /* the dx_symbol_name_hasher value, computed on the first request */
+	int has_name_hash;
+} dx_interned_symbol_t;
+
+typedef struct {
+	dx_interned_symbol_t* symbols; /* indexed by the symbol id */
+	int size;
+	int capacity;
+
+	int* slots; /* the open addressing hash slots with the symbol id + 1, 0 marks a free slot */
+	int slot_count; /* a power of two, at least twice the symbol capacity */
+} dx_symbol_table_data_t;
+
+/* -------------------------------------------------------------------------- */
+/*
+ *	Helper functions
+ */
+/* -------------------------------------------------------------------------- */
+
+static dxf_uint_t dx_cipher_hash (dxf_int_t cipher) {
+	return (dxf_uint_t)cipher * 0x9E3779B9u;
+}
+
+/* -------------------------------------------------------------------------- */
+
+static dxf_uint_t dx_chars_hash (const dxf_char_t* chars, int length) {
+	dxf_uint_t hash = 2166136261u;
+	int i = 0;
+
+	for (; i < length; ++i) {
+		hash = (hash ^ (dxf_uint_t)chars[i]) * 16777619u;
+	}
+
+	return hash;
+}
+
+/* -------------------------------------------------------------------------- */
+
+static int dx_is_same_symbol (const dx_interned_symbol_t* entry, dxf_int_t cipher, dxf_uint_t hash,
+							const dxf_char_t* chars, int length) {
+	if (entry->cipher != cipher || entry->hash != hash) {
+		return false;
+	}
+
+	return cipher != 0 || (entry->length == length && dx_compare_strings_num(entry->symbol, chars, length) == 0);
+}
+
+/* -------------------------------------------------------------------------- */
+
+/* Returns the slot holding the symbol or the free slot it's to be stored in */
+static int* dx_find_symbol_slot (dx_symbol_table_data_t* data, dxf_int_t cipher, dxf_uint_t hash,
+								const dxf_char_t* chars, int length) {
+	int mask = data->slot_count - 1;
+	int index = (int)(hash & (dxf_uint_t)mask);
+
+	for (;; index = (index + 1) & mask) {
+		int* slot = data->slots + index;
+
+		if (*slot == 0 || dx_is_same_symbol(data->symbols + *slot - 1, cipher, hash, chars, length)) {
+			return slot;
+		}
+	}
+}
+
+/* -------------------------------------------------------------------------- */
+
+static int dx_grow_symbol_table (dx_symbol_table_data_t* data) {
+	int new_capacity = (data->capacity == 0) ? INITIAL_SYMBOL_CAPACITY : data->capacity * 2;
+	dx_interned_symbol_t* new_symbols = dx_calloc(new_capacity, sizeof(dx_interned_symbol_t));
+	int* new_slots = dx_calloc(new_capacity * 2, sizeof(int));
+	int i = 0;
+
+	if (new_symbols == NULL || new_slots == NULL) {
+		CHECKED_FREE(new_symbols);
+		CHECKED_FREE(new_slots);
+
+		return false;
+	}
+
+	if (data->size > 0) {
+		dx_memcpy(new_symbols, data->symbols, data->size * sizeof(dx_interned_symbol_t));
+	}
+
+	CHECKED_FREE(data->symbols);
+	CHECKED_FREE(data->slots);
+
+	data->symbols = new_symbols;
+	data->capacity = new_capacity;
+	data->slots = new_slots;
+	data->slot_count = new_capacity * 2;
+
+	/* the symbols are distinct, so each one just takes the first free slot */
+	for (; i < data->size; ++i) {
+		int mask = data->slot_count - 1;
+		int index = (int)(data->symbols[i].hash & (dxf_uint_t)mask);
+
+		while (data->slots[index] != 0) {
+			index = (index + 1) & mask;
+		}
+
+		data->slots[index] = i + 1;
+	}
+
+	return true;
+}
+
+/* -------------------------------------------------------------------------- */
+
+/* The symbol string is either the given characters or is decoded from the cipher */
+static int dx_intern_symbol (dx_symbol_table_data_t* data, dxf_int_t cipher, const dxf_char_t* chars, int length,
+							OUT dxf_const_string_t* symbol, OUT dxf_int_t* symbol_id) {
+	dxf_uint_t hash = (cipher != 0) ? dx_cipher_hash(cipher) : dx_chars_hash(chars, length);
+	int* slot = NULL;
+	dx_interned_symbol_t* entry = NULL;
+
+	if (data->slots != NULL) {
+		slot = dx_find_symbol_slot(data, cipher, hash, chars, length);
+
+		if (*slot != 0) {
+			*symbol = data->symbols[*slot - 1].symbol;
+			*symbol_id = *slot - 1;
+
+			return true;
+		}
+	}
+
+	/* a new symbol */
+
+	if (data->size == data->capacity) {
+		CHECKED_CALL(dx_grow_symbol_table, data);
+
+		slot = dx_find_symbol_slot(data, cipher, hash, chars, length);
+	}
+
+	entry = data->symbols + data->size;
+
+	if (cipher != 0) {
+		CHECKED_CALL_2(dx_decode_symbol_name, cipher, (dxf_const_string_t*)&entry->symbol);
+	} else if ((entry->symbol = dx_create_string_src_len(chars, length)) == NULL) {
+		return false;
+	}
+
+	entry->cipher = cipher;
+	entry->length = length;
+	entry->hash = hash;
+	entry->has_name_hash = false;
+
+	*slot = ++data->size;
+	*symbol = entry->symbol;
+	*symbol_id = data->size - 1;
+
+	return true;
+}
+
+/* -------------------------------------------------------------------------- */
+/*
+ *	Symbol table lifecycle functions implementation
+ */
+/* -------------------------------------------------------------------------- */
+
+dx_symbol_table_t dx_create_symbol_table (void) {
+	return dx_calloc(1, sizeof(dx_symbol_table_data_t));
+}
+
+/* -------------------------------------------------------------------------- */
+
+void dx_free_symbol_table (dx_symbol_table_t table) {
+	dx_symbol_table_data_t* data = table;
+
+	if (data == NULL) {
+		return;
+	}
+
+	dx_clear_symbol_table(table);
+
+	CHECKED_FREE(data->symbols);
+	CHECKED_FREE(data->slots);
+
+	dx_free(data);
+}
+
+/* -------------------------------------------------------------------------- */
+
+void dx_clear_symbol_table (dx_symbol_table_t table) {
+	dx_symbol_table_data_t* data = table;
+	int i = 0;
+
+	for (; i < data->size; ++i) {
+		dx_free(data->symbols[i].symbol);
+	}
+
+	data->size = 0;
+
+	if (data->slots != NULL) {
+		dx_memset(data->slots, 0, data->slot_count * sizeof(int));
+	}
+}
+
+/* -------------------------------------------------------------------------- */
+
+int dx_get_symbol_table_size (dx_symbol_table_t table) {
+	return ((dx_symbol_table_data_t*)table)->size;
+}
+
+/* -------------------------------------------------------------------------- */
+/*
+ *	Interning functions implementation
+ */
+/* -------------------------------------------------------------------------- */
+
+int dx_intern_cipher_symbol (dx_symbol_table_t table, dxf_int_t cipher,
+							OUT dxf_const_string_t* symbol, OUT dxf_int_t* symbol_id) {
+	if (table == NULL || cipher == 0) {
+		return dx_set_error_code(dx_ec_invalid_func_param_internal);
+	}
+
+	return dx_intern_symbol(table, cipher, NULL, 0, symbol, symbol_id);
+}
+
+/* -------------------------------------------------------------------------- */
+
+int dx_intern_string_symbol (dx_symbol_table_t table, const dxf_char_t* chars, int length,
+							OUT dxf_const_string_t* symbol, OUT dxf_int_t* symbol_id) {
+	dxf_int_t cipher = 0;
+
+	if (table == NULL || chars == NULL || length < 0) {
+		return dx_set_error_code(dx_ec_invalid_func_param_internal);
+	}
+
+	if (length <= MAX_CIPHER_SYMBOL_LENGTH) {
+		dxf_char_t buffer[MAX_CIPHER_SYMBOL_LENGTH + 1];
+
+		dx_memcpy(buffer, chars, length * sizeof(dxf_char_t));
+		buffer[length] = 0;
+
+		cipher = dx_encode_symbol_name(buffer);
+	}
+
+	return dx_intern_symbol(table, cipher, chars, length, symbol, symbol_id);
+}
+
+/* -------------------------------------------------------------------------- */
+
+dxf_ulong_t dx_get_symbol_name_hash (dx_symbol_table_t table, dxf_int_t symbol_id) {
+	dx_interned_symbol_t* entry = ((dx_symbol_table_data_t*)table)->symbols + symbol_id;
+
+	if (!entry->has_name_hash) {
+		entry->name_hash = dx_symbol_name_hasher(entry->symbol);
+		entry->has_name_hash = true;
+	}
+
+	return entry->name_hash;
+}
@@ -0,0 +1,69 @@
+/*
+ * The contents of this file are subject to the Mozilla Public License Version
+ * 1.1 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ * http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+ * for the specific language governing rights and limitations under the
+ * License.
+ *
+ * The Initial Developer of the Original Code is Devexperts LLC.
+ * Portions created by the Initial Developer are Copyright (C) 2010
+ * the Initial Developer. All Rights Reserved.
+ *
+ * Contributor(s):
+ *
+ */
+
+/*
+ *	The symbol table interns the symbols received by a connection. Every distinct symbol gets
+ *  one string and a small integer id, both staying valid until the table is cleared, so that
+ *  the records of an already seen symbol are processed without allocating the symbol string.
+ *  The symbols are keyed by their cipher when they can be penta-encoded and by their characters
+ *  otherwise, so a symbol gets the same id however the server has sent it.
+ *  The table is not thread-safe, it's used by the thread processing the server data.
+ */
+
+#ifndef SYMBOL_TABLE_H_INCLUDED
+#define SYMBOL_TABLE_H_INCLUDED
+
+#include "PrimitiveTypes.h"
+#include "DXTypes.h"
+
+typedef void* dx_symbol_table_t;
+
+/* -------------------------------------------------------------------------- */
+/*
+ *	Symbol table lifecycle functions
+ */
+/* -------------------------------------------------------------------------- */
+
+dx_symbol_table_t dx_create_symbol_table (void);
+void dx_free_symbol_table (dx_symbol_table_t table);
+
+/* Forgets all the symbols, the strings and the ids returned earlier become invalid */
+void dx_clear_symbol_table (dx_symbol_table_t table);
+
+/* Returns the number of the interned symbols */
+int dx_get_symbol_table_size (dx_symbol_table_t table);
+
+/* -------------------------------------------------------------------------- */
+/*
+ *	Interning functions
+ */
+/* -------------------------------------------------------------------------- */
+
+/* Returns the symbol of the cipher, which must not be 0 */
+int dx_intern_cipher_symbol (dx_symbol_table_t table, dxf_int_t cipher,
+							OUT dxf_const_string_t* symbol, OUT dxf_int_t* symbol_id);
+
+/* Returns the symbol with the characters, they don't have to be null-terminated */
+int dx_intern_string_symbol (dx_symbol_table_t table, const dxf_char_t* chars, int length,
+							OUT dxf_const_string_t* symbol, OUT dxf_int_t* symbol_id);
+
+/* Returns the dx_symbol_name_hasher value of the interned symbol, it's computed once per symbol */
+dxf_ulong_t dx_get_symbol_name_hash (dx_symbol_table_t table, dxf_int_t symbol_id);
+
+#endif /* SYMBOL_TABLE_H_INCLUDED */
@@ -37,15 +37,23 @@ typedef struct {
 
 typedef struct {
 	dx_mutex_t guard;
+	dx_condition_t wakeup_condition;
 
 	dx_task_data_t* elements;
 	size_t size;
 	size_t capacity;
 
+	/* set when a task is added or the queue is woken up explicitly, reset by the waiting thread */
+	int wakeup_pending;
+
+	dx_task_queue_wakeup_notifier_t wakeup_notifier;
+	void* wakeup_notifier_data;
+
 	int set_fields_flags;
 } dx_task_queue_data_t;
 
 #define MUTEX_FIELD_FLAG (1 << 0)
+#define CONDITION_FIELD_FLAG (1 << 1)
 
 /* -------------------------------------------------------------------------- */
 /*
@@ -64,6 +72,10 @@ int dx_clear_task_queue_data (dx_task_queue_data_t* tqd) {
 		res = dx_mutex_destroy(&tqd->guard) && res;
 	}
 
+	if (IS_FLAG_SET(tqd->set_fields_flags, CONDITION_FIELD_FLAG)) {
+		res = dx_condition_destroy(&tqd->wakeup_condition) && res;
+	}
+
 	CHECKED_FREE(tqd->elements);
 	dx_free(tqd);
 
@@ -89,7 +101,8 @@ int dx_create_task_queue (OUT dx_task_queue_t* tq) {
 		return false;
 	}
 
-	if (!(dx_mutex_create(&tqd->guard) && (tqd->set_fields_flags |= MUTEX_FIELD_FLAG))) { /* setting the flag if the function succeeded, not setting otherwise */
+	if (!(dx_mutex_create(&tqd->guard) && (tqd->set_fields_flags |= MUTEX_FIELD_FLAG)) || /* setting the flag if the function succeeded, not setting otherwise */
+		!(dx_condition_create(&tqd->wakeup_condition) && (tqd->set_fields_flags |= CONDITION_FIELD_FLAG))) {
 		dx_clear_task_queue_data(tqd);
 
 		return false;
@@ -161,6 +174,15 @@ int dx_add_task_to_queue (dx_task_queue_t tq, dx_task_processor_t processor, voi
 
 	DX_ARRAY_INSERT(*tqd, dx_task_data_t, task, tqd->size, dx_capacity_manager_halfer, failed);
 
+	if (!failed) {
+		tqd->wakeup_pending = true;
+		failed = !dx_condition_signal(&(tqd->wakeup_condition));
+
+		if (tqd->wakeup_notifier != NULL) {
+			tqd->wakeup_notifier(tqd->wakeup_notifier_data);
+		}
+	}
+
 	return dx_mutex_unlock(&(tqd->guard)) && !failed;
 }
 
@@ -225,3 +247,64 @@ int dx_is_queue_empty (dx_task_queue_t tq, OUT int* res) {
 
 	return true;
 }
+
+/* -------------------------------------------------------------------------- */
+
+int dx_wait_for_task_queue (dx_task_queue_t tq, int timeout) {
+	dx_task_queue_data_t* tqd = tq;
+	int res = true;
+
+	if (tq == NULL || timeout < 0) {
+		return dx_set_error_code(dx_ec_invalid_func_param_internal);
+	}
+
+	CHECKED_CALL(dx_mutex_lock, &(tqd->guard));
+
+	if (!tqd->wakeup_pending && timeout > 0) {
+		/* a spurious wakeup only makes the caller recheck its deadlines earlier */
+		res = dx_condition_wait(&(tqd->wakeup_condition), &(tqd->guard), timeout);
+	}
+
+	tqd->wakeup_pending = false;
+
+	return dx_mutex_unlock(&(tqd->guard)) && res;
+}
+
+/* -------------------------------------------------------------------------- */
+
+int dx_wake_up_task_queue (dx_task_queue_t tq) {
+	dx_task_queue_data_t* tqd = tq;
+	int res = true;
+
+	if (tq == NULL) {
+		return dx_set_error_code(dx_ec_invalid_func_param_internal);
+	}
+
+	CHECKED_CALL(dx_mutex_lock, &(tqd->guard));
+
+	tqd->wakeup_pending = true;
+	res = dx_condition_signal(&(tqd->wakeup_condition));
+
+	if (tqd->wakeup_notifier != NULL) {
+		tqd->wakeup_notifier(tqd->wakeup_notifier_data);
+	}
+
+	return dx_mutex_unlock(&(tqd->guard)) && res;
+}
+
+/* -------------------------------------------------------------------------- */
+
+int dx_set_task_queue_wakeup_notifier (dx_task_queue_t tq, dx_task_queue_wakeup_notifier_t notifier, void* data) {
+	dx_task_queue_data_t* tqd = tq;
+
+	if (tq == NULL) {
+		return dx_set_error_code(dx_ec_invalid_func_param_internal);
+	}
+
+	CHECKED_CALL(dx_mutex_lock, &(tqd->guard));
+
+	tqd->wakeup_notifier = notifier;
+	tqd->wakeup_notifier_data = data;
+
+	return dx_mutex_unlock(&(tqd->guard));
+}
@@ -43,6 +43,9 @@ typedef int (*dx_task_processor_t) (void* data, int command);
 
 typedef void* dx_task_queue_t;
 
+/* called on the same events the waiting thread is woken up on, used when the queue is served by an event loop */
+typedef void (*dx_task_queue_wakeup_notifier_t) (void* data);
+
 /* -------------------------------------------------------------------------- */
 /*
  *	Task queue functions
@@ -56,4 +59,13 @@ int dx_add_task_to_queue (dx_task_queue_t tq, dx_task_processor_t processor, voi
 int dx_execute_task_queue (dx_task_queue_t tq);
 int dx_is_queue_empty (dx_task_queue_t tq, OUT int* res);
 
+/*
+ *	Blocks the calling thread until a new task is added to the queue, the queue is woken up explicitly
+ *  or 'timeout' milliseconds pass, whichever comes first. Returns immediately if the queue has been
+ *  woken up since the previous call.
+ */
+int dx_wait_for_task_queue (dx_task_queue_t tq, int timeout);
+int dx_wake_up_task_queue (dx_task_queue_t tq);
+int dx_set_task_queue_wakeup_notifier (dx_task_queue_t tq, dx_task_queue_wakeup_notifier_t notifier, void* data);
+
 #endif /* TASK_QUEUE_H_INCLUDED */
\ No newline at end of file
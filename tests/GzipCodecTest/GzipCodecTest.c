@@ -0,0 +1,657 @@
+/*
+ * The contents of this file are subject to the Mozilla Public License Version
+ * 1.1 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ * http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+ * for the specific language governing rights and limitations under the
+ * License.
+ *
+ * The Initial Developer of the Original Code is Devexperts LLC.
+ * Portions created by the Initial Developer are Copyright (C) 2010
+ * the Initial Developer. All Rights Reserved.
+ *
+ * Contributor(s):
+ *
+ */
+
+/*
+ *	The loopback test of the gzip codec. The test runs a stand-in server that speaks the compressed
+ *  QTP protocol on the local interface, connects to it via the 'gzip+' address and checks that all
+ *  the events are received and the compression statistics is consistent.
+ */
+
+#ifdef _WIN32
+#	ifndef _CRT_STDIO_ISO_WIDE_SPECIFIERS
+#		define _CRT_STDIO_ISO_WIDE_SPECIFIERS 1
+#	endif
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <zlib.h>
+
+#include "DXErrorCodes.h"
+#include "DXFeed.h"
+#include "EventData.h"
+#include "Logger.h"
+
+#ifdef _WIN32
+#	pragma warning(push)
+#	pragma warning(disable : 5105)
+#	include <WinSock2.h>
+#	include <WS2tcpip.h>
+#	include <Windows.h>
+#	pragma warning(pop)
+typedef SOCKET dxs_socket_t;
+typedef HANDLE dxs_thread_t;
+#	define DXS_INVALID_SOCKET INVALID_SOCKET
+void dxs_sleep(int milliseconds) { Sleep((DWORD)milliseconds); }
+void dxs_close_socket(dxs_socket_t s) { closesocket(s); }
+#else
+#	include <arpa/inet.h>
+#	include <netinet/in.h>
+#	include <netinet/tcp.h>
+#	include <pthread.h>
+#	include <sys/socket.h>
+#	include <time.h>
+#	include <unistd.h>
+typedef int dxs_socket_t;
+typedef pthread_t dxs_thread_t;
+#	define DXS_INVALID_SOCKET (-1)
+void dxs_sleep(int milliseconds) {
+	struct timespec ts;
+	ts.tv_sec = milliseconds / 1000;
+	ts.tv_nsec = (milliseconds % 1000) * 1000000;
+	nanosleep(&ts, NULL);
+}
+void dxs_close_socket(dxs_socket_t s) { close(s); }
+#endif
+
+#define SYMBOL "GZIP"
+#define BULK_QUOTE_COUNT 20000
+#define FRAGMENTED_QUOTE_COUNT 500
+#define QUOTE_COUNT (BULK_QUOTE_COUNT + FRAGMENTED_QUOTE_COUNT)
+#define QUOTES_PER_MESSAGE 50
+#define WAIT_TIMEOUT 10000
+
+#define MESSAGE_DESCRIBE_PROTOCOL 1
+#define MESSAGE_DESCRIBE_RECORDS 2
+#define MESSAGE_TICKER_DATA 10
+#define MESSAGE_TICKER_ADD_SUBSCRIPTION 11
+
+/* -------------------------------------------------------------------------- */
+/*
+ *	Stand-in server
+ */
+/* -------------------------------------------------------------------------- */
+
+typedef struct {
+	unsigned char* data;
+	int size;
+	int capacity;
+} dxs_buffer_t;
+
+typedef struct {
+	dxs_socket_t listener;
+	dxs_socket_t client;
+	z_stream inflater;
+	z_stream deflater;
+	volatile int is_subscribed;
+	volatile int is_finished;
+	int result;
+} dxs_server_t;
+
+static dxs_server_t g_server;
+static volatile int g_received_quotes = 0;
+static volatile int g_corrupted_quotes = 0;
+
+/* -------------------------------------------------------------------------- */
+
+static void dxs_buffer_write(dxs_buffer_t* buffer, const void* data, int size) {
+	if (buffer->size + size > buffer->capacity) {
+		buffer->capacity = (buffer->size + size) * 2;
+		buffer->data = realloc(buffer->data, buffer->capacity);
+	}
+
+	memcpy(buffer->data + buffer->size, data, size);
+	buffer->size += size;
+}
+
+/* -------------------------------------------------------------------------- */
+
+static void dxs_buffer_write_byte(dxs_buffer_t* buffer, int value) {
+	unsigned char byte = (unsigned char)value;
+
+	dxs_buffer_write(buffer, &byte, 1);
+}
+
+/* -------------------------------------------------------------------------- */
+
+static void dxs_buffer_write_compact_int(dxs_buffer_t* buffer, int value) {
+	if (value >= -0x40 && value < 0x40) {
+		dxs_buffer_write_byte(buffer, value & 0x7F);
+	} else if (value >= -0x2000 && value < 0x2000) {
+		dxs_buffer_write_byte(buffer, ((value >> 8) & 0x3F) | 0x80);
+		dxs_buffer_write_byte(buffer, value);
+	} else if (value >= -0x100000 && value < 0x100000) {
+		dxs_buffer_write_byte(buffer, ((value >> 16) & 0x1F) | 0xC0);
+		dxs_buffer_write_byte(buffer, value >> 8);
+		dxs_buffer_write_byte(buffer, value);
+	} else {
+		dxs_buffer_write_byte(buffer, 0xF0);
+		dxs_buffer_write_byte(buffer, value >> 24);
+		dxs_buffer_write_byte(buffer, value >> 16);
+		dxs_buffer_write_byte(buffer, value >> 8);
+		dxs_buffer_write_byte(buffer, value);
+	}
+}
+
+/* -------------------------------------------------------------------------- */
+
+static void dxs_buffer_write_utf(dxs_buffer_t* buffer, const char* value) {
+	int length = (int)strlen(value);
+
+	dxs_buffer_write_compact_int(buffer, length);
+	dxs_buffer_write(buffer, value, length);
+}
+
+/* -------------------------------------------------------------------------- */
+
+/* Wraps the body into the message with the length and the type prefix */
+static void dxs_buffer_write_message(dxs_buffer_t* buffer, int type, const dxs_buffer_t* body) {
+	dxs_buffer_t payload = {NULL, 0, 0};
+
+	dxs_buffer_write_compact_int(&payload, type);
+	dxs_buffer_write(&payload, body->data, body->size);
+	dxs_buffer_write_compact_int(buffer, payload.size);
+	dxs_buffer_write(buffer, payload.data, payload.size);
+
+	free(payload.data);
+}
+
+/* -------------------------------------------------------------------------- */
+
+static void dxs_write_describe_protocol(dxs_buffer_t* buffer) {
+	static const int send_ids[] = {MESSAGE_TICKER_DATA};
+	static const char* send_names[] = {"TICKER_DATA"};
+	static const int receive_ids[] = {MESSAGE_TICKER_ADD_SUBSCRIPTION, 12};
+	static const char* receive_names[] = {"TICKER_ADD_SUBSCRIPTION", "TICKER_REMOVE_SUBSCRIPTION"};
+	dxs_buffer_t body = {NULL, 0, 0};
+	int i = 0;
+
+	dxs_buffer_write(&body, "DXP3", 4);
+	dxs_buffer_write_compact_int(&body, 0); /* no properties */
+
+	dxs_buffer_write_compact_int(&body, 1);
+	for (i = 0; i < 1; ++i) {
+		dxs_buffer_write_compact_int(&body, send_ids[i]);
+		dxs_buffer_write_utf(&body, send_names[i]);
+		dxs_buffer_write_compact_int(&body, 0);
+	}
+
+	dxs_buffer_write_compact_int(&body, 2);
+	for (i = 0; i < 2; ++i) {
+		dxs_buffer_write_compact_int(&body, receive_ids[i]);
+		dxs_buffer_write_utf(&body, receive_names[i]);
+		dxs_buffer_write_compact_int(&body, 0);
+	}
+
+	dxs_buffer_write_message(buffer, MESSAGE_DESCRIBE_PROTOCOL, &body);
+	free(body.data);
+}
+
+/* -------------------------------------------------------------------------- */
+
+static void dxs_write_describe_records(dxs_buffer_t* buffer) {
+	static const char* field_names[] = {"Sequence", "TimeNanoPart", "Bid.Time", "Bid.Exchange", "Bid.Price",
+		"Bid.Size", "Ask.Time", "Ask.Exchange", "Ask.Price", "Ask.Size"};
+	static const int field_types[] = {0x08, 0x08, 0x08, 0x02, 0x78, 0x78, 0x08, 0x02, 0x78, 0x78};
+	dxs_buffer_t body = {NULL, 0, 0};
+	int i = 0;
+
+	dxs_buffer_write_compact_int(&body, 0); /* record id */
+	dxs_buffer_write_utf(&body, "Quote");
+	dxs_buffer_write_compact_int(&body, 10);
+
+	for (; i < 10; ++i) {
+		dxs_buffer_write_utf(&body, field_names[i]);
+		dxs_buffer_write_compact_int(&body, field_types[i]);
+	}
+
+	dxs_buffer_write_message(buffer, MESSAGE_DESCRIBE_RECORDS, &body);
+	free(body.data);
+}
+
+/* -------------------------------------------------------------------------- */
+
+/* The quote fields are derived from the index, so that the client is able to verify them */
+static void dxs_write_quotes(dxs_buffer_t* buffer, int first_index, int count) {
+	dxs_buffer_t body = {NULL, 0, 0};
+	int i = first_index;
+
+	for (; i < first_index + count; ++i) {
+		dxs_buffer_write_byte(&body, 0xFC); /* the full symbol follows */
+		dxs_buffer_write_utf(&body, SYMBOL);
+		dxs_buffer_write_compact_int(&body, 0); /* record id */
+		dxs_buffer_write_compact_int(&body, i); /* Sequence */
+		dxs_buffer_write_compact_int(&body, 0);
+		dxs_buffer_write_compact_int(&body, i); /* Bid.Time */
+		dxs_buffer_write_byte(&body, 'A' + i % 26);
+		dxs_buffer_write_compact_int(&body, 100);
+		dxs_buffer_write_compact_int(&body, 10);
+		dxs_buffer_write_compact_int(&body, i); /* Ask.Time */
+		dxs_buffer_write_byte(&body, 'B');
+		dxs_buffer_write_compact_int(&body, 200);
+		dxs_buffer_write_compact_int(&body, 20);
+	}
+
+	dxs_buffer_write_message(buffer, MESSAGE_TICKER_DATA, &body);
+	free(body.data);
+}
+
+/* -------------------------------------------------------------------------- */
+
+static int dxs_send_all(dxs_socket_t s, const unsigned char* data, int size) {
+	while (size > 0) {
+		int sent = (int)send(s, (const char*)data, size, 0);
+
+		if (sent <= 0) {
+			return false;
+		}
+
+		data += sent;
+		size -= sent;
+	}
+
+	return true;
+}
+
+/* -------------------------------------------------------------------------- */
+
+/*
+ *	Compresses the data with the sync flush and sends it in the pieces of the given size,
+ *  so that the client has to deal with the incomplete deflate blocks.
+ */
+static int dxs_send_compressed(dxs_server_t* server, dxs_buffer_t* data, int piece_size) {
+	unsigned char output[16384];
+	dxs_buffer_t compressed = {NULL, 0, 0};
+	int offset = 0;
+	int res = true;
+
+	server->deflater.next_in = data->data;
+	server->deflater.avail_in = (uInt)data->size;
+
+	do {
+		server->deflater.next_out = output;
+		server->deflater.avail_out = sizeof(output);
+
+		if (deflate(&server->deflater, Z_SYNC_FLUSH) == Z_STREAM_ERROR) {
+			free(compressed.data);
+
+			return false;
+		}
+
+		dxs_buffer_write(&compressed, output, (int)(sizeof(output) - server->deflater.avail_out));
+	} while (server->deflater.avail_out == 0);
+
+	for (; offset < compressed.size && res; offset += piece_size) {
+		int size = compressed.size - offset < piece_size ? compressed.size - offset : piece_size;
+
+		res = dxs_send_all(server->client, compressed.data + offset, size);
+
+		if (piece_size < compressed.size) {
+			dxs_sleep(1);
+		}
+	}
+
+	free(compressed.data);
+	data->size = 0;
+
+	return res;
+}
+
+/* -------------------------------------------------------------------------- */
+
+/* Returns the message type of the first message in the data or -1 if the message is incomplete */
+static int dxs_read_message(const unsigned char* data, int size, OUT int* message_size) {
+	int length = 0;
+	int header_size = 1;
+
+	/* the client messages are short, so the two byte lengths are enough here */
+	if (size < 1) {
+		return -1;
+	}
+
+	if ((data[0] & 0x80) == 0) {
+		length = data[0];
+	} else {
+		if (size < 2) {
+			return -1;
+		}
+
+		length = ((data[0] & 0x3F) << 8) | data[1];
+		header_size = 2;
+	}
+
+	if (size < header_size + length) {
+		return -1;
+	}
+
+	*message_size = header_size + length;
+
+	return length == 0 ? 0 : data[header_size];
+}
+
+/* -------------------------------------------------------------------------- */
+
+/* Inflates the client data until the subscription arrives */
+static int dxs_wait_for_subscription(dxs_server_t* server) {
+	unsigned char input[4096];
+	unsigned char output[65536];
+	int output_size = 0;
+
+	while (!server->is_subscribed) {
+		int received = (int)recv(server->client, (char*)input, sizeof(input), 0);
+		int offset = 0;
+		int message_size = 0;
+		int message_type = 0;
+
+		if (received <= 0) {
+			return false;
+		}
+
+		server->inflater.next_in = input;
+		server->inflater.avail_in = (uInt)received;
+
+		while (server->inflater.avail_in > 0) {
+			int res = Z_OK;
+
+			server->inflater.next_out = output + output_size;
+			server->inflater.avail_out = (uInt)(sizeof(output) - output_size);
+
+			res = inflate(&server->inflater, Z_SYNC_FLUSH);
+
+			if (res != Z_OK && res != Z_BUF_ERROR) {
+				wprintf(L"Server: the client data is not a valid gzip stream (%d)\n", res);
+
+				return false;
+			}
+
+			output_size = (int)(sizeof(output) - server->inflater.avail_out);
+		}
+
+		while ((message_type = dxs_read_message(output + offset, output_size - offset, &message_size)) >= 0) {
+			if (message_type == MESSAGE_TICKER_ADD_SUBSCRIPTION) {
+				server->is_subscribed = true;
+			}
+
+			offset += message_size;
+		}
+
+		memmove(output, output + offset, output_size - offset);
+		output_size -= offset;
+	}
+
+	return true;
+}
+
+/* -------------------------------------------------------------------------- */
+
+static int dxs_serve_client(dxs_server_t* server) {
+	dxs_buffer_t data = {NULL, 0, 0};
+	int i = 0;
+	int res = true;
+
+	dxs_write_describe_protocol(&data);
+	dxs_write_describe_records(&data);
+	res = dxs_send_compressed(server, &data, 7);
+
+	res = res && dxs_wait_for_subscription(server);
+
+	/* a lot of data in a single piece, it's inflated into several receive buffer portions */
+	for (i = 0; res && i < BULK_QUOTE_COUNT; i += QUOTES_PER_MESSAGE) {
+		dxs_write_quotes(&data, i, QUOTES_PER_MESSAGE);
+	}
+
+	res = res && dxs_send_compressed(server, &data, data.size);
+
+	/* small messages split into the pieces that end in the middle of the deflate blocks */
+	for (; res && i < QUOTE_COUNT; i += 5) {
+		dxs_write_quotes(&data, i, 5);
+		res = dxs_send_compressed(server, &data, 3 + i % 11);
+	}
+
+	free(data.data);
+
+	return res;
+}
+
+/* -------------------------------------------------------------------------- */
+
+#ifdef _WIN32
+static DWORD WINAPI dxs_server_thread(LPVOID arg) {
+#else
+static void* dxs_server_thread(void* arg) {
+#endif
+	dxs_server_t* server = arg;
+
+	server->client = accept(server->listener, NULL, NULL);
+
+	if (server->client == DXS_INVALID_SOCKET) {
+		server->result = false;
+	} else {
+		server->result = dxs_serve_client(server);
+
+		/* the client closes the connection first, otherwise it would try to reconnect */
+		while (!server->is_finished) {
+			dxs_sleep(10);
+		}
+
+		dxs_close_socket(server->client);
+	}
+
+	return 0;
+}
+
+/* -------------------------------------------------------------------------- */
+
+static int dxs_start_server(dxs_server_t* server, OUT int* port, OUT dxs_thread_t* thread) {
+	struct sockaddr_in addr;
+	socklen_t addr_size = sizeof(addr);
+
+	memset(server, 0, sizeof(dxs_server_t));
+
+	if (inflateInit2(&server->inflater, MAX_WBITS + 16) != Z_OK ||
+		deflateInit2(&server->deflater, Z_DEFAULT_COMPRESSION, Z_DEFLATED, MAX_WBITS + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+		return false;
+	}
+
+	memset(&addr, 0, sizeof(addr));
+	addr.sin_family = AF_INET;
+	addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	addr.sin_port = 0;
+
+	server->listener = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+
+	if (server->listener == DXS_INVALID_SOCKET || bind(server->listener, (struct sockaddr*)&addr, sizeof(addr)) != 0 ||
+		listen(server->listener, 1) != 0 || getsockname(server->listener, (struct sockaddr*)&addr, &addr_size) != 0) {
+		return false;
+	}
+
+	*port = ntohs(addr.sin_port);
+
+#ifdef _WIN32
+	*thread = CreateThread(NULL, 0, dxs_server_thread, server, 0, NULL);
+
+	return *thread != NULL;
+#else
+	return pthread_create(thread, NULL, dxs_server_thread, server) == 0;
+#endif
+}
+
+/* -------------------------------------------------------------------------- */
+
+static void dxs_stop_server(dxs_server_t* server, dxs_thread_t thread) {
+	server->is_finished = true;
+
+#ifdef _WIN32
+	WaitForSingleObject(thread, INFINITE);
+	CloseHandle(thread);
+#else
+	pthread_join(thread, NULL);
+#endif
+
+	dxs_close_socket(server->listener);
+	inflateEnd(&server->inflater);
+	deflateEnd(&server->deflater);
+}
+
+/* -------------------------------------------------------------------------- */
+/*
+ *	Client
+ */
+/* -------------------------------------------------------------------------- */
+
+void process_last_error() {
+	int error_code = dx_ec_success;
+	dxf_const_string_t error_descr = NULL;
+	int res;
+
+	res = dxf_get_last_error(&error_code, &error_descr);
+
+	if (res == DXF_SUCCESS) {
+		if (error_code == dx_ec_success) {
+			wprintf(L"No error information is stored");
+
+			return;
+		}
+
+		wprintf(
+			L"Error occurred and successfully retrieved:\n"
+			L"error code = %d, description = \"%ls\"\n",
+			error_code, error_descr);
+		return;
+	}
+
+	wprintf(L"An error occurred but the error subsystem failed to initialize\n");
+}
+
+/* -------------------------------------------------------------------------- */
+
+void listener(int event_type, dxf_const_string_t symbol_name, const dxf_event_data_t* data, int data_count,
+			  void* user_data) {
+	const dxf_quote_t* quotes = (const dxf_quote_t*)data;
+	int i = 0;
+
+	for (; i < data_count; ++i) {
+		const int index = g_received_quotes + g_corrupted_quotes;
+
+		/* the events of a single symbol arrive in order */
+		if (quotes[i].bid_time == (dxf_long_t)index * 1000 && quotes[i].bid_exchange_code == L'A' + index % 26 &&
+			quotes[i].ask_exchange_code == L'B') {
+			++g_received_quotes;
+		} else {
+			++g_corrupted_quotes;
+		}
+	}
+}
+
+/* -------------------------------------------------------------------------- */
+
+int main(int argc, char* argv[]) {
+	dxf_connection_t connection;
+	dxf_subscription_t subscription;
+	dxf_compression_statistics_t statistics;
+	dxs_thread_t server_thread;
+	char address[64];
+	int port = 0;
+	int waited = 0;
+	int res = 0;
+
+#ifdef _WIN32
+	WSADATA wsa_data;
+
+	WSAStartup(MAKEWORD(2, 2), &wsa_data);
+#endif
+
+	dxf_initialize_logger("gzip-codec-test-api.log", true, true, false);
+
+	wprintf(L"Gzip codec test started.\n");
+
+	if (!dxs_start_server(&g_server, &port, &server_thread)) {
+		wprintf(L"Failed to start the stand-in server\n");
+
+		return 1;
+	}
+
+	snprintf(address, sizeof(address), "gzip+127.0.0.1:%d", port);
+	wprintf(L"Connecting to the stand-in server %hs...\n", address);
+
+	if (!dxf_create_connection(address, NULL, NULL, NULL, NULL, NULL, &connection)) {
+		process_last_error();
+		dxs_stop_server(&g_server, server_thread);
+
+		return 2;
+	}
+
+	if (!dxf_create_subscription(connection, DXF_ET_QUOTE, &subscription) ||
+		!dxf_attach_event_listener(subscription, listener, NULL) || !dxf_add_symbol(subscription, L"" SYMBOL)) {
+		process_last_error();
+		dxf_close_connection(connection);
+		dxs_stop_server(&g_server, server_thread);
+
+		return 10;
+	}
+
+	for (; waited < WAIT_TIMEOUT && g_received_quotes + g_corrupted_quotes < QUOTE_COUNT; waited += 10) {
+		dxs_sleep(10);
+	}
+
+	if (!dxf_get_connection_compression_statistics(connection, &statistics)) {
+		process_last_error();
+		res = 11;
+	}
+
+	dxf_close_subscription(subscription);
+	dxf_close_connection(connection);
+	dxs_stop_server(&g_server, server_thread);
+
+	wprintf(L"Quotes received: %d of %d, corrupted: %d\n", g_received_quotes, QUOTE_COUNT, g_corrupted_quotes);
+
+	if (res != 0) {
+		return res;
+	}
+
+	wprintf(L"Received: %llu bytes inflated to %llu (ratio %.2f)\n", statistics.received_compressed_bytes,
+		statistics.received_uncompressed_bytes,
+		(double)statistics.received_uncompressed_bytes / (double)(statistics.received_compressed_bytes + 1));
+	wprintf(L"Sent: %llu bytes deflated to %llu\n", statistics.sent_uncompressed_bytes,
+		statistics.sent_compressed_bytes);
+
+	if (!g_server.result || !g_server.is_subscribed) {
+		wprintf(L"Test failed: the stand-in server didn't receive the subscription\n");
+
+		return 20;
+	}
+
+	if (g_received_quotes != QUOTE_COUNT || g_corrupted_quotes != 0) {
+		wprintf(L"Test failed: the quotes are lost or corrupted\n");
+
+		return 21;
+	}
+
+	if (statistics.received_compressed_bytes == 0 ||
+		statistics.received_uncompressed_bytes <= statistics.received_compressed_bytes ||
+		statistics.sent_uncompressed_bytes == 0 || statistics.sent_compressed_bytes == 0) {
+		wprintf(L"Test failed: the compression statistics is inconsistent\n");
+
+		return 22;
+	}
+
+	wprintf(L"Test passed\n");
+
+	return 0;
+}
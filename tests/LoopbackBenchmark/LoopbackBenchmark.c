@@ -0,0 +1,1058 @@
+/*
+ * The contents of this file are subject to the Mozilla Public License Version
+ * 1.1 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ * http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+ * for the specific language governing rights and limitations under the
+ * License.
+ *
+ * The Initial Developer of the Original Code is Devexperts LLC.
+ * Portions created by the Initial Developer are Copyright (C) 2010
+ * the Initial Developer. All Rights Reserved.
+ *
+ * Contributor(s):
+ *
+ */
+
+/*
+ *	The benchmarks of the client code paths that run against a stand-in QTP server on the local interface,
+ *  so that the numbers don't depend on the network and the feed.
+ *
+ *  Usage: LoopbackBenchmark <scenario> [<parameters>]
+ *  Scenarios:
+ *      subscription [<symbol count>] - the rate of the bulk dxf_add_symbols call, the symbols are counted
+ *                                      when the server receives them
+ *      decode [<record count>]         - the time to process a Quote, Trade and Order record, from reading
+ *                                      the socket to the listener call. The records are decoded both by
+ *                                      the decode plans and by the former field by field code
+ *      compact [<value count>]         - the compact int and long decode throughput of the buffered input,
+ *                                      with and without the message validated at once. This scenario
+ *                                      decodes a buffer in memory and doesn't start the server
+ */
+
+#ifdef _WIN32
+#	ifndef _CRT_STDIO_ISO_WIDE_SPECIFIERS
+#		define _CRT_STDIO_ISO_WIDE_SPECIFIERS 1
+#	endif
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <wchar.h>
+
+#include "BufferedInput.h"
+#include "DXErrorCodes.h"
+#include "DXFeed.h"
+#include "EventData.h"
+#include "Logger.h"
+#include "ServerMessageProcessor.h"
+
+#ifdef _WIN32
+#	pragma warning(push)
+#	pragma warning(disable : 5105)
+#	include <WinSock2.h>
+#	include <WS2tcpip.h>
+#	include <Windows.h>
+#	pragma warning(pop)
+typedef SOCKET dxs_socket_t;
+typedef HANDLE dxs_thread_t;
+#	define DXS_INVALID_SOCKET INVALID_SOCKET
+void dxs_sleep(int milliseconds) { Sleep((DWORD)milliseconds); }
+void dxs_close_socket(dxs_socket_t s) { closesocket(s); }
+double dxs_now_ms() {
+	LARGE_INTEGER counter, frequency;
+	QueryPerformanceCounter(&counter);
+	QueryPerformanceFrequency(&frequency);
+	return (double)counter.QuadPart * 1000.0 / (double)frequency.QuadPart;
+}
+#else
+#	include <arpa/inet.h>
+#	include <netinet/in.h>
+#	include <pthread.h>
+#	include <sys/socket.h>
+#	include <time.h>
+#	include <unistd.h>
+typedef int dxs_socket_t;
+typedef pthread_t dxs_thread_t;
+#	define DXS_INVALID_SOCKET (-1)
+void dxs_sleep(int milliseconds) {
+	struct timespec ts;
+	ts.tv_sec = milliseconds / 1000;
+	ts.tv_nsec = (milliseconds % 1000) * 1000000;
+	nanosleep(&ts, NULL);
+}
+void dxs_close_socket(dxs_socket_t s) { close(s); }
+double dxs_now_ms() {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (double)ts.tv_sec * 1000.0 + (double)ts.tv_nsec / 1000000.0;
+}
+#endif
+
+#define DEFAULT_SYMBOL_COUNT 200000
+#define DEFAULT_RECORD_COUNT 1000000
+#define DEFAULT_VALUE_COUNT 1000000
+#define COMPACT_DECODE_PASSES 20
+#define RECORDS_PER_MESSAGE 100
+#define WAIT_TIMEOUT 60000
+
+#define MESSAGE_DESCRIBE_PROTOCOL 1
+#define MESSAGE_DESCRIBE_RECORDS 2
+#define MESSAGE_TICKER_DATA 10
+#define MESSAGE_TICKER_ADD_SUBSCRIPTION 11
+#define MESSAGE_TICKER_REMOVE_SUBSCRIPTION 12
+#define MESSAGE_STREAM_DATA 15
+#define MESSAGE_STREAM_ADD_SUBSCRIPTION 16
+#define MESSAGE_STREAM_REMOVE_SUBSCRIPTION 17
+#define MESSAGE_HISTORY_DATA 20
+#define MESSAGE_HISTORY_ADD_SUBSCRIPTION 21
+#define MESSAGE_HISTORY_REMOVE_SUBSCRIPTION 22
+
+/* -------------------------------------------------------------------------- */
+/*
+ *	Stand-in server
+ */
+/* -------------------------------------------------------------------------- */
+
+typedef struct {
+	unsigned char* data;
+	int size;
+	int capacity;
+} dxs_buffer_t;
+
+typedef struct {
+	dxs_socket_t listener;
+	dxs_socket_t client;
+	volatile int is_finished;
+
+	/* the client traffic statistics */
+	volatile int subscription_entries;
+	volatile int subscription_messages;
+	volatile int reads;
+	volatile long long bytes;
+} dxs_server_t;
+
+static dxs_server_t g_server;
+
+/* -------------------------------------------------------------------------- */
+
+static void dxs_buffer_write(dxs_buffer_t* buffer, const void* data, int size) {
+	if (buffer->size + size > buffer->capacity) {
+		buffer->capacity = (buffer->size + size) * 2;
+		buffer->data = realloc(buffer->data, buffer->capacity);
+	}
+
+	memcpy(buffer->data + buffer->size, data, size);
+	buffer->size += size;
+}
+
+/* -------------------------------------------------------------------------- */
+
+static void dxs_buffer_write_byte(dxs_buffer_t* buffer, int value) {
+	unsigned char byte = (unsigned char)value;
+
+	dxs_buffer_write(buffer, &byte, 1);
+}
+
+/* -------------------------------------------------------------------------- */
+
+static void dxs_buffer_write_compact_int(dxs_buffer_t* buffer, int value) {
+	if (value >= -0x40 && value < 0x40) {
+		dxs_buffer_write_byte(buffer, value & 0x7F);
+	} else if (value >= -0x2000 && value < 0x2000) {
+		dxs_buffer_write_byte(buffer, ((value >> 8) & 0x3F) | 0x80);
+		dxs_buffer_write_byte(buffer, value);
+	} else if (value >= -0x100000 && value < 0x100000) {
+		dxs_buffer_write_byte(buffer, ((value >> 16) & 0x1F) | 0xC0);
+		dxs_buffer_write_byte(buffer, value >> 8);
+		dxs_buffer_write_byte(buffer, value);
+	} else if (value >= -0x8000000 && value < 0x8000000) {
+		dxs_buffer_write_byte(buffer, ((value >> 24) & 0x0F) | 0xE0);
+		dxs_buffer_write_byte(buffer, value >> 16);
+		dxs_buffer_write_byte(buffer, value >> 8);
+		dxs_buffer_write_byte(buffer, value);
+	} else {
+		dxs_buffer_write_byte(buffer, 0xF0);
+		dxs_buffer_write_byte(buffer, value >> 24);
+		dxs_buffer_write_byte(buffer, value >> 16);
+		dxs_buffer_write_byte(buffer, value >> 8);
+		dxs_buffer_write_byte(buffer, value);
+	}
+}
+
+/* -------------------------------------------------------------------------- */
+
+static void dxs_buffer_write_int(dxs_buffer_t* buffer, int value) {
+	dxs_buffer_write_byte(buffer, value >> 24);
+	dxs_buffer_write_byte(buffer, value >> 16);
+	dxs_buffer_write_byte(buffer, value >> 8);
+	dxs_buffer_write_byte(buffer, value);
+}
+
+/* -------------------------------------------------------------------------- */
+
+static void dxs_buffer_write_compact_long(dxs_buffer_t* buffer, long long value) {
+	int hi = (int)(value >> 32);
+
+	if (value >= -0x8000000 && value < 0x8000000) {
+		dxs_buffer_write_compact_int(buffer, (int)value);
+
+		return;
+	}
+
+	if (hi >= -0x04 && hi < 0x04) {
+		dxs_buffer_write_byte(buffer, (hi & 0x07) | 0xF0);
+	} else if (hi >= -0x200 && hi < 0x200) {
+		dxs_buffer_write_byte(buffer, ((hi >> 8) & 0x03) | 0xF8);
+		dxs_buffer_write_byte(buffer, hi);
+	} else if (hi >= -0x10000 && hi < 0x10000) {
+		dxs_buffer_write_byte(buffer, ((hi >> 16) & 0x01) | 0xFC);
+		dxs_buffer_write_byte(buffer, hi >> 8);
+		dxs_buffer_write_byte(buffer, hi);
+	} else if (hi >= -0x800000 && hi < 0x800000) {
+		dxs_buffer_write_byte(buffer, 0xFE);
+		dxs_buffer_write_byte(buffer, hi >> 16);
+		dxs_buffer_write_byte(buffer, hi >> 8);
+		dxs_buffer_write_byte(buffer, hi);
+	} else {
+		dxs_buffer_write_byte(buffer, 0xFF);
+		dxs_buffer_write_int(buffer, hi);
+	}
+
+	dxs_buffer_write_int(buffer, (int)value);
+}
+
+/* -------------------------------------------------------------------------- */
+
+static void dxs_buffer_write_utf(dxs_buffer_t* buffer, const char* value) {
+	int length = (int)strlen(value);
+
+	dxs_buffer_write_compact_int(buffer, length);
+	dxs_buffer_write(buffer, value, length);
+}
+
+/* -------------------------------------------------------------------------- */
+
+/* Wraps the body into the message with the length and the type prefix */
+static void dxs_buffer_write_message(dxs_buffer_t* buffer, int type, const dxs_buffer_t* body) {
+	dxs_buffer_t payload = {NULL, 0, 0};
+
+	dxs_buffer_write_compact_int(&payload, type);
+	dxs_buffer_write(&payload, body->data, body->size);
+	dxs_buffer_write_compact_int(buffer, payload.size);
+	dxs_buffer_write(buffer, payload.data, payload.size);
+
+	free(payload.data);
+}
+
+/* -------------------------------------------------------------------------- */
+
+static void dxs_buffer_write_message_descriptor(dxs_buffer_t* buffer, int type, const char* name) {
+	dxs_buffer_write_compact_int(buffer, type);
+	dxs_buffer_write_utf(buffer, name);
+	dxs_buffer_write_compact_int(buffer, 0); /* no properties */
+}
+
+/* -------------------------------------------------------------------------- */
+
+static void dxs_write_describe_protocol(dxs_buffer_t* buffer) {
+	dxs_buffer_t body = {NULL, 0, 0};
+
+	dxs_buffer_write(&body, "DXP3", 4);
+	dxs_buffer_write_compact_int(&body, 0); /* no properties */
+
+	dxs_buffer_write_compact_int(&body, 3);
+	dxs_buffer_write_message_descriptor(&body, MESSAGE_TICKER_DATA, "TICKER_DATA");
+	dxs_buffer_write_message_descriptor(&body, MESSAGE_STREAM_DATA, "STREAM_DATA");
+	dxs_buffer_write_message_descriptor(&body, MESSAGE_HISTORY_DATA, "HISTORY_DATA");
+
+	dxs_buffer_write_compact_int(&body, 6);
+	dxs_buffer_write_message_descriptor(&body, MESSAGE_TICKER_ADD_SUBSCRIPTION, "TICKER_ADD_SUBSCRIPTION");
+	dxs_buffer_write_message_descriptor(&body, MESSAGE_TICKER_REMOVE_SUBSCRIPTION, "TICKER_REMOVE_SUBSCRIPTION");
+	dxs_buffer_write_message_descriptor(&body, MESSAGE_STREAM_ADD_SUBSCRIPTION, "STREAM_ADD_SUBSCRIPTION");
+	dxs_buffer_write_message_descriptor(&body, MESSAGE_STREAM_REMOVE_SUBSCRIPTION, "STREAM_REMOVE_SUBSCRIPTION");
+	dxs_buffer_write_message_descriptor(&body, MESSAGE_HISTORY_ADD_SUBSCRIPTION, "HISTORY_ADD_SUBSCRIPTION");
+	dxs_buffer_write_message_descriptor(&body, MESSAGE_HISTORY_REMOVE_SUBSCRIPTION, "HISTORY_REMOVE_SUBSCRIPTION");
+
+	dxs_buffer_write_message(buffer, MESSAGE_DESCRIBE_PROTOCOL, &body);
+	free(body.data);
+}
+
+/* -------------------------------------------------------------------------- */
+
+/* The records of the decode scenario, the field types are the ones the feed sends */
+typedef struct {
+	const char* name;
+	int field_count;
+	const char* const* field_names;
+	const int* field_types;
+} dxs_record_t;
+
+#define DXS_UTF_CHAR 0x02
+#define DXS_COMPACT_INT 0x08
+#define DXS_DATE 0x58
+#define DXS_LONG 0x68
+#define DXS_WIDE_DECIMAL 0x78
+#define DXS_TIME_MILLIS 0x98
+
+static const char* const g_quote_field_names[] = {"Sequence", "TimeNanoPart", "Bid.Time", "Bid.Exchange", "Bid.Price",
+	"Bid.Size", "Ask.Time", "Ask.Exchange", "Ask.Price", "Ask.Size"};
+static const int g_quote_field_types[] = {DXS_COMPACT_INT, DXS_COMPACT_INT, DXS_COMPACT_INT, DXS_UTF_CHAR,
+	DXS_WIDE_DECIMAL, DXS_WIDE_DECIMAL, DXS_COMPACT_INT, DXS_UTF_CHAR, DXS_WIDE_DECIMAL, DXS_WIDE_DECIMAL};
+
+static const char* const g_trade_field_names[] = {"Last.Time", "Last.Sequence", "Last.TimeNanoPart", "Last.Exchange",
+	"Last.Price", "Last.Size", "Last.Tick", "Last.Change", "DayId", "Volume", "DayTurnover", "Last.Flags"};
+static const int g_trade_field_types[] = {DXS_COMPACT_INT, DXS_COMPACT_INT, DXS_COMPACT_INT, DXS_UTF_CHAR,
+	DXS_WIDE_DECIMAL, DXS_WIDE_DECIMAL, DXS_COMPACT_INT, DXS_WIDE_DECIMAL, DXS_DATE, DXS_WIDE_DECIMAL, DXS_WIDE_DECIMAL,
+	DXS_COMPACT_INT};
+
+static const char* const g_order_field_names[] = {"Index", "Time", "Sequence", "TimeNanoPart", "ActionTime", "OrderId",
+	"AuxOrderId", "Price", "Size", "ExecutedSize", "Count", "Flags", "TradeId", "TradePrice", "TradeSize",
+	"MarketMaker"};
+static const int g_order_field_types[] = {DXS_COMPACT_INT, DXS_COMPACT_INT, DXS_COMPACT_INT, DXS_COMPACT_INT,
+	DXS_TIME_MILLIS, DXS_LONG, DXS_LONG, DXS_WIDE_DECIMAL, DXS_WIDE_DECIMAL, DXS_WIDE_DECIMAL, DXS_WIDE_DECIMAL,
+	DXS_COMPACT_INT, DXS_LONG, DXS_WIDE_DECIMAL, DXS_WIDE_DECIMAL, DXS_COMPACT_INT};
+
+/* the server record ids are the indexes in this table */
+static const dxs_record_t g_records[] = {
+	{"Quote", sizeof(g_quote_field_types) / sizeof(int), g_quote_field_names, g_quote_field_types},
+	{"Trade", sizeof(g_trade_field_types) / sizeof(int), g_trade_field_names, g_trade_field_types},
+	{"Order#NTV", sizeof(g_order_field_types) / sizeof(int), g_order_field_names, g_order_field_types}};
+
+#define RECORD_COUNT ((int)(sizeof(g_records) / sizeof(g_records[0])))
+
+/* the penta code of "BENCH" that is sent as a 30-bit symbol */
+#define BENCHMARK_SYMBOL L"BENCH"
+#define BENCHMARK_SYMBOL_PENTA ((2 << 20) | (5 << 15) | (14 << 10) | (3 << 5) | 8)
+
+/* -------------------------------------------------------------------------- */
+
+static void dxs_write_describe_records(dxs_buffer_t* buffer) {
+	dxs_buffer_t body = {NULL, 0, 0};
+	int record_id = 0;
+
+	for (; record_id < RECORD_COUNT; ++record_id) {
+		const dxs_record_t* record = &g_records[record_id];
+		int i = 0;
+
+		dxs_buffer_write_compact_int(&body, record_id);
+		dxs_buffer_write_utf(&body, record->name);
+		dxs_buffer_write_compact_int(&body, record->field_count);
+
+		for (; i < record->field_count; ++i) {
+			dxs_buffer_write_utf(&body, record->field_names[i]);
+			dxs_buffer_write_compact_int(&body, record->field_types[i]);
+		}
+	}
+
+	dxs_buffer_write_message(buffer, MESSAGE_DESCRIBE_RECORDS, &body);
+	free(body.data);
+}
+
+/* -------------------------------------------------------------------------- */
+
+/* Writes the records with the field values that change from one record to another */
+static void dxs_write_records(dxs_buffer_t* buffer, int record_id, int count) {
+	const dxs_record_t* record = &g_records[record_id];
+	dxs_buffer_t body = {NULL, 0, 0};
+	int index = 0;
+
+	for (; index < count; ++index) {
+		int i = 0;
+
+		dxs_buffer_write_byte(&body, 0x80 | (BENCHMARK_SYMBOL_PENTA >> 24));
+		dxs_buffer_write_byte(&body, BENCHMARK_SYMBOL_PENTA >> 16);
+		dxs_buffer_write_byte(&body, BENCHMARK_SYMBOL_PENTA >> 8);
+		dxs_buffer_write_byte(&body, BENCHMARK_SYMBOL_PENTA);
+		dxs_buffer_write_compact_int(&body, record_id);
+
+		for (; i < record->field_count; ++i) {
+			switch (record->field_types[i]) {
+			case DXS_UTF_CHAR:
+				dxs_buffer_write_byte(&body, 'A' + (index + i) % 26);
+				break;
+			case DXS_WIDE_DECIMAL:
+				/* the price with two decimal digits */
+				dxs_buffer_write_compact_int(&body, (10000 + (index + i) % 5000) * 256 + 128 + 2);
+				break;
+			default:
+				dxs_buffer_write_compact_int(&body, index + i);
+			}
+		}
+
+		if ((index + 1) % RECORDS_PER_MESSAGE == 0 || index + 1 == count) {
+			dxs_buffer_write_message(buffer, MESSAGE_TICKER_DATA, &body);
+			body.size = 0;
+		}
+	}
+
+	free(body.data);
+}
+
+/* -------------------------------------------------------------------------- */
+
+static int dxs_send_all(dxs_socket_t s, const unsigned char* data, int size) {
+	while (size > 0) {
+		int sent = (int)send(s, (const char*)data, size, 0);
+
+		if (sent <= 0) {
+			return false;
+		}
+
+		data += sent;
+		size -= sent;
+	}
+
+	return true;
+}
+
+/* -------------------------------------------------------------------------- */
+
+/* Reads the compact int, returns false if the data is incomplete */
+static int dxs_read_compact_int(const unsigned char* data, int size, int* offset, int* value) {
+	int first = 0;
+	int length = 0;
+	int i = 1;
+
+	if (*offset >= size) {
+		return false;
+	}
+
+	first = data[*offset];
+
+	if (first < 0x80) {
+		length = 1;
+		*value = (first << 25) >> 25;
+	} else if (first < 0xC0) {
+		length = 2;
+		*value = ((first & 0x3F) << 26) >> 18;
+	} else if (first < 0xE0) {
+		length = 3;
+		*value = ((first & 0x1F) << 27) >> 11;
+	} else if (first < 0xF0) {
+		length = 4;
+		*value = ((first & 0x0F) << 28) >> 4;
+	} else {
+		length = 5;
+		*value = 0;
+	}
+
+	if (*offset + length > size) {
+		return false;
+	}
+
+	for (; i < length; ++i) {
+		*value |= data[*offset + i] << ((length - i - 1) * 8);
+	}
+
+	*offset += length;
+
+	return true;
+}
+
+/* -------------------------------------------------------------------------- */
+
+/* Skips the symbol written by the client symbol codec */
+static int dxs_skip_symbol(const unsigned char* data, int size, int* offset) {
+	int first = data[*offset];
+	int length = 0;
+
+	if (first < 0x80) {
+		*offset += 2;
+	} else if (first < 0xC0) {
+		*offset += 4;
+	} else if (first >= 0xE0 && first < 0xF0) {
+		*offset += 3;
+	} else if (first >= 0xF0 && first < 0xF8) {
+		*offset += 5;
+	} else if (first == 0xFD) {
+		++(*offset);
+
+		if (!dxs_read_compact_int(data, size, offset, &length)) {
+			return false;
+		}
+
+		/* the benchmark symbols are ASCII */
+		*offset += length;
+	} else {
+		++(*offset);
+	}
+
+	return *offset <= size;
+}
+
+/* -------------------------------------------------------------------------- */
+
+/* Counts the subscription entries of the complete messages, returns the size of the processed data */
+static int dxs_process_client_data(dxs_server_t* server, const unsigned char* data, int size) {
+	int offset = 0;
+
+	for (;;) {
+		int message_offset = offset;
+		int message_length = 0;
+		int message_end = 0;
+		int message_type = 0;
+
+		if (!dxs_read_compact_int(data, size, &offset, &message_length) || offset + message_length > size) {
+			return message_offset;
+		}
+
+		message_end = offset + message_length;
+
+		if (message_length > 0 && dxs_read_compact_int(data, message_end, &offset, &message_type) &&
+			(message_type == MESSAGE_TICKER_ADD_SUBSCRIPTION || message_type == MESSAGE_STREAM_ADD_SUBSCRIPTION ||
+			 message_type == MESSAGE_HISTORY_ADD_SUBSCRIPTION)) {
+			int record_id = 0;
+			int time = 0;
+			int entries = 0;
+
+			/* the history entries also contain the time, the benchmarks subscribe to the small ones */
+			while (offset < message_end && dxs_skip_symbol(data, message_end, &offset) &&
+				   dxs_read_compact_int(data, message_end, &offset, &record_id) &&
+				   (message_type != MESSAGE_HISTORY_ADD_SUBSCRIPTION ||
+					dxs_read_compact_int(data, message_end, &offset, &time))) {
+				++entries;
+			}
+
+			server->subscription_entries += entries;
+			++server->subscription_messages;
+		}
+
+		offset = message_end;
+	}
+}
+
+/* -------------------------------------------------------------------------- */
+
+static void dxs_serve_client(dxs_server_t* server) {
+	dxs_buffer_t data = {NULL, 0, 0};
+	int data_size = 0;
+
+	dxs_write_describe_protocol(&data);
+
+	if (!dxs_send_all(server->client, data.data, data.size)) {
+		free(data.data);
+
+		return;
+	}
+
+	data.capacity = 1024 * 1024;
+	data.data = realloc(data.data, data.capacity);
+
+	while (!server->is_finished) {
+		int received = 0;
+		int processed = 0;
+
+		if (data_size == data.capacity) {
+			data.capacity *= 2;
+			data.data = realloc(data.data, data.capacity);
+		}
+
+		received = (int)recv(server->client, (char*)data.data + data_size, data.capacity - data_size, 0);
+
+		if (received <= 0) {
+			break;
+		}
+
+		++server->reads;
+		server->bytes += received;
+		data_size += received;
+
+		processed = dxs_process_client_data(server, data.data, data_size);
+		memmove(data.data, data.data + processed, data_size - processed);
+		data_size -= processed;
+	}
+
+	free(data.data);
+}
+
+/* -------------------------------------------------------------------------- */
+
+#ifdef _WIN32
+static DWORD WINAPI dxs_server_thread(LPVOID arg) {
+#else
+static void* dxs_server_thread(void* arg) {
+#endif
+	dxs_server_t* server = arg;
+
+	server->client = accept(server->listener, NULL, NULL);
+
+	if (server->client != DXS_INVALID_SOCKET) {
+		dxs_serve_client(server);
+		dxs_close_socket(server->client);
+	}
+
+	return 0;
+}
+
+/* -------------------------------------------------------------------------- */
+
+static int dxs_start_server(dxs_server_t* server, OUT int* port, OUT dxs_thread_t* thread) {
+	struct sockaddr_in addr;
+	socklen_t addr_size = sizeof(addr);
+
+	memset(server, 0, sizeof(dxs_server_t));
+	memset(&addr, 0, sizeof(addr));
+	addr.sin_family = AF_INET;
+	addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	addr.sin_port = 0;
+
+	server->listener = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+
+	if (server->listener == DXS_INVALID_SOCKET || bind(server->listener, (struct sockaddr*)&addr, sizeof(addr)) != 0 ||
+		listen(server->listener, 1) != 0 || getsockname(server->listener, (struct sockaddr*)&addr, &addr_size) != 0) {
+		return false;
+	}
+
+	*port = ntohs(addr.sin_port);
+
+#ifdef _WIN32
+	*thread = CreateThread(NULL, 0, dxs_server_thread, server, 0, NULL);
+
+	return *thread != NULL;
+#else
+	return pthread_create(thread, NULL, dxs_server_thread, server) == 0;
+#endif
+}
+
+/* -------------------------------------------------------------------------- */
+
+/* Must be called after the client connection is closed */
+static void dxs_stop_server(dxs_server_t* server, dxs_thread_t thread) {
+	server->is_finished = true;
+
+#ifdef _WIN32
+	WaitForSingleObject(thread, INFINITE);
+	CloseHandle(thread);
+#else
+	pthread_join(thread, NULL);
+#endif
+
+	dxs_close_socket(server->listener);
+}
+
+/* -------------------------------------------------------------------------- */
+
+/* Returns true if the server has received the expected number of subscription entries within the timeout */
+static int dxs_wait_for_entries(dxs_server_t* server, int entry_count) {
+	int waited = 0;
+
+	for (; server->subscription_entries < entry_count; ++waited) {
+		if (waited >= WAIT_TIMEOUT) {
+			return false;
+		}
+
+		dxs_sleep(1);
+	}
+
+	return true;
+}
+
+/* -------------------------------------------------------------------------- */
+/*
+ *	Client
+ */
+/* -------------------------------------------------------------------------- */
+
+void process_last_error() {
+	int error_code = dx_ec_success;
+	dxf_const_string_t error_descr = NULL;
+	int res;
+
+	res = dxf_get_last_error(&error_code, &error_descr);
+
+	if (res == DXF_SUCCESS) {
+		if (error_code == dx_ec_success) {
+			wprintf(L"No error information is stored");
+
+			return;
+		}
+
+		wprintf(
+			L"Error occurred and successfully retrieved:\n"
+			L"error code = %d, description = \"%ls\"\n",
+			error_code, error_descr);
+		return;
+	}
+
+	wprintf(L"An error occurred but the error subsystem failed to initialize\n");
+}
+
+/* -------------------------------------------------------------------------- */
+
+static int subscription_benchmark(dxf_connection_t connection, int symbol_count) {
+	static dxf_const_string_t warmup_symbol = L"WARMUP";
+	dxf_subscription_t subscription;
+	dxf_string_t* symbols = NULL;
+	int entries_per_symbol = 0;
+	int messages = 0;
+	int reads = 0;
+	long long bytes = 0;
+	double start = 0;
+	double added = 0;
+	double received = 0;
+	int res = 0;
+	int i = 0;
+
+	symbols = calloc(symbol_count, sizeof(dxf_string_t));
+
+	/* option-like symbols that are sent as strings */
+	for (; i < symbol_count; ++i) {
+		symbols[i] = calloc(32, sizeof(dxf_char_t));
+		swprintf(symbols[i], 32, L".SYM%dC%d", i / 1000, 100 + i % 1000);
+	}
+
+	if (!dxf_create_subscription(connection, DXF_ET_QUOTE, &subscription)) {
+		process_last_error();
+		res = 10;
+	} else {
+		/*
+		 *	The first symbol is sent after the protocol handshake, it must not affect the measurement.
+		 *  It also tells the number of the records subscribed for every symbol.
+		 */
+		if (!dxf_add_symbol(subscription, warmup_symbol) || !dxs_wait_for_entries(&g_server, 1)) {
+			wprintf(L"The warmup symbol is not received\n");
+			res = 11;
+		} else {
+			dxs_sleep(100);
+			entries_per_symbol = g_server.subscription_entries;
+			messages = g_server.subscription_messages;
+			reads = g_server.reads;
+			bytes = g_server.bytes;
+			start = dxs_now_ms();
+
+			if (!dxf_add_symbols(subscription, (dxf_const_string_t*)symbols, symbol_count)) {
+				process_last_error();
+				res = 12;
+			} else {
+				added = dxs_now_ms();
+
+				if (!dxs_wait_for_entries(&g_server, (symbol_count + 1) * entries_per_symbol)) {
+					wprintf(L"Only %d of %d subscription entries are received\n",
+						g_server.subscription_entries - entries_per_symbol, symbol_count * entries_per_symbol);
+					res = 13;
+				}
+
+				received = dxs_now_ms();
+				messages = g_server.subscription_messages - messages;
+				reads = g_server.reads - reads;
+				bytes = g_server.bytes - bytes;
+			}
+		}
+
+		dxf_close_subscription(subscription);
+	}
+
+	if (res == 0) {
+		wprintf(L"Symbols: %d, subscription entries: %d\n", symbol_count, symbol_count * entries_per_symbol);
+		wprintf(L"dxf_add_symbols call: %.1f ms\n", added - start);
+		wprintf(L"Received by the server: %.1f ms\n", received - start);
+		wprintf(L"Rate: %.0f symbols/s\n", symbol_count * 1000.0 / (received - start));
+		wprintf(L"Subscription messages: %d, reads: %d, bytes: %lld\n", messages, reads, bytes);
+	}
+
+	for (i = 0; i < symbol_count; ++i) {
+		free(symbols[i]);
+	}
+
+	free(symbols);
+
+	return res;
+}
+
+/* -------------------------------------------------------------------------- */
+
+static volatile int g_received_records = 0;
+
+void record_listener(int event_type, dxf_const_string_t symbol_name, const dxf_event_data_t* data, int data_count,
+					 void* user_data) {
+	g_received_records += data_count;
+}
+
+/* -------------------------------------------------------------------------- */
+
+/* Sends the records and returns the time to receive them all or a negative value on timeout */
+static double decode_records(int record_id, int record_count) {
+	dxs_buffer_t data = {NULL, 0, 0};
+	double start = 0;
+	int waited = 0;
+
+	dxs_write_records(&data, record_id, record_count);
+	g_received_records = 0;
+	start = dxs_now_ms();
+
+	if (!dxs_send_all(g_server.client, data.data, data.size)) {
+		free(data.data);
+
+		return -1;
+	}
+
+	free(data.data);
+
+	/* the events are counted as precisely as the sleep allows, so the record count must be large enough */
+	for (; g_received_records < record_count; ++waited) {
+		if (waited >= WAIT_TIMEOUT) {
+			return -1;
+		}
+
+		dxs_sleep(1);
+	}
+
+	return dxs_now_ms() - start;
+}
+
+/* -------------------------------------------------------------------------- */
+
+static int decode_benchmark(dxf_connection_t connection, int record_count) {
+	static const int event_types[] = {DXF_ET_QUOTE, DXF_ET_TRADE, DXF_ET_ORDER};
+	dxf_subscription_t subscriptions[RECORD_COUNT];
+	dxs_buffer_t data = {NULL, 0, 0};
+	int res = 0;
+	int i = 0;
+
+	for (; i < RECORD_COUNT; ++i) {
+		if (!dxf_create_subscription(connection, event_types[i], &subscriptions[i]) ||
+			(event_types[i] == DXF_ET_ORDER && !dxf_set_order_source(subscriptions[i], "NTV")) ||
+			!dxf_attach_event_listener(subscriptions[i], record_listener, NULL) ||
+			!dxf_add_symbol(subscriptions[i], BENCHMARK_SYMBOL)) {
+			process_last_error();
+
+			return 20;
+		}
+	}
+
+	/* the subscription must be complete before the records are sent */
+	if (!dxs_wait_for_entries(&g_server, 1)) {
+		wprintf(L"The subscription is not received\n");
+
+		return 21;
+	}
+
+	dxs_sleep(200);
+	dxs_write_describe_records(&data);
+
+	if (!dxs_send_all(g_server.client, data.data, data.size)) {
+		free(data.data);
+		wprintf(L"Failed to send the record descriptions\n");
+
+		return 22;
+	}
+
+	free(data.data);
+	wprintf(L"Records: %d of each type\n", record_count);
+
+	for (i = 0; i < RECORD_COUNT && res == 0; ++i) {
+		/* the first round warms the caches and the allocator up */
+		double field_time = decode_records(i, record_count / 10 + 1);
+		double plan_time = -1;
+
+		if (field_time >= 0) {
+			dx_set_record_decode_plans_enabled(false);
+			field_time = decode_records(i, record_count);
+			dx_set_record_decode_plans_enabled(true);
+		}
+
+		if (field_time >= 0) {
+			plan_time = decode_records(i, record_count);
+		}
+
+		if (field_time < 0 || plan_time < 0) {
+			wprintf(L"%hs: only %d of %d records are received\n", g_records[i].name, g_received_records, record_count);
+			res = 23;
+		} else {
+			wprintf(L"%hs: %.1f ns/record field by field, %.1f ns/record by the plan (%+.1f%%)\n", g_records[i].name,
+				field_time * 1000000.0 / record_count, plan_time * 1000000.0 / record_count,
+				(plan_time - field_time) * 100.0 / field_time);
+		}
+	}
+
+	for (i = 0; i < RECORD_COUNT; ++i) {
+		dxf_close_subscription(subscriptions[i]);
+	}
+
+	return res;
+}
+
+/* -------------------------------------------------------------------------- */
+
+/* The values of all the encoded lengths in equal shares, from the 7 bit ones to the full width ones */
+static long long compact_value(unsigned long long* seed, int max_bits) {
+	int bits;
+
+	*seed = *seed * 6364136223846793005ULL + 1442695040888963407ULL;
+	bits = 7 * (int)(1 + (*seed >> 59) % ((max_bits + 6) / 7));
+
+	if (bits > max_bits) {
+		bits = max_bits;
+	}
+
+	/* the arithmetic shift keeps the sign of the value */
+	return (long long)(*seed << 11) >> (64 - bits);
+}
+
+/* -------------------------------------------------------------------------- */
+
+/* Decodes the values in passes and returns the time of a pass or a negative value if a value differs */
+static double decode_compact_values(void* bicc, dxs_buffer_t* data, const long long* values, int value_count,
+									int is_long, int validate_message) {
+	double start = 0;
+	int pass = 0;
+
+	start = dxs_now_ms();
+
+	for (; pass < COMPACT_DECODE_PASSES; ++pass) {
+		int i = 0;
+
+		dx_set_in_buffer(bicc, (dxf_byte_t*)data->data, data->size);
+		dx_set_in_buffer_position(bicc, 0);
+
+		if (validate_message) {
+			dx_set_in_buffer_limit(bicc, data->size);
+		}
+
+		for (; i < value_count; ++i) {
+			dxf_long_t value = 0;
+
+			if (is_long) {
+				if (!dx_read_compact_long(bicc, &value)) {
+					return -1;
+				}
+			} else {
+				dxf_int_t int_value = 0;
+
+				if (!dx_read_compact_int(bicc, &int_value)) {
+					return -1;
+				}
+
+				value = int_value;
+			}
+
+			if (value != values[i]) {
+				return -1;
+			}
+		}
+	}
+
+	return (dxs_now_ms() - start) / COMPACT_DECODE_PASSES;
+}
+
+/* -------------------------------------------------------------------------- */
+
+static int compact_benchmark(int value_count) {
+	static const char* const modes[] = {"checked", "message validated"};
+	unsigned long long seed = 1;
+	long long* values = NULL;
+	void* bicc = NULL;
+	int res = 0;
+	int is_long = 0;
+
+	values = malloc(value_count * sizeof(long long));
+	bicc = dx_create_buffered_input();
+
+	if (values == NULL || bicc == NULL) {
+		free(values);
+		dx_free_buffered_input(bicc);
+
+		return 2;
+	}
+
+	wprintf(L"Values: %d, passes: %d\n", value_count, COMPACT_DECODE_PASSES);
+
+	for (; is_long < 2; ++is_long) {
+		dxs_buffer_t data = {NULL, 0, 0};
+		int i = 0;
+		int validate_message = 0;
+
+		for (; i < value_count; ++i) {
+			values[i] = compact_value(&seed, is_long ? 64 : 32);
+
+			if (is_long) {
+				dxs_buffer_write_compact_long(&data, values[i]);
+			} else {
+				dxs_buffer_write_compact_int(&data, (int)values[i]);
+			}
+		}
+
+		for (; validate_message < 2; ++validate_message) {
+			double time = decode_compact_values(bicc, &data, values, value_count, is_long, validate_message);
+
+			if (time < 0) {
+				wprintf(L"compact %ls, %hs: the decoded values differ\n", is_long ? L"long" : L"int",
+					modes[validate_message]);
+				res = 24;
+			} else {
+				wprintf(L"compact %ls, %hs: %.2f ns/value, %.1f MB/s\n", is_long ? L"long" : L"int",
+					modes[validate_message], time * 1000000.0 / value_count, data.size / time / 1000.0);
+			}
+		}
+
+		free(data.data);
+	}
+
+	dx_free_buffered_input(bicc);
+	free(values);
+
+	return res;
+}
+
+/* -------------------------------------------------------------------------- */
+
+int main(int argc, char* argv[]) {
+	dxf_connection_t connection;
+	dxs_thread_t server_thread;
+	const char* scenario = argc > 1 ? argv[1] : "subscription";
+	char address[64];
+	int port = 0;
+	int res = 0;
+
+#ifdef _WIN32
+	WSADATA wsa_data;
+
+	WSAStartup(MAKEWORD(2, 2), &wsa_data);
+#endif
+
+	if (strcmp(scenario, "compact") == 0) {
+		return compact_benchmark(argc > 2 ? atoi(argv[2]) : DEFAULT_VALUE_COUNT);
+	}
+
+	if (strcmp(scenario, "subscription") != 0 && strcmp(scenario, "decode") != 0) {
+		wprintf(L"Usage: LoopbackBenchmark <scenario> [<parameters>]\n"
+				L"Scenarios:\n"
+				L"    subscription [<symbol count>] - the rate of the bulk dxf_add_symbols call\n"
+				L"    decode [<record count>]       - the time to process a Quote, Trade and Order record\n"
+				L"    compact [<value count>]       - the compact int and long decode throughput\n");
+
+		return 1;
+	}
+
+	dxf_initialize_logger("loopback-benchmark-api.log", true, true, false);
+
+	if (!dxs_start_server(&g_server, &port, &server_thread)) {
+		wprintf(L"Failed to start the stand-in server\n");
+
+		return 2;
+	}
+
+	snprintf(address, sizeof(address), "127.0.0.1:%d", port);
+
+	if (!dxf_create_connection(address, NULL, NULL, NULL, NULL, NULL, &connection)) {
+		process_last_error();
+		dxs_stop_server(&g_server, server_thread);
+
+		return 3;
+	}
+
+	if (strcmp(scenario, "subscription") == 0) {
+		res = subscription_benchmark(connection, argc > 2 ? atoi(argv[2]) : DEFAULT_SYMBOL_COUNT);
+	} else {
+		res = decode_benchmark(connection, argc > 2 ? atoi(argv[2]) : DEFAULT_RECORD_COUNT);
+	}
+
+	dxf_close_connection(connection);
+	dxs_stop_server(&g_server, server_thread);
+
+	return res;
+}
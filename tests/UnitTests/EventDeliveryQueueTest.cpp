@@ -0,0 +1,589 @@
+/*
+ * The contents of this file are subject to the Mozilla Public License Version
+ * 1.1 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ * http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+ * for the specific language governing rights and limitations under the
+ * License.
+ *
+ * The Initial Developer of the Original Code is Devexperts LLC.
+ * Portions created by the Initial Developer are Copyright (C) 2010
+ * the Initial Developer. All Rights Reserved.
+ *
+ * Contributor(s):
+ *
+ */
+
+#pragma warning(push)
+#pragma warning(disable : 5105)
+#include <Windows.h>
+#pragma warning(pop)
+
+extern "C" {
+
+#include "EventDeliveryQueueTest.h"
+
+#include "DXAlgorithms.h"
+#include "DXFeed.h"
+#include "DXMemory.h"
+#include "DXThreads.h"
+#include "EventManager.h"
+#include "EventSubscription.h"
+#include "TestHelper.h"
+
+}
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "EventDeliveryQueue.hpp"
+#include "EventSubscription.hpp"
+
+// How long the test waits for the other threads before it fails
+static const auto QUEUE_TEST_TIMEOUT = std::chrono::seconds(10);
+
+// How long the test makes sure that the other thread keeps waiting
+static const auto QUEUE_TEST_WAIT_TIME = std::chrono::milliseconds(50);
+
+#define QUEUE_TEST_CAPACITY 4
+
+// The symbols of the events, the symbol keys are the addresses of the items
+static dxf_const_string_t g_queue_test_symbols[] = {L"A", L"B", L"C", L"D", L"E"};
+
+/* -------------------------------------------------------------------------- */
+
+/*
+ * The target of the queue records the delivered events. Its listener waits while the gate is closed and closes
+ * the queue on the first event if it's told to.
+ */
+struct QueueTestTarget {
+	std::mutex mutex{};
+	std::condition_variable changed{};
+	std::vector<std::wstring> symbols{};
+	std::vector<dxf_double_t> prices{};
+	int deliveryDepth = 0;
+	int waitDepth = 0;
+	int waitCount = 0;
+	bool gateOpen = true;
+	bool listenerWaiting = false;
+	dx::DeliveryQueue* closedQueue = nullptr;
+	bool closeReturned = false;
+};
+
+static void queue_test_begin_delivery(void* target) {
+	auto testTarget = static_cast<QueueTestTarget*>(target);
+	std::lock_guard<std::mutex> lk(testTarget->mutex);
+
+	testTarget->deliveryDepth++;
+}
+
+static void queue_test_end_delivery(void* target) {
+	auto testTarget = static_cast<QueueTestTarget*>(target);
+	std::lock_guard<std::mutex> lk(testTarget->mutex);
+
+	testTarget->deliveryDepth--;
+}
+
+static void queue_test_deliver(void* target, dx_event_id_t event_id, dxf_const_string_t symbol_name,
+							   dxf_const_event_data_t data, int data_count, const dxf_event_params_t* event_params) {
+	auto testTarget = static_cast<QueueTestTarget*>(target);
+	std::unique_lock<std::mutex> lk(testTarget->mutex);
+
+	for (int i = 0; i < data_count; ++i) {
+		testTarget->symbols.emplace_back(symbol_name);
+		testTarget->prices.push_back(static_cast<const dxf_trade_t*>(data)[i].price);
+	}
+
+	testTarget->listenerWaiting = true;
+	testTarget->changed.notify_all();
+	testTarget->changed.wait(lk, [testTarget] { return testTarget->gateOpen; });
+	testTarget->listenerWaiting = false;
+
+	auto closedQueue = testTarget->closedQueue;
+
+	testTarget->closedQueue = nullptr;
+	lk.unlock();
+
+	if (closedQueue != nullptr) {
+		closedQueue->close();
+
+		lk.lock();
+		testTarget->closeReturned = true;
+	}
+}
+
+static void queue_test_begin_wait_for_room(void* target) {
+	auto testTarget = static_cast<QueueTestTarget*>(target);
+	std::lock_guard<std::mutex> lk(testTarget->mutex);
+
+	testTarget->waitDepth++;
+	testTarget->waitCount++;
+}
+
+static void queue_test_end_wait_for_room(void* target) {
+	auto testTarget = static_cast<QueueTestTarget*>(target);
+	std::lock_guard<std::mutex> lk(testTarget->mutex);
+
+	testTarget->waitDepth--;
+}
+
+static void queue_test_set_gate(QueueTestTarget& target, bool open) {
+	std::lock_guard<std::mutex> lk(target.mutex);
+
+	target.gateOpen = open;
+	target.changed.notify_all();
+}
+
+/* -------------------------------------------------------------------------- */
+
+// The executor keeps the tasks until the test runs them, as if it were another thread
+struct QueueTestExecutor {
+	std::mutex mutex{};
+	std::vector<std::pair<dxf_delivery_task_t, void*>> tasks{};
+};
+
+static void queue_test_execute(dxf_delivery_task_t task, void* task_data, void* executor_data) {
+	auto executor = static_cast<QueueTestExecutor*>(executor_data);
+	std::lock_guard<std::mutex> lk(executor->mutex);
+
+	executor->tasks.emplace_back(task, task_data);
+}
+
+// Runs the tasks until the executor has none, returns the number of the tasks run
+static int queue_test_run_tasks(QueueTestExecutor& executor) {
+	int count = 0;
+
+	for (;;) {
+		std::vector<std::pair<dxf_delivery_task_t, void*>> tasks;
+
+		{
+			std::lock_guard<std::mutex> lk(executor.mutex);
+
+			tasks.swap(executor.tasks);
+		}
+
+		if (tasks.empty()) {
+			return count;
+		}
+
+		for (auto&& task : tasks) {
+			task.first(task.second);
+			count++;
+		}
+	}
+}
+
+static bool queue_test_has_tasks(QueueTestExecutor& executor) {
+	std::lock_guard<std::mutex> lk(executor.mutex);
+
+	return !executor.tasks.empty();
+}
+
+/* -------------------------------------------------------------------------- */
+
+// Returns false if the condition isn't met before the timeout
+static bool queue_test_wait_until(const std::function<bool()>& condition) {
+	auto deadline = std::chrono::steady_clock::now() + QUEUE_TEST_TIMEOUT;
+
+	while (!condition()) {
+		if (std::chrono::steady_clock::now() >= deadline) {
+			return false;
+		}
+
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+
+	return true;
+}
+
+static std::shared_ptr<dx::DeliveryQueue> queue_test_create(QueueTestTarget& target,
+															 dxf_delivery_overflow_policy_t policy,
+															 QueueTestExecutor* executor) {
+	dx::DeliveryQueue::Target queueTarget{&target,
+										  queue_test_begin_delivery,
+										  queue_test_deliver,
+										  queue_test_end_delivery,
+										  queue_test_begin_wait_for_room,
+										  queue_test_end_wait_for_room};
+	dxf_delivery_options_t options = {dxf_dm_queue, QUEUE_TEST_CAPACITY, policy,
+									  (executor != nullptr) ? queue_test_execute : nullptr, executor};
+	auto queue = dx::DeliveryQueue::create(queueTarget, DXF_ET_TRADE, options);
+
+	if (!queue || !queue->start()) {
+		return nullptr;
+	}
+
+	return queue;
+}
+
+// Puts the trades of the symbol with the prices from the first one on
+static bool queue_test_enqueue(dx::DeliveryQueue& queue, int symbol_index, int first_price, int count) {
+	std::vector<dxf_trade_t> trades(static_cast<std::size_t>(count));
+
+	for (int i = 0; i < count; ++i) {
+		dx_memset(&trades[i], 0, sizeof(dxf_trade_t));
+		trades[i].price = first_price + i;
+	}
+
+	return queue.enqueue(dx_eid_trade, &g_queue_test_symbols[symbol_index], g_queue_test_symbols[symbol_index],
+						 trades.data(), count, nullptr);
+}
+
+static dxf_delivery_statistics_t queue_test_statistics(const dx::DeliveryQueue& queue) {
+	dxf_delivery_statistics_t statistics;
+
+	queue.getStatistics(statistics);
+
+	return statistics;
+}
+
+// Checks that the events of the symbols were delivered with the prices, in order
+static int queue_test_check_delivered(QueueTestTarget& target, const std::vector<int>& symbol_indices,
+									  const std::vector<int>& prices) {
+	std::lock_guard<std::mutex> lk(target.mutex);
+
+	DX_CHECK(dx_is_equal_size_t(prices.size(), target.prices.size()));
+
+	for (std::size_t i = 0; i < prices.size(); ++i) {
+		DX_CHECK(dx_is_equal_dxf_const_string_t(g_queue_test_symbols[symbol_indices[i]], target.symbols[i].c_str()));
+		DX_CHECK(dx_is_equal_double(prices[i], target.prices[i]));
+	}
+
+	DX_CHECK(dx_is_equal_int(0, target.deliveryDepth));
+
+	return true;
+}
+
+/* -------------------------------------------------------------------------- */
+
+/*
+ * Test
+ *
+ * The producer waits for the room while the listener is busy and the queue is full, no event is lost.
+ */
+int delivery_queue_block_test(void) {
+	QueueTestTarget target;
+	auto queue = queue_test_create(target, dxf_dop_block, nullptr);
+	int res = true;
+
+	DX_CHECK(dx_is_not_null(queue.get()));
+
+	queue_test_set_gate(target, false);
+
+	std::thread producer([&queue] {
+		for (int i = 0; i < 20; ++i) {
+			queue_test_enqueue(*queue, 0, i, 1);
+		}
+	});
+
+	res = dx_is_true(queue_test_wait_until([&queue, &target] {
+			  std::lock_guard<std::mutex> lk(target.mutex);
+
+			  return queue_test_statistics(*queue).blocked_enqueues > 0 && target.waitDepth == 1;
+		  })) &&
+		dx_is_equal_int(QUEUE_TEST_CAPACITY, queue_test_statistics(*queue).queue_size);
+
+	queue_test_set_gate(target, true);
+	producer.join();
+
+	res = res && dx_is_true(queue_test_wait_until([&queue] {
+			  return queue_test_statistics(*queue).delivered_events == 20;
+		  }));
+
+	queue->close();
+
+	std::vector<int> prices;
+
+	for (int i = 0; i < 20; ++i) {
+		prices.push_back(i);
+	}
+
+	res = res && queue_test_check_delivered(target, std::vector<int>(20, 0), prices) &&
+		dx_is_equal_dxf_ulong_t(0, queue_test_statistics(*queue).dropped_events) &&
+		dx_is_equal_int(0, target.waitDepth);
+
+	return res;
+}
+
+/* -------------------------------------------------------------------------- */
+
+/*
+ * Test
+ *
+ * The producer putting more events at once than the queue holds gets the executor to deliver them before it waits
+ * for the room.
+ */
+int delivery_queue_block_executor_test(void) {
+	QueueTestTarget target;
+	QueueTestExecutor executor;
+	auto queue = queue_test_create(target, dxf_dop_block, &executor);
+	std::atomic<bool> producerDone{false};
+	int res = true;
+
+	DX_CHECK(dx_is_not_null(queue.get()));
+
+	std::thread producer([&queue, &producerDone] {
+		queue_test_enqueue(*queue, 0, 0, 10);
+		producerDone.store(true);
+	});
+
+	res = dx_is_true(queue_test_wait_until([&executor, &target] {
+		std::lock_guard<std::mutex> lk(target.mutex);
+
+		return target.waitDepth == 1 && queue_test_has_tasks(executor);
+	}));
+
+	// the executor thread delivers the events while the producer waits
+	while (res && !producerDone.load()) {
+		queue_test_run_tasks(executor);
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+
+	// the closing releases the producer that the events haven't been scheduled for
+	if (!res) {
+		queue->close();
+	}
+
+	producer.join();
+	queue_test_run_tasks(executor);
+	queue->close();
+
+	std::vector<int> prices;
+
+	for (int i = 0; i < 10; ++i) {
+		prices.push_back(i);
+	}
+
+	res = res && queue_test_check_delivered(target, std::vector<int>(10, 0), prices) &&
+		dx_is_equal_int(0, target.waitDepth);
+
+	return res;
+}
+
+/* -------------------------------------------------------------------------- */
+
+/*
+ * Test
+ *
+ * The oldest events are dropped to make room for the new ones.
+ */
+int delivery_queue_drop_oldest_test(void) {
+	QueueTestTarget target;
+	QueueTestExecutor executor;
+	auto queue = queue_test_create(target, dxf_dop_drop_oldest, &executor);
+	int res = true;
+
+	DX_CHECK(dx_is_not_null(queue.get()));
+
+	for (int i = 0; res && i < 10; ++i) {
+		res = dx_is_true(queue_test_enqueue(*queue, 0, i, 1));
+	}
+
+	auto statistics = queue_test_statistics(*queue);
+
+	res = res && dx_is_equal_int(QUEUE_TEST_CAPACITY, statistics.queue_size) &&
+		dx_is_equal_int(QUEUE_TEST_CAPACITY, statistics.max_queue_size) &&
+		dx_is_equal_dxf_ulong_t(10 - QUEUE_TEST_CAPACITY, statistics.dropped_events) &&
+		dx_is_true(queue_test_run_tasks(executor) > 0) &&
+		queue_test_check_delivered(target, {0, 0, 0, 0}, {6, 7, 8, 9}) &&
+		dx_is_equal_dxf_ulong_t(QUEUE_TEST_CAPACITY, queue_test_statistics(*queue).delivered_events) &&
+		dx_is_equal_int(0, target.waitCount);
+
+	queue->close();
+	queue_test_run_tasks(executor);
+
+	return res;
+}
+
+/* -------------------------------------------------------------------------- */
+
+/*
+ * Test
+ *
+ * The new events replace the queued events of their symbols in place, the event of a symbol having no queued event
+ * drops the oldest one.
+ */
+int delivery_queue_conflate_test(void) {
+	QueueTestTarget target;
+	QueueTestExecutor executor;
+	auto queue = queue_test_create(target, dxf_dop_conflate, &executor);
+	int res = true;
+
+	DX_CHECK(dx_is_not_null(queue.get()));
+
+	for (int i = 0; res && i < QUEUE_TEST_CAPACITY; ++i) {
+		res = dx_is_true(queue_test_enqueue(*queue, i, 10 + i, 1));
+	}
+
+	res = res && dx_is_true(queue_test_enqueue(*queue, 0, 20, 1)) &&
+		dx_is_true(queue_test_enqueue(*queue, 1, 21, 1)) && dx_is_true(queue_test_enqueue(*queue, 4, 24, 1));
+
+	auto statistics = queue_test_statistics(*queue);
+
+	res = res && dx_is_equal_int(QUEUE_TEST_CAPACITY, statistics.queue_size) &&
+		dx_is_equal_dxf_ulong_t(2, statistics.conflated_events) &&
+		dx_is_equal_dxf_ulong_t(1, statistics.dropped_events) && dx_is_true(queue_test_run_tasks(executor) > 0) &&
+		queue_test_check_delivered(target, {1, 2, 3, 4}, {21, 12, 13, 24});
+
+	queue->close();
+	queue_test_run_tasks(executor);
+
+	return res;
+}
+
+/* -------------------------------------------------------------------------- */
+
+/*
+ * Test
+ *
+ * The closing waits for the listener called by the delivery thread, and the events left in the queue aren't
+ * delivered after that. The closing releases the producer waiting for the room.
+ */
+int delivery_queue_close_test(void) {
+	QueueTestTarget target;
+	auto queue = queue_test_create(target, dxf_dop_block, nullptr);
+	std::atomic<bool> closed{false};
+	int res = true;
+
+	DX_CHECK(dx_is_not_null(queue.get()));
+
+	queue_test_set_gate(target, false);
+
+	res = dx_is_true(queue_test_enqueue(*queue, 0, 0, 1)) && dx_is_true(queue_test_enqueue(*queue, 1, 1, 1)) &&
+		dx_is_true(queue_test_wait_until([&target] {
+			std::lock_guard<std::mutex> lk(target.mutex);
+
+			return target.listenerWaiting;
+		}));
+
+	std::thread closer([&queue, &closed] {
+		queue->close();
+		closed.store(true);
+	});
+
+	std::this_thread::sleep_for(QUEUE_TEST_WAIT_TIME);
+	res = res && dx_is_false(closed.load());
+
+	queue_test_set_gate(target, true);
+	closer.join();
+
+	res = res && dx_is_true(queue_test_enqueue(*queue, 2, 2, 1)) && queue_test_check_delivered(target, {0}, {0});
+
+	DX_CHECK(res);
+
+	QueueTestTarget blockedTarget;
+	QueueTestExecutor executor;
+	auto blockedQueue = queue_test_create(blockedTarget, dxf_dop_block, &executor);
+
+	DX_CHECK(dx_is_not_null(blockedQueue.get()));
+
+	std::thread producer([&blockedQueue] { queue_test_enqueue(*blockedQueue, 0, 0, 10); });
+
+	res = dx_is_true(queue_test_wait_until([&blockedTarget] {
+		std::lock_guard<std::mutex> lk(blockedTarget.mutex);
+
+		return blockedTarget.waitDepth == 1;
+	}));
+
+	blockedQueue->close();
+	producer.join();
+	queue_test_run_tasks(executor);
+
+	res = res && dx_is_equal_int(0, blockedTarget.waitDepth) && queue_test_check_delivered(blockedTarget, {}, {});
+
+	return res;
+}
+
+/* -------------------------------------------------------------------------- */
+
+/*
+ * Test
+ *
+ * The listener called by the executor task closes its queue without waiting for itself, the other events taken
+ * by the task aren't delivered and no task is scheduled after that.
+ */
+int delivery_queue_self_close_test(void) {
+	QueueTestTarget target;
+	QueueTestExecutor executor;
+	auto queue = queue_test_create(target, dxf_dop_drop_oldest, &executor);
+	int res = true;
+
+	DX_CHECK(dx_is_not_null(queue.get()));
+
+	target.closedQueue = queue.get();
+
+	res = dx_is_true(queue_test_enqueue(*queue, 0, 0, 1)) && dx_is_true(queue_test_enqueue(*queue, 1, 1, 1)) &&
+		dx_is_true(queue_test_enqueue(*queue, 2, 2, 1)) && dx_is_equal_int(1, queue_test_run_tasks(executor)) &&
+		dx_is_true(target.closeReturned) && queue_test_check_delivered(target, {0}, {0}) &&
+		dx_is_true(queue_test_enqueue(*queue, 3, 3, 1)) && dx_is_equal_int(0, queue_test_run_tasks(executor)) &&
+		queue_test_check_delivered(target, {0}, {0});
+
+	return res;
+}
+
+/* -------------------------------------------------------------------------- */
+
+/*
+ * Test
+ *
+ * The thread closing a subscription doesn't wait for the dispatch waiting for the room in a full queue, otherwise
+ * the executor thread closing it would wait for itself.
+ */
+int delivery_queue_dispatch_wait_test(void) {
+	dx::EventSubscriptionConnectionContext context(nullptr);
+	std::atomic<bool> waited{false};
+	int res = true;
+
+	context.process([](dx::EventSubscriptionConnectionContext* ctx) { ctx->beginDispatch(); });
+
+	std::thread closer([&context, &waited] {
+		context.waitForDispatch();
+		waited.store(true);
+	});
+
+	std::this_thread::sleep_for(QUEUE_TEST_WAIT_TIME);
+	res = dx_is_false(waited.load());
+
+	context.process([](dx::EventSubscriptionConnectionContext* ctx) { ctx->beginWaitForRoom(); });
+
+	res = res && dx_is_true(queue_test_wait_until([&waited] { return waited.load(); }));
+
+	context.process([](dx::EventSubscriptionConnectionContext* ctx) {
+		ctx->endWaitForRoom();
+		ctx->endDispatch();
+	});
+
+	closer.join();
+
+	return res;
+}
+
+/* -------------------------------------------------------------------------- */
+
+int event_delivery_queue_all_tests(void) {
+	int res = true;
+
+	if (!delivery_queue_block_test() ||
+		!delivery_queue_block_executor_test() ||
+		!delivery_queue_drop_oldest_test() ||
+		!delivery_queue_conflate_test() ||
+		!delivery_queue_close_test() ||
+		!delivery_queue_self_close_test() ||
+		!delivery_queue_dispatch_wait_test()) {
+
+		res = false;
+	}
+
+	return res;
+}
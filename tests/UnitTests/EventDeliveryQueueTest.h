@@ -0,0 +1,33 @@
+/*
+ * The contents of this file are subject to the Mozilla Public License Version
+ * 1.1 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ * http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+ * for the specific language governing rights and limitations under the
+ * License.
+ *
+ * The Initial Developer of the Original Code is Devexperts LLC.
+ * Portions created by the Initial Developer are Copyright (C) 2010
+ * the Initial Developer. All Rights Reserved.
+ *
+ * Contributor(s):
+ *
+ */
+
+#ifndef EVENT_DELIVERY_QUEUE_TEST_H_INCLUDED
+#define EVENT_DELIVERY_QUEUE_TEST_H_INCLUDED
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+int event_delivery_queue_all_tests(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* EVENT_DELIVERY_QUEUE_TEST_H_INCLUDED */
@@ -36,10 +36,14 @@
 #include "ConnectionContextData.h"
 #include "DXAlgorithms.h"
 #include "DXFeed.h"
+#include "DXThreads.h"
 #include "DXTypes.h"
 #include "EventSubscription.h"
 #include "SnapshotTests.h"
 #include "Snapshot.h"
+#include "SnapshotKeyTable.h"
+#include "SnapshotRecordTree.h"
+#include "StringArena.h"
 #include "SymbolCodec.h"
 #include "TestHelper.h"
 
@@ -80,6 +84,7 @@ int snapshot_test_runner(dxf_order_t* events, size_t size, dxf_snapshot_listener
 	const dx_event_subscr_flag subscr_flags = dx_esf_time_series | dx_esf_single_record;
 	dxf_const_string_t symbol = SYMBOL_DEFAULT;
 	dx_snap_test_state_t state = { 0, true };
+	dxf_string_t symbol_copy = NULL;
 
 	dxf_connection_t connection = dx_init_connection();
 	dxf_subscription_t subscription =
@@ -107,7 +112,8 @@ int snapshot_test_runner(dxf_order_t* events, size_t size, dxf_snapshot_listener
 		return false;
 	}
 
-	dx_close_snapshot(snapshot);
+	/* the subscription of the snapshot is the one created here, it's closed below */
+	dx_close_snapshot(snapshot, &subscription, &symbol_copy);
 	dx_close_event_subscription(subscription);
 	dx_deinit_connection(connection);
 
@@ -427,6 +433,185 @@ int snapshot_buildin_update_test(void) {
 
 /* -------------------------------------------------------------------------- */
 
+#define CLOSE_TEST_SYMBOL L"IBM"
+#define CLOSE_TEST_THROTTLE_INTERVAL 60000
+#define CLOSE_TEST_LISTENER_DELAY 50
+#define CLOSE_TEST_TIMEOUT 5000
+#define CLOSE_TEST_WAIT_STEP 10
+
+typedef struct {
+	dxf_connection_t connection;
+	dxf_snapshot_t snapshot;
+	dxf_subscription_t closed_subscription;
+	int listener_call_counter;
+	int close_result;
+	volatile int dispatch_done;
+	volatile int publisher_stopped;
+} dx_close_test_state_t;
+
+/* The snapshot listener closing its snapshot while the publisher task goes through the snapshots */
+void close_test_listener(const dxf_snapshot_data_ptr_t snapshot_data, void* user_data) {
+	dx_close_test_state_t* state = (dx_close_test_state_t*)user_data;
+	dxf_string_t symbol = NULL;
+
+	state->listener_call_counter++;
+
+	/* the publisher task waits for the snapshot guard meanwhile, if the listener is called under it */
+	dx_sleep(CLOSE_TEST_LISTENER_DELAY);
+
+	state->close_result = dx_close_snapshot(state->snapshot, &state->closed_subscription, &symbol);
+	dx_free(symbol);
+}
+
+void close_test_throttled_listener(const dxf_snapshot_data_ptr_t snapshot_data, void* user_data) {
+	(*(int*)user_data)++;
+}
+
+int close_test_play_events(dxf_connection_t connection, dxf_const_string_t symbol) {
+	size_t i = 0;
+
+	for (; i < SIZE_OF_ARRAY(simple_test_data); ++i) {
+		dxf_order_t order = simple_test_data[i];
+		dxf_event_params_t event_params = { order.event_flags, order.index,
+			dx_new_snapshot_key(dx_rid_order, symbol, order.source) };
+
+		if (!dx_process_event_data(connection, dx_eid_order, symbol, (dxf_event_data_t)&order, &event_params)) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/* Receives the snapshot whose listener closes it */
+#if !defined(_WIN32) || defined(USE_PTHREADS)
+void* close_test_dispatch_routine(void* arg) {
+#else
+unsigned close_test_dispatch_routine(void* arg) {
+#endif
+	dx_close_test_state_t* state = (dx_close_test_state_t*)arg;
+
+	close_test_play_events(state->connection, SYMBOL_DEFAULT);
+	state->dispatch_done = true;
+
+	return DX_THREAD_RETVAL_NULL;
+}
+
+/* Runs the publisher task as the worker thread does, until the snapshot is received */
+#if !defined(_WIN32) || defined(USE_PTHREADS)
+void* close_test_publisher_routine(void* arg) {
+#else
+unsigned close_test_publisher_routine(void* arg) {
+#endif
+	dx_close_test_state_t* state = (dx_close_test_state_t*)arg;
+
+	while (!state->dispatch_done) {
+		dx_publish_snapshots(state->connection);
+	}
+
+	state->publisher_stopped = true;
+
+	return DX_THREAD_RETVAL_NULL;
+}
+
+dxf_subscription_t close_test_subscription(dxf_connection_t connection, dxf_const_string_t symbol) {
+	dxf_subscription_t subscription = dx_create_event_subscription(connection, DXF_ET_ORDER,
+		dx_esf_time_series | dx_esf_single_record, TIME_DEFAULT);
+
+	if (subscription != dx_invalid_subscription) {
+		dx_clear_order_source(subscription);
+		dx_add_order_source(subscription, SOURCE_DEFAULT);
+		dx_add_symbols(subscription, &symbol, 1);
+	}
+
+	return subscription;
+}
+
+int close_test_wait(volatile int* flag) {
+	int waited = 0;
+
+	for (; !*flag && waited < CLOSE_TEST_TIMEOUT; waited += CLOSE_TEST_WAIT_STEP) {
+		dx_sleep(CLOSE_TEST_WAIT_STEP);
+	}
+
+	return *flag;
+}
+
+/*
+ * Test
+ *
+ * Closes a snapshot from its listener, while the publisher task goes through the snapshots of the connection
+ * because another snapshot is throttled.
+ *
+ * Expected: no deadlock, the snapshot is closed and the throttled one is published.
+ */
+int snapshot_close_in_listener_test(void) {
+	dx_close_test_state_t state = { NULL, dx_invalid_snapshot, dx_invalid_subscription, 0, false, false, false };
+	dxf_snapshot_publication_policy_t policy = { CLOSE_TEST_THROTTLE_INTERVAL, false };
+	dxf_subscription_t subscription = dx_invalid_subscription;
+	dxf_subscription_t throttled_subscription = dx_invalid_subscription;
+	dxf_snapshot_t throttled_snapshot = dx_invalid_snapshot;
+	dxf_string_t symbol = NULL;
+	dx_thread_t dispatch_thread;
+	dx_thread_t publisher_thread;
+	int throttled_call_counter = 0;
+	int res = true;
+
+	state.connection = dx_init_connection();
+
+	if (state.connection == NULL || !dx_init_symbol_codec()) {
+		return false;
+	}
+
+	subscription = close_test_subscription(state.connection, SYMBOL_DEFAULT);
+	throttled_subscription = close_test_subscription(state.connection, CLOSE_TEST_SYMBOL);
+	state.snapshot = dx_create_snapshot(state.connection, subscription, dx_eid_order, dx_rid_order, SYMBOL_DEFAULT,
+		SOURCE_DEFAULT, TIME_DEFAULT);
+	throttled_snapshot = dx_create_snapshot(state.connection, throttled_subscription, dx_eid_order, dx_rid_order,
+		CLOSE_TEST_SYMBOL, SOURCE_DEFAULT, TIME_DEFAULT);
+
+	if (subscription == dx_invalid_subscription || throttled_subscription == dx_invalid_subscription ||
+		state.snapshot == dx_invalid_snapshot || throttled_snapshot == dx_invalid_snapshot ||
+		!dx_set_snapshot_publication_policy(throttled_snapshot, &policy) ||
+		!dx_add_snapshot_listener(state.snapshot, close_test_listener, (void*)&state) ||
+		!dx_add_snapshot_listener(throttled_snapshot, close_test_throttled_listener, (void*)&throttled_call_counter) ||
+		!close_test_play_events(state.connection, CLOSE_TEST_SYMBOL) ||
+		!dx_request_full_snapshot(throttled_snapshot) ||
+		!dx_thread_create(&publisher_thread, NULL, close_test_publisher_routine, (void*)&state)) {
+
+		return false;
+	}
+
+	if (!dx_thread_create(&dispatch_thread, NULL, close_test_dispatch_routine, (void*)&state)) {
+		state.dispatch_done = true;
+		dx_wait_for_thread(publisher_thread, NULL);
+
+		return false;
+	}
+
+	/* the threads are left deadlocked on failure */
+	if (!dx_is_true(close_test_wait(&state.dispatch_done)) || !dx_is_true(close_test_wait(&state.publisher_stopped))) {
+		return false;
+	}
+
+	dx_wait_for_thread(dispatch_thread, NULL);
+	dx_wait_for_thread(publisher_thread, NULL);
+
+	/* the requested publication is made for sure, it's made once */
+	res = dx_publish_snapshots(state.connection);
+	res = res && dx_is_equal_int(1, state.listener_call_counter) && dx_is_true(state.close_result) &&
+		dx_is_true(state.closed_subscription == subscription) && dx_is_equal_int(1, throttled_call_counter);
+
+	dx_close_event_subscription(subscription);
+	res = dx_close_snapshot(throttled_snapshot, &throttled_subscription, &symbol) && res;
+	dx_close_event_subscription(throttled_subscription);
+	dx_deinit_connection(state.connection);
+
+	return res;
+}
+
+/* -------------------------------------------------------------------------- */
+
 static dx_record_info_id_t g_record_info_ids_list[] = {
 	dx_rid_order, dx_rid_time_and_sale, dx_rid_candle,
 	dx_rid_spread_order, dx_rid_greeks, dx_rid_series
@@ -551,6 +736,343 @@ int symbol_name_hasher_test(void) {
 
 /* -------------------------------------------------------------------------- */
 
+/* The number of the records making the tree three levels high */
+#define RECORD_TREE_TEST_SIZE 20000
+/* The prime step visiting the record numbers in a scattered order */
+#define RECORD_TREE_TEST_STEP 7919
+
+typedef struct {
+	dxf_long_t index;
+	dxf_long_t payload;
+} record_tree_test_record_t;
+
+dx_snapshot_record_key_t record_tree_test_key(dxf_long_t index) {
+	dx_snapshot_record_key_t key = { (dxf_time_int_field_t)(index % 7), index };
+
+	return key;
+}
+
+/* Checks that the records are visited in the key order and that every record matches its key */
+int record_tree_test_traversal(dx_snapshot_record_tree_t* tree, size_t expected_size) {
+	record_tree_test_record_t* records = NULL;
+	size_t i;
+
+	DX_CHECK(dx_is_equal_size_t(expected_size, tree->size));
+
+	if (expected_size == 0) {
+		return true;
+	}
+
+	records = dx_calloc(expected_size, sizeof(record_tree_test_record_t));
+	DX_CHECK(dx_is_not_null(records));
+	dx_copy_snapshot_records(tree, records);
+
+	for (i = 0; i < expected_size; ++i) {
+		if (records[i].payload != -records[i].index ||
+			(i > 0 && dx_snapshot_record_key_comparator(record_tree_test_key(records[i - 1].index),
+				record_tree_test_key(records[i].index)) >= 0)) {
+
+			PRINT_TEST_FAILED_MESSAGE("The records are out of order or don't match their keys!");
+			dx_free(records);
+			return false;
+		}
+	}
+
+	dx_free(records);
+
+	return true;
+}
+
+/*
+ * Test
+ */
+int snapshot_record_tree_test(void) {
+	dx_snapshot_record_tree_t tree;
+	dxf_long_t i;
+	int res = true;
+
+	dx_init_snapshot_record_tree(&tree, sizeof(record_tree_test_record_t));
+
+	/* the records are added in a scattered order, so the leaves and the branches are split at any position */
+	for (i = 0; i < RECORD_TREE_TEST_SIZE && res; ++i) {
+		dxf_long_t index = i * RECORD_TREE_TEST_STEP % RECORD_TREE_TEST_SIZE;
+		record_tree_test_record_t* record = dx_insert_snapshot_record(&tree, record_tree_test_key(index));
+
+		if (record == NULL) {
+			PRINT_TEST_FAILED_MESSAGE("Insert record error!");
+			res = false;
+			break;
+		}
+
+		record->index = index;
+		record->payload = -index;
+	}
+
+	res = res && dx_is_true(tree.height >= 2) && record_tree_test_traversal(&tree, RECORD_TREE_TEST_SIZE);
+
+	for (i = 0; i < RECORD_TREE_TEST_SIZE && res; ++i) {
+		record_tree_test_record_t* record = dx_find_snapshot_record(&tree, record_tree_test_key(i));
+
+		res = dx_is_not_null(record) && dx_is_equal_dxf_long_t(i, record->index);
+	}
+
+	res = res && dx_is_null(dx_find_snapshot_record(&tree, record_tree_test_key(RECORD_TREE_TEST_SIZE)));
+
+	/* the removal of every other record merges the nodes and moves the records between them */
+	for (i = 0; i < RECORD_TREE_TEST_SIZE && res; i += 2) {
+		dxf_long_t index = i * RECORD_TREE_TEST_STEP % RECORD_TREE_TEST_SIZE;
+
+		res = dx_is_true(dx_remove_snapshot_record(&tree, record_tree_test_key(index))) &&
+			dx_is_false(dx_remove_snapshot_record(&tree, record_tree_test_key(index)));
+	}
+
+	res = res && record_tree_test_traversal(&tree, RECORD_TREE_TEST_SIZE / 2);
+
+	for (i = 0; i < RECORD_TREE_TEST_SIZE && res; ++i) {
+		dxf_long_t index = i * RECORD_TREE_TEST_STEP % RECORD_TREE_TEST_SIZE;
+		record_tree_test_record_t* record = dx_find_snapshot_record(&tree, record_tree_test_key(index));
+
+		res = (i % 2 == 0) ? dx_is_null(record) : dx_is_not_null(record) && dx_is_equal_dxf_long_t(index, record->index);
+	}
+
+	/* the tree shrinks to the root leaf when the rest of the records are removed */
+	for (i = 1; i < RECORD_TREE_TEST_SIZE && res; i += 2) {
+		dxf_long_t index = i * RECORD_TREE_TEST_STEP % RECORD_TREE_TEST_SIZE;
+
+		res = dx_is_true(dx_remove_snapshot_record(&tree, record_tree_test_key(index)));
+	}
+
+	res = res && dx_is_equal_int(0, tree.height) && record_tree_test_traversal(&tree, 0) &&
+		dx_is_null(dx_find_snapshot_record(&tree, record_tree_test_key(1)));
+
+	dx_clear_snapshot_record_tree(&tree);
+
+	return res;
+}
+
+/* -------------------------------------------------------------------------- */
+
+/* The number of the strings filling several chunks of the arena */
+#define STRING_ARENA_TEST_SIZE 3000
+/* The length of the strings longer than the largest chunk, they get the chunks of their own */
+#define STRING_ARENA_TEST_LONG_LENGTH 70000
+
+/* Makes the distinct string of the number padded to the length, the buffer must hold the length + 1 characters */
+void string_arena_test_string(dxf_char_t* buffer, size_t number, size_t length) {
+	size_t i = 0;
+
+	do {
+		buffer[i++] = L'a' + (dxf_char_t)(number % 26);
+		number /= 26;
+	} while (number > 0);
+
+	buffer[i++] = L'#';
+
+	for (; i < length; ++i) {
+		buffer[i] = L'0' + (dxf_char_t)(i % 10);
+	}
+
+	buffer[i] = 0;
+}
+
+/* Interns the strings and checks that the equal strings get the same copy */
+int string_arena_test_fill(dx_string_arena_t* arena, dxf_const_string_t* copies, dxf_char_t* buffer) {
+	size_t i;
+
+	for (i = 0; i < STRING_ARENA_TEST_SIZE; ++i) {
+		dxf_const_string_t copy = NULL;
+		dxf_string_t other_buffer = NULL;
+		int interned = false;
+
+		string_arena_test_string(buffer, i, (i % 100 == 99) ? STRING_ARENA_TEST_LONG_LENGTH : i % 40);
+		DX_CHECK(dx_intern_arena_string(arena, buffer, &copies[i]));
+		DX_CHECK(copies[i] != buffer && dx_compare_strings(copies[i], buffer) == 0);
+
+		/* the string is interned again from another buffer */
+		DX_CHECK(dx_is_not_null(other_buffer = dx_create_string_src(buffer)));
+		interned = dx_intern_arena_string(arena, other_buffer, &copy);
+		dx_free(other_buffer);
+		DX_CHECK(interned && dx_is_equal_ptr((void*)copies[i], (void*)copy));
+	}
+
+	DX_CHECK(dx_is_equal_size_t(STRING_ARENA_TEST_SIZE, arena->size));
+
+	/* the earlier copies stay intact while the arena grows */
+	for (i = 0; i < STRING_ARENA_TEST_SIZE; ++i) {
+		string_arena_test_string(buffer, i, (i % 100 == 99) ? STRING_ARENA_TEST_LONG_LENGTH : i % 40);
+		DX_CHECK(dx_compare_strings(copies[i], buffer) == 0);
+	}
+
+	return true;
+}
+
+/*
+ * Test
+ */
+int string_arena_test(void) {
+	dx_string_arena_t arena;
+	dxf_const_string_t* copies = dx_calloc(STRING_ARENA_TEST_SIZE, sizeof(dxf_const_string_t));
+	dxf_char_t* buffer = dx_calloc(STRING_ARENA_TEST_LONG_LENGTH + 1, sizeof(dxf_char_t));
+	dxf_const_string_t copy = NULL;
+	size_t chunks_capacity = 0;
+	int res = true;
+
+	dx_init_string_arena(&arena);
+
+	res = dx_is_not_null(copies) && dx_is_not_null(buffer) &&
+		dx_is_false(dx_intern_arena_string(&arena, NULL, &copy)) &&
+		/* the strings spread over several chunks */
+		string_arena_test_fill(&arena, copies, buffer) &&
+		dx_is_true(arena.chunks_capacity > STRING_ARENA_TEST_LONG_LENGTH);
+
+	if (res) {
+		chunks_capacity = arena.chunks_capacity;
+
+		/* the clearing forgets the strings and compacts the chunks into one holding as many characters */
+		dx_clear_string_arena(&arena);
+
+		res = dx_is_equal_size_t(0, arena.size) && dx_is_equal_size_t(chunks_capacity, arena.chunks_capacity) &&
+			string_arena_test_fill(&arena, copies, buffer) &&
+			/* the same strings fit into the compacted chunk, no chunk is added */
+			dx_is_equal_size_t(chunks_capacity, arena.chunks_capacity);
+	}
+
+	res = res && dx_intern_arena_string(&arena, L"", &copy) && dx_is_equal_size_t(0, dx_string_length(copy));
+
+	dx_free_string_arena(&arena);
+	CHECKED_FREE(copies);
+	CHECKED_FREE(buffer);
+
+	return res;
+}
+
+/* -------------------------------------------------------------------------- */
+
+/* The number of the keys sharing one home slot */
+#define KEY_TABLE_TEST_CHAIN_SIZE 4
+/* The number of the keys growing the table several times */
+#define KEY_TABLE_TEST_SIZE 5000
+
+/* Returns the value of the key, the values only need to be distinct and not NULL */
+void* key_table_test_value(dxf_ulong_t key) {
+	return (void*)(size_t)(key + 1);
+}
+
+/* Checks that the keys are found with their values */
+int key_table_test_find(dx_snapshot_key_table_t* table, dxf_ulong_t* keys, size_t count) {
+	size_t i;
+
+	for (i = 0; i < count; ++i) {
+		DX_CHECK(dx_is_equal_ptr(key_table_test_value(keys[i]), dx_find_snapshot_key_value(table, keys[i])));
+	}
+
+	return true;
+}
+
+/*
+ * Test
+ */
+int snapshot_key_table_test(void) {
+	dx_snapshot_key_table_t table;
+	/* the chain of the colliding keys followed by the key whose home slot is inside the chain */
+	dxf_ulong_t chain[KEY_TABLE_TEST_CHAIN_SIZE + 1];
+	dxf_ulong_t* keys = dx_calloc(KEY_TABLE_TEST_SIZE, sizeof(dxf_ulong_t));
+	size_t chain_size = 0;
+	size_t home_index = 0;
+	size_t slot_count = 0;
+	dxf_ulong_t key = 0;
+	size_t i = 0;
+	int res = true;
+
+	dx_init_snapshot_key_table(&table);
+
+	if (!dx_is_not_null(keys) || !dx_is_null(dx_find_snapshot_key_value(&table, 0)) ||
+		!dx_is_true(dx_reserve_snapshot_key_table(&table, KEY_TABLE_TEST_CHAIN_SIZE + 1))) {
+
+		CHECKED_FREE(keys);
+		dx_free_snapshot_key_table(&table);
+
+		return false;
+	}
+
+	slot_count = table.slot_count;
+	home_index = dx_get_snapshot_key_home_index(&table, 0);
+
+	for (key = 0; chain_size < KEY_TABLE_TEST_CHAIN_SIZE; ++key) {
+		if (dx_get_snapshot_key_home_index(&table, key) == home_index) {
+			chain[chain_size++] = key;
+		}
+	}
+
+	for (; dx_get_snapshot_key_home_index(&table, key) != ((home_index + 1) & (slot_count - 1)); ++key) {}
+
+	chain[chain_size++] = key;
+
+	for (i = 0; res && i < chain_size; ++i) {
+		res = dx_is_true(dx_add_snapshot_key_value(&table, chain[i], key_table_test_value(chain[i])));
+	}
+
+	/* the colliding keys are probed past their home slot without growing the table */
+	res = res && dx_is_equal_size_t(slot_count, table.slot_count) && dx_is_equal_size_t(chain_size, table.size) &&
+		key_table_test_find(&table, chain, chain_size) &&
+		dx_is_null(dx_find_snapshot_key_value(&table, key + 1)) &&
+		/* the removal needs the value stored with the key */
+		dx_is_false(dx_remove_snapshot_key_value(&table, chain[1], key_table_test_value(chain[2]))) &&
+		dx_is_false(dx_remove_snapshot_key_value(&table, key + 1, key_table_test_value(key + 1)));
+
+	/* the removal from the middle of the chain keeps the keys probed after the removed one reachable */
+	res = res && dx_is_true(dx_remove_snapshot_key_value(&table, chain[1], key_table_test_value(chain[1]))) &&
+		dx_is_null(dx_find_snapshot_key_value(&table, chain[1])) &&
+		dx_is_equal_size_t(chain_size - 1, table.size) &&
+		key_table_test_find(&table, chain, 1) && key_table_test_find(&table, chain + 2, chain_size - 2) &&
+		dx_is_true(dx_remove_snapshot_key_value(&table, chain[0], key_table_test_value(chain[0]))) &&
+		key_table_test_find(&table, chain + 2, chain_size - 2) &&
+		dx_is_true(dx_add_snapshot_key_value(&table, chain[1], key_table_test_value(chain[1]))) &&
+		key_table_test_find(&table, chain + 1, chain_size - 1);
+
+	for (i = 0; res && i < KEY_TABLE_TEST_SIZE; ++i) {
+		/* the keys differing in the high bits only, like the keys of the symbols with the same hash */
+		keys[i] = ((dxf_ulong_t)i << 40u) | (key + 1);
+		res = dx_is_true(dx_add_snapshot_key_value(&table, keys[i], key_table_test_value(keys[i])));
+	}
+
+	/* the table is rehashed while growing, every entry stays reachable */
+	res = res && dx_is_true(table.slot_count > slot_count) && dx_is_true(table.slot_count >= table.size * 2) &&
+		dx_is_equal_size_t(KEY_TABLE_TEST_SIZE + chain_size - 1, table.size) &&
+		key_table_test_find(&table, keys, KEY_TABLE_TEST_SIZE) &&
+		key_table_test_find(&table, chain + 1, chain_size - 1);
+
+	for (i = 0; res && i < KEY_TABLE_TEST_SIZE; i += 2) {
+		res = dx_is_true(dx_remove_snapshot_key_value(&table, keys[i], key_table_test_value(keys[i])));
+	}
+
+	for (i = 0; res && i < KEY_TABLE_TEST_SIZE; ++i) {
+		res = (i % 2 == 0) ? dx_is_null(dx_find_snapshot_key_value(&table, keys[i])) :
+			dx_is_equal_ptr(key_table_test_value(keys[i]), dx_find_snapshot_key_value(&table, keys[i]));
+	}
+
+	for (i = 1; res && i < KEY_TABLE_TEST_SIZE; i += 2) {
+		res = dx_is_true(dx_remove_snapshot_key_value(&table, keys[i], key_table_test_value(keys[i])));
+	}
+
+	for (i = 1; res && i < chain_size; ++i) {
+		res = dx_is_true(dx_remove_snapshot_key_value(&table, chain[i], key_table_test_value(chain[i])));
+	}
+
+	res = res && dx_is_equal_size_t(0, table.size) && dx_is_null(dx_find_snapshot_key_value(&table, keys[1]));
+
+	for (i = 0; res && i < table.slot_count; ++i) {
+		res = dx_is_null(table.slots[i].value);
+	}
+
+	CHECKED_FREE(keys);
+	dx_free_snapshot_key_table(&table);
+
+	return res;
+}
+
+/* -------------------------------------------------------------------------- */
+
 int snapshot_all_unit_test(void) {
 	int res = true;
 
@@ -560,8 +1082,12 @@ int snapshot_all_unit_test(void) {
 		!snapshot_bid_ask_test() ||
 		!snapshot_duplicate_index_test() ||
 		!snapshot_buildin_update_test() ||
+		!snapshot_close_in_listener_test() ||
 		!snapshot_key_test() ||
-		!symbol_name_hasher_test()) {
+		!symbol_name_hasher_test() ||
+		!snapshot_record_tree_test() ||
+		!string_arena_test() ||
+		!snapshot_key_table_test()) {
 
 		res = false;
 	}
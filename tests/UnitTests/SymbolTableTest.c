@@ -0,0 +1,222 @@
+/*
+ * The contents of this file are subject to the Mozilla Public License Version
+ * 1.1 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ * http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+ * for the specific language governing rights and limitations under the
+ * License.
+ *
+ * The Initial Developer of the Original Code is Devexperts LLC.
+ * Portions created by the Initial Developer are Copyright (C) 2010
+ * the Initial Developer. All Rights Reserved.
+ *
+ * Contributor(s):
+ *
+ */
+
+#include <stdio.h>
+#include <wchar.h>
+
+#include "SymbolTableTest.h"
+#include "DXAlgorithms.h"
+#include "EventSubscription.h"
+#include "SymbolCodec.h"
+#include "SymbolTable.h"
+#include "TestHelper.h"
+
+/* The number of the symbols growing the table several times */
+#define SYMBOL_TABLE_TEST_SIZE 2000
+#define SYMBOL_TABLE_TEST_BUFFER_SIZE 32
+
+/* Makes the symbol of the number, the even ones may be penta-encoded and the odd ones are too long for that */
+static int symbol_table_test_symbol(dxf_char_t* buffer, int number) {
+	if (number % 2 == 0) {
+		return swprintf(buffer, SYMBOL_TABLE_TEST_BUFFER_SIZE, L"S%d", number);
+	}
+
+	return swprintf(buffer, SYMBOL_TABLE_TEST_BUFFER_SIZE, L"LONGSYMBOL%d", number);
+}
+
+/* -------------------------------------------------------------------------- */
+
+/*
+ * Test
+ *
+ * Interns a symbol by its characters and by its cipher.
+ *
+ * Expected: the symbol gets the same string and id both ways, the characters don't have to be null-terminated.
+ */
+static int symbol_table_cipher_test(void) {
+	dx_symbol_table_t table = dx_create_symbol_table();
+	dxf_int_t cipher = dx_encode_symbol_name(L"IBM");
+	dxf_const_string_t symbol = NULL;
+	dxf_const_string_t cipher_symbol = NULL;
+	dxf_const_string_t prefix_symbol = NULL;
+	dxf_int_t symbol_id = -1;
+	dxf_int_t cipher_symbol_id = -1;
+	dxf_int_t prefix_symbol_id = -1;
+	int res = true;
+
+	DX_CHECK(dx_is_not_null(table));
+
+	res = dx_is_true(cipher != 0) &&
+		dx_is_true(dx_intern_string_symbol(table, L"IBM", 3, &symbol, &symbol_id)) &&
+		dx_is_true(dx_intern_cipher_symbol(table, cipher, &cipher_symbol, &cipher_symbol_id)) &&
+		dx_is_true(dx_intern_string_symbol(table, L"IBM.TEST", 3, &prefix_symbol, &prefix_symbol_id)) &&
+		dx_is_equal_dxf_const_string_t(L"IBM", symbol) &&
+		dx_is_equal_ptr((void*)symbol, (void*)cipher_symbol) && dx_is_equal_int(symbol_id, cipher_symbol_id) &&
+		dx_is_equal_ptr((void*)symbol, (void*)prefix_symbol) && dx_is_equal_int(symbol_id, prefix_symbol_id) &&
+		dx_is_equal_int(1, dx_get_symbol_table_size(table));
+
+	dx_free_symbol_table(table);
+
+	return res;
+}
+
+/* -------------------------------------------------------------------------- */
+
+/*
+ * Test
+ *
+ * Interns the symbols that can't be penta-encoded, from the different buffers.
+ *
+ * Expected: the equal symbols get the same null-terminated string and id, the other ones get the other ids.
+ */
+static int symbol_table_string_test(void) {
+	dx_symbol_table_t table = dx_create_symbol_table();
+	dxf_char_t buffer[SYMBOL_TABLE_TEST_BUFFER_SIZE] = L"LONGSYMBOL";
+	dxf_const_string_t symbol = NULL;
+	dxf_const_string_t same_symbol = NULL;
+	dxf_const_string_t other_symbol = NULL;
+	dxf_int_t symbol_id = -1;
+	dxf_int_t same_symbol_id = -1;
+	dxf_int_t other_symbol_id = -1;
+	int res = true;
+
+	DX_CHECK(dx_is_not_null(table));
+
+	res = dx_is_true(dx_intern_string_symbol(table, L"LONGSYMBOL/EXTRA", 10, &symbol, &symbol_id)) &&
+		dx_is_true(dx_intern_string_symbol(table, buffer, 10, &same_symbol, &same_symbol_id)) &&
+		dx_is_true(dx_intern_string_symbol(table, L"LONGSYMBOLX", 11, &other_symbol, &other_symbol_id)) &&
+		dx_is_equal_dxf_const_string_t(L"LONGSYMBOL", symbol) &&
+		dx_is_equal_ptr((void*)symbol, (void*)same_symbol) && dx_is_equal_int(symbol_id, same_symbol_id) &&
+		dx_is_equal_dxf_const_string_t(L"LONGSYMBOLX", other_symbol) &&
+		dx_is_true(symbol_id != other_symbol_id) && dx_is_equal_int(2, dx_get_symbol_table_size(table));
+
+	dx_free_symbol_table(table);
+
+	return res;
+}
+
+/* -------------------------------------------------------------------------- */
+
+static int symbol_table_fill(dx_symbol_table_t table, dxf_const_string_t* symbols) {
+	dxf_char_t buffer[SYMBOL_TABLE_TEST_BUFFER_SIZE];
+	int i;
+
+	for (i = 0; i < SYMBOL_TABLE_TEST_SIZE; ++i) {
+		int length = symbol_table_test_symbol(buffer, i);
+		dxf_int_t symbol_id = -1;
+
+		DX_CHECK(dx_intern_string_symbol(table, buffer, length, &symbols[i], &symbol_id));
+		DX_CHECK(dx_is_equal_int(i, symbol_id));
+		DX_CHECK(dx_is_equal_dxf_const_string_t(buffer, symbols[i]));
+	}
+
+	return true;
+}
+
+/*
+ * Test
+ *
+ * Interns many symbols, then interns them again and clears the table.
+ *
+ * Expected: the symbols get the consecutive ids, and their strings stay the same while the table grows. The symbol
+ * name hashes match the ones of the dispatch. The cleared table gives the ids from 0 again.
+ */
+static int symbol_table_growth_test(void) {
+	dx_symbol_table_t table = dx_create_symbol_table();
+	dxf_const_string_t* symbols = dx_calloc(SYMBOL_TABLE_TEST_SIZE, sizeof(dxf_const_string_t));
+	dxf_char_t buffer[SYMBOL_TABLE_TEST_BUFFER_SIZE];
+	int res = true;
+	int i;
+
+	if (!dx_is_not_null(table) || !dx_is_not_null(symbols)) {
+		dx_free_symbol_table(table);
+		CHECKED_FREE(symbols);
+
+		return false;
+	}
+
+	res = symbol_table_fill(table, symbols) &&
+		dx_is_equal_int(SYMBOL_TABLE_TEST_SIZE, dx_get_symbol_table_size(table));
+
+	for (i = 0; res && i < SYMBOL_TABLE_TEST_SIZE; ++i) {
+		int length = symbol_table_test_symbol(buffer, i);
+		dxf_const_string_t symbol = NULL;
+		dxf_int_t symbol_id = -1;
+
+		res = dx_is_true(dx_intern_string_symbol(table, buffer, length, &symbol, &symbol_id)) &&
+			dx_is_equal_int(i, symbol_id) && dx_is_equal_ptr((void*)symbols[i], (void*)symbol) &&
+			dx_is_equal_dxf_ulong_t(dx_symbol_name_hasher(symbol), dx_get_symbol_name_hash(table, symbol_id));
+	}
+
+	res = res && dx_is_equal_int(SYMBOL_TABLE_TEST_SIZE, dx_get_symbol_table_size(table));
+
+	if (res) {
+		dx_clear_symbol_table(table);
+
+		res = dx_is_equal_int(0, dx_get_symbol_table_size(table)) && symbol_table_fill(table, symbols);
+	}
+
+	dx_free_symbol_table(table);
+	CHECKED_FREE(symbols);
+
+	return res;
+}
+
+/* -------------------------------------------------------------------------- */
+
+/*
+ * Test
+ *
+ * Tries to intern the zero cipher and the invalid characters.
+ *
+ * Expected: the calls fail, nothing is interned.
+ */
+static int symbol_table_invalid_params_test(void) {
+	dx_symbol_table_t table = dx_create_symbol_table();
+	dxf_const_string_t symbol = NULL;
+	dxf_int_t symbol_id = -1;
+	int res = true;
+
+	DX_CHECK(dx_is_not_null(table));
+
+	res = dx_is_false(dx_intern_cipher_symbol(table, 0, &symbol, &symbol_id)) &&
+		dx_is_false(dx_intern_string_symbol(table, NULL, 3, &symbol, &symbol_id)) &&
+		dx_is_false(dx_intern_string_symbol(table, L"IBM", -1, &symbol, &symbol_id)) &&
+		dx_is_equal_int(0, dx_get_symbol_table_size(table));
+
+	dx_free_symbol_table(table);
+
+	return res;
+}
+
+/* -------------------------------------------------------------------------- */
+
+int symbol_table_all_tests(void) {
+	int res = true;
+
+	if (!dx_init_symbol_codec() ||
+		!symbol_table_cipher_test() ||
+		!symbol_table_string_test() ||
+		!symbol_table_growth_test() ||
+		!symbol_table_invalid_params_test()) {
+
+		res = false;
+	}
+	return res;
+}
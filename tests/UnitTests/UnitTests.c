@@ -23,11 +23,13 @@
 #include "AlgorithmsTest.h"
 #include "ConnectionTest.h"
 #include "DXNetworkTests.h"
+#include "EventDeliveryQueueTest.h"
 #include "EventSubscriptionTest.h"
 #include "EventDynamicSubscriptionTest.h"
 #include "OrderSourceConfigurationTest.h"
 #include "CandleTest.h"
 #include "SnapshotTests.h"
+#include "SymbolTableTest.h"
 
 typedef int(*test_function_t)(void);
 
@@ -48,8 +50,10 @@ static test_function_data_t g_tests[] = {
 	{ "event_subscription_test", event_subscription_all_test },
 	{ "address_parser_test", address_parser_all_tests },
 	{ "algorithms_test", algorithms_all_tests },
+	{ "symbol_table_test", symbol_table_all_tests },
 	{ "network_test", network_all_test },
 	{ "event_dymamic_subscription_test", event_dynamic_subscription_all_test },
+	{ "event_delivery_queue_test", event_delivery_queue_all_tests },
 	{ "order_source_test", order_source_configuration_test },
 	{ "candle_test", candle_all_tests },
 	{ "connection_test", connection_all_test },